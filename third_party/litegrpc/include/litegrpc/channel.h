@@ -18,7 +18,9 @@
  */
 
 #include <string>       // std::string
+#include <map>          // std::map
 #include <memory>       // std::shared_ptr, std::unique_ptr
+#include <atomic>       // std::atomic
 #include <chrono>       // std::chrono::system_clock
 #include "litegrpc/core.h"        // 核心配置和类型定义
 #include "litegrpc/status.h"      // 状态码和错误处理
@@ -137,12 +139,13 @@ public:
  * @note 与标准 gRPC Channel 完全兼容
  * @note 内置 HTTP/2 客户端，无需外部依赖
  * @note 支持 SSL/TLS 加密传输
+ * @note 线程安全：多个线程的并发调用在同一条 HTTP/2 连接上多路复用
  */
 class LiteGrpcChannel : public Channel {
 public:
     /**
      * @brief 构造函数
-     * @param target 目标服务器地址（格式：host:port 或 https://host:port）
+     * @param target 目标服务器地址（格式：host:port、https://host:port、unix:path 或 unix-abstract:name）
      * @param credentials 通道安全凭据
      * @param args 通道配置参数
      * 
@@ -172,6 +175,8 @@ public:
     /**
      * @brief 建立连接
      * @return Status 连接结果
+     * 
+     * @note 最长等待 Config::DEFAULT_TIMEOUT_MS；RPC 触发的连接受该调用的截止时间约束
      */
     Status Connect() override;
     
@@ -268,6 +273,42 @@ public:
      * @return 通道配置参数
      */
     const ChannelArguments& GetArguments() const override { return args_; }
+    
+    /**
+     * @brief 获取当前连接上套接字选项的实际生效值
+     * @return 选项名到生效值的映射，未连接时为空
+     * 
+     * @details 用于诊断通道参数（包括套接字预设）是否按预期生效。
+     *          键为 "tcp_nodelay"、"so_sndbuf"、"so_rcvbuf"、"tcp_user_timeout_ms"、
+     *          "so_busy_poll_us"、"tcp_quickack"、"ktls_send"、"ktls_recv"、"tls_resumed"。
+     *          值由 getsockopt 读回，可能与请求的值不同（例如内核将缓冲区大小翻倍、权限不足时
+     *          忙轮询未生效）；kTLS 两项表示 TLS 记录层在对应方向上是否实际由内核处理，
+     *          "tls_resumed" 表示当前连接的 TLS 握手是否以会话恢复完成。
+     */
+    std::map<std::string, int> GetSocketOptions() const;
+    
+    /**
+     * @brief 获取当前连接上保活 PING 测得的往返时延
+     * @return 统计项名到值的映射，未连接时为空
+     * 
+     * @details 键为 "keepalive_pings"、"rtt_samples"、"last_rtt_us"、"min_rtt_us"、
+     *          "smoothed_rtt_us"。只有设置了 GRPC_ARG_KEEPALIVE_TIME_MS 的通道才会
+     *          发送保活 PING 并产生采样；尚无采样时时延为 0。可用于在多个通道之间
+     *          按时延选择，或诊断网络状况。重连后重新计数。
+     */
+    std::map<std::string, int64_t> GetRttStats() const;
+    
+    /**
+     * @brief 获取当前连接上 HTTP/2 会话的内存使用情况
+     * @return 统计项名到值的映射，未连接时为空
+     * 
+     * @details 会话内部对象从每个连接独占的内存池分配。键为 "in_use_bytes"（当前占用）、
+     *          "reserved_bytes"（内存池向系统申请的字节数）、"peak_reserved_bytes"、
+     *          "allocations"（nghttp2 的分配请求次数）、"system_allocations"
+     *          （内存池实际调用 malloc 的次数）、"allocation_failures"（超出
+     *          LITEGRPC_ARG_HTTP2_SESSION_MEMORY_LIMIT 预算的次数）。重连后重新计数。
+     */
+    std::map<std::string, int64_t> GetSessionMemoryStats() const;
 
 private:
     /* ========================================================================
@@ -277,7 +318,7 @@ private:
     std::string target_;                                    ///< 目标服务器地址
     std::shared_ptr<ChannelCredentials> credentials_;       ///< 安全凭据
     ChannelArguments args_;                                 ///< 通道参数
-    bool connected_;                                        ///< 连接状态标志
+    std::atomic<bool> connected_;                           ///< 连接状态标志
     
     /**
      * @brief HTTP/2 连接详细信息
@@ -302,9 +343,10 @@ private:
     
     /**
      * @brief 建立底层连接
-     * @return Status 连接建立结果
+     * @param timeout_ms 连接超时时间（毫秒），覆盖地址解析后的 TCP 连接与 TLS 握手
+     * @return Status 连接建立结果；超时返回 DEADLINE_EXCEEDED
      */
-    Status EstablishConnection();
+    Status EstablishConnection(int timeout_ms);
     
     /**
      * @brief 发送 HTTP/2 请求
@@ -329,12 +371,14 @@ private:
 
 /**
  * @brief 创建标准通道
- * @param target 目标服务器地址（格式：host:port）
+ * @param target 目标服务器地址（格式：host:port、unix:path、unix-abstract:name、inproc://name 或 shm:path）
  * @param creds 通道安全凭据
  * @return 创建的通道智能指针
  * 
  * @details 使用默认参数创建 gRPC 通道，适用于大多数场景。
  *          内部会使用默认的 ChannelArguments 配置。
+ *          inproc://name 目标返回 InprocChannel（见 litegrpc/inproc.h），
+ *          shm: 目标返回 ShmChannel（见 litegrpc/shm.h），其余目标返回 LiteGrpcChannel。
  * 
  * @note 这是最常用的通道创建方法
  * @note 与标准 gRPC CreateChannel 函数完全兼容
@@ -345,13 +389,15 @@ std::shared_ptr<Channel> CreateChannel(
 
 /**
  * @brief 创建自定义通道
- * @param target 目标服务器地址（格式：host:port）
+ * @param target 目标服务器地址（格式：host:port、unix:path、unix-abstract:name、inproc://name 或 shm:path）
  * @param creds 通道安全凭据
  * @param args 自定义通道参数
  * @return 创建的通道智能指针
  * 
  * @details 使用自定义参数创建 gRPC 通道，允许精细控制通道行为。
  *          可以配置超时、重试策略、压缩算法等高级选项。
+ *          inproc://name 目标返回 InprocChannel，通道参数不影响其行为；
+ *          shm: 目标返回 ShmChannel，只使用 LITEGRPC_ARG_SHM_RING_SIZE。
  * 
  * @note 适用于需要特殊配置的高级场景
  * @note 与标准 gRPC CreateCustomChannel 函数完全兼容
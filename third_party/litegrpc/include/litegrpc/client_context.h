@@ -186,6 +186,45 @@ public:
      */
     const std::string& user_agent_prefix() const;
     
+    /* ========================================================================
+     * 优先级管理 - RFC 9218 可扩展优先级
+     * ======================================================================== */
+    
+    static constexpr int kUrgencyHighest = 0;  ///< 最高紧急度（心跳、控制类调用）
+    static constexpr int kUrgencyDefault = 3;  ///< 默认紧急度
+    static constexpr int kUrgencyLowest = 7;   ///< 最低紧急度（后台批量传输）
+    
+    /**
+     * @brief 设置调用优先级
+     * @param urgency 紧急度，kUrgencyHighest（0）最高，kUrgencyLowest（7）最低，
+     *        超出范围时截断到边界
+     * @param incremental 响应是否可以与同紧急度的其他响应交错处理
+     * 
+     * @details 优先级以 RFC 9218 的 priority 请求头（例如 "u=0"、"u=5, i"）
+     *          与 HTTP/2 HEADERS 帧中的流权重告知服务器，同时约束本端写出顺序：
+     *          同一连接上紧急度更高的调用还有请求体未写出时，
+     *          紧急度较低的调用暂停生成 DATA 帧。
+     * 
+     * @note 未设置时不发送优先级信号，按默认紧急度调度
+     */
+    void set_priority(int urgency, bool incremental = false);
+    
+    /**
+     * @brief 获取紧急度
+     * @return 设置的紧急度，未设置时返回 kUrgencyDefault
+     */
+    int priority_urgency() const;
+    
+    /**
+     * @brief 获取是否可交错处理
+     */
+    bool priority_incremental() const;
+    
+    /**
+     * @brief 检查是否设置了优先级
+     */
+    bool has_priority() const;
+    
     /* ========================================================================
      * 内部实现方法 - 框架内部使用
      * ======================================================================== */
@@ -225,6 +264,9 @@ private:
     std::string authority_;                                 ///< 服务器权威名称
     std::string compression_algorithm_;                     ///< 压缩算法
     std::string user_agent_prefix_;                         ///< 用户代理前缀
+    int urgency_ = kUrgencyDefault;                         ///< 紧急度
+    bool incremental_ = false;                              ///< 是否可交错处理
+    bool has_priority_ = false;                             ///< 是否设置了优先级
 };
 
 } // namespace litegrpc
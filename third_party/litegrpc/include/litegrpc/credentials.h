@@ -19,10 +19,16 @@
 
 #include <string>   // std::string
 #include <memory>   // std::shared_ptr
-#include "litegrpc/core.h"  // SslCredentialsOptions
+#include <mutex>    // std::once_flag
+#include "litegrpc/core.h"    // SslCredentialsOptions
+#include "litegrpc/status.h"  // Status
 
 namespace litegrpc {
 
+namespace http2 {
+class TlsContext;
+} // namespace http2
+
 /* ============================================================================
  * 通道凭证基类和实现
  * ============================================================================ */
@@ -93,6 +99,8 @@ public:
  * 
  * @note 与标准 gRPC SslCredentials 兼容
  * @note 支持自定义根证书和客户端证书
+ * @note 证书在首次建立连接时解析一次，得到的 TLS 上下文由使用本凭证的
+ *       所有通道、连接与重连共享
  */
 class SslChannelCredentialsImpl : public ChannelCredentials {
 public:
@@ -123,8 +131,22 @@ public:
      */
     const SslCredentialsOptions& GetOptions() const { return options_; }
     
+    /**
+     * @brief 获取由本凭证构建的 TLS 上下文（内部使用）
+     * @param context 输出参数，共享的不可变 TLS 上下文
+     * @return 首次调用时解析 PEM 的结果，之后返回同一结果
+     * 
+     * @details 证书或私钥无法解析时返回 INVALID_ARGUMENT，
+     *          使用本凭证的连接都会以该错误失败。
+     */
+    Status GetTlsContext(std::shared_ptr<http2::TlsContext>* context) const;
+    
 private:
     SslCredentialsOptions options_;  ///< SSL 凭证配置
+    
+    mutable std::once_flag tls_once_;                        ///< 保证 TLS 上下文只构建一次
+    mutable std::shared_ptr<http2::TlsContext> tls_context_; ///< 构建出的 TLS 上下文
+    mutable Status tls_status_;                              ///< 构建结果
 };
 
 /* ============================================================================
@@ -211,7 +233,12 @@ public:
     /** @brief 连接保活超时时间（毫秒） */
     static const std::string GRPC_ARG_KEEPALIVE_TIMEOUT_MS;
     
-    /** @brief 是否允许在没有活跃调用时发送保活包 */
+    /**
+     * @brief 是否允许在没有活跃调用时发送保活包
+     * @note 只在设置 LITEGRPC_ARG_IO_THREAD（litegrpc.io_thread=1）时生效：
+     *       否则事件循环由发起调用的线程驱动，没有调用时无人发送 PING，
+     *       空闲连接的检查推迟到下一次调用开始时
+     */
     static const std::string GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS;
     
     /** @brief HTTP/2 无数据时最大 ping 数量 */
@@ -232,6 +259,102 @@ public:
     /** @brief 连接生存时间宽限期（毫秒） */
     static const std::string GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS;
     
+    /** @brief 是否启用 BDP 探测自动调整接收窗口（0/1，默认 1） */
+    static const std::string GRPC_ARG_HTTP2_BDP_PROBE;
+    
+    /** @brief HTTP/2 流级初始接收窗口（字节） */
+    static const std::string GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES;
+    
+    /* ========================================================================
+     * LiteGRPC 扩展参数键常量 - 传输层调优
+     * ======================================================================== */
+    
+    /** @brief 多次系统调用的批量写入是否用 TCP_CORK 包裹（0/1，默认 0） */
+    static const std::string LITEGRPC_ARG_TCP_CORK;
+    
+    /** @brief 明文连接上使用 MSG_ZEROCOPY 发送的最小字节数（默认 0，表示禁用） */
+    static const std::string LITEGRPC_ARG_ZEROCOPY_SEND_THRESHOLD;
+    
+    /** @brief HTTP/2 连接级接收窗口（字节） */
+    static const std::string LITEGRPC_ARG_HTTP2_CONNECTION_WINDOW_SIZE;
+    
+    /** @brief 每个连接的 HTTP/2 会话内存预算（字节，默认 0，表示不限；见 LiteGrpcChannel::GetSessionMemoryStats） */
+    static const std::string LITEGRPC_ARG_HTTP2_SESSION_MEMORY_LIMIT;
+    
+    /* ========================================================================
+     * LiteGRPC 扩展参数键常量 - 套接字选项
+     * ======================================================================== */
+    
+    /** @brief 套接字预设（字符串 "low-latency" 或 "bulk"），单项参数覆盖预设中的对应值 */
+    static const std::string LITEGRPC_ARG_SOCKET_PROFILE;
+    
+    /** @brief 是否设置 TCP_NODELAY（0/1，默认 1） */
+    static const std::string LITEGRPC_ARG_TCP_NODELAY;
+    
+    /** @brief SO_SNDBUF（字节，默认由内核自动调整） */
+    static const std::string LITEGRPC_ARG_SOCKET_SEND_BUFFER;
+    
+    /** @brief SO_RCVBUF（字节，默认由内核自动调整） */
+    static const std::string LITEGRPC_ARG_SOCKET_RECV_BUFFER;
+    
+    /** @brief TCP_USER_TIMEOUT（毫秒，默认使用内核设置） */
+    static const std::string LITEGRPC_ARG_TCP_USER_TIMEOUT_MS;
+    
+    /** @brief SO_BUSY_POLL（微秒，默认 0 表示禁用） */
+    static const std::string LITEGRPC_ARG_SOCKET_BUSY_POLL_US;
+    
+    /** @brief 每次读取后重新启用 TCP_QUICKACK（0/1，默认 0） */
+    static const std::string LITEGRPC_ARG_TCP_QUICKACK;
+    
+    /* ========================================================================
+     * LiteGRPC 扩展参数键常量 - I/O 后端
+     * ======================================================================== */
+    
+    /** @brief 使用 io_uring 驱动套接字读写（0/1，默认 0；构建或内核不支持时回退到 epoll） */
+    static const std::string LITEGRPC_ARG_IO_URING;
+    
+    /** @brief 每个连接由独占的 I/O 线程驱动，调用经无锁队列提交（0/1，默认 0） */
+    static const std::string LITEGRPC_ARG_IO_THREAD;
+    
+    /** @brief TLS 握手后把记录层交给内核 kTLS（0/1，默认 0；OpenSSL、内核或密码套件不支持时保持用户态） */
+    static const std::string LITEGRPC_ARG_KTLS;
+    
+    /* ========================================================================
+     * LiteGRPC 扩展参数键常量 - 共享内存传输
+     * ======================================================================== */
+    
+    /** @brief shm: 通道每个方向的环容量（字节，默认 4 MiB；调整为 64 KiB 到 1 GiB 之间的 2 的幂） */
+    static const std::string LITEGRPC_ARG_SHM_RING_SIZE;
+    
+    /* ========================================================================
+     * LiteGRPC 扩展参数键常量 - TLS 会话恢复
+     * ======================================================================== */
+    
+    /** @brief 重连时以缓存的会话恢复 TLS（0/1，默认 1） */
+    static const std::string LITEGRPC_ARG_TLS_SESSION_RESUMPTION;
+    
+    /** @brief TLS 会话的磁盘存储文件路径（字符串，默认不使用磁盘存储；文件以 0600 创建） */
+    static const std::string LITEGRPC_ARG_TLS_TICKET_STORE_PATH;
+    
+    /** @brief 磁盘存储的槽位数（每槽位 8 KiB，默认 64；已有文件沿用其槽位数） */
+    static const std::string LITEGRPC_ARG_TLS_TICKET_STORE_ENTRIES;
+    
+    /* ========================================================================
+     * LiteGRPC 扩展参数键常量 - DNS 解析
+     * ======================================================================== */
+    
+    /** @brief 直接查询的 DNS 服务器（字符串 "ip[:port]"，默认使用系统解析） */
+    static const std::string LITEGRPC_ARG_DNS_SERVER;
+    
+    /** @brief 只从该 hosts 格式文件解析主机名（字符串路径，优先于 DNS 服务器） */
+    static const std::string LITEGRPC_ARG_DNS_HOSTS_FILE;
+    
+    /** @brief 解析结果不带 TTL 时的缓存时间（毫秒，默认 30000） */
+    static const std::string LITEGRPC_ARG_DNS_DEFAULT_TTL_MS;
+    
+    /** @brief 解析失败结果的缓存时间（毫秒，默认 5000） */
+    static const std::string LITEGRPC_ARG_DNS_NEGATIVE_TTL_MS;
+    
 private:
     /* ========================================================================
      * 私有成员变量 - 参数存储
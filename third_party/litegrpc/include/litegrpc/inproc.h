@@ -0,0 +1,178 @@
+#ifndef LITEGRPC_INPROC_H
+#define LITEGRPC_INPROC_H
+
+/**
+ * @file inproc.h
+ * @brief LiteGRPC 进程内传输接口定义
+ * @details 定义了 inproc://name 通道与进程内处理函数的注册接口。
+ *          进程内通道把请求直接交给以同名注册的处理函数，不经过套接字、
+ *          内核与 HTTP/2 分帧，也不做 gRPC 消息分帧：
+ *          - 请求数据以引用方式交给处理函数，处理函数直接写入调用方的响应缓冲区，
+ *            整个调用不复制序列化后的数据
+ *          - 处理函数在调用线程上同步执行
+ *
+ *          用途：单元测试与 CI 中以本地替身代替独立的测试服务器、
+ *          同进程部署的服务之间的调用，以及在没有网络开销的情况下
+ *          剖析序列化与存根层的耗时。
+ *
+ * @author LinxOS Team
+ * @date 2024
+ * @version 1.0
+ *
+ * @example
+ * ```cpp
+ * litegrpc::RegisterInprocHandler("agent",
+ *     [](const std::string& method, litegrpc::ClientContext* context,
+ *        const std::string& request, std::string* response) {
+ *         *response = request;  // 回显
+ *         return litegrpc::Status::OK();
+ *     });
+ * auto channel = litegrpc::CreateChannel("inproc://agent",
+ *                                        litegrpc::InsecureChannelCredentials());
+ * ```
+ */
+
+#include <functional>   // std::function
+#include <memory>       // std::shared_ptr
+#include <string>       // std::string
+#include "litegrpc/channel.h"     // Channel 接口
+#include "litegrpc/status.h"      // 状态码和错误处理
+
+namespace litegrpc {
+
+// 前向声明
+struct InprocEndpoint;
+
+/**
+ * @brief 进程内处理函数
+ * @param method RPC 方法名（格式：/service/method）
+ * @param context 调用方的客户端上下文（元数据、截止时间），可能为 nullptr
+ * @param request_data 序列化后的请求数据，只在调用期间有效
+ * @param response_data 输出参数，调用方的响应缓冲区
+ * @return Status 调用结果，原样返回给调用方
+ *
+ * @note 多个线程的调用会并发执行同一个处理函数，处理函数必须线程安全
+ */
+using InprocHandler = std::function<Status(const std::string& method,
+                                           ClientContext* context,
+                                           const std::string& request_data,
+                                           std::string* response_data)>;
+
+/**
+ * @brief 注册进程内处理函数
+ * @param name 端点名，inproc://name 通道的调用交给该处理函数
+ * @param handler 处理函数
+ * @return Status 注册结果；同名端点已注册时返回 ALREADY_EXISTS，
+ *         名字为空或处理函数为空时返回 INVALID_ARGUMENT
+ */
+Status RegisterInprocHandler(const std::string& name, InprocHandler handler);
+
+/**
+ * @brief 注销进程内处理函数
+ * @param name 端点名
+ *
+ * @details 注销后新的调用返回 UNAVAILABLE；正在执行的调用继续完成，
+ *          处理函数在最后一个调用返回后才被释放。
+ */
+void UnregisterInprocHandler(const std::string& name);
+
+/**
+ * @class InprocChannel
+ * @brief 进程内通道
+ * @details 由 CreateChannel() / CreateCustomChannel() 为 inproc://name（或 inproc:name）
+ *          目标创建，凭证与通道参数不影响其行为。
+ *          端点注册后即视为已连接；注销后再次以同名注册时自动改用新的处理函数。
+ *
+ * @note 线程安全：多个线程可以并发调用 ExecuteRequest()
+ */
+class InprocChannel : public Channel {
+public:
+    /**
+     * @brief 判断目标地址是否为进程内目标
+     * @param target 目标地址
+     * @return true 如果以 inproc: 开头
+     */
+    static bool IsInprocTarget(const std::string& target);
+
+    /**
+     * @brief 构造函数
+     * @param target 目标地址（格式：inproc://name 或 inproc:name）
+     * @param credentials 通道安全凭据（不使用）
+     * @param args 通道配置参数（不使用）
+     */
+    InprocChannel(const std::string& target,
+                  std::shared_ptr<ChannelCredentials> credentials,
+                  const ChannelArguments& args);
+
+    /**
+     * @brief 析构函数
+     */
+    ~InprocChannel() override;
+
+    /* ========================================================================
+     * Channel 接口实现
+     * ======================================================================== */
+
+    /**
+     * @brief 检查端点是否已注册
+     */
+    bool IsConnected() const override;
+
+    /**
+     * @brief 查找端点
+     * @return Status 端点未注册时返回 UNAVAILABLE
+     */
+    Status Connect() override;
+
+    /**
+     * @brief 释放对端点的引用
+     */
+    void Disconnect() override;
+
+    /**
+     * @brief 等待端点注册
+     * @param deadline 等待截止时间
+     * @return true 如果在截止时间前端点已注册
+     */
+    bool WaitForConnected(std::chrono::system_clock::time_point deadline) override;
+
+    /**
+     * @brief 在调用线程上执行处理函数
+     * @param method RPC 方法名
+     * @param context 客户端上下文
+     * @param request_data 请求数据，以引用方式交给处理函数
+     * @param response_data 响应数据输出，由处理函数直接写入
+     * @return Status 处理函数的结果；端点未注册时返回 UNAVAILABLE，
+     *         调用前或处理函数返回时已超过截止时间返回 DEADLINE_EXCEEDED
+     */
+    Status ExecuteRequest(
+        const std::string& method,
+        ClientContext* context,
+        const std::string& request_data,
+        std::string* response_data) override;
+
+    /* ========================================================================
+     * 通道信息查询方法
+     * ======================================================================== */
+
+    std::string GetTarget() const override { return target_; }
+    std::shared_ptr<ChannelCredentials> GetCredentials() const override { return credentials_; }
+    const ChannelArguments& GetArguments() const override { return args_; }
+
+private:
+    /**
+     * @brief 取得仍处于注册状态的端点，必要时重新查找
+     * @return 端点，未注册时为空
+     */
+    std::shared_ptr<InprocEndpoint> GetEndpoint() const;
+
+    std::string target_;                            ///< 目标地址
+    std::string name_;                              ///< 端点名
+    std::shared_ptr<ChannelCredentials> credentials_;  ///< 通道凭证
+    ChannelArguments args_;                         ///< 通道参数
+    mutable std::shared_ptr<InprocEndpoint> endpoint_;  ///< 缓存的端点（以 atomic_load/atomic_store 访问）
+};
+
+} // namespace litegrpc
+
+#endif // LITEGRPC_INPROC_H
@@ -36,6 +36,8 @@
 #include "litegrpc/client_context.h" // 客户端上下文
 #include "litegrpc/credentials.h"    // 安全凭证管理
 #include "litegrpc/stub.h"           // 服务存根接口
+#include "litegrpc/inproc.h"         // 进程内传输
+#include "litegrpc/shm.h"            // 共享内存传输
 
 /* ============================================================================
  * 标准 gRPC 兼容命名空间
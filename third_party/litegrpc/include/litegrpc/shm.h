@@ -0,0 +1,187 @@
+#ifndef LITEGRPC_SHM_H
+#define LITEGRPC_SHM_H
+
+/**
+ * @file shm.h
+ * @brief LiteGRPC 共享内存传输接口定义
+ * @details 定义了同机进程之间的 shm: 通道与服务端 ShmServer。
+ *          连接时客户端创建一段 memfd 共享内存，经 Unix 域套接字交给服务端，
+ *          此后请求与响应都经共享内存中的一对单生产者单消费者环传递：
+ *          - 不经过内核网络协议栈，也不做 HTTP/2 与 gRPC 消息分帧
+ *          - 大消息按偏移分片写入环，数据从调用方缓冲区直接写入共享内存，
+ *            对端直接从共享内存复制到目标缓冲区
+ *          - 等待对端时先短暂自旋，再以跨进程 futex 休眠，
+ *            对端未在等待时不发出唤醒系统调用
+ *
+ *          Unix 域套接字只用于握手与检测对端退出。
+ *
+ *          目标格式：shm:path、shm:///abs/path（文件系统路径）
+ *          或 shm:@name（Linux 抽象命名空间），客户端与服务端使用同一个目标。
+ *
+ * @author LinxOS Team
+ * @date 2024
+ * @version 1.0
+ *
+ * @example
+ * ```cpp
+ * // 媒体进程
+ * litegrpc::ShmServer server("shm:@media", [](const std::string& method,
+ *                                               litegrpc::ClientContext* context,
+ *                                               const std::string& request,
+ *                                               std::string* response) {
+ *     *response = CaptureFrame(request);
+ *     return litegrpc::Status::OK();
+ * });
+ * server.Start();
+ *
+ * // 代理进程
+ * auto channel = litegrpc::CreateChannel("shm:@media",
+ *                                        litegrpc::InsecureChannelCredentials());
+ * ```
+ */
+
+#include <memory>       // std::shared_ptr, std::unique_ptr
+#include <mutex>        // std::mutex
+#include <string>       // std::string
+#include "litegrpc/channel.h"     // Channel 接口
+#include "litegrpc/inproc.h"      // InprocHandler
+#include "litegrpc/status.h"      // 状态码和错误处理
+
+namespace litegrpc {
+
+// 前向声明
+struct ShmConnection;
+struct ShmServerState;
+
+/**
+ * @class ShmChannel
+ * @brief 共享内存通道
+ * @details 由 CreateChannel() / CreateCustomChannel() 为 shm: 目标创建。
+ *          每个通道持有一个连接（一段共享内存），多个线程的调用共用请求环
+ *          （写入时串行化），等待响应的线程之一负责读取响应环并分发。
+ *          对端退出后连接被关闭，下一次调用重新建立连接。
+ *
+ *          通道参数 LITEGRPC_ARG_SHM_RING_SIZE 设置每个方向的环容量，
+ *          凭证不影响其行为。
+ *
+ * @note 线程安全：多个线程可以并发调用 ExecuteRequest()
+ */
+class ShmChannel : public Channel {
+public:
+    /**
+     * @brief 判断目标地址是否为共享内存目标
+     * @param target 目标地址
+     * @return true 如果以 shm: 开头
+     */
+    static bool IsShmTarget(const std::string& target);
+
+    /**
+     * @brief 构造函数
+     * @param target 目标地址（格式：shm:path、shm:///abs/path 或 shm:@name）
+     * @param credentials 通道安全凭据（不使用）
+     * @param args 通道配置参数
+     */
+    ShmChannel(const std::string& target,
+               std::shared_ptr<ChannelCredentials> credentials,
+               const ChannelArguments& args);
+
+    /**
+     * @brief 析构函数
+     */
+    ~ShmChannel() override;
+
+    /* ========================================================================
+     * Channel 接口实现
+     * ======================================================================== */
+
+    bool IsConnected() const override;
+    Status Connect() override;
+    void Disconnect() override;
+    bool WaitForConnected(std::chrono::system_clock::time_point deadline) override;
+
+    /**
+     * @brief 经共享内存执行一次调用
+     * @param method RPC 方法名
+     * @param context 客户端上下文（元数据与截止时间传给服务端）
+     * @param request_data 请求数据
+     * @param response_data 响应数据输出
+     * @return Status 服务端处理函数的结果；对端断开返回 UNAVAILABLE，
+     *         超过截止时间返回 DEADLINE_EXCEEDED
+     */
+    Status ExecuteRequest(
+        const std::string& method,
+        ClientContext* context,
+        const std::string& request_data,
+        std::string* response_data) override;
+
+    /* ========================================================================
+     * 通道信息查询方法
+     * ======================================================================== */
+
+    std::string GetTarget() const override { return target_; }
+    std::shared_ptr<ChannelCredentials> GetCredentials() const override { return credentials_; }
+    const ChannelArguments& GetArguments() const override { return args_; }
+
+private:
+    /**
+     * @brief 建立连接：连接套接字、创建并交出共享段、等待服务端确认
+     * @param timeout_ms 超时时间（毫秒）
+     */
+    Status EstablishConnection(int timeout_ms);
+
+    std::string target_;                               ///< 目标地址
+    std::shared_ptr<ChannelCredentials> credentials_;  ///< 通道凭证
+    ChannelArguments args_;                            ///< 通道参数
+    uint64_t ring_capacity_;                           ///< 每个方向的环容量（字节）
+    std::mutex connect_mutex_;                         ///< 串行化建立连接
+    std::shared_ptr<ShmConnection> connection_;        ///< 当前连接（以 atomic_load/atomic_store 访问）
+};
+
+/**
+ * @class ShmServer
+ * @brief 共享内存传输的服务端
+ * @details 在 Unix 域套接字上接受 ShmChannel 的连接。每个连接由一个线程服务，
+ *          按到达顺序逐个调用处理函数，并把结果写回该连接的响应环。
+ *          处理函数的签名与进程内处理函数相同，context 中带有客户端的元数据与截止时间。
+ *
+ * @note 不同连接的调用会并发执行同一个处理函数，处理函数必须线程安全
+ * @note 请求消息超过 Config::DEFAULT_MAX_MESSAGE_SIZE 时不缓冲其数据，
+ *       直接返回 RESOURCE_EXHAUSTED，与 HTTP/2 传输的限制一致
+ */
+class ShmServer {
+public:
+    /**
+     * @brief 构造函数
+     * @param target 监听地址（格式与 ShmChannel 相同）
+     * @param handler 处理函数
+     */
+    ShmServer(const std::string& target, InprocHandler handler);
+
+    /**
+     * @brief 析构函数，停止服务
+     */
+    ~ShmServer();
+
+    ShmServer(const ShmServer&) = delete;
+    ShmServer& operator=(const ShmServer&) = delete;
+
+    /**
+     * @brief 开始监听并接受连接
+     * @return Status 启动状态；地址无效返回 INVALID_ARGUMENT，绑定失败返回 UNAVAILABLE
+     *
+     * @note 文件系统路径上已有的套接字文件会被替换
+     */
+    Status Start();
+
+    /**
+     * @brief 停止接受连接，关闭所有连接并等待服务线程退出
+     */
+    void Shutdown();
+
+private:
+    std::unique_ptr<ShmServerState> state_;  ///< 服务端状态
+};
+
+} // namespace litegrpc
+
+#endif // LITEGRPC_SHM_H
@@ -22,37 +22,286 @@
 
 #include "litegrpc/channel.h"
 #include "litegrpc/client_context.h"
+#include "litegrpc/inproc.h"
+#include "litegrpc/shm.h"
 #include "../http2/http2_client.h"
+#include "dns_resolver.h"
 #include <regex>
 #include <sstream>
 #include <thread>
+#include <mutex>
 #include <arpa/inet.h>
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 namespace litegrpc {
 
+/**
+ * @brief 栈上元数据名值对数组的容量，超过时改用堆内存
+ */
+static const size_t kInlineMetadataCount = 16;
+
+/**
+ * @brief 服务器未处理的请求（GOAWAY 之后的流）在新连接上透明重试的最大次数
+ */
+static const int kMaxTransparentRetries = 2;
+
+/**
+ * @brief 套接字预设名称
+ */
+static const char kSocketProfileLowLatency[] = "low-latency";
+static const char kSocketProfileBulk[] = "bulk";
+
+/**
+ * @brief 应用套接字预设
+ * @param profile 预设名称
+ * @param options 输出参数，被预设覆盖的传输层选项
+ * @return bool 预设名称是否有效
+ * 
+ * - low-latency：小消息往返时延优先。关闭 Nagle，每次读取后立即确认，
+ *   读取时忙轮询 50us，对端 10s 未确认即断开
+ * - bulk：大消息吞吐优先。固定 4MB 套接字缓冲区，批量写入用 TCP_CORK 包裹，
+ *   接收窗口从 1MB 起步
+ */
+static bool ApplySocketProfile(const std::string& profile, http2::TransportOptions* options) {
+    if (profile == kSocketProfileLowLatency) {
+        options->tcp_nodelay = true;
+        options->quickack = true;
+        options->busy_poll_us = 50;
+        options->user_timeout_ms = 10000;
+        return true;
+    }
+    if (profile == kSocketProfileBulk) {
+        options->tcp_nodelay = true;
+        options->send_buffer_size = 4 * 1024 * 1024;
+        options->recv_buffer_size = 4 * 1024 * 1024;
+        options->tcp_cork = true;
+        options->initial_window_size = 1024 * 1024;
+        options->connection_window_size = 1024 * 1024;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 根据通道参数构造传输层选项
+ * @param args 通道参数
+ * @param options 输出参数，传输层选项，未设置的参数保持默认值
+ * @return Status 参数无效（例如未知的套接字预设）时返回 INVALID_ARGUMENT
+ * 
+ * 先应用套接字预设，再由单项参数覆盖。
+ */
+static Status BuildTransportOptions(const ChannelArguments& args, http2::TransportOptions* options) {
+    *options = http2::TransportOptions();
+    std::string profile;
+    if (args.GetString(ChannelArguments::LITEGRPC_ARG_SOCKET_PROFILE, &profile) &&
+        !ApplySocketProfile(profile, options)) {
+        return Status::InvalidArgument("Unknown socket profile: " + profile);
+    }
+    
+    int value = 0;
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_TCP_CORK, &value)) {
+        options->tcp_cork = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_ZEROCOPY_SEND_THRESHOLD, &value) && value > 0) {
+        options->zerocopy_threshold = static_cast<size_t>(value);
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_KEEPALIVE_TIME_MS, &value) && value > 0 &&
+        value != std::numeric_limits<int>::max()) {
+        options->keepalive_time_ms = value;  // INT_MAX 与官方 gRPC 一样表示不启用
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_KEEPALIVE_TIMEOUT_MS, &value) && value > 0) {
+        options->keepalive_timeout_ms = value;
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, &value)) {
+        options->keepalive_permit_without_calls = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA, &value) && value >= 0) {
+        options->max_pings_without_data = value;
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_HTTP2_MIN_SENT_PING_INTERVAL_WITHOUT_DATA_MS, &value) &&
+        value >= 0) {
+        options->min_ping_interval_without_data_ms = value;
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_HTTP2_BDP_PROBE, &value)) {
+        options->bdp_probe = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES, &value) && value > 0) {
+        options->initial_window_size = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_HTTP2_CONNECTION_WINDOW_SIZE, &value) && value > 0) {
+        options->connection_window_size = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_HTTP2_SESSION_MEMORY_LIMIT, &value) && value > 0) {
+        options->session_memory_limit = static_cast<size_t>(value);
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_TCP_NODELAY, &value)) {
+        options->tcp_nodelay = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_SOCKET_SEND_BUFFER, &value) && value >= 0) {
+        options->send_buffer_size = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_SOCKET_RECV_BUFFER, &value) && value >= 0) {
+        options->recv_buffer_size = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_TCP_USER_TIMEOUT_MS, &value) && value >= 0) {
+        options->user_timeout_ms = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_SOCKET_BUSY_POLL_US, &value) && value >= 0) {
+        options->busy_poll_us = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_TCP_QUICKACK, &value)) {
+        options->quickack = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_IO_URING, &value)) {
+        options->io_uring = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_IO_THREAD, &value)) {
+        options->io_thread = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_KTLS, &value)) {
+        options->ktls = value != 0;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_TLS_SESSION_RESUMPTION, &value)) {
+        options->tls_session_resumption = value != 0;
+    }
+    std::string ticket_store_path;
+    if (options->tls_session_resumption &&
+        args.GetString(ChannelArguments::LITEGRPC_ARG_TLS_TICKET_STORE_PATH, &ticket_store_path) &&
+        !ticket_store_path.empty()) {
+        size_t entries = http2::TlsTicketStore::kDefaultSlotCount;
+        if (args.GetInt(ChannelArguments::LITEGRPC_ARG_TLS_TICKET_STORE_ENTRIES, &value) && value > 0) {
+            entries = static_cast<size_t>(value);
+        }
+        // 存储文件无法打开（目录不可写、只读文件系统、属主或权限不安全）时只使用进程内缓存
+        http2::TlsTicketStore::Open(ticket_store_path, entries, &options->tls_ticket_store);
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 根据通道参数构造 DNS 解析器配置
+ * @param args 通道参数
+ * @return ResolverOptions 解析器配置，未设置的参数保持默认值
+ */
+static ResolverOptions BuildResolverOptions(const ChannelArguments& args) {
+    ResolverOptions options;
+    args.GetString(ChannelArguments::LITEGRPC_ARG_DNS_HOSTS_FILE, &options.hosts_file);
+    args.GetString(ChannelArguments::LITEGRPC_ARG_DNS_SERVER, &options.nameserver);
+    int value = 0;
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_DNS_DEFAULT_TTL_MS, &value) && value >= 0) {
+        options.default_ttl_ms = value;
+    }
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_DNS_NEGATIVE_TTL_MS, &value) && value >= 0) {
+        options.negative_ttl_ms = value;
+    }
+    return options;
+}
+
 /**
  * @brief HTTP/2 连接封装结构
  * 
  * 封装了 HTTP/2 客户端连接的相关信息，包括客户端实例、
  * 主机地址、端口号和是否使用 SSL 等配置。
+ * 
+ * host、port、use_ssl 与 target_status 在通道构造时由目标地址解析得到，
+ * 此后不再修改：重连与 GOAWAY 迁移期间，其他调用线程无需加锁即可读取。
+ * 
+ * 服务器发送 GOAWAY 后，新请求改用新建的客户端实例；排空中的旧实例
+ * 由仍在进行的调用持有引用，最后一个调用完成时随之释放。
  */
 struct LiteGrpcChannel::Http2Connection {
-    std::unique_ptr<http2::Http2Client> client;  ///< HTTP/2 客户端实例
+    std::shared_ptr<http2::Http2Client> client;  ///< 当前接受新请求的 HTTP/2 客户端实例
+    mutable std::mutex client_mutex;              ///< 保护 client 指针的读取与替换
     std::string host;                             ///< 服务器主机地址
-    int port;                                     ///< 服务器端口号
-    bool use_ssl;                                 ///< 是否使用 SSL/TLS 加密
+    int port = 0;                                 ///< 服务器端口号
+    bool use_ssl = false;                         ///< 是否使用 SSL/TLS 加密
+    Status target_status;                         ///< 目标地址的解析结果
+    std::mutex connect_mutex;                     ///< 串行化并发的连接建立
+    std::shared_ptr<DnsResolver> resolver;        ///< 主机名解析器（与同配置的通道共享缓存）
+    
+    std::mutex header_mutex;                      ///< 保护 header_blocks
+    std::map<std::string, std::shared_ptr<const http2::HeaderBlock>>
+        header_blocks;                            ///< 方法路径 -> 预编译请求头部块
     
     /**
      * @brief 构造函数
      * 初始化 HTTP/2 客户端实例
      */
-    Http2Connection() : client(std::make_unique<http2::Http2Client>()) {}
+    Http2Connection() : client(std::make_shared<http2::Http2Client>()) {}
+    
+    /**
+     * @brief 获取当前接受新请求的客户端实例
+     * @return 客户端实例的引用，调用期间即使被替换也保持有效
+     */
+    std::shared_ptr<http2::Http2Client> GetClient() const {
+        std::lock_guard<std::mutex> lock(client_mutex);
+        return client;
+    }
+    
+    /**
+     * @brief 以已连接的新实例替换当前客户端实例
+     * @param replacement 新实例
+     */
+    void SetClient(std::shared_ptr<http2::Http2Client> replacement) {
+        std::lock_guard<std::mutex> lock(client_mutex);
+        client.swap(replacement);  // 旧实例在锁外随 replacement 析构
+    }
+    
+    /**
+     * @brief 默认的 :authority 值
+     * @return "host:port"；Unix 域套接字目标与官方 gRPC 一致使用 "localhost"
+     */
+    std::string DefaultAuthority() const {
+        if (http2::IsUnixSocketTarget(host)) {
+            return "localhost";
+        }
+        return host + ":" + std::to_string(port);
+    }
+    
+    /**
+     * @brief 构造请求头部块
+     * @param method RPC 方法路径
+     * @param authority :authority 伪头部的值
+     * @param user_agent user-agent 头部的值
+     * @return 新的头部块
+     */
+    std::shared_ptr<const http2::HeaderBlock> BuildHeaderBlock(
+        const std::string& method, const std::string& authority, const std::string& user_agent) const {
+        return std::make_shared<const http2::HeaderBlock>(std::vector<http2::HeaderBlock::Field>{
+            {":method", "POST"},
+            {":scheme", use_ssl ? "https" : "http"},
+            {":path", method},
+            {":authority", authority},
+            {"content-type", "application/grpc+proto"},  // gRPC 内容类型
+            {"te", "trailers"},                          // 支持 trailers
+            {"user-agent", user_agent},                  // 用户代理
+        });
+    }
+    
+    /**
+     * @brief 获取方法对应的预编译头部块
+     * @param method RPC 方法路径
+     * @return 头部块，首次调用该方法时构造并缓存
+     * 
+     * 通道的目标地址不变，同一方法每次调用的伪头部和 gRPC 固定头部都相同。
+     */
+    std::shared_ptr<const http2::HeaderBlock> GetHeaderBlock(const std::string& method) {
+        std::lock_guard<std::mutex> lock(header_mutex);
+        auto it = header_blocks.find(method);
+        if (it != header_blocks.end()) {
+            return it->second;
+        }
+        auto block = BuildHeaderBlock(method, DefaultAuthority(), Config::DEFAULT_USER_AGENT);
+        header_blocks.emplace(method, block);
+        return block;
+    }
 };
 
 /**
  * @brief LiteGrpcChannel 构造函数
- * @param target 目标服务器地址（格式：host:port 或 scheme://host:port）
+ * @param target 目标服务器地址（格式：host:port、scheme://host:port、unix:path 或 unix-abstract:name）
  * @param credentials 通道凭证（用于身份验证和加密）
  * @param args 通道参数配置
  * 
@@ -68,6 +317,8 @@ LiteGrpcChannel::LiteGrpcChannel(
     , args_(args)
     , connected_(false)
     , connection_(std::make_unique<Http2Connection>()) {
+    connection_->target_status = ParseTarget(target_, &connection_->host, &connection_->port,
+                                             &connection_->use_ssl);
 }
 
 /**
@@ -86,45 +337,108 @@ LiteGrpcChannel::~LiteGrpcChannel() {
  * 检查通道的连接状态，包括内部连接标志和底层 HTTP/2 客户端的连接状态。
  */
 bool LiteGrpcChannel::IsConnected() const {
-    return connected_ && connection_->client->IsConnected();
+    return connected_ && connection_->GetClient()->IsConnected();
 }
 
 /**
  * @brief 建立到服务器的连接
  * @return 连接状态，成功返回 Status::OK()
  * 
- * 解析目标地址并建立 HTTP/2 连接。如果已经连接，则直接返回成功。
- * 连接过程包括：
- * 1. 解析目标地址（主机、端口、SSL 配置）
- * 2. 配置连接参数
- * 3. 建立底层 HTTP/2 连接
+ * 以默认超时建立连接，详见 EstablishConnection()。
  */
 Status LiteGrpcChannel::Connect() {
+    return EstablishConnection(Config::DEFAULT_TIMEOUT_MS);
+}
+
+/**
+ * @brief 建立底层连接
+ * @param timeout_ms 连接超时时间（毫秒）
+ * @return 连接状态，成功返回 Status::OK()
+ * 
+ * 建立 HTTP/2 连接。如果已经连接，则直接返回成功。
+ * 连接过程包括：
+ * 1. 检查构造时解析目标地址（主机、端口、SSL 配置）的结果
+ * 2. 配置连接参数（包括由通道参数得到的传输层选项，以及 SSL 凭证
+ *    共享的 TLS 上下文）
+ * 3. 通过带缓存的 DNS 解析器得到候选地址；缓存中有结果（即使已过期）时
+ *    不会等待解析，重连时不会被 DNS 阻塞。Unix 域套接字目标直接构造地址
+ * 4. 建立底层 HTTP/2 连接，所有候选地址以 Happy Eyeballs 方式竞争，
+ *    整个过程（含解析）不超过 timeout_ms；当前连接正在排空时在新的客户端
+ *    实例上建立，成功后替换
+ */
+Status LiteGrpcChannel::EstablishConnection(int timeout_ms) {
     // 如果已经连接，直接返回成功
-    if (connected_) {
+    if (IsConnected()) {
         return Status::OK();
     }
     
-    std::string host;
-    int port;
-    bool use_ssl;
+    // 多个线程同时发现断线时只建立一次连接
+    std::lock_guard<std::mutex> lock(connection_->connect_mutex);
+    if (IsConnected()) {
+        return Status::OK();
+    }
     
-    // 解析目标地址
-    auto status = ParseTarget(target_, &host, &port, &use_ssl);
+    // 目标地址在构造时解析，之后只读
+    auto status = connection_->target_status;
     if (!status.ok()) {
         return status;
     }
+    const std::string& host = connection_->host;
+    const int port = connection_->port;
+    const bool use_ssl = connection_->use_ssl;
     
     // 配置连接参数
-    connection_->host = host;
-    connection_->port = port;
-    connection_->use_ssl = use_ssl;
+    http2::TransportOptions options;
+    status = BuildTransportOptions(args_, &options);
+    if (!status.ok()) {
+        return status;
+    }
+    
+    // SSL 凭证的 TLS 上下文只构建一次，所有连接与重连共享
+    if (use_ssl) {
+        auto* ssl_credentials = dynamic_cast<const SslChannelCredentialsImpl*>(credentials_.get());
+        if (ssl_credentials) {
+            status = ssl_credentials->GetTlsContext(&options.tls_context);
+            if (!status.ok()) {
+                return status;
+            }
+        }
+    }
+    
+    // 解析主机名
+    const auto start = std::chrono::steady_clock::now();
+    if (!connection_->resolver) {
+        connection_->resolver = DnsResolver::Get(BuildResolverOptions(args_));
+    }
+    std::vector<http2::ResolvedAddress> addresses;
+    if (http2::IsUnixSocketTarget(host)) {
+        status = http2::ResolveHost(host, port, &addresses);  // 直接构造 AF_UNIX 地址
+    } else {
+        status = connection_->resolver->Resolve(host, port, timeout_ms, &addresses);
+    }
+    if (!status.ok()) {
+        return status;
+    }
+    if (timeout_ms >= 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        timeout_ms = static_cast<int>(std::max<int64_t>(timeout_ms - elapsed, 0));
+    }
     
-    // 建立 HTTP/2 连接
-    status = connection_->client->Connect(host, port, use_ssl);
+    // 建立 HTTP/2 连接。当前连接正在排空（收到 GOAWAY）时在新实例上建立，
+    // 连接成功后才替换，旧连接上的调用继续完成，新调用不会看到未连接的实例
+    auto client = connection_->GetClient();
+    const bool migrate = client->IsDraining();
+    if (migrate) {
+        client = std::make_shared<http2::Http2Client>();
+    }
+    status = client->Connect(host, port, addresses, use_ssl, options, timeout_ms);
     if (!status.ok()) {
         return status;
     }
+    if (migrate) {
+        connection_->SetClient(std::move(client));
+    }
     
     connected_ = true;
     return Status::OK();
@@ -137,12 +451,74 @@ Status LiteGrpcChannel::Connect() {
  * 此方法是幂等的，可以安全地多次调用。
  */
 void LiteGrpcChannel::Disconnect() {
-    if (connection_->client) {
-        connection_->client->Disconnect();
+    auto client = connection_->GetClient();
+    if (client) {
+        client->Disconnect();
     }
     connected_ = false;
 }
 
+/**
+ * @brief 获取当前连接上套接字选项的实际生效值
+ * @return 选项名到生效值的映射，未连接时为空
+ */
+std::map<std::string, int> LiteGrpcChannel::GetSocketOptions() const {
+    std::map<std::string, int> result;
+    if (!IsConnected()) {
+        return result;
+    }
+    const http2::TransportStats stats = connection_->GetClient()->GetTransportStats();
+    const http2::SocketSettings& socket = stats.socket;
+    result["tcp_nodelay"] = socket.tcp_nodelay ? 1 : 0;
+    result["so_sndbuf"] = socket.send_buffer_size;
+    result["so_rcvbuf"] = socket.recv_buffer_size;
+    result["tcp_user_timeout_ms"] = socket.user_timeout_ms;
+    result["so_busy_poll_us"] = socket.busy_poll_us;
+    result["tcp_quickack"] = socket.quickack ? 1 : 0;
+    result["ktls_send"] = stats.ktls_send ? 1 : 0;
+    result["ktls_recv"] = stats.ktls_recv ? 1 : 0;
+    result["tls_resumed"] = stats.tls_resumed ? 1 : 0;
+    result["io_thread"] = stats.io_thread ? 1 : 0;
+    return result;
+}
+
+/**
+ * @brief 获取当前连接上保活 PING 测得的往返时延
+ * @return 统计项名到值的映射，未连接时为空
+ */
+std::map<std::string, int64_t> LiteGrpcChannel::GetRttStats() const {
+    std::map<std::string, int64_t> result;
+    if (!IsConnected()) {
+        return result;
+    }
+    const http2::TransportStats stats = connection_->GetClient()->GetTransportStats();
+    result["keepalive_pings"] = static_cast<int64_t>(stats.keepalive_pings);
+    result["rtt_samples"] = static_cast<int64_t>(stats.rtt_samples);
+    result["last_rtt_us"] = stats.last_rtt_us;
+    result["min_rtt_us"] = stats.min_rtt_us;
+    result["smoothed_rtt_us"] = stats.smoothed_rtt_us;
+    return result;
+}
+
+/**
+ * @brief 获取当前连接上 HTTP/2 会话的内存使用情况
+ * @return 统计项名到值的映射，未连接时为空
+ */
+std::map<std::string, int64_t> LiteGrpcChannel::GetSessionMemoryStats() const {
+    std::map<std::string, int64_t> result;
+    if (!IsConnected()) {
+        return result;
+    }
+    const http2::TransportStats stats = connection_->GetClient()->GetTransportStats();
+    result["in_use_bytes"] = static_cast<int64_t>(stats.session_memory_in_use);
+    result["reserved_bytes"] = static_cast<int64_t>(stats.session_memory_reserved);
+    result["peak_reserved_bytes"] = static_cast<int64_t>(stats.session_memory_peak);
+    result["allocations"] = static_cast<int64_t>(stats.session_allocations);
+    result["system_allocations"] = static_cast<int64_t>(stats.session_system_allocations);
+    result["allocation_failures"] = static_cast<int64_t>(stats.session_allocation_failures);
+    return result;
+}
+
 /**
  * @brief 等待连接建立（带超时）
  * @param deadline 等待截止时间
@@ -157,8 +533,14 @@ bool LiteGrpcChannel::WaitForConnected(std::chrono::system_clock::time_point dea
         return true;
     }
     
-    // 如果未连接，尝试建立连接
-    auto status = Connect();
+    // 如果未连接，尝试在截止时间内建立连接
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::system_clock::now()).count();
+    if (remaining <= 0) {
+        return false;
+    }
+    auto status = EstablishConnection(static_cast<int>(
+        std::min<int64_t>(remaining, std::numeric_limits<int>::max())));
     if (!status.ok()) {
         return false;
     }
@@ -187,7 +569,7 @@ bool LiteGrpcChannel::WaitForConnected(std::chrono::system_clock::time_point dea
  * 2. 检查超时设置
  * 3. 准备 HTTP/2 头部
  * 4. 格式化 gRPC 消息
- * 5. 发送请求并接收响应
+ * 5. 发送请求并接收响应（服务器未处理的请求在新连接上透明重试）
  * 6. 解析响应和状态码
  */
 Status LiteGrpcChannel::ExecuteRequest(
@@ -196,46 +578,68 @@ Status LiteGrpcChannel::ExecuteRequest(
     const std::string& request_data,
     std::string* response_data) {
     
-    // 确保连接已建立
+    // 检查请求是否已超时
+    if (context && context->IsExpired()) {
+        return Status::DeadlineExceeded("Request deadline exceeded");
+    }
+    
+    // 确保连接已建立，建连时间计入本次调用的截止时间
     if (!IsConnected()) {
-        auto status = Connect();
+        int connect_timeout_ms = (context && context->has_deadline())
+            ? context->GetTimeoutMs() : Config::DEFAULT_TIMEOUT_MS;
+        auto status = EstablishConnection(connect_timeout_ms);
         if (!status.ok()) {
             return status;
         }
     }
     
-    // 检查请求是否已超时
-    if (context && context->IsExpired()) {
-        return Status::DeadlineExceeded("Request deadline exceeded");
+    // 准备 HTTP/2 头部：伪头部与 gRPC 固定头部来自按方法缓存的头部块，
+    // 覆盖 :authority 或 user-agent 的调用使用一次性的头部块
+    std::shared_ptr<const http2::HeaderBlock> headers;
+    if (context && (!context->authority().empty() || !context->user_agent_prefix().empty())) {
+        headers = connection_->BuildHeaderBlock(
+            method,
+            context->authority().empty()
+                ? connection_->DefaultAuthority()
+                : context->authority(),
+            context->user_agent_prefix().empty()
+                ? std::string(Config::DEFAULT_USER_AGENT)
+                : context->user_agent_prefix() + " " + Config::DEFAULT_USER_AGENT);
+    } else {
+        headers = connection_->GetHeaderBlock(method);
     }
     
-    // 准备 HTTP/2 头部
-    std::map<std::string, std::string> headers;
-    headers["content-type"] = "application/grpc+proto";  // gRPC 内容类型
-    headers["te"] = "trailers";                          // 支持 trailers
-    headers["user-agent"] = Config::DEFAULT_USER_AGENT;  // 用户代理
-    
-    // 设置 :authority 伪头部（gRPC 协议要求）
-    headers[":authority"] = connection_->host + ":" + std::to_string(connection_->port);
-    
-    // 添加自定义元数据
+    // 添加自定义元数据：不带 NO_COPY 标志，由 nghttp2 在提交时复制；
+    // 伪头部和与固定头部重名的元数据被忽略
+    nghttp2_nv inline_metadata[kInlineMetadataCount];
+    std::vector<nghttp2_nv> heap_metadata;
+    nghttp2_nv* metadata = inline_metadata;
+    size_t metadata_count = 0;
     if (context) {
-        // 添加用户定义的元数据
-        for (const auto& metadata : context->GetMetadata()) {
-            headers[metadata.first] = metadata.second;
+        const auto& entries = context->GetMetadata();
+        if (entries.size() > kInlineMetadataCount) {
+            heap_metadata.resize(entries.size());
+            metadata = heap_metadata.data();
         }
-        
-        // 设置权威头部（用于虚拟主机）
-        if (!context->authority().empty()) {
-            headers[":authority"] = context->authority();
-        }
-        
-        // 设置自定义用户代理前缀
-        if (!context->user_agent_prefix().empty()) {
-            headers["user-agent"] = context->user_agent_prefix() + " " + Config::DEFAULT_USER_AGENT;
+        for (const auto& entry : entries) {
+            if (entry.first.empty() || entry.first[0] == ':' || headers->Contains(entry.first)) {
+                continue;
+            }
+            metadata[metadata_count++] = nghttp2_nv{
+                reinterpret_cast<uint8_t*>(const_cast<char*>(entry.first.data())),
+                reinterpret_cast<uint8_t*>(const_cast<char*>(entry.second.data())),
+                entry.first.size(), entry.second.size(), NGHTTP2_NV_FLAG_NONE
+            };
         }
     }
     
+    // 检查请求消息大小
+    if (request_data.size() > static_cast<size_t>(Config::DEFAULT_MAX_MESSAGE_SIZE)) {
+        return Status::ResourceExhausted("Request message larger than max (" +
+                                         std::to_string(request_data.size()) + " vs. " +
+                                         std::to_string(Config::DEFAULT_MAX_MESSAGE_SIZE) + ")");
+    }
+    
     // 准备 gRPC 消息格式
     std::string grpc_message;
     grpc_message.resize(5 + request_data.size());
@@ -246,10 +650,36 @@ Status LiteGrpcChannel::ExecuteRequest(
     memcpy(&grpc_message[1], &length, 4);
     memcpy(&grpc_message[5], request_data.data(), request_data.size());
     
-    // 发送 HTTP/2 请求
+    // 发送 HTTP/2 请求，等待时间受调用截止时间约束。
+    // 服务器确定未处理的请求（连接排空中、GOAWAY 之后的流、REFUSED_STREAM）
+    // 在新连接上透明重试，滚动发布时调用方不会看到失败
+    http2::StreamPriority priority;
+    if (context && context->has_priority()) {
+        priority.urgency = context->priority_urgency();
+        priority.incremental = context->priority_incremental();
+        priority.signal = true;
+    }
     http2::Http2Response response;
-    auto status = connection_->client->SendRequest(
-        "POST", method, headers, grpc_message, &response);
+    Status status;
+    for (int attempt = 0; ; ++attempt) {
+        int timeout_ms = (context && context->has_deadline())
+            ? context->GetTimeoutMs() : Config::DEFAULT_TIMEOUT_MS;
+        if (attempt > 0) {
+            if (context && context->IsExpired()) {
+                return Status::DeadlineExceeded("Request deadline exceeded");
+            }
+            status = EstablishConnection(timeout_ms);
+            if (!status.ok()) {
+                return status;
+            }
+            response = http2::Http2Response();
+        }
+        status = connection_->GetClient()->SendRequest(
+            headers, metadata, metadata_count, grpc_message, &response, timeout_ms, priority);
+        if (status.ok() || !response.refused || attempt >= kMaxTransparentRetries) {
+            break;
+        }
+    }
     
     if (!status.ok()) {
         return status;
@@ -260,32 +690,52 @@ Status LiteGrpcChannel::ExecuteRequest(
         return Status::Internal("HTTP error: " + std::to_string(response.status_code));
     }
     
-    // 解析 gRPC 响应
-    if (response.body.size() < 5) {
-        return Status::Internal("Invalid gRPC response format");
-    }
-    
-    // 跳过 gRPC 头部（5字节）并提取 protobuf 数据
-    *response_data = response.body.substr(5);
-    
-    // 检查 trailers 中的 gRPC 状态码
-    auto grpc_status_it = response.headers.find("grpc-status");
-    if (grpc_status_it != response.headers.end()) {
-        int grpc_status = std::stoi(grpc_status_it->second);
+    // 检查 trailers 中的 gRPC 状态码（只有 trailers 的错误响应没有消息体，需先于消息体检查）
+    const http2::ResponseMetadata& trailers = response.metadata;
+    if (trailers.has_grpc_status()) {
+        int grpc_status = trailers.grpc_status();
+        if (grpc_status < 0 || grpc_status > static_cast<int>(StatusCode::UNAUTHENTICATED)) {
+            grpc_status = static_cast<int>(StatusCode::UNKNOWN);  // 格式错误或未知的状态码
+        }
         if (grpc_status != 0) {
-            // 获取错误消息
-            auto grpc_message_it = response.headers.find("grpc-message");
-            std::string error_message = (grpc_message_it != response.headers.end()) 
-                ? grpc_message_it->second : "Unknown gRPC error";
+            // 获取错误消息（grpc-message 以百分号编码传输）
+            std::string error_message;
+            if (!trailers.GetGrpcMessage(&error_message)) {
+                error_message = "Unknown gRPC error";
+            }
             
             return Status(static_cast<StatusCode>(grpc_status), error_message);
         }
     }
     
+    // 取出 gRPC 响应消息：响应体必须在消息边界处结束，一元调用恰好包含一条消息
+    auto message_status = response.messages.Finish();
+    if (!message_status.ok()) {
+        return message_status;
+    }
+    if (response.messages.message_count() != 1) {
+        return Status::Internal(response.messages.message_count() == 0
+            ? "No response message received for unary call"
+            : "More than one response message received for unary call");
+    }
+    response.messages.PopMessage(response_data);
+    
     return Status::OK();
 }
 
 Status LiteGrpcChannel::ParseTarget(const std::string& target, std::string* host, int* port, bool* use_ssl) {
+    // Unix domain socket targets: unix:path, unix:///abs/path, unix-abstract:name.
+    // The whole target is kept as the host and resolved by the transport; h2c only.
+    if (http2::IsUnixSocketTarget(target)) {
+        if (credentials_->IsSecure()) {
+            return Status::InvalidArgument("Unix domain socket targets require insecure credentials: " + target);
+        }
+        *host = target;
+        *port = 0;
+        *use_ssl = false;
+        return Status::OK();
+    }
+    
     // Parse target format: [scheme://]host[:port]
     std::regex target_regex(R"(^(?:([^:]+)://)?([^:]+)(?::(\d+))?$)");
     std::smatch matches;
@@ -325,7 +775,7 @@ std::shared_ptr<Channel> CreateChannel(
     std::shared_ptr<ChannelCredentials> creds) {
     
     ChannelArguments args;
-    return std::make_shared<LiteGrpcChannel>(target, creds, args);
+    return CreateCustomChannel(target, creds, args);
 }
 
 std::shared_ptr<Channel> CreateCustomChannel(
@@ -333,6 +783,14 @@ std::shared_ptr<Channel> CreateCustomChannel(
     std::shared_ptr<ChannelCredentials> creds,
     const ChannelArguments& args) {
     
+    // 进程内目标不经过网络，直接交给注册的处理函数
+    if (InprocChannel::IsInprocTarget(target)) {
+        return std::make_shared<InprocChannel>(target, creds, args);
+    }
+    // 同机共享内存目标经 memfd 中的环形缓冲区传输
+    if (ShmChannel::IsShmTarget(target)) {
+        return std::make_shared<ShmChannel>(target, creds, args);
+    }
     return std::make_shared<LiteGrpcChannel>(target, creds, args);
 }
 
@@ -0,0 +1,611 @@
+/**
+ * @file dns_resolver.cpp
+ * @brief 异步 DNS 解析器实现
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "dns_resolver.h"
+#include <sys/socket.h>     // socket, send, recv
+#include <netinet/in.h>     // sockaddr_in, sockaddr_in6
+#include <arpa/inet.h>      // inet_pton
+#include <arpa/nameser.h>   // ns_initparse, ns_parserr
+#include <netdb.h>          // getaddrinfo
+#include <poll.h>           // poll
+#include <unistd.h>         // close
+#include <algorithm>        // std::min, std::max
+#include <cctype>           // std::tolower
+#include <cerrno>           // errno
+#include <cstdlib>          // atoi
+#include <cstring>          // memset, memcpy, strerror
+#include <fstream>          // hosts 文件读取
+#include <random>           // 查询 ID
+#include <sstream>          // hosts 文件行解析
+
+namespace litegrpc {
+
+namespace {
+
+/// 后台解析线程数上限
+const size_t kMaxWorkers = 2;
+
+/// 缓存条目数超过该值时清理过期条目
+const size_t kMaxCacheEntries = 1024;
+
+/// DNS 应答 TTL 的下限和上限（毫秒），避免 TTL 为 0 时反复查询
+const int kMinTtlMs = 1000;
+const int kMaxTtlMs = 3600 * 1000;
+
+/// 单次 DNS 查询的等待时间（毫秒）和发送次数
+const int kQueryTimeoutMs = 2000;
+const int kQueryAttempts = 2;
+
+/// DNS 服务器的默认端口
+const int kDnsPort = 53;
+
+/**
+ * @brief 进程内共享的解析器，按配置索引
+ */
+std::mutex g_registry_mutex;
+std::map<std::string, std::weak_ptr<DnsResolver>> g_registry;
+
+/**
+ * @brief 将 IP 地址字面量转换为地址
+ * @return bool host 是否为 IPv4/IPv6 地址字面量
+ */
+bool ParseIpLiteral(const std::string& host, int port, http2::ResolvedAddress* address) {
+    memset(&address->storage, 0, sizeof(address->storage));
+    auto* sin = reinterpret_cast<struct sockaddr_in*>(&address->storage);
+    if (inet_pton(AF_INET, host.c_str(), &sin->sin_addr) == 1) {
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(static_cast<uint16_t>(port));
+        address->length = sizeof(struct sockaddr_in);
+        return true;
+    }
+    auto* sin6 = reinterpret_cast<struct sockaddr_in6*>(&address->storage);
+    if (inet_pton(AF_INET6, host.c_str(), &sin6->sin6_addr) == 1) {
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = htons(static_cast<uint16_t>(port));
+        address->length = sizeof(struct sockaddr_in6);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 设置地址中的端口号
+ */
+void SetPort(http2::ResolvedAddress* address, int port) {
+    if (address->family() == AF_INET6) {
+        reinterpret_cast<struct sockaddr_in6*>(&address->storage)->sin6_port =
+            htons(static_cast<uint16_t>(port));
+    } else {
+        reinterpret_cast<struct sockaddr_in*>(&address->storage)->sin_port =
+            htons(static_cast<uint16_t>(port));
+    }
+}
+
+/**
+ * @brief 主机名转小写，DNS 名称不区分大小写
+ */
+std::string Lowercase(const std::string& host) {
+    std::string result = host;
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+/**
+ * @brief 解析 "ip[:port]" / "[ipv6]:port" 形式的 DNS 服务器地址
+ */
+bool ParseNameserver(const std::string& spec, http2::ResolvedAddress* address) {
+    std::string host = spec;
+    int port = kDnsPort;
+    if (!spec.empty() && spec[0] == '[') {
+        size_t end = spec.find(']');
+        if (end == std::string::npos) {
+            return false;
+        }
+        host = spec.substr(1, end - 1);
+        if (end + 1 < spec.size()) {
+            if (spec[end + 1] != ':') {
+                return false;
+            }
+            port = atoi(spec.c_str() + end + 2);
+        }
+    } else if (std::count(spec.begin(), spec.end(), ':') == 1) {
+        size_t colon = spec.find(':');
+        host = spec.substr(0, colon);
+        port = atoi(spec.c_str() + colon + 1);
+    }
+    if (port <= 0 || port > 65535) {
+        return false;
+    }
+    return ParseIpLiteral(host, port, address);
+}
+
+/**
+ * @brief 构造 DNS 查询报文（RFC 1035 第 4.1 节）
+ * @return bool 主机名是否合法
+ */
+bool BuildQuery(uint16_t id, const std::string& host, uint16_t qtype, std::vector<uint8_t>* query) {
+    query->clear();
+    const uint8_t header[12] = {
+        static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id & 0xff),
+        0x01, 0x00,  // RD = 1
+        0x00, 0x01,  // QDCOUNT = 1
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+    query->insert(query->end(), header, header + sizeof(header));
+
+    size_t start = 0;
+    while (start < host.size()) {
+        size_t dot = host.find('.', start);
+        if (dot == std::string::npos) {
+            dot = host.size();
+        }
+        const size_t label = dot - start;
+        if (label == 0 || label > 63) {
+            return false;
+        }
+        query->push_back(static_cast<uint8_t>(label));
+        query->insert(query->end(), host.begin() + start, host.begin() + dot);
+        start = dot + 1;
+    }
+    query->push_back(0);
+    if (query->size() - sizeof(header) > 255) {
+        return false;
+    }
+
+    query->push_back(static_cast<uint8_t>(qtype >> 8));
+    query->push_back(static_cast<uint8_t>(qtype & 0xff));
+    query->push_back(0x00);
+    query->push_back(0x01);  // QCLASS = IN
+    return true;
+}
+
+/**
+ * @brief 一个 DNS 查询（A 或 AAAA）的状态
+ */
+struct Query {
+    ns_type type;                                   ///< 查询类型
+    uint16_t id = 0;                                ///< 查询 ID
+    std::vector<uint8_t> packet;                    ///< 查询报文
+    bool answered = false;                          ///< 是否已收到应答
+    int rcode = 0;                                  ///< 应答码
+    std::vector<http2::ResolvedAddress> addresses;  ///< 应答中的地址
+    int ttl_ms = kMaxTtlMs;                         ///< 应答记录的最小 TTL
+};
+
+/**
+ * @brief 解析 DNS 应答并填入对应查询
+ * @return bool 报文是否是某个未完成查询的合法应答
+ */
+bool HandleResponse(const uint8_t* data, size_t len, std::vector<Query>* queries) {
+    ns_msg msg;
+    if (ns_initparse(data, static_cast<int>(len), &msg) < 0 || !ns_msg_getflag(msg, ns_f_qr)) {
+        return false;
+    }
+    auto it = std::find_if(queries->begin(), queries->end(), [&](const Query& q) {
+        return !q.answered && q.id == ns_msg_id(msg);
+    });
+    if (it == queries->end()) {
+        return false;
+    }
+
+    it->answered = true;
+    it->rcode = ns_msg_getflag(msg, ns_f_rcode);
+    for (int i = 0; i < ns_msg_count(msg, ns_s_an); ++i) {
+        ns_rr rr;
+        if (ns_parserr(&msg, ns_s_an, i, &rr) < 0) {
+            break;
+        }
+        // CNAME 链上每条记录的 TTL 都限制结果的有效期
+        it->ttl_ms = std::min<int64_t>(it->ttl_ms, static_cast<int64_t>(ns_rr_ttl(rr)) * 1000);
+        if (ns_rr_class(rr) != ns_c_in || ns_rr_type(rr) != it->type) {
+            continue;
+        }
+
+        http2::ResolvedAddress address;
+        memset(&address.storage, 0, sizeof(address.storage));
+        if (it->type == ns_t_a && ns_rr_rdlen(rr) == 4) {
+            auto* sin = reinterpret_cast<struct sockaddr_in*>(&address.storage);
+            sin->sin_family = AF_INET;
+            memcpy(&sin->sin_addr, ns_rr_rdata(rr), 4);
+            address.length = sizeof(struct sockaddr_in);
+        } else if (it->type == ns_t_aaaa && ns_rr_rdlen(rr) == 16) {
+            auto* sin6 = reinterpret_cast<struct sockaddr_in6*>(&address.storage);
+            sin6->sin6_family = AF_INET6;
+            memcpy(&sin6->sin6_addr, ns_rr_rdata(rr), 16);
+            address.length = sizeof(struct sockaddr_in6);
+        } else {
+            continue;
+        }
+        it->addresses.push_back(address);
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 配置的唯一标识
+ */
+std::string ResolverOptions::Key() const {
+    return hosts_file + "|" + nameserver + "|" + std::to_string(default_ttl_ms) + "|" +
+           std::to_string(negative_ttl_ms);
+}
+
+/**
+ * @brief 获取与配置对应的共享解析器
+ *
+ * 注册表只保存弱引用，所有通道释放后解析器随之销毁。
+ */
+std::shared_ptr<DnsResolver> DnsResolver::Get(const ResolverOptions& options) {
+    const std::string key = options.Key();
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    auto resolver = g_registry[key].lock();
+    if (!resolver) {
+        resolver = std::make_shared<DnsResolver>(options);
+        g_registry[key] = resolver;
+    }
+    return resolver;
+}
+
+DnsResolver::DnsResolver(const ResolverOptions& options)
+    : options_(options) {
+}
+
+/**
+ * @brief 析构函数
+ *
+ * 正在执行的解析（例如阻塞在 getaddrinfo 中）完成后线程才会退出。
+ */
+DnsResolver::~DnsResolver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    work_cv_.notify_all();
+    done_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief 解析主机名
+ *
+ * 步骤：
+ * 1. IP 地址字面量直接返回
+ * 2. 命中未过期的失败缓存时返回缓存的错误
+ * 3. 有成功结果时立即返回；已进入刷新区间（TTL 剩余不足 1/4）或
+ *    已过期时同时安排后台刷新
+ * 4. 没有可用结果时安排解析（同一主机只排队一次），等待完成或超时
+ */
+Status DnsResolver::Resolve(const std::string& host, int port, int timeout_ms,
+                            std::vector<http2::ResolvedAddress>* addresses) {
+    addresses->clear();
+    http2::ResolvedAddress literal;
+    if (ParseIpLiteral(host, port, &literal)) {
+        addresses->push_back(literal);
+        return Status::OK();
+    }
+
+    const std::string key = Lowercase(host);
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    Evict();
+    Entry* entry = &cache_[key];
+    const auto now = Clock::now();
+
+    if (entry->valid && !entry->error.ok() && now < entry->expires) {
+        stats_.negative_hits++;
+        return entry->error;
+    }
+
+    if (!entry->valid || !entry->error.ok()) {
+        stats_.misses++;
+        if (!entry->pending) {
+            Schedule(key, entry);
+        }
+
+        auto ready = [&]() {
+            auto it = cache_.find(key);
+            return shutdown_ || it == cache_.end() || !it->second.pending;
+        };
+        if (timeout_ms < 0) {
+            done_cv_.wait(lock, ready);
+        } else if (!done_cv_.wait_until(lock, deadline, ready)) {
+            return Status::DeadlineExceeded("DNS resolution of " + host + " timed out");
+        }
+
+        auto it = cache_.find(key);
+        if (it == cache_.end() || !it->second.valid) {
+            return Status::Unavailable("DNS resolution of " + host + " was cancelled");
+        }
+        entry = &it->second;
+        if (!entry->error.ok()) {
+            return entry->error;
+        }
+    } else {
+        if (now >= entry->expires) {
+            stats_.stale_hits++;
+        } else {
+            stats_.hits++;
+        }
+        if (now >= entry->refresh_at && !entry->pending) {
+            Schedule(key, entry);
+        }
+    }
+
+    *addresses = entry->addresses;
+    for (auto& address : *addresses) {
+        SetPort(&address, port);
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 获取缓存统计信息
+ */
+DnsResolver::Stats DnsResolver::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+/**
+ * @brief 将主机名加入解析队列
+ *
+ * 没有空闲线程且线程数未达上限时启动新线程。
+ */
+void DnsResolver::Schedule(const std::string& host, Entry* entry) {
+    entry->pending = true;
+    queue_.push_back(host);
+    if (idle_workers_ == 0 && workers_.size() < kMaxWorkers) {
+        workers_.emplace_back(&DnsResolver::WorkerLoop, this);
+    } else {
+        work_cv_.notify_one();
+    }
+}
+
+/**
+ * @brief 后台线程主循环
+ *
+ * 解析在不持有锁的情况下执行。刷新失败时保留原有的成功结果，
+ * 在 negative_ttl_ms 后再次尝试，避免 DNS 服务器短暂故障导致无法连接。
+ */
+void DnsResolver::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        idle_workers_++;
+        work_cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+        idle_workers_--;
+        if (shutdown_) {
+            return;
+        }
+
+        const std::string host = queue_.front();
+        queue_.pop_front();
+        if (cache_[host].valid) {
+            stats_.refreshes++;
+        }
+        stats_.lookups++;
+
+        lock.unlock();
+        std::vector<http2::ResolvedAddress> addresses;
+        int ttl_ms = options_.default_ttl_ms;
+        Status status = Lookup(host, &addresses, &ttl_ms);
+        lock.lock();
+
+        Entry& entry = cache_[host];
+        const auto now = Clock::now();
+        entry.pending = false;
+        if (status.ok()) {
+            ttl_ms = std::max(kMinTtlMs, std::min(kMaxTtlMs, ttl_ms));
+            entry.addresses = std::move(addresses);
+            entry.error = Status::OK();
+            entry.refresh_at = now + std::chrono::milliseconds(ttl_ms - ttl_ms / 4);
+            entry.expires = now + std::chrono::milliseconds(ttl_ms);
+        } else if (entry.valid && entry.error.ok()) {
+            entry.refresh_at = now + std::chrono::milliseconds(options_.negative_ttl_ms);
+        } else {
+            entry.addresses.clear();
+            entry.error = status;
+            entry.expires = now + std::chrono::milliseconds(options_.negative_ttl_ms);
+        }
+        entry.valid = true;
+        done_cv_.notify_all();
+    }
+}
+
+/**
+ * @brief 按配置的后端执行一次解析
+ */
+Status DnsResolver::Lookup(const std::string& host, std::vector<http2::ResolvedAddress>* addresses,
+                           int* ttl_ms) const {
+    if (!options_.hosts_file.empty()) {
+        return LookupHostsFile(host, addresses);
+    }
+    if (!options_.nameserver.empty()) {
+        return LookupNameserver(host, addresses, ttl_ms);
+    }
+    return LookupSystem(host, addresses);
+}
+
+/**
+ * @brief 使用 getaddrinfo 解析
+ */
+Status DnsResolver::LookupSystem(const std::string& host,
+                                 std::vector<http2::ResolvedAddress>* addresses) const {
+    return http2::ResolveHost(host, 0, addresses);
+}
+
+/**
+ * @brief 直接向 DNS 服务器查询 AAAA 和 A 记录
+ *
+ * 步骤：
+ * 1. 在同一个 UDP 套接字上同时发出 AAAA 和 A 查询
+ * 2. 等待两个应答，超时后重发未应答的查询
+ * 3. AAAA 结果在前（RFC 8305 首选 IPv6），TTL 取所有应答记录的最小值
+ *
+ * 不使用 EDNS，截断的应答直接使用其中已有的记录。
+ */
+Status DnsResolver::LookupNameserver(const std::string& host,
+                                     std::vector<http2::ResolvedAddress>* addresses,
+                                     int* ttl_ms) const {
+    http2::ResolvedAddress server;
+    if (!ParseNameserver(options_.nameserver, &server)) {
+        return Status::InvalidArgument("Invalid DNS server address: " + options_.nameserver);
+    }
+
+    std::string name = host;
+    if (!name.empty() && name.back() == '.') {
+        name.pop_back();
+    }
+
+    std::random_device random;
+    std::vector<Query> queries(2);
+    queries[0].type = ns_t_aaaa;
+    queries[1].type = ns_t_a;
+    for (auto& query : queries) {
+        query.id = static_cast<uint16_t>(random());
+        if (!BuildQuery(query.id, name, query.type, &query.packet)) {
+            return Status::InvalidArgument("Invalid host name: " + host);
+        }
+    }
+    queries[1].id ^= (queries[0].id == queries[1].id) ? 1 : 0;
+
+    int fd = socket(server.family(), SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return Status::Unavailable("Failed to create DNS socket: " + std::string(strerror(errno)));
+    }
+    if (connect(fd, reinterpret_cast<const struct sockaddr*>(&server.storage), server.length) < 0) {
+        int err = errno;
+        close(fd);
+        return Status::Unavailable("Failed to connect to DNS server " + server.ToString() + ": " +
+                                   std::string(strerror(err)));
+    }
+
+    auto all_answered = [&queries]() {
+        return std::all_of(queries.begin(), queries.end(), [](const Query& q) { return q.answered; });
+    };
+    for (int attempt = 0; attempt < kQueryAttempts && !all_answered(); ++attempt) {
+        for (const auto& query : queries) {
+            if (!query.answered) {
+                send(fd, query.packet.data(), query.packet.size(), 0);
+            }
+        }
+
+        const auto attempt_deadline = Clock::now() + std::chrono::milliseconds(kQueryTimeoutMs);
+        while (!all_answered()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                attempt_deadline - Clock::now()).count();
+            if (remaining <= 0) {
+                break;
+            }
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            int n = poll(&pfd, 1, static_cast<int>(remaining));
+            if (n <= 0) {
+                continue;  // EINTR 或本轮超时
+            }
+            uint8_t buffer[NS_PACKETSZ * 8];
+            ssize_t len = recv(fd, buffer, sizeof(buffer), 0);
+            if (len > 0) {
+                HandleResponse(buffer, static_cast<size_t>(len), &queries);
+            }
+            // ECONNREFUSED 等错误由下一轮 poll 超时兜底
+        }
+    }
+    close(fd);
+
+    addresses->clear();
+    *ttl_ms = kMaxTtlMs;
+    bool any_answer = false;
+    for (const auto& query : queries) {
+        if (!query.answered || (query.rcode != ns_r_noerror && query.rcode != ns_r_nxdomain)) {
+            continue;
+        }
+        any_answer = true;
+        if (!query.addresses.empty()) {
+            addresses->insert(addresses->end(), query.addresses.begin(), query.addresses.end());
+            *ttl_ms = std::min(*ttl_ms, query.ttl_ms);
+        }
+    }
+
+    if (!addresses->empty()) {
+        return Status::OK();
+    }
+    if (!any_answer) {
+        return Status::Unavailable("DNS server " + server.ToString() + " did not answer for " + host);
+    }
+    return Status::Unavailable("Failed to resolve host: " + host + " not found");
+}
+
+/**
+ * @brief 从 hosts 格式文件中查找主机名
+ *
+ * 每次解析都重新读取文件，修改文件后在缓存过期时即可生效。
+ * 格式与 /etc/hosts 相同：每行一个地址，后跟一个或多个名称，'#' 之后为注释。
+ */
+Status DnsResolver::LookupHostsFile(const std::string& host,
+                                    std::vector<http2::ResolvedAddress>* addresses) const {
+    std::ifstream file(options_.hosts_file);
+    if (!file) {
+        return Status::Unavailable("Failed to open hosts file: " + options_.hosts_file);
+    }
+
+    addresses->clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string ip;
+        std::string name;
+        if (!(fields >> ip)) {
+            continue;
+        }
+        while (fields >> name) {
+            if (Lowercase(name) != host) {
+                continue;
+            }
+            http2::ResolvedAddress address;
+            if (ParseIpLiteral(ip, 0, &address)) {
+                addresses->push_back(address);
+            }
+            break;
+        }
+    }
+
+    if (addresses->empty()) {
+        return Status::Unavailable("Failed to resolve host: " + host + " not found in " +
+                                   options_.hosts_file);
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 清理过期条目
+ *
+ * 只在缓存条目数超过 kMaxCacheEntries 时执行，正在解析的条目不会被清理。
+ */
+void DnsResolver::Evict() {
+    if (cache_.size() <= kMaxCacheEntries) {
+        return;
+    }
+    const auto now = Clock::now();
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        if (!it->second.pending && now >= it->second.expires) {
+            it = cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace litegrpc
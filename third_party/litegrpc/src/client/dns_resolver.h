@@ -0,0 +1,190 @@
+/**
+ * @file dns_resolver.h
+ * @brief 异步 DNS 解析器头文件
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ *
+ * 本文件定义了通道建立连接时使用的 DNS 解析器，主要特性：
+ * - 解析在后台线程执行，调用线程只在没有任何缓存结果时等待
+ * - 按 TTL 缓存解析结果，解析失败的结果按 negative_ttl_ms 缓存
+ * - 在 TTL 剩余不足四分之一时提前在后台刷新
+ * - 缓存过期但后台刷新尚未完成时，继续返回旧结果（serve-stale）
+ * - 多个线程同时解析同一主机时只发起一次查询
+ *
+ * 支持三种解析后端：
+ * - 系统解析（默认）：getaddrinfo，遵循 /etc/nsswitch.conf 和 /etc/hosts，
+ *   无法获得 TTL，使用 default_ttl_ms
+ * - 指定 DNS 服务器：直接向 "ip[:port]" 发送 A/AAAA 查询，使用应答中的 TTL，
+ *   可指向本地的替身解析器用于测试
+ * - hosts 文件：只查找指定格式与 /etc/hosts 相同的文件，适合测试和
+ *   没有 DNS 的嵌入式部署
+ */
+
+#ifndef LITEGRPC_CLIENT_DNS_RESOLVER_H
+#define LITEGRPC_CLIENT_DNS_RESOLVER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "litegrpc/status.h"
+#include "../http2/connector.h"  // ResolvedAddress
+
+namespace litegrpc {
+
+/**
+ * @brief DNS 解析器配置
+ */
+struct ResolverOptions {
+    std::string hosts_file;        ///< 非空时使用 hosts 文件模式
+    std::string nameserver;        ///< 非空时直接向该服务器查询（"ip[:port]"，IPv6 写作 "[ip]:port"）
+    int default_ttl_ms = 30000;    ///< 后端不提供 TTL 时使用的缓存时间（毫秒）
+    int negative_ttl_ms = 5000;    ///< 解析失败结果的缓存时间（毫秒）
+
+    /**
+     * @brief 配置的唯一标识，相同配置的通道共享同一个解析器实例
+     */
+    std::string Key() const;
+};
+
+/**
+ * @class DnsResolver
+ * @brief 带缓存的异步 DNS 解析器
+ *
+ * 通过 Get() 获取与配置对应的共享实例，同一进程内配置相同的通道
+ * 共享缓存，避免重连风暴时对同一主机名反复解析。
+ * 最后一个使用者释放后实例随之销毁，后台线程也会退出。
+ *
+ * 线程安全性：所有公有方法均可从多个线程并发调用。
+ */
+class DnsResolver {
+public:
+    /**
+     * @brief 缓存统计信息
+     */
+    struct Stats {
+        uint64_t hits = 0;           ///< 命中未过期缓存的次数
+        uint64_t stale_hits = 0;     ///< 返回已过期结果（同时后台刷新）的次数
+        uint64_t negative_hits = 0;  ///< 命中失败缓存的次数
+        uint64_t misses = 0;         ///< 需要等待解析的次数
+        uint64_t lookups = 0;        ///< 后台实际执行的解析次数
+        uint64_t refreshes = 0;      ///< 其中提前刷新或过期刷新的次数
+    };
+
+    /**
+     * @brief 获取与配置对应的共享解析器
+     * @param options 解析器配置
+     * @return std::shared_ptr<DnsResolver> 解析器实例
+     */
+    static std::shared_ptr<DnsResolver> Get(const ResolverOptions& options);
+
+    /**
+     * @brief 构造函数
+     * @param options 解析器配置
+     *
+     * 不会立即创建后台线程，首次需要解析时才启动。
+     */
+    explicit DnsResolver(const ResolverOptions& options);
+
+    /**
+     * @brief 析构函数，通知并等待后台线程退出
+     */
+    ~DnsResolver();
+
+    DnsResolver(const DnsResolver&) = delete;
+    DnsResolver& operator=(const DnsResolver&) = delete;
+
+    /**
+     * @brief 解析主机名
+     * @param host 主机名或 IP 地址字面量
+     * @param port 端口号，写入返回的每个地址
+     * @param timeout_ms 没有缓存结果时的最长等待时间（毫秒），-1 表示不限时
+     * @param addresses 输出参数，解析得到的地址列表
+     * @return Status 解析状态；等待超时返回 DEADLINE_EXCEEDED，
+     *         解析失败（含失败缓存）返回 UNAVAILABLE
+     *
+     * IP 地址字面量直接返回，不经过缓存。
+     */
+    Status Resolve(const std::string& host, int port, int timeout_ms,
+                   std::vector<http2::ResolvedAddress>* addresses);
+
+    /**
+     * @brief 获取缓存统计信息
+     * @return Stats 统计信息快照
+     */
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 缓存条目
+     */
+    struct Entry {
+        std::vector<http2::ResolvedAddress> addresses;  ///< 解析结果（端口为 0）
+        Status error;                  ///< 解析失败时的错误
+        bool valid = false;            ///< 是否已有解析结果（成功或失败）
+        bool pending = false;          ///< 是否已在解析队列中或正在解析
+        Clock::time_point refresh_at;  ///< 到达后触发后台提前刷新
+        Clock::time_point expires;     ///< 过期时间
+    };
+
+    /**
+     * @brief 将主机名加入解析队列，必要时启动后台线程
+     * @param host 主机名
+     * @param entry 对应的缓存条目
+     *
+     * 调用方必须持有 mutex_。
+     */
+    void Schedule(const std::string& host, Entry* entry);
+
+    /**
+     * @brief 后台线程主循环
+     */
+    void WorkerLoop();
+
+    /**
+     * @brief 按配置的后端执行一次解析
+     * @param host 主机名
+     * @param addresses 输出参数，解析结果
+     * @param ttl_ms 输出参数，结果的有效期（毫秒）
+     * @return Status 解析状态
+     */
+    Status Lookup(const std::string& host, std::vector<http2::ResolvedAddress>* addresses,
+                  int* ttl_ms) const;
+
+    Status LookupSystem(const std::string& host, std::vector<http2::ResolvedAddress>* addresses) const;
+    Status LookupNameserver(const std::string& host, std::vector<http2::ResolvedAddress>* addresses,
+                            int* ttl_ms) const;
+    Status LookupHostsFile(const std::string& host, std::vector<http2::ResolvedAddress>* addresses) const;
+
+    /**
+     * @brief 清理过期且不在解析中的条目，限制缓存大小
+     *
+     * 调用方必须持有 mutex_。
+     */
+    void Evict();
+
+    const ResolverOptions options_;              ///< 解析器配置
+
+    mutable std::mutex mutex_;                   ///< 保护以下所有字段
+    std::condition_variable work_cv_;            ///< 通知后台线程有新任务
+    std::condition_variable done_cv_;            ///< 通知等待线程解析完成
+    std::map<std::string, Entry> cache_;         ///< 主机名 -> 缓存条目
+    std::deque<std::string> queue_;              ///< 待解析的主机名
+    std::vector<std::thread> workers_;           ///< 后台解析线程
+    size_t idle_workers_ = 0;                    ///< 空闲的后台线程数
+    bool shutdown_ = false;                      ///< 是否正在销毁
+    Stats stats_;                                ///< 统计信息
+};
+
+} // namespace litegrpc
+
+#endif // LITEGRPC_CLIENT_DNS_RESOLVER_H
@@ -0,0 +1,193 @@
+/**
+ * @file inproc_channel.cpp
+ * @brief LiteGRPC 进程内通道实现
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ *
+ * 本文件实现了进程内处理函数的注册表与 inproc:// 通道：
+ * - 注册表按端点名保存处理函数，注册与注销以互斥锁保护
+ * - 通道缓存查找到的端点，每次调用只做一次原子读取，不获取注册表的锁
+ * - 端点注销时只清除其有效标志，正在执行的调用持有端点的引用，
+ *   处理函数在最后一个调用返回后才被释放
+ */
+
+#include "litegrpc/inproc.h"
+#include "litegrpc/client_context.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace litegrpc {
+
+/**
+ * @brief 已注册的端点
+ */
+struct InprocEndpoint {
+    InprocHandler handler;            ///< 处理函数
+    std::atomic<bool> active{true};   ///< 是否仍处于注册状态
+};
+
+namespace {
+
+const char kInprocPrefix[] = "inproc:";  ///< 进程内目标的前缀
+
+/**
+ * @brief 进程内端点注册表
+ */
+std::mutex g_endpoints_mutex;
+std::map<std::string, std::shared_ptr<InprocEndpoint>> g_endpoints;
+
+/**
+ * @brief 由目标地址得到端点名（去掉 inproc: 与可选的 //）
+ */
+std::string EndpointName(const std::string& target) {
+    std::string name = target.substr(sizeof(kInprocPrefix) - 1);
+    if (name.compare(0, 2, "//") == 0) {
+        name = name.substr(2);
+    }
+    return name;
+}
+
+} // namespace
+
+/**
+ * @brief 注册进程内处理函数
+ */
+Status RegisterInprocHandler(const std::string& name, InprocHandler handler) {
+    if (name.empty() || !handler) {
+        return Status::InvalidArgument("Inproc endpoint requires a name and a handler");
+    }
+    auto endpoint = std::make_shared<InprocEndpoint>();
+    endpoint->handler = std::move(handler);
+
+    std::lock_guard<std::mutex> lock(g_endpoints_mutex);
+    auto& slot = g_endpoints[name];
+    if (slot) {
+        return Status::AlreadyExists("Inproc endpoint already registered: " + name);
+    }
+    slot = std::move(endpoint);
+    return Status::OK();
+}
+
+/**
+ * @brief 注销进程内处理函数
+ */
+void UnregisterInprocHandler(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_endpoints_mutex);
+    auto it = g_endpoints.find(name);
+    if (it != g_endpoints.end()) {
+        it->second->active = false;
+        g_endpoints.erase(it);
+    }
+}
+
+bool InprocChannel::IsInprocTarget(const std::string& target) {
+    return target.compare(0, sizeof(kInprocPrefix) - 1, kInprocPrefix) == 0;
+}
+
+/**
+ * @brief InprocChannel 构造函数
+ *
+ * 不查找端点：通道可以先于端点创建，第一次调用时再查找。
+ */
+InprocChannel::InprocChannel(
+    const std::string& target,
+    std::shared_ptr<ChannelCredentials> credentials,
+    const ChannelArguments& args)
+    : target_(target)
+    , name_(EndpointName(target))
+    , credentials_(credentials)
+    , args_(args) {
+}
+
+InprocChannel::~InprocChannel() = default;
+
+/**
+ * @brief 取得仍处于注册状态的端点
+ *
+ * 缓存的端点有效时直接返回；否则（尚未查找或已被注销）查找注册表，
+ * 找到同名的新端点时替换缓存。
+ */
+std::shared_ptr<InprocEndpoint> InprocChannel::GetEndpoint() const {
+    auto endpoint = std::atomic_load(&endpoint_);
+    if (endpoint && endpoint->active) {
+        return endpoint;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_endpoints_mutex);
+        auto it = g_endpoints.find(name_);
+        endpoint = it != g_endpoints.end() ? it->second : nullptr;
+    }
+    std::atomic_store(&endpoint_, endpoint);
+    return endpoint;
+}
+
+bool InprocChannel::IsConnected() const {
+    auto endpoint = std::atomic_load(&endpoint_);
+    return endpoint && endpoint->active;
+}
+
+Status InprocChannel::Connect() {
+    if (!GetEndpoint()) {
+        return Status::Unavailable("No inproc endpoint registered as " + name_);
+    }
+    return Status::OK();
+}
+
+void InprocChannel::Disconnect() {
+    std::atomic_store(&endpoint_, std::shared_ptr<InprocEndpoint>());
+}
+
+/**
+ * @brief 等待端点注册
+ *
+ * 端点由同一进程中的其他代码注册，注册时不会通知通道，因此按固定间隔查找。
+ */
+bool InprocChannel::WaitForConnected(std::chrono::system_clock::time_point deadline) {
+    while (!GetEndpoint()) {
+        if (std::chrono::system_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+/**
+ * @brief 在调用线程上执行处理函数
+ *
+ * 步骤：
+ * 1. 检查截止时间
+ * 2. 取得端点（持有其引用直到调用返回，期间注销不影响本次调用）
+ * 3. 以引用方式传入请求数据，处理函数直接写入响应缓冲区
+ * 4. 处理函数无法被中途取消，返回时若已超过截止时间，
+ *    与网络通道一致地丢弃响应并返回 DEADLINE_EXCEEDED
+ */
+Status InprocChannel::ExecuteRequest(
+    const std::string& method,
+    ClientContext* context,
+    const std::string& request_data,
+    std::string* response_data) {
+
+    if (context && context->IsExpired()) {
+        return Status::DeadlineExceeded("Request deadline exceeded");
+    }
+
+    auto endpoint = GetEndpoint();
+    if (!endpoint) {
+        return Status::Unavailable("No inproc endpoint registered as " + name_);
+    }
+
+    auto status = endpoint->handler(method, context, request_data, response_data);
+    if (status.ok() && context && context->IsExpired()) {
+        status = Status::DeadlineExceeded("Request deadline exceeded");
+    }
+    if (!status.ok()) {
+        response_data->clear();
+    }
+    return status;
+}
+
+} // namespace litegrpc
@@ -0,0 +1,458 @@
+/**
+ * @file shm_channel.cpp
+ * @brief LiteGRPC 共享内存通道实现
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ *
+ * 本文件实现了 shm: 通道的客户端：
+ * - 建立连接时创建共享段，经 Unix 域套接字交给服务端并等待确认
+ * - 发起调用的线程持有发送锁把请求写入请求环
+ * - 等待响应的线程以领导者/跟随者方式轮流读取响应环：
+ *   持有轮询权的线程读取所有到达的响应并分发给各自的调用，
+ *   其余线程在条件变量上等待
+ */
+
+#include "litegrpc/shm.h"
+#include "litegrpc/client_context.h"
+#include "litegrpc/core.h"
+#include "shm_ring.h"
+#include "../http2/connector.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace litegrpc {
+
+namespace {
+
+const uint64_t kMaxResponseReserve = 256 << 20;  ///< 按响应头部预留缓冲区的上限（字节）
+const uint64_t kMaxMessageSize = static_cast<uint64_t>(Config::DEFAULT_MAX_MESSAGE_SIZE);  ///< 消息大小上限（字节）
+
+/**
+ * @brief 一次调用的结果，由读取响应的线程填写
+ */
+struct ShmCall {
+    Status status;          ///< 服务端返回的状态
+    std::string response;   ///< 响应数据
+    bool done = false;      ///< 响应已完整接收（由连接的 mutex 保护）
+};
+
+int TimeoutMs(std::chrono::system_clock::time_point deadline, int cap_ms) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::system_clock::now()).count();
+    return static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(remaining + 1, cap_ms)));
+}
+
+Status ToStatus(int32_t code, const std::string& message) {
+    if (code < static_cast<int32_t>(StatusCode::OK) ||
+        code > static_cast<int32_t>(StatusCode::UNAUTHENTICATED)) {
+        return Status::Unknown(message);
+    }
+    return Status(static_cast<StatusCode>(code), message);
+}
+
+Status MessageTooLarge(uint64_t size) {
+    return Status::ResourceExhausted("Received message larger than max (" + std::to_string(size) +
+                                     " vs. " + std::to_string(kMaxMessageSize) + ")");
+}
+
+} // namespace
+
+/**
+ * @brief 共享内存连接
+ */
+struct ShmConnection {
+    int fd = -1;                    ///< 握手套接字，之后只用于检测对端退出
+    shm::Segment segment;           ///< 共享段
+    shm::Ring requests;             ///< 请求环（生产者）
+    shm::Ring responses;            ///< 响应环（消费者）
+    std::atomic<uint64_t> next_call_id{1};  ///< 下一个调用标识
+
+    std::mutex send_mutex;          ///< 串行化请求环的写入
+
+    std::mutex mutex;               ///< 保护以下字段
+    std::condition_variable cv;     ///< 调用完成或轮询权释放时通知
+    bool polling = false;           ///< 是否有线程正在读取响应环
+    std::atomic<bool> closed{false};  ///< 连接已关闭
+    Status close_status;            ///< 关闭原因
+    std::unordered_map<uint64_t, std::shared_ptr<ShmCall>> calls;  ///< 等待响应的调用
+
+    // 正在接收的响应，只由持有轮询权的线程访问
+    std::shared_ptr<ShmCall> receiving;  ///< 当前响应所属的调用（调用已放弃时为空）
+    uint64_t receiving_id = 0;           ///< 当前响应的调用标识
+
+    ~ShmConnection() {
+        segment.Unmap();
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    /**
+     * @brief 关闭连接，所有等待中的调用以 status 结束（需持有 mutex）
+     */
+    void Close(const Status& status) {
+        if (closed) {
+            return;
+        }
+        closed = true;
+        close_status = status;
+        shutdown(fd, SHUT_RDWR);
+        cv.notify_all();
+    }
+
+    /**
+     * @brief 读取响应环（需持有轮询权）
+     * @param timeout_ms 没有响应时的最长等待时间（毫秒）
+     * @return Status 对端断开或共享段损坏时返回错误
+     *
+     * 步骤：
+     * 1. 读取所有已到达的记录，没有记录时等待
+     * 2. 响应头部：按调用标识找到调用并记录状态，调用已放弃时丢弃该响应
+     * 3. 数据记录：从共享内存直接追加到调用的响应缓冲区，超过消息大小上限时
+ *    以 RESOURCE_EXHAUSTED 结束该调用并丢弃其余数据
+     * 4. 消息的最后一个记录：标记调用完成并通知等待者
+     */
+    Status Poll(int timeout_ms) {
+        shm::RecordHeader record;
+        const char* data = nullptr;
+        bool corrupt = false;
+        bool received = false;
+        for (;;) {
+            if (!responses.Peek(&record, &data, &corrupt)) {
+                if (corrupt) {
+                    return Status::Internal("Corrupt shared-memory response ring");
+                }
+                if (received) {
+                    return Status::OK();
+                }
+                if (!responses.WaitForData(timeout_ms)) {
+                    return shm::PeerAlive(fd) ? Status::OK()
+                        : Status::Unavailable("Shared-memory peer disconnected");
+                }
+                received = true;
+                continue;
+            }
+            received = true;
+
+            if (record.type == shm::kRecordResponse) {
+                shm::ResponseHeader header;
+                if (!shm::DecodeResponseHeader(data, record.length, &header)) {
+                    return Status::Internal("Malformed shared-memory response header");
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto it = calls.find(record.call_id);
+                    receiving = it != calls.end() ? it->second : nullptr;
+                }
+                receiving_id = record.call_id;
+                if (receiving) {
+                    receiving->status = ToStatus(header.code, header.message);
+                    if (header.payload_length > kMaxMessageSize) {
+                        receiving->status = MessageTooLarge(header.payload_length);
+                    } else {
+                        receiving->response.reserve(std::min(header.payload_length, kMaxResponseReserve));
+                    }
+                }
+            } else if (record.type == shm::kRecordData) {
+                // 出错的响应不带数据；超过上限后丢弃剩余数据记录
+                if (receiving && record.call_id == receiving_id && receiving->status.ok()) {
+                    if (receiving->response.size() + record.length > kMaxMessageSize) {
+                        receiving->status = MessageTooLarge(receiving->response.size() + record.length);
+                        std::string().swap(receiving->response);
+                    } else {
+                        receiving->response.append(data, record.length);
+                    }
+                }
+            } else {
+                return Status::Internal("Unexpected record in shared-memory response ring");
+            }
+
+            if ((record.flags & shm::kRecordEnd) && receiving) {
+                std::lock_guard<std::mutex> lock(mutex);
+                receiving->done = true;
+                calls.erase(receiving_id);
+                receiving.reset();
+                cv.notify_all();
+            }
+            responses.Consume();
+        }
+    }
+
+    /**
+     * @brief 没有线程读取响应环时读取一次已到达的响应，不等待
+     *
+     * 发送方等待请求环空间时调用：服务端可能正阻塞在写入响应上
+     * （例如响应属于已超时的调用，没有线程在等待），
+     * 不读取响应环双方会互相等待。
+     */
+    void PollIfIdle() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (polling || closed) {
+                return;
+            }
+            polling = true;
+        }
+        auto status = Poll(0);
+        std::lock_guard<std::mutex> lock(mutex);
+        polling = false;
+        if (!status.ok()) {
+            Close(status);
+        }
+        cv.notify_all();
+    }
+};
+
+bool ShmChannel::IsShmTarget(const std::string& target) {
+    return target.compare(0, sizeof(shm::kShmPrefix) - 1, shm::kShmPrefix) == 0;
+}
+
+/**
+ * @brief ShmChannel 构造函数
+ *
+ * 不建立连接：第一次调用或 Connect() 时再连接。
+ */
+ShmChannel::ShmChannel(
+    const std::string& target,
+    std::shared_ptr<ChannelCredentials> credentials,
+    const ChannelArguments& args)
+    : target_(target)
+    , credentials_(credentials)
+    , args_(args)
+    , ring_capacity_(shm::kDefaultRingCapacity) {
+    int value = 0;
+    if (args.GetInt(ChannelArguments::LITEGRPC_ARG_SHM_RING_SIZE, &value) && value > 0) {
+        ring_capacity_ = static_cast<uint64_t>(value);
+    }
+}
+
+ShmChannel::~ShmChannel() {
+    Disconnect();
+}
+
+bool ShmChannel::IsConnected() const {
+    auto connection = std::atomic_load(&connection_);
+    return connection && !connection->closed;
+}
+
+Status ShmChannel::Connect() {
+    return EstablishConnection(Config::DEFAULT_TIMEOUT_MS);
+}
+
+void ShmChannel::Disconnect() {
+    std::lock_guard<std::mutex> connect_lock(connect_mutex_);
+    auto connection = std::atomic_load(&connection_);
+    if (connection) {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        connection->Close(Status::Unavailable("Channel disconnected"));
+    }
+    std::atomic_store(&connection_, std::shared_ptr<ShmConnection>());
+}
+
+/**
+ * @brief 等待连接建立
+ *
+ * 服务端尚未启动时连接立即失败，按固定间隔重试直到截止时间。
+ */
+bool ShmChannel::WaitForConnected(std::chrono::system_clock::time_point deadline) {
+    for (;;) {
+        if (EstablishConnection(TimeoutMs(deadline, Config::DEFAULT_TIMEOUT_MS)).ok()) {
+            return true;
+        }
+        if (std::chrono::system_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+/**
+ * @brief 建立连接
+ *
+ * 步骤：
+ * 1. 由 shm: 目标得到 Unix 域套接字地址并连接
+ * 2. 创建共享段，以 SCM_RIGHTS 把 memfd 交给服务端
+ * 3. 等待服务端映射并校验共享段后发回的确认字节
+ * 4. 绑定两个环并替换当前连接
+ */
+Status ShmChannel::EstablishConnection(int timeout_ms) {
+    std::lock_guard<std::mutex> connect_lock(connect_mutex_);
+    auto current = std::atomic_load(&connection_);
+    if (current && !current->closed) {
+        return Status::OK();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string socket_target;
+    auto status = shm::SocketTarget(target_, &socket_target);
+    if (!status.ok()) {
+        return status;
+    }
+    std::vector<http2::ResolvedAddress> addresses;
+    status = http2::ResolveHost(socket_target, 0, &addresses);
+    if (!status.ok()) {
+        return status;
+    }
+
+    auto connection = std::make_shared<ShmConnection>();
+    status = http2::ConnectHappyEyeballs(socket_target, addresses, timeout_ms, &connection->fd);
+    if (!status.ok()) {
+        return status;
+    }
+
+    int memfd = -1;
+    status = shm::CreateSegment(ring_capacity_, &connection->segment, &memfd);
+    if (!status.ok()) {
+        return status;
+    }
+    status = shm::SendDescriptor(connection->fd, memfd);
+    close(memfd);
+    if (!status.ok()) {
+        return status;
+    }
+
+    int elapsed_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    status = http2::WaitForSocket(connection->fd, false,
+                                  timeout_ms < 0 ? -1 : std::max(0, timeout_ms - elapsed_ms));
+    if (!status.ok()) {
+        return status;
+    }
+    char ack = 0;
+    if (recv(connection->fd, &ack, 1, 0) != 1) {
+        return Status::Unavailable("Shared-memory server rejected the connection");
+    }
+
+    auto* header = connection->segment.header();
+    connection->requests.Attach(&header->request, connection->segment.request_data(),
+                                header->ring_capacity);
+    connection->responses.Attach(&header->response, connection->segment.response_data(),
+                                 header->ring_capacity);
+    std::atomic_store(&connection_, connection);
+    return Status::OK();
+}
+
+/**
+ * @brief 经共享内存执行一次调用
+ *
+ * 步骤：
+ * 1. 检查截止时间，必要时建立连接（建连时间计入截止时间）
+ * 2. 登记调用后持发送锁写入请求；环已满时检查对端并顺带读取响应环
+ * 3. 等待响应：没有线程读取响应环时取得轮询权读取，否则在条件变量上等待
+ * 4. 截止时间到达时放弃调用，之后到达的响应被丢弃
+ */
+Status ShmChannel::ExecuteRequest(
+    const std::string& method,
+    ClientContext* context,
+    const std::string& request_data,
+    std::string* response_data) {
+
+    if (context && context->IsExpired()) {
+        return Status::DeadlineExceeded("Request deadline exceeded");
+    }
+    auto deadline = (context && context->has_deadline())
+        ? context->deadline() : std::chrono::system_clock::time_point::max();
+
+    auto connection = std::atomic_load(&connection_);
+    if (!connection || connection->closed) {
+        int connect_timeout_ms = (context && context->has_deadline())
+            ? context->GetTimeoutMs() : Config::DEFAULT_TIMEOUT_MS;
+        auto status = EstablishConnection(connect_timeout_ms);
+        if (!status.ok()) {
+            return status;
+        }
+        connection = std::atomic_load(&connection_);
+        if (!connection) {
+            return Status::Unavailable("Channel disconnected");
+        }
+    }
+
+    if (request_data.size() > kMaxMessageSize) {
+        return Status::ResourceExhausted("Request message larger than max (" +
+                                         std::to_string(request_data.size()) + " vs. " +
+                                         std::to_string(kMaxMessageSize) + ")");
+    }
+
+    shm::RequestHeader request;
+    request.method = method;
+    if (context) {
+        request.metadata = context->GetMetadata();
+        if (context->has_deadline()) {
+            request.deadline_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                context->deadline().time_since_epoch()).count();
+        }
+    }
+    request.payload_length = request_data.size();
+    std::string header;
+    shm::EncodeRequestHeader(request, &header);
+
+    auto call = std::make_shared<ShmCall>();
+    uint64_t call_id = connection->next_call_id.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        if (connection->closed) {
+            return connection->close_status;
+        }
+        connection->calls[call_id] = call;
+    }
+
+    Status status;
+    {
+        std::lock_guard<std::mutex> send_lock(connection->send_mutex);
+        status = shm::WriteMessage(
+            &connection->requests, shm::kRecordRequest, call_id, header, request_data, deadline,
+            [&connection]() {
+                if (!shm::PeerAlive(connection->fd)) {
+                    return Status::Unavailable("Shared-memory peer disconnected");
+                }
+                connection->PollIfIdle();
+                return connection->closed ? connection->close_status : Status::OK();
+            });
+    }
+
+    std::unique_lock<std::mutex> lock(connection->mutex);
+    if (!status.ok()) {
+        connection->calls.erase(call_id);
+        if (status.error_code() == StatusCode::UNAVAILABLE) {
+            connection->Close(status);
+        }
+        return status;
+    }
+
+    while (!call->done) {
+        if (connection->closed) {
+            connection->calls.erase(call_id);
+            return connection->close_status;
+        }
+        if (std::chrono::system_clock::now() >= deadline) {
+            connection->calls.erase(call_id);
+            return Status::DeadlineExceeded("Request deadline exceeded");
+        }
+        if (!connection->polling) {
+            connection->polling = true;
+            lock.unlock();
+            status = connection->Poll(TimeoutMs(deadline, shm::kLivenessCheckMs));
+            lock.lock();
+            connection->polling = false;
+            if (!status.ok()) {
+                connection->Close(status);
+            }
+            connection->cv.notify_all();
+            continue;
+        }
+        connection->cv.wait_for(lock, std::chrono::milliseconds(
+            TimeoutMs(deadline, shm::kLivenessCheckMs)));
+    }
+
+    *response_data = std::move(call->response);
+    return call->status;
+}
+
+} // namespace litegrpc
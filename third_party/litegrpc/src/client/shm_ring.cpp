@@ -0,0 +1,619 @@
+/**
+ * @file shm_ring.cpp
+ * @brief 共享内存传输的环形缓冲区与共享段实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "shm_ring.h"
+#include "../http2/connector.h"   // WaitForSocket
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace litegrpc {
+namespace shm {
+
+namespace {
+
+const size_t kRecordSize = sizeof(RecordHeader);  ///< 记录头部大小
+const int kSpinIterations = 2048;                  ///< 多核系统上 futex 等待前的自旋次数
+
+size_t Align8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+/**
+ * @brief futex 等待前的自旋次数
+ *
+ * 单核系统上对端在本线程让出处理器之前无法运行，自旋只会推迟对端，直接休眠。
+ */
+int SpinIterations() {
+    static const int iterations = std::thread::hardware_concurrency() > 1 ? kSpinIterations : 0;
+    return iterations;
+}
+
+void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief 在共享内存中的 32 位字上等待（跨进程）
+ */
+void FutexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+uint64_t NormalizeCapacity(uint64_t capacity) {
+    capacity = std::min(std::max(capacity, kMinRingCapacity), kMaxRingCapacity);
+    uint64_t rounded = kMinRingCapacity;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+void PutU32(std::string* out, uint32_t value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void PutU64(std::string* out, uint64_t value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void PutString(std::string* out, const std::string& value) {
+    PutU32(out, static_cast<uint32_t>(value.size()));
+    out->append(value);
+}
+
+/**
+ * @brief 带边界检查的头部解码器
+ */
+class Decoder {
+public:
+    Decoder(const char* data, size_t length) : data_(data), remaining_(length) {}
+
+    bool U32(uint32_t* value) { return Raw(value, sizeof(*value)); }
+    bool U64(uint64_t* value) { return Raw(value, sizeof(*value)); }
+
+    bool String(std::string* value) {
+        uint32_t length;
+        if (!U32(&length) || length > remaining_) {
+            return false;
+        }
+        value->assign(data_, length);
+        data_ += length;
+        remaining_ -= length;
+        return true;
+    }
+
+    bool done() const { return remaining_ == 0; }
+
+private:
+    bool Raw(void* value, size_t size) {
+        if (size > remaining_) {
+            return false;
+        }
+        memcpy(value, data_, size);
+        data_ += size;
+        remaining_ -= size;
+        return true;
+    }
+
+    const char* data_;
+    size_t remaining_;
+};
+
+int RemainingMs(std::chrono::system_clock::time_point deadline) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::system_clock::now()).count();
+    return static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(remaining + 1, kLivenessCheckMs)));
+}
+
+} // namespace
+
+// ========== Ring ==========
+
+/**
+ * @brief 绑定到共享段中的一个环
+ *
+ * 共享段在每次连接时新建，双方的位置都从 0 开始。
+ */
+void Ring::Attach(RingControl* control, uint8_t* data, uint64_t capacity) {
+    control_ = control;
+    data_ = data;
+    capacity_ = capacity;
+    position_ = 0;
+    peer_position_ = 0;
+    record_size_ = 0;
+}
+
+/**
+ * @brief 尝试写入一个记录
+ *
+ * 步骤：
+ * 1. 环末尾剩余不足一个记录头时，双方都隐式跳过这段空间
+ * 2. 可写空间取环末尾的连续空间与空闲空间中较小者
+ * 3. 数据放不下时：允许切分则写入能放下的部分；
+ *    否则在连续空间是限制因素时写入填充记录，从环起始处重试
+ * 4. 复制数据并推进本地写入位置，由 Publish() 发布
+ */
+size_t Ring::TryWrite(uint32_t type, uint64_t call_id, const char* data, size_t length,
+                      bool end, bool split) {
+    for (;;) {
+        uint64_t free = capacity_ - (position_ - peer_position_);
+        if (free < kRecordSize + Align8(length)) {
+            peer_position_ = control_->head.load(std::memory_order_acquire);
+            free = capacity_ - (position_ - peer_position_);
+        }
+        size_t offset = static_cast<size_t>(position_ & (capacity_ - 1));
+        size_t contiguous = static_cast<size_t>(capacity_) - offset;
+
+        if (contiguous < kRecordSize) {
+            if (free < contiguous) {
+                return SIZE_MAX;
+            }
+            position_ += contiguous;
+            continue;
+        }
+
+        size_t room = static_cast<size_t>(std::min<uint64_t>(contiguous, free));
+        if (room < kRecordSize) {
+            return SIZE_MAX;
+        }
+        room -= kRecordSize;
+
+        size_t n = length;
+        if (Align8(length) > room) {
+            if (split && room > 0) {
+                n = room;
+            } else if (contiguous <= free) {
+                auto* padding = reinterpret_cast<RecordHeader*>(data_ + offset);
+                padding->type = kRecordPadding;
+                padding->flags = 0;
+                padding->call_id = 0;
+                padding->length = contiguous - kRecordSize;
+                position_ += contiguous;
+                continue;
+            } else {
+                return SIZE_MAX;
+            }
+        }
+
+        auto* record = reinterpret_cast<RecordHeader*>(data_ + offset);
+        record->type = type;
+        record->flags = (end && n == length) ? kRecordEnd : 0;
+        record->call_id = call_id;
+        record->length = n;
+        if (n > 0) {
+            memcpy(record + 1, data, n);
+        }
+        position_ += kRecordSize + Align8(n);
+        return n;
+    }
+}
+
+/**
+ * @brief 发布已写入的记录
+ *
+ * 发布位置与读取等待标志都使用顺序一致的内存序，与 WaitForData() 中
+ * “登记等待、再检查位置”的顺序配对：两者至少有一方看到对方的写入，
+ * 因此不会丢失唤醒。
+ */
+void Ring::Publish() {
+    control_->tail.store(position_, std::memory_order_seq_cst);
+    if (control_->consumer_waiting.load(std::memory_order_seq_cst)) {
+        control_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWake(&control_->data_seq);
+    }
+}
+
+/**
+ * @brief 等待消费者释放空间
+ *
+ * 先自旋等待读取位置变化，仍未变化时登记等待并在 space_seq 上休眠。
+ */
+void Ring::WaitForSpace(int timeout_ms) {
+    for (int i = 0, n = SpinIterations(); i < n; ++i) {
+        if (control_->head.load(std::memory_order_acquire) != peer_position_) {
+            return;
+        }
+        CpuRelax();
+    }
+    control_->producer_waiting.store(1, std::memory_order_seq_cst);
+    uint32_t seq = control_->space_seq.load(std::memory_order_seq_cst);
+    if (control_->head.load(std::memory_order_seq_cst) == peer_position_) {
+        FutexWait(&control_->space_seq, seq, timeout_ms);
+    }
+    control_->producer_waiting.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 查看下一个记录
+ *
+ * 对端给出的写入位置必须在本地读取位置之后、且相差不超过环容量；
+ * 记录长度必须落在已发布的范围与环末尾之内。
+ */
+bool Ring::Peek(RecordHeader* record, const char** data, bool* corrupt) {
+    *corrupt = false;
+    bool skipped = false;
+    for (;;) {
+        if (position_ == peer_position_) {
+            peer_position_ = control_->tail.load(std::memory_order_acquire);
+            if (peer_position_ - position_ > capacity_ || peer_position_ % 8 != 0) {
+                *corrupt = true;
+                return false;
+            }
+            if (peer_position_ == position_) {
+                if (skipped) {
+                    ReleaseHead();
+                }
+                return false;
+            }
+        }
+        uint64_t available = peer_position_ - position_;
+        size_t offset = static_cast<size_t>(position_ & (capacity_ - 1));
+        size_t contiguous = static_cast<size_t>(capacity_) - offset;
+
+        if (contiguous < kRecordSize) {
+            if (available < contiguous) {
+                *corrupt = true;
+                return false;
+            }
+            position_ += contiguous;
+            skipped = true;
+            continue;
+        }
+
+        if (available < kRecordSize) {
+            *corrupt = true;
+            return false;
+        }
+        memcpy(record, data_ + offset, kRecordSize);
+        if (record->length > contiguous - kRecordSize ||
+            kRecordSize + Align8(record->length) > available) {
+            *corrupt = true;
+            return false;
+        }
+        size_t size = kRecordSize + Align8(record->length);
+        if (record->type == kRecordPadding) {
+            position_ += size;
+            skipped = true;
+            continue;
+        }
+        *data = reinterpret_cast<const char*>(data_ + offset + kRecordSize);
+        record_size_ = size;
+        return true;
+    }
+}
+
+void Ring::Consume() {
+    position_ += record_size_;
+    record_size_ = 0;
+    ReleaseHead();
+}
+
+/**
+ * @brief 释放已读取的空间，与 WaitForSpace() 配对
+ */
+void Ring::ReleaseHead() {
+    control_->head.store(position_, std::memory_order_seq_cst);
+    if (control_->producer_waiting.load(std::memory_order_seq_cst)) {
+        control_->space_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWake(&control_->space_seq);
+    }
+}
+
+/**
+ * @brief 等待数据到达
+ *
+ * 先自旋等待写入位置变化，仍未变化时登记等待并在 data_seq 上休眠。
+ */
+bool Ring::WaitForData(int timeout_ms) {
+    for (int i = 0, n = SpinIterations(); i < n; ++i) {
+        if (control_->tail.load(std::memory_order_acquire) != position_) {
+            return true;
+        }
+        CpuRelax();
+    }
+    control_->consumer_waiting.store(1, std::memory_order_seq_cst);
+    uint32_t seq = control_->data_seq.load(std::memory_order_seq_cst);
+    if (control_->tail.load(std::memory_order_seq_cst) == position_) {
+        FutexWait(&control_->data_seq, seq, timeout_ms);
+    }
+    control_->consumer_waiting.store(0, std::memory_order_relaxed);
+    return control_->tail.load(std::memory_order_acquire) != position_;
+}
+
+// ========== 共享段 ==========
+
+void Segment::Unmap() {
+    if (base) {
+        munmap(base, size);
+        base = nullptr;
+        size = 0;
+    }
+}
+
+/**
+ * @brief 创建并初始化共享段
+ *
+ * 封印禁止之后改变 memfd 的大小，服务端据此确认映射范围始终有效，
+ * 不会因为客户端截断文件而在访问时收到 SIGBUS。
+ */
+Status CreateSegment(uint64_t ring_capacity, Segment* segment, int* fd) {
+    ring_capacity = NormalizeCapacity(ring_capacity);
+    size_t size = kDataOffset + 2 * ring_capacity;
+
+    int memfd = memfd_create("litegrpc-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0) {
+        return Status::Unavailable("memfd_create failed: " + std::string(strerror(errno)));
+    }
+    if (ftruncate(memfd, static_cast<off_t>(size)) != 0 ||
+        fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        int err = errno;
+        close(memfd);
+        return Status::Unavailable("Failed to size shared-memory segment: " + std::string(strerror(err)));
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    if (base == MAP_FAILED) {
+        int err = errno;
+        close(memfd);
+        return Status::Unavailable("mmap failed: " + std::string(strerror(err)));
+    }
+
+    // memfd 的内容初始为零，控制块中的计数与标志无需再初始化
+    auto* header = new (base) SegmentHeader;
+    header->magic = kSegmentMagic;
+    header->version = kSegmentVersion;
+    header->ring_capacity = ring_capacity;
+
+    segment->base = static_cast<uint8_t*>(base);
+    segment->size = size;
+    *fd = memfd;
+    return Status::OK();
+}
+
+/**
+ * @brief 映射并校验对端创建的共享段
+ */
+Status MapSegment(int fd, Segment* segment) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_GROW)) != (F_SEAL_SHRINK | F_SEAL_GROW)) {
+        return Status::InvalidArgument("Shared-memory segment is not sealed against resizing");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kDataOffset)) {
+        return Status::InvalidArgument("Shared-memory segment too small");
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return Status::Unavailable("mmap failed: " + std::string(strerror(errno)));
+    }
+
+    const auto* header = static_cast<const SegmentHeader*>(base);
+    uint64_t capacity = header->ring_capacity;
+    if (header->magic != kSegmentMagic || header->version != kSegmentVersion ||
+        capacity < kMinRingCapacity || capacity > kMaxRingCapacity ||
+        (capacity & (capacity - 1)) != 0 || size != kDataOffset + 2 * capacity) {
+        munmap(base, size);
+        return Status::InvalidArgument("Invalid shared-memory segment header");
+    }
+    segment->base = static_cast<uint8_t*>(base);
+    segment->size = size;
+    return Status::OK();
+}
+
+// ========== 套接字 ==========
+
+Status SocketTarget(const std::string& target, std::string* socket_target) {
+    if (target.compare(0, sizeof(kShmPrefix) - 1, kShmPrefix) != 0) {
+        return Status::InvalidArgument("Not a shm: target: " + target);
+    }
+    std::string address = target.substr(sizeof(kShmPrefix) - 1);
+    if (address.empty() || address == "@") {
+        return Status::InvalidArgument("shm: target requires a socket address: " + target);
+    }
+    if (address[0] == '@') {
+        *socket_target = "unix-abstract:" + address.substr(1);
+    } else {
+        *socket_target = "unix:" + address;
+    }
+    return Status::OK();
+}
+
+Status SendDescriptor(int sock, int fd) {
+    char byte = 0;
+    struct iovec iov = {&byte, 1};
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    if (sendmsg(sock, &msg, MSG_NOSIGNAL) != 1) {
+        return Status::Unavailable("Failed to send shared-memory segment: " + std::string(strerror(errno)));
+    }
+    return Status::OK();
+}
+
+Status ReceiveDescriptor(int sock, int timeout_ms, int* fd) {
+    auto status = http2::WaitForSocket(sock, false, timeout_ms);
+    if (!status.ok()) {
+        return status;
+    }
+
+    char byte;
+    struct iovec iov = {&byte, 1};
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    if (n <= 0) {
+        return Status::Unavailable("Peer closed before sending shared-memory segment");
+    }
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+        return Status::InvalidArgument("Handshake did not carry a shared-memory segment");
+    }
+    memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+    return Status::OK();
+}
+
+bool PeerAlive(int sock) {
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN | POLLRDHUP;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
+}
+
+// ========== 消息 ==========
+
+void EncodeRequestHeader(const RequestHeader& header, std::string* out) {
+    out->clear();
+    PutU64(out, static_cast<uint64_t>(header.deadline_ns));
+    PutU64(out, header.payload_length);
+    PutString(out, header.method);
+    PutU32(out, static_cast<uint32_t>(header.metadata.size()));
+    for (const auto& entry : header.metadata) {
+        PutString(out, entry.first);
+        PutString(out, entry.second);
+    }
+}
+
+bool DecodeRequestHeader(const char* data, size_t length, RequestHeader* header) {
+    Decoder decoder(data, length);
+    uint64_t deadline_ns;
+    uint32_t count;
+    if (!decoder.U64(&deadline_ns) || !decoder.U64(&header->payload_length) ||
+        !decoder.String(&header->method) || !decoder.U32(&count)) {
+        return false;
+    }
+    header->deadline_ns = static_cast<int64_t>(deadline_ns);
+    header->metadata.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string key, value;
+        if (!decoder.String(&key) || !decoder.String(&value)) {
+            return false;
+        }
+        header->metadata[key] = value;
+    }
+    return decoder.done();
+}
+
+void EncodeResponseHeader(const ResponseHeader& header, std::string* out) {
+    out->clear();
+    PutU64(out, header.payload_length);
+    PutU32(out, static_cast<uint32_t>(header.code));
+    PutString(out, header.message);
+}
+
+bool DecodeResponseHeader(const char* data, size_t length, ResponseHeader* header) {
+    Decoder decoder(data, length);
+    uint32_t code;
+    if (!decoder.U64(&header->payload_length) || !decoder.U32(&code) ||
+        !decoder.String(&header->message)) {
+        return false;
+    }
+    header->code = static_cast<int32_t>(code);
+    return decoder.done();
+}
+
+/**
+ * @brief 把一条消息写入环
+ *
+ * 步骤：
+ * 1. 写入头部记录（不切分），等待空间期间受截止时间约束
+ * 2. 依次写入数据记录，每个记录尽可能大，写入后立即发布，
+ *    读取方可以一边复制一边等待后续片段
+ * 3. 最后一个记录带 kRecordEnd 标志
+ */
+Status WriteMessage(Ring* ring, uint32_t header_type, uint64_t call_id,
+                    const std::string& header, const std::string& payload,
+                    std::chrono::system_clock::time_point deadline,
+                    const std::function<Status()>& on_full) {
+    if (kRecordSize + Align8(header.size()) > ring->capacity() / 4) {
+        return Status::ResourceExhausted("Message header too large for shared-memory ring");
+    }
+
+    while (ring->TryWrite(header_type, call_id, header.data(), header.size(),
+                          payload.empty(), false) == SIZE_MAX) {
+        ring->Publish();
+        if (std::chrono::system_clock::now() >= deadline) {
+            return Status::DeadlineExceeded("Request deadline exceeded");
+        }
+        auto status = on_full();
+        if (!status.ok()) {
+            return status;
+        }
+        ring->WaitForSpace(RemainingMs(deadline));
+    }
+
+    size_t offset = 0;
+    while (offset < payload.size()) {
+        size_t n = ring->TryWrite(kRecordData, call_id, payload.data() + offset,
+                                  payload.size() - offset, true, true);
+        ring->Publish();
+        if (n == SIZE_MAX) {
+            auto status = on_full();
+            if (!status.ok()) {
+                return status;
+            }
+            ring->WaitForSpace(kLivenessCheckMs);
+            continue;
+        }
+        offset += n;
+    }
+    ring->Publish();
+    return Status::OK();
+}
+
+} // namespace shm
+} // namespace litegrpc
@@ -0,0 +1,312 @@
+/**
+ * @file shm_ring.h
+ * @brief 共享内存传输的内存布局与环形缓冲区头文件
+ *
+ * shm:// 通道与 ShmServer 之间不经过套接字传输数据：客户端创建一个 memfd，
+ * 经 Unix 域套接字以 SCM_RIGHTS 交给服务端，双方映射同一段内存。
+ * 共享段的布局：
+ *
+ *     +------------------+ 0
+ *     | SegmentHeader    |  魔数、版本、环容量、两个环的控制块
+ *     +------------------+ kDataOffset
+ *     | 请求环数据区     |  客户端写、服务端读
+ *     +------------------+ kDataOffset + capacity
+ *     | 响应环数据区     |  服务端写、客户端读
+ *     +------------------+ kDataOffset + 2 * capacity
+ *
+ * 每个环都是单生产者单消费者的字节环，头尾位置是单调递增的 64 位计数，
+ * 环中是按 8 字节对齐的变长记录。一条消息由一个头部记录和若干数据记录组成，
+ * 最后一个记录带 kRecordEnd 标志；大消息被切分成多个数据记录，
+ * 数据直接从调用方的缓冲区写入环，读取方直接从环中按偏移复制到目标缓冲区。
+ *
+ * 等待使用不带 FUTEX_PRIVATE_FLAG 的 futex（跨进程有效），
+ * 只有对端登记了等待时才发出唤醒系统调用；等待前先短暂自旋。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_SHM_RING_H
+#define LITEGRPC_SHM_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace shm {
+
+/// 共享内存通道目标的前缀（其后是 Unix 域套接字地址，@name 表示抽象命名空间）
+static const char kShmPrefix[] = "shm:";
+
+static const uint32_t kSegmentMagic = 0x4c47534d;       ///< "LGSM"
+static const uint32_t kSegmentVersion = 1;              ///< 布局版本
+static const uint64_t kDefaultRingCapacity = 4 << 20;   ///< 每个方向的默认环容量（字节）
+static const uint64_t kMinRingCapacity = 64 << 10;      ///< 最小环容量（字节）
+static const uint64_t kMaxRingCapacity = 1ull << 30;    ///< 最大环容量（字节）
+static const int kLivenessCheckMs = 100;                ///< 等待期间检查对端是否存活的间隔
+
+/// 记录类型
+enum RecordType : uint32_t {
+    kRecordPadding = 1,   ///< 填充到环末尾，读取方跳过
+    kRecordRequest = 2,   ///< 请求头部（方法名、元数据、截止时间）
+    kRecordResponse = 3,  ///< 响应头部（状态码、错误信息）
+    kRecordData = 4,      ///< 消息数据片段
+};
+
+/// 记录标志：消息的最后一个记录
+static const uint32_t kRecordEnd = 1;
+
+/**
+ * @brief 单个环的控制块
+ *
+ * 生产者与消费者写入的字段位于不同的缓存行。
+ * 等待序号只在对端登记了等待时递增，用作 futex 的比较值。
+ */
+struct RingControl {
+    alignas(64) std::atomic<uint64_t> tail;       ///< 已发布的写入位置（生产者写）
+    std::atomic<uint32_t> data_seq;               ///< 数据到达序号（生产者递增，消费者等待）
+    std::atomic<uint32_t> producer_waiting;       ///< 生产者正在等待空间
+    alignas(64) std::atomic<uint64_t> head;       ///< 已释放的读取位置（消费者写）
+    std::atomic<uint32_t> space_seq;              ///< 空间释放序号（消费者递增，生产者等待）
+    std::atomic<uint32_t> consumer_waiting;       ///< 消费者正在等待数据
+};
+
+/**
+ * @brief 共享段头部，位于映射起始处，由客户端初始化
+ */
+struct SegmentHeader {
+    uint32_t magic;             ///< kSegmentMagic
+    uint32_t version;           ///< kSegmentVersion
+    uint64_t ring_capacity;     ///< 每个环的数据区大小（2 的幂）
+    RingControl request;        ///< 请求环（客户端 -> 服务端）
+    RingControl response;       ///< 响应环（服务端 -> 客户端）
+};
+
+/// 数据区在共享段中的起始偏移
+static const size_t kDataOffset = (sizeof(SegmentHeader) + 4095) & ~size_t(4095);
+
+/**
+ * @brief 环中的记录头部，其后紧跟 length 字节数据并填充到 8 字节对齐
+ */
+struct RecordHeader {
+    uint32_t type;      ///< RecordType
+    uint32_t flags;     ///< kRecordEnd 等
+    uint64_t call_id;   ///< 调用标识，由客户端分配
+    uint64_t length;    ///< 数据长度（不含头部与填充）
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(sizeof(RecordHeader) % 8 == 0, "record header must keep 8-byte alignment");
+
+/**
+ * @brief 单生产者单消费者字节环
+ *
+ * 同一个 Ring 对象只用作生产者或只用作消费者，头尾位置各自在本地缓存，
+ * 只在发布或释放时写入共享控制块。对端写入的位置与记录在使用前都会校验，
+ * 损坏的共享段不会导致越界访问。
+ *
+ * 线程安全性：生产者方法与消费者方法分别只能由一个线程（或持锁的线程）调用。
+ */
+class Ring {
+public:
+    /**
+     * @brief 绑定到共享段中的一个环
+     * @param control 控制块
+     * @param data 数据区起始地址
+     * @param capacity 数据区大小（2 的幂）
+     */
+    void Attach(RingControl* control, uint8_t* data, uint64_t capacity);
+
+    /**
+     * @brief 数据区大小
+     */
+    uint64_t capacity() const { return capacity_; }
+
+    /* ========== 生产者 ========== */
+
+    /**
+     * @brief 尝试写入一个记录
+     * @param type 记录类型
+     * @param call_id 调用标识
+     * @param data 数据
+     * @param length 数据长度
+     * @param end 写完全部数据时是否带 kRecordEnd 标志
+     * @param split 空间不足时是否只写入一部分数据
+     * @return size_t 写入的数据字节数；空间不足时返回 SIZE_MAX
+     *
+     * 不允许切分的记录必须在环末尾之前连续存放，放不下时先写入填充记录。
+     */
+    size_t TryWrite(uint32_t type, uint64_t call_id, const char* data, size_t length,
+                    bool end, bool split);
+
+    /**
+     * @brief 发布已写入的记录，消费者正在等待时唤醒它
+     */
+    void Publish();
+
+    /**
+     * @brief 等待消费者释放空间
+     * @param timeout_ms 最长等待时间（毫秒）
+     */
+    void WaitForSpace(int timeout_ms);
+
+    /* ========== 消费者 ========== */
+
+    /**
+     * @brief 查看下一个记录
+     * @param record 输出参数，记录头部的副本（已校验，不受对端后续写入影响）
+     * @param data 输出参数，记录数据在共享段中的地址
+     * @param corrupt 输出参数，共享段中的位置或记录无效时置为 true
+     * @return bool 有记录时返回 true
+     *
+     * 跳过的填充记录会立即释放，等待空间的生产者不会因此停住。
+     */
+    bool Peek(RecordHeader* record, const char** data, bool* corrupt);
+
+    /**
+     * @brief 释放 Peek() 返回的记录，生产者正在等待时唤醒它
+     */
+    void Consume();
+
+    /**
+     * @brief 等待数据到达
+     * @param timeout_ms 最长等待时间（毫秒）
+     * @return bool 有数据可读时返回 true
+     */
+    bool WaitForData(int timeout_ms);
+
+private:
+    void ReleaseHead();
+
+    RingControl* control_ = nullptr;  ///< 共享控制块
+    uint8_t* data_ = nullptr;         ///< 数据区
+    uint64_t capacity_ = 0;           ///< 数据区大小
+    uint64_t position_ = 0;           ///< 本地位置：生产者为写入位置，消费者为读取位置
+    uint64_t peer_position_ = 0;      ///< 最近一次读到的对端位置
+    uint64_t record_size_ = 0;        ///< Peek() 返回的记录占用的字节数（消费者）
+};
+
+/* ========== 共享段 ========== */
+
+/**
+ * @brief 已映射的共享段
+ */
+struct Segment {
+    uint8_t* base = nullptr;  ///< 映射起始地址
+    size_t size = 0;          ///< 映射大小
+
+    SegmentHeader* header() const { return reinterpret_cast<SegmentHeader*>(base); }
+    uint8_t* request_data() const { return base + kDataOffset; }
+    uint8_t* response_data() const { return base + kDataOffset + header()->ring_capacity; }
+
+    /**
+     * @brief 解除映射
+     */
+    void Unmap();
+};
+
+/**
+ * @brief 创建并初始化共享段
+ * @param ring_capacity 每个环的容量（会被调整为合法的 2 的幂）
+ * @param segment 输出参数，已映射的共享段
+ * @param fd 输出参数，memfd（已设置不可改变大小的封印）
+ * @return Status 创建状态
+ */
+Status CreateSegment(uint64_t ring_capacity, Segment* segment, int* fd);
+
+/**
+ * @brief 映射并校验对端创建的共享段
+ * @param fd 对端传来的 memfd
+ * @param segment 输出参数，已映射的共享段
+ * @return Status 映射状态；大小、封印或头部无效时返回 INVALID_ARGUMENT
+ */
+Status MapSegment(int fd, Segment* segment);
+
+/* ========== 套接字 ========== */
+
+/**
+ * @brief 把 shm: 目标转换为 Unix 域套接字目标
+ * @param target shm:path、shm:///abs/path 或 shm:@name
+ * @param socket_target 输出参数，unix: 或 unix-abstract: 目标
+ * @return Status 转换状态，格式无效返回 INVALID_ARGUMENT
+ */
+Status SocketTarget(const std::string& target, std::string* socket_target);
+
+/**
+ * @brief 经 Unix 域套接字发送一个文件描述符
+ */
+Status SendDescriptor(int sock, int fd);
+
+/**
+ * @brief 经 Unix 域套接字接收一个文件描述符
+ * @param sock 非阻塞套接字
+ * @param timeout_ms 超时时间（毫秒）
+ * @param fd 输出参数，接收到的文件描述符
+ */
+Status ReceiveDescriptor(int sock, int timeout_ms, int* fd);
+
+/**
+ * @brief 对端是否仍保持连接
+ *
+ * 握手之后套接字上不再有数据，可读即表示对端已关闭或进程已退出。
+ */
+bool PeerAlive(int sock);
+
+/* ========== 消息 ========== */
+
+/**
+ * @brief 请求头部的内容
+ */
+struct RequestHeader {
+    std::string method;                              ///< 方法名
+    std::map<std::string, std::string> metadata;     ///< 元数据
+    int64_t deadline_ns = 0;                         ///< 截止时间（system_clock 纳秒，0 表示不限）
+    uint64_t payload_length = 0;                     ///< 消息数据长度
+};
+
+/**
+ * @brief 响应头部的内容
+ */
+struct ResponseHeader {
+    int32_t code = 0;              ///< 状态码
+    std::string message;           ///< 错误信息
+    uint64_t payload_length = 0;   ///< 消息数据长度
+};
+
+void EncodeRequestHeader(const RequestHeader& header, std::string* out);
+bool DecodeRequestHeader(const char* data, size_t length, RequestHeader* header);
+void EncodeResponseHeader(const ResponseHeader& header, std::string* out);
+bool DecodeResponseHeader(const char* data, size_t length, ResponseHeader* header);
+
+/**
+ * @brief 把一条消息写入环
+ * @param ring 生产者环
+ * @param header_type kRecordRequest 或 kRecordResponse
+ * @param call_id 调用标识
+ * @param header 已编码的头部
+ * @param payload 消息数据
+ * @param deadline 开始写入前等待空间的截止时间
+ * @param on_full 环已满、即将等待空间时调用：检查对端是否存活，
+ *        必要时处理反方向的数据以免双方互相等待；返回错误时放弃写入
+ * @return Status 写入状态；头部超过环容量的四分之一返回 RESOURCE_EXHAUSTED，
+ *         开始写入前超时返回 DEADLINE_EXCEEDED，其余错误来自 on_full
+ *
+ * 头部记录写入后消息必须完整写出，此后只在 on_full 返回错误时失败，
+ * 此时环中留有不完整的消息，调用方必须关闭连接。
+ */
+Status WriteMessage(Ring* ring, uint32_t header_type, uint64_t call_id,
+                    const std::string& header, const std::string& payload,
+                    std::chrono::system_clock::time_point deadline,
+                    const std::function<Status()>& on_full);
+
+} // namespace shm
+} // namespace litegrpc
+
+#endif // LITEGRPC_SHM_RING_H
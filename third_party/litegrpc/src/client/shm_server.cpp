@@ -0,0 +1,325 @@
+/**
+ * @file shm_server.cpp
+ * @brief LiteGRPC 共享内存传输服务端实现
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ *
+ * 本文件实现了 ShmServer：
+ * - 监听线程接受 Unix 域套接字连接，每个连接交给一个服务线程
+ * - 服务线程接收并校验客户端的共享段，发回确认字节后开始读取请求环
+ * - 请求按到达顺序交给处理函数，结果写回响应环
+ */
+
+#include "litegrpc/shm.h"
+#include "litegrpc/client_context.h"
+#include "litegrpc/core.h"
+#include "shm_ring.h"
+#include "../http2/connector.h"
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <thread>
+#include <vector>
+
+namespace litegrpc {
+
+namespace {
+
+const int kHandshakeTimeoutMs = 5000;  ///< 等待客户端交出共享段的时间（毫秒）
+
+} // namespace
+
+/**
+ * @brief 服务端状态
+ */
+struct ShmServerState {
+    /**
+     * @brief 服务线程
+     */
+    struct Worker {
+        std::thread thread;                              ///< 线程
+        std::shared_ptr<std::atomic<bool>> finished;     ///< 线程已退出，可以回收
+    };
+
+    std::string target;                 ///< 监听地址
+    InprocHandler handler;              ///< 处理函数
+    int listen_fd = -1;                 ///< 监听套接字
+    std::string socket_path;            ///< 文件系统套接字路径（抽象命名空间为空）
+    std::atomic<bool> stopping{false};  ///< 正在停止
+    std::thread accept_thread;          ///< 监听线程
+    std::list<Worker> workers;          ///< 服务线程（只由监听线程与 Shutdown() 访问）
+
+    void AcceptLoop();
+    void ServeConnection(int fd);
+    void ReapWorkers(bool all);
+};
+
+/**
+ * @brief 回收已退出的服务线程
+ * @param all 为 true 时等待所有服务线程退出
+ */
+void ShmServerState::ReapWorkers(bool all) {
+    for (auto it = workers.begin(); it != workers.end();) {
+        if (all || *it->finished) {
+            it->thread.join();
+            it = workers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief 监听线程主循环
+ *
+ * 按 kLivenessCheckMs 的间隔检查停止标志。
+ */
+void ShmServerState::AcceptLoop() {
+    while (!stopping) {
+        struct pollfd pfd;
+        pfd.fd = listen_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, shm::kLivenessCheckMs) > 0) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0) {
+                Worker worker;
+                worker.finished = std::make_shared<std::atomic<bool>>(false);
+                auto finished = worker.finished;
+                worker.thread = std::thread([this, fd, finished]() {
+                    ServeConnection(fd);
+                    *finished = true;
+                });
+                workers.push_back(std::move(worker));
+            }
+        }
+        ReapWorkers(false);
+    }
+}
+
+/**
+ * @brief 服务一个连接
+ *
+ * 步骤：
+ * 1. 接收客户端的 memfd，映射并校验共享段，发回确认字节
+ * 2. 读取请求环：头部记录开始一个请求，数据记录追加到请求数据，
+ *    带 kRecordEnd 的记录结束请求
+ * 3. 请求超过消息大小上限时丢弃其数据并返回 RESOURCE_EXHAUSTED；
+ *    到达时已超过截止时间则直接返回 DEADLINE_EXCEEDED，否则调用处理函数
+ * 4. 把状态与响应数据写回响应环；响应环已满时检查客户端是否存活
+ * 5. 客户端断开、共享段损坏或服务端停止时关闭连接
+ */
+void ShmServerState::ServeConnection(int fd) {
+    int memfd = -1;
+    shm::Segment segment;
+    auto status = shm::ReceiveDescriptor(fd, kHandshakeTimeoutMs, &memfd);
+    if (status.ok()) {
+        status = shm::MapSegment(memfd, &segment);
+        close(memfd);
+    }
+    char ack = 1;
+    if (!status.ok() || send(fd, &ack, 1, MSG_NOSIGNAL) != 1) {
+        segment.Unmap();
+        close(fd);
+        return;
+    }
+
+    auto* header = segment.header();
+    shm::Ring requests;
+    shm::Ring responses;
+    requests.Attach(&header->request, segment.request_data(), header->ring_capacity);
+    responses.Attach(&header->response, segment.response_data(), header->ring_capacity);
+
+    auto on_full = [this, fd]() {
+        if (stopping || !shm::PeerAlive(fd)) {
+            return Status::Unavailable("Shared-memory client disconnected");
+        }
+        return Status::OK();
+    };
+
+    shm::RequestHeader request;
+    std::string request_data;
+    uint64_t call_id = 0;
+    bool receiving = false;
+    uint64_t received_length = 0;  // 当前请求已收到的数据字节数
+    bool oversized = false;        // 当前请求超过消息大小上限
+    const uint64_t max_message_size = static_cast<uint64_t>(Config::DEFAULT_MAX_MESSAGE_SIZE);
+    shm::RecordHeader record;
+    const char* data = nullptr;
+    bool corrupt = false;
+
+    while (!stopping) {
+        if (!requests.Peek(&record, &data, &corrupt)) {
+            if (corrupt) {
+                break;
+            }
+            if (!requests.WaitForData(shm::kLivenessCheckMs) && !shm::PeerAlive(fd)) {
+                break;
+            }
+            continue;
+        }
+
+        if (record.type == shm::kRecordRequest) {
+            if (!shm::DecodeRequestHeader(data, record.length, &request)) {
+                break;
+            }
+            call_id = record.call_id;
+            receiving = true;
+            request_data.clear();
+            received_length = 0;
+            oversized = request.payload_length > max_message_size;
+            if (!oversized) {
+                request_data.reserve(std::min<uint64_t>(request.payload_length, header->ring_capacity));
+            }
+        } else if (record.type == shm::kRecordData && receiving && record.call_id == call_id) {
+            // 超过上限后丢弃剩余数据记录，不再缓冲
+            received_length += record.length;
+            if (received_length > max_message_size) {
+                oversized = true;
+                std::string().swap(request_data);
+            }
+            if (!oversized) {
+                request_data.append(data, record.length);
+            }
+        } else {
+            break;
+        }
+        bool end = (record.flags & shm::kRecordEnd) != 0;
+        requests.Consume();
+        if (!end) {
+            continue;
+        }
+        receiving = false;
+
+        ClientContext context;
+        for (const auto& entry : request.metadata) {
+            context.AddMetadata(entry.first, entry.second);
+        }
+        if (request.deadline_ns != 0) {
+            context.set_deadline(std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(request.deadline_ns))));
+        }
+
+        std::string response_data;
+        Status result;
+        if (oversized) {
+            result = Status::ResourceExhausted("Received message larger than max (" +
+                                               std::to_string(std::max(request.payload_length, received_length)) +
+                                               " vs. " + std::to_string(max_message_size) + ")");
+        } else if (context.IsExpired()) {
+            result = Status::DeadlineExceeded("Request deadline exceeded");
+        } else {
+            result = handler(request.method, &context, request_data, &response_data);
+        }
+        if (!result.ok()) {
+            response_data.clear();
+        }
+
+        shm::ResponseHeader response;
+        response.code = static_cast<int32_t>(result.error_code());
+        response.message = result.error_message();
+        response.payload_length = response_data.size();
+        std::string encoded;
+        shm::EncodeResponseHeader(response, &encoded);
+        status = shm::WriteMessage(&responses, shm::kRecordResponse, call_id, encoded, response_data,
+                                   std::chrono::system_clock::time_point::max(), on_full);
+        if (!status.ok()) {
+            break;
+        }
+    }
+
+    segment.Unmap();
+    close(fd);
+}
+
+ShmServer::ShmServer(const std::string& target, InprocHandler handler)
+    : state_(new ShmServerState) {
+    state_->target = target;
+    state_->handler = std::move(handler);
+}
+
+ShmServer::~ShmServer() {
+    Shutdown();
+}
+
+/**
+ * @brief 开始监听并接受连接
+ *
+ * 文件系统路径上只替换已有的套接字文件，其他类型的文件保持不变并返回错误。
+ */
+Status ShmServer::Start() {
+    if (state_->listen_fd >= 0) {
+        return Status::FailedPrecondition("ShmServer already started");
+    }
+    if (!state_->handler) {
+        return Status::InvalidArgument("ShmServer requires a handler");
+    }
+    std::string socket_target;
+    auto status = shm::SocketTarget(state_->target, &socket_target);
+    if (!status.ok()) {
+        return status;
+    }
+    std::vector<http2::ResolvedAddress> addresses;
+    status = http2::ResolveHost(socket_target, 0, &addresses);
+    if (!status.ok()) {
+        return status;
+    }
+    const auto& address = addresses.front();
+    const auto* sun = reinterpret_cast<const struct sockaddr_un*>(&address.storage);
+    std::string socket_path;
+    if (sun->sun_path[0] != '\0') {
+        socket_path = sun->sun_path;
+        struct stat st;
+        if (lstat(socket_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+            unlink(socket_path.c_str());
+        }
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return Status::Unavailable("Failed to create socket: " + std::string(strerror(errno)));
+    }
+    if (bind(fd, reinterpret_cast<const struct sockaddr*>(&address.storage), address.length) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        int err = errno;
+        close(fd);
+        return Status::Unavailable("Failed to listen on " + address.ToString() + ": " + strerror(err));
+    }
+
+    state_->listen_fd = fd;
+    state_->socket_path = socket_path;
+    state_->stopping = false;
+    ShmServerState* state = state_.get();
+    state_->accept_thread = std::thread([state]() { state->AcceptLoop(); });
+    return Status::OK();
+}
+
+/**
+ * @brief 停止服务
+ *
+ * 服务线程在下一次检查停止标志时退出；正在执行的处理函数会先执行完毕。
+ */
+void ShmServer::Shutdown() {
+    if (state_->listen_fd < 0) {
+        return;
+    }
+    state_->stopping = true;
+    state_->accept_thread.join();
+    state_->ReapWorkers(true);
+    close(state_->listen_fd);
+    state_->listen_fd = -1;
+    if (!state_->socket_path.empty()) {
+        unlink(state_->socket_path.c_str());
+    }
+}
+
+} // namespace litegrpc
@@ -14,11 +14,13 @@
  * - 权威名称管理：设置目标服务的权威名称
  * - 压缩算法管理：配置请求压缩算法
  * - 用户代理管理：设置客户端用户代理信息
+ * - 优先级管理：设置 RFC 9218 紧急度与交错标志
  * - 上下文重置：清理所有上下文信息
  * - 超时检查：判断调用是否已过期
  */
 
 #include "litegrpc/client_context.h"
+#include <algorithm>
 #include <chrono>
 
 namespace litegrpc {
@@ -141,6 +143,31 @@ const std::string& ClientContext::user_agent_prefix() const {
     return user_agent_prefix_;
 }
 
+/**
+ * @brief 设置调用优先级
+ * @param urgency 紧急度（0 最高，7 最低）
+ * @param incremental 是否可交错处理
+ * 
+ * 超出范围的紧急度截断到边界，发送给服务器的值总是有效的。
+ */
+void ClientContext::set_priority(int urgency, bool incremental) {
+    urgency_ = std::min(std::max(urgency, kUrgencyHighest), kUrgencyLowest);
+    incremental_ = incremental;
+    has_priority_ = true;
+}
+
+int ClientContext::priority_urgency() const {
+    return urgency_;
+}
+
+bool ClientContext::priority_incremental() const {
+    return incremental_;
+}
+
+bool ClientContext::has_priority() const {
+    return has_priority_;
+}
+
 /**
  * @brief 重置上下文
  * 
@@ -155,6 +182,9 @@ void ClientContext::Reset() {
     authority_.clear();
     compression_algorithm_.clear();
     user_agent_prefix_.clear();
+    urgency_ = kUrgencyDefault;
+    incremental_ = false;
+    has_priority_ = false;
 }
 
 /**
@@ -17,6 +17,7 @@
  */
 
 #include "litegrpc/credentials.h"
+#include "../http2/tls_context.h"
 
 namespace litegrpc {
 
@@ -37,6 +38,36 @@ const std::string ChannelArguments::GRPC_ARG_HTTP2_MIN_RECV_PING_INTERVAL_WITHOU
 const std::string ChannelArguments::GRPC_ARG_MAX_CONNECTION_IDLE_MS = "grpc.max_connection_idle_ms";                               ///< 最大连接空闲时间（毫秒）
 const std::string ChannelArguments::GRPC_ARG_MAX_CONNECTION_AGE_MS = "grpc.max_connection_age_ms";                                 ///< 最大连接存活时间（毫秒）
 const std::string ChannelArguments::GRPC_ARG_MAX_CONNECTION_AGE_GRACE_MS = "grpc.max_connection_age_grace_ms";                     ///< 连接存活宽限时间（毫秒）
+const std::string ChannelArguments::GRPC_ARG_HTTP2_BDP_PROBE = "grpc.http2.bdp_probe";                                             ///< 是否启用 BDP 探测
+const std::string ChannelArguments::GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES = "grpc.http2.lookahead_bytes";                          ///< 流级初始接收窗口（字节）
+
+/**
+ * @brief LiteGRPC 扩展通道参数常量定义
+ * 
+ * 标准 gRPC 中没有对应项的传输层调优参数，统一使用 "litegrpc." 前缀。
+ */
+const std::string ChannelArguments::LITEGRPC_ARG_TCP_CORK = "litegrpc.tcp_cork";                                                     ///< 批量写入时使用 TCP_CORK
+const std::string ChannelArguments::LITEGRPC_ARG_ZEROCOPY_SEND_THRESHOLD = "litegrpc.zerocopy_send_threshold";                     ///< MSG_ZEROCOPY 发送阈值（字节）
+const std::string ChannelArguments::LITEGRPC_ARG_HTTP2_CONNECTION_WINDOW_SIZE = "litegrpc.http2.connection_window_size";           ///< 连接级接收窗口（字节）
+const std::string ChannelArguments::LITEGRPC_ARG_HTTP2_SESSION_MEMORY_LIMIT = "litegrpc.http2.session_memory_limit";               ///< 会话内存预算（字节）
+const std::string ChannelArguments::LITEGRPC_ARG_SOCKET_PROFILE = "litegrpc.socket_profile";                                         ///< 套接字预设
+const std::string ChannelArguments::LITEGRPC_ARG_TCP_NODELAY = "litegrpc.tcp_nodelay";                                               ///< TCP_NODELAY
+const std::string ChannelArguments::LITEGRPC_ARG_SOCKET_SEND_BUFFER = "litegrpc.socket_send_buffer";                                 ///< SO_SNDBUF（字节）
+const std::string ChannelArguments::LITEGRPC_ARG_SOCKET_RECV_BUFFER = "litegrpc.socket_recv_buffer";                                 ///< SO_RCVBUF（字节）
+const std::string ChannelArguments::LITEGRPC_ARG_TCP_USER_TIMEOUT_MS = "litegrpc.tcp_user_timeout_ms";                               ///< TCP_USER_TIMEOUT（毫秒）
+const std::string ChannelArguments::LITEGRPC_ARG_SOCKET_BUSY_POLL_US = "litegrpc.socket_busy_poll_us";                               ///< SO_BUSY_POLL（微秒）
+const std::string ChannelArguments::LITEGRPC_ARG_TCP_QUICKACK = "litegrpc.tcp_quickack";                                             ///< TCP_QUICKACK
+const std::string ChannelArguments::LITEGRPC_ARG_IO_URING = "litegrpc.io_uring";                                                     ///< io_uring I/O 后端
+const std::string ChannelArguments::LITEGRPC_ARG_IO_THREAD = "litegrpc.io_thread";                                                   ///< 独占 I/O 线程
+const std::string ChannelArguments::LITEGRPC_ARG_KTLS = "litegrpc.ktls";                                                             ///< 内核 TLS
+const std::string ChannelArguments::LITEGRPC_ARG_SHM_RING_SIZE = "litegrpc.shm.ring_size";                                           ///< 共享内存环容量（字节）
+const std::string ChannelArguments::LITEGRPC_ARG_TLS_SESSION_RESUMPTION = "litegrpc.tls.session_resumption";                         ///< TLS 会话恢复
+const std::string ChannelArguments::LITEGRPC_ARG_TLS_TICKET_STORE_PATH = "litegrpc.tls.ticket_store_path";                           ///< TLS 会话磁盘存储路径
+const std::string ChannelArguments::LITEGRPC_ARG_TLS_TICKET_STORE_ENTRIES = "litegrpc.tls.ticket_store_entries";                     ///< TLS 会话磁盘存储槽位数
+const std::string ChannelArguments::LITEGRPC_ARG_DNS_SERVER = "litegrpc.dns.server";                                                 ///< 直接查询的 DNS 服务器
+const std::string ChannelArguments::LITEGRPC_ARG_DNS_HOSTS_FILE = "litegrpc.dns.hosts_file";                                         ///< hosts 格式的解析文件
+const std::string ChannelArguments::LITEGRPC_ARG_DNS_DEFAULT_TTL_MS = "litegrpc.dns.default_ttl_ms";                                 ///< 无 TTL 时的缓存时间（毫秒）
+const std::string ChannelArguments::LITEGRPC_ARG_DNS_NEGATIVE_TTL_MS = "litegrpc.dns.negative_ttl_ms";                               ///< 失败结果缓存时间（毫秒）
 
 /**
  * @brief 设置整数类型参数
@@ -123,6 +154,25 @@ bool ChannelArguments::GetPointer(const std::string& key, void** value) const {
     return false;
 }
 
+// SslChannelCredentialsImpl 实现
+
+/**
+ * @brief 获取由本凭证构建的 TLS 上下文
+ * @param context 输出参数，共享的不可变 TLS 上下文
+ * @return 构建结果
+ * 
+ * 首次调用时解析根证书、客户端证书链与私钥并构建 SSL_CTX，
+ * 并发的首次调用只会构建一次。之后直接返回缓存的上下文与状态，
+ * 重连无需重新解析证书。
+ */
+Status SslChannelCredentialsImpl::GetTlsContext(std::shared_ptr<http2::TlsContext>* context) const {
+    std::call_once(tls_once_, [this]() {
+        tls_status_ = http2::TlsContext::Create(options_, &tls_context_);
+    });
+    *context = tls_context_;
+    return tls_status_;
+}
+
 // 凭证工厂函数
 
 /**
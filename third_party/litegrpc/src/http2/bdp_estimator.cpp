@@ -0,0 +1,73 @@
+/**
+ * @file bdp_estimator.cpp
+ * @brief 带宽时延积（BDP）估计器实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "bdp_estimator.h"
+#include <algorithm>  // std::max, std::min
+
+namespace litegrpc {
+namespace http2 {
+
+/// 估计值不再增长时探测间隔的上限
+static const std::chrono::milliseconds kMaxInterPingDelay(10000);
+
+BdpEstimator::BdpEstimator(int64_t initial_estimate)
+    : estimate_(initial_estimate) {
+}
+
+/**
+ * @brief 是否应发送新的探测 PING
+ */
+bool BdpEstimator::NeedPing(Clock::time_point now) const {
+    return !ping_in_flight_ && now >= next_ping_;
+}
+
+/**
+ * @brief 标记探测 PING 已提交
+ *
+ * 累计值从零开始，ACK 到达时它近似等于一个 RTT 内收到的数据量。
+ */
+void BdpEstimator::StartPing(Clock::time_point now) {
+    ping_in_flight_ = true;
+    ping_start_ = now;
+    accumulator_ = 0;
+}
+
+/**
+ * @brief 处理探测 PING 的 ACK
+ *
+ * 步骤：
+ * 1. 由累计字节数和往返时间计算本次带宽
+ * 2. 累计量超过估计值的 2/3（窗口可能已成为瓶颈）且带宽创新高时，
+ *    估计值取 max(累计量, 2 * 估计值)，探测间隔恢复为 100ms
+ * 3. 否则探测间隔乘以 1.5，最长 10s
+ */
+bool BdpEstimator::CompletePing(Clock::time_point now) {
+    ping_in_flight_ = false;
+
+    const double seconds = std::chrono::duration<double>(now - ping_start_).count();
+    const double bandwidth = seconds > 0 ? static_cast<double>(accumulator_) / seconds : 0;
+
+    bool grew = false;
+    if (accumulator_ > 2 * estimate_ / 3 && bandwidth > bandwidth_) {
+        estimate_ = std::max(accumulator_, estimate_ * 2);
+        bandwidth_ = bandwidth;
+        inter_ping_delay_ = std::chrono::milliseconds(100);
+        grew = true;
+    } else {
+        inter_ping_delay_ = std::min(kMaxInterPingDelay,
+            std::chrono::milliseconds(inter_ping_delay_.count() * 3 / 2));
+    }
+
+    accumulator_ = 0;
+    next_ping_ = now + inter_ping_delay_;
+    return grew;
+}
+
+} // namespace http2
+} // namespace litegrpc
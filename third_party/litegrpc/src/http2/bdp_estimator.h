@@ -0,0 +1,94 @@
+/**
+ * @file bdp_estimator.h
+ * @brief 带宽时延积（BDP）估计器头文件
+ *
+ * 此文件定义了用于自动调整 HTTP/2 流量控制窗口的 BDP 估计器，
+ * 算法与官方 gRPC 的 BdpEstimator 相同：
+ * - 收到数据时若没有探测在进行，发送一个 PING 并开始累计接收字节数
+ * - 收到 PING ACK 时，累计字节数约等于一个 RTT 内到达的数据量
+ * - 若累计量超过当前估计值的 2/3 且带宽仍在增长，估计值至少翻倍
+ * - 估计值不再增长时逐步拉长探测间隔，减少空闲连接上的 PING
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_BDP_ESTIMATOR_H
+#define LITEGRPC_HTTP2_BDP_ESTIMATOR_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief BDP 估计器
+ *
+ * 只负责计算，不发送任何帧。调用方在收到 DATA 时调用
+ * AddIncomingBytes()，在 NeedPing() 为 true 时发送 PING 并调用
+ * StartPing()，收到对应的 PING ACK 后调用 CompletePing()。
+ *
+ * 线程安全性：非线程安全，由持有连接锁的线程访问。
+ */
+class BdpEstimator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 构造函数
+     * @param initial_estimate 初始估计值（字节），通常为当前接收窗口大小
+     */
+    explicit BdpEstimator(int64_t initial_estimate = 65535);
+
+    /**
+     * @brief 记录收到的 DATA 负载字节数
+     * @param bytes 字节数
+     */
+    void AddIncomingBytes(int64_t bytes) { accumulator_ += bytes; }
+
+    /**
+     * @brief 是否应发送新的探测 PING
+     * @param now 当前时间
+     * @return bool 没有探测在进行且已超过探测间隔时返回 true
+     */
+    bool NeedPing(Clock::time_point now) const;
+
+    /**
+     * @brief 标记探测 PING 已提交
+     * @param now 当前时间
+     */
+    void StartPing(Clock::time_point now);
+
+    /**
+     * @brief 处理探测 PING 的 ACK
+     * @param now 当前时间
+     * @return bool 估计值是否增长
+     */
+    bool CompletePing(Clock::time_point now);
+
+    /**
+     * @brief 探测是否正在进行
+     */
+    bool ping_in_flight() const { return ping_in_flight_; }
+
+    /**
+     * @brief 当前 BDP 估计值（字节）
+     */
+    int64_t estimate() const { return estimate_; }
+
+private:
+    int64_t estimate_;                          ///< BDP 估计值（字节）
+    int64_t accumulator_ = 0;                   ///< 本次探测期间收到的字节数
+    double bandwidth_ = 0;                      ///< 已观测到的最大带宽（字节/秒）
+    bool ping_in_flight_ = false;               ///< 是否有探测 PING 未被确认
+    Clock::time_point ping_start_;              ///< 探测 PING 的发送时间
+    Clock::time_point next_ping_;               ///< 允许发送下一次探测的时间
+    std::chrono::milliseconds inter_ping_delay_{100};  ///< 当前探测间隔
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_BDP_ESTIMATOR_H
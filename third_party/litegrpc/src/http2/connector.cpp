@@ -0,0 +1,375 @@
+/**
+ * @file connector.cpp
+ * @brief TCP 连接建立（Happy Eyeballs）实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "connector.h"
+#include <netdb.h>         // getaddrinfo
+#include <netinet/in.h>    // sockaddr_in, sockaddr_in6
+#include <arpa/inet.h>     // inet_ntop
+#include <sys/un.h>        // sockaddr_un
+#include <cstddef>         // offsetof
+#include <poll.h>          // poll
+#include <unistd.h>        // close
+#include <algorithm>       // std::min, std::find_if
+#include <cerrno>          // errno
+#include <chrono>          // 超时计算
+#include <cstring>         // memcmp, strerror
+#include <map>             // 胜出地址记录
+#include <mutex>           // 胜出地址记录的互斥保护
+
+namespace litegrpc {
+namespace http2 {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief 上次胜出的地址，按 "host:port" 索引
+ */
+std::mutex g_preferred_mutex;
+std::map<std::string, ResolvedAddress> g_preferred;
+
+/**
+ * @brief 比较两个地址是否相同
+ */
+bool SameAddress(const ResolvedAddress& a, const ResolvedAddress& b) {
+    return a.length == b.length && memcmp(&a.storage, &b.storage, a.length) == 0;
+}
+
+/**
+ * @brief 计算距离截止时间的剩余毫秒数
+ * @return int 剩余毫秒数（不小于 0），无截止时间时返回 -1
+ */
+int RemainingMs(bool has_deadline, Clock::time_point deadline) {
+    if (!has_deadline) {
+        return -1;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - Clock::now()).count();
+    return remaining > 0 ? static_cast<int>(remaining) : 0;
+}
+
+/**
+ * @brief 按 RFC 8305 第 4 节排列候选地址
+ *
+ * 以首个地址的地址族为首选族，两族地址交错排列；
+ * 上次胜出的地址（如果仍在列表中）排在最前。
+ */
+std::vector<ResolvedAddress> SortAddresses(const std::string& target,
+                                           const std::vector<ResolvedAddress>& addresses) {
+    std::vector<ResolvedAddress> preferred_family;
+    std::vector<ResolvedAddress> other_family;
+    for (const auto& address : addresses) {
+        if (address.family() == addresses.front().family()) {
+            preferred_family.push_back(address);
+        } else {
+            other_family.push_back(address);
+        }
+    }
+
+    std::vector<ResolvedAddress> sorted;
+    sorted.reserve(addresses.size());
+    for (size_t i = 0; i < preferred_family.size() || i < other_family.size(); ++i) {
+        if (i < preferred_family.size()) {
+            sorted.push_back(preferred_family[i]);
+        }
+        if (i < other_family.size()) {
+            sorted.push_back(other_family[i]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_preferred_mutex);
+    auto it = g_preferred.find(target);
+    if (it != g_preferred.end()) {
+        auto pos = std::find_if(sorted.begin(), sorted.end(), [&](const ResolvedAddress& a) {
+            return SameAddress(a, it->second);
+        });
+        if (pos != sorted.end()) {
+            std::rotate(sorted.begin(), pos, pos + 1);
+        }
+    }
+    return sorted;
+}
+
+const size_t kUnixPrefixLen = sizeof(kUnixPrefix) - 1;                  ///< "unix:" 的长度
+const size_t kUnixAbstractPrefixLen = sizeof(kUnixAbstractPrefix) - 1;  ///< "unix-abstract:" 的长度
+
+} // namespace
+
+/**
+ * @brief 转换为可读字符串
+ */
+std::string ResolvedAddress::ToString() const {
+    char buf[INET6_ADDRSTRLEN] = {0};
+    if (family() == AF_UNIX) {
+        const auto* sun = reinterpret_cast<const struct sockaddr_un*>(&storage);
+        const size_t path_len = length - offsetof(struct sockaddr_un, sun_path);
+        if (path_len > 0 && sun->sun_path[0] == '\0') {
+            return std::string(kUnixAbstractPrefix) + std::string(sun->sun_path + 1, path_len - 1);
+        }
+        return std::string(kUnixPrefix) + std::string(sun->sun_path);
+    }
+    if (family() == AF_INET6) {
+        const auto* sin6 = reinterpret_cast<const struct sockaddr_in6*>(&storage);
+        inet_ntop(AF_INET6, &sin6->sin6_addr, buf, sizeof(buf));
+        return "[" + std::string(buf) + "]:" + std::to_string(ntohs(sin6->sin6_port));
+    }
+    const auto* sin = reinterpret_cast<const struct sockaddr_in*>(&storage);
+    inet_ntop(AF_INET, &sin->sin_addr, buf, sizeof(buf));
+    return std::string(buf) + ":" + std::to_string(ntohs(sin->sin_port));
+}
+
+/**
+ * @brief 是否为 Unix 域套接字目标
+ */
+bool IsUnixSocketTarget(const std::string& target) {
+    return target.compare(0, kUnixPrefixLen, kUnixPrefix) == 0 ||
+           target.compare(0, kUnixAbstractPrefixLen, kUnixAbstractPrefix) == 0;
+}
+
+/**
+ * @brief 由 Unix 域套接字目标构造地址
+ *
+ * 支持的形式（与 gRPC 命名约定一致）：
+ * - unix:path 或 unix:/absolute/path：文件系统路径，可以是相对路径
+ * - unix:///absolute/path：文件系统路径，必须是绝对路径
+ * - unix-abstract:name：Linux 抽象命名空间，sun_path 以 NUL 开头，
+ *   地址长度只覆盖名字本身，名字中可以包含任意字节，但不能为空
+ */
+static Status ResolveUnixSocket(const std::string& target, std::vector<ResolvedAddress>* addresses) {
+    ResolvedAddress address;
+    memset(&address.storage, 0, sizeof(address.storage));
+    auto* sun = reinterpret_cast<struct sockaddr_un*>(&address.storage);
+    sun->sun_family = AF_UNIX;
+
+    if (target.compare(0, kUnixAbstractPrefixLen, kUnixAbstractPrefix) == 0) {
+        const std::string name = target.substr(kUnixAbstractPrefixLen);
+        if (name.empty()) {
+            // 与空的 unix: 路径一样视为无效目标，而不是去连接名字为空的抽象地址
+            return Status::InvalidArgument("Empty abstract socket name: " + target);
+        }
+        if (name.size() + 1 > sizeof(sun->sun_path)) {
+            return Status::InvalidArgument("Abstract socket name too long: " + target);
+        }
+        memcpy(sun->sun_path + 1, name.data(), name.size());
+        address.length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + 1 + name.size());
+    } else {
+        std::string path = target.substr(kUnixPrefixLen);
+        if (path.compare(0, 2, "//") == 0) {
+            path = path.substr(2);
+            if (path.empty() || path[0] != '/') {
+                return Status::InvalidArgument("unix:// target requires an absolute path: " + target);
+            }
+        }
+        if (path.empty() || path.size() + 1 > sizeof(sun->sun_path)) {
+            return Status::InvalidArgument("Invalid Unix socket path: " + target);
+        }
+        memcpy(sun->sun_path, path.data(), path.size());
+        address.length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size() + 1);
+    }
+
+    addresses->clear();
+    addresses->push_back(address);
+    return Status::OK();
+}
+
+/**
+ * @brief 解析主机名
+ *
+ * getaddrinfo 返回的顺序已按 RFC 6724 的目的地址选择规则排序。
+ * Unix 域套接字目标不经过 getaddrinfo，直接构造地址。
+ */
+Status ResolveHost(const std::string& host, int port, std::vector<ResolvedAddress>* addresses) {
+    if (IsUnixSocketTarget(host)) {
+        return ResolveUnixSocket(host, addresses);
+    }
+    
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;      // 支持 IPv4 和 IPv6
+    hints.ai_socktype = SOCK_STREAM;  // TCP 套接字
+
+    int rv = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result);
+    if (rv != 0) {
+        return Status::Unavailable("Failed to resolve host: " + std::string(gai_strerror(rv)));
+    }
+
+    addresses->clear();
+    for (struct addrinfo* ai = result; ai; ai = ai->ai_next) {
+        if (ai->ai_family != AF_INET && ai->ai_family != AF_INET6) {
+            continue;
+        }
+        ResolvedAddress address;
+        memset(&address.storage, 0, sizeof(address.storage));
+        memcpy(&address.storage, ai->ai_addr, ai->ai_addrlen);
+        address.length = ai->ai_addrlen;
+        addresses->push_back(address);
+    }
+    freeaddrinfo(result);
+
+    if (addresses->empty()) {
+        return Status::Unavailable("Failed to resolve host: no usable address for " + host);
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 以 Happy Eyeballs 方式连接
+ *
+ * 步骤：
+ * 1. 按 SortAddresses() 的顺序排列候选地址
+ * 2. 没有进行中的尝试、或距上一次尝试已超过 kConnectionAttemptDelayMs 时，
+ *    对下一个地址创建套接字、调用 prepare 并发起非阻塞 connect
+ * 3. 用 poll 同时等待所有进行中的尝试；某个尝试失败时立即发起下一个
+ * 4. 第一个成功的连接胜出，关闭其余套接字并记录胜出地址
+ */
+Status ConnectHappyEyeballs(const std::string& target,
+                            const std::vector<ResolvedAddress>& addresses,
+                            int timeout_ms, int* fd,
+                            const std::function<void(int)>& prepare) {
+    struct Attempt {
+        int fd;
+        size_t index;
+    };
+
+    const std::vector<ResolvedAddress> candidates = SortAddresses(target, addresses);
+    const bool has_deadline = timeout_ms >= 0;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(
+        has_deadline ? timeout_ms : 0);
+
+    std::vector<Attempt> pending;
+    size_t next = 0;
+    Clock::time_point next_attempt = Clock::now();
+    Status last_error = Status::Unavailable("No address to connect to " + target);
+
+    auto close_pending = [&pending]() {
+        for (const Attempt& attempt : pending) {
+            close(attempt.fd);
+        }
+        pending.clear();
+    };
+    auto finish = [&](int winner_fd, size_t index) {
+        *fd = winner_fd;
+        std::lock_guard<std::mutex> lock(g_preferred_mutex);
+        g_preferred[target] = candidates[index];
+        return Status::OK();
+    };
+
+    while (true) {
+        if (has_deadline && Clock::now() >= deadline) {
+            close_pending();
+            return Status::DeadlineExceeded("Connect to " + target + " timed out");
+        }
+
+        // 发起下一个连接尝试
+        if (next < candidates.size() && (pending.empty() || Clock::now() >= next_attempt)) {
+            const ResolvedAddress& address = candidates[next];
+            const size_t index = next++;
+            next_attempt = Clock::now() + std::chrono::milliseconds(kConnectionAttemptDelayMs);
+
+            int s = socket(address.family(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (s < 0) {
+                last_error = Status::Unavailable("Failed to create socket: " +
+                                                 std::string(strerror(errno)));
+                continue;
+            }
+            if (prepare) {
+                prepare(s);
+            }
+            if (connect(s, reinterpret_cast<const struct sockaddr*>(&address.storage),
+                        address.length) == 0) {
+                close_pending();
+                return finish(s, index);
+            }
+            if (errno != EINPROGRESS) {
+                last_error = Status::Unavailable("Failed to connect to " + address.ToString() +
+                                                 ": " + std::string(strerror(errno)));
+                close(s);
+                continue;
+            }
+            pending.push_back(Attempt{s, index});
+            continue;
+        }
+
+        if (pending.empty()) {
+            return last_error;  // 所有地址都已失败
+        }
+
+        // 等待进行中的尝试完成，最多等到下一次尝试的时间点或截止时间
+        int wait_ms = RemainingMs(has_deadline, deadline);
+        if (next < candidates.size()) {
+            int until_next = RemainingMs(true, next_attempt);
+            wait_ms = wait_ms < 0 ? until_next : std::min(wait_ms, until_next);
+        }
+
+        std::vector<struct pollfd> pfds(pending.size());
+        for (size_t i = 0; i < pending.size(); ++i) {
+            pfds[i].fd = pending[i].fd;
+            pfds[i].events = POLLOUT;
+            pfds[i].revents = 0;
+        }
+        int n = poll(pfds.data(), pfds.size(), wait_ms);
+        if (n < 0 && errno != EINTR) {
+            int err = errno;
+            close_pending();
+            return Status::Internal("poll failed: " + std::string(strerror(err)));
+        }
+        if (n <= 0) {
+            continue;
+        }
+
+        // 检查完成的尝试，倒序遍历以便原地移除
+        for (size_t i = pending.size(); i-- > 0;) {
+            if (pfds[i].revents == 0) {
+                continue;
+            }
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (getsockopt(pending[i].fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) {
+                err = errno;
+            }
+            if (err == 0) {
+                const Attempt winner = pending[i];
+                pending.erase(pending.begin() + i);
+                close_pending();
+                return finish(winner.fd, winner.index);
+            }
+            last_error = Status::Unavailable("Failed to connect to " +
+                                             candidates[pending[i].index].ToString() + ": " +
+                                             std::string(strerror(err)));
+            close(pending[i].fd);
+            pending.erase(pending.begin() + i);
+            next_attempt = Clock::now();  // 失败后立即尝试下一个地址
+        }
+    }
+}
+
+/**
+ * @brief 等待非阻塞套接字就绪
+ */
+Status WaitForSocket(int fd, bool want_write, int timeout_ms) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = want_write ? POLLOUT : POLLIN;
+    pfd.revents = 0;
+    int n;
+    do {
+        n = poll(&pfd, 1, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return Status::Internal("poll failed: " + std::string(strerror(errno)));
+    }
+    if (n == 0) {
+        return Status::DeadlineExceeded("Timed out waiting for socket");
+    }
+    return Status::OK();
+}
+
+} // namespace http2
+} // namespace litegrpc
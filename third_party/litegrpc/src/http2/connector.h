@@ -0,0 +1,110 @@
+/**
+ * @file connector.h
+ * @brief TCP 连接建立（Happy Eyeballs）头文件
+ *
+ * 此文件定义了 Http2Client 建立 TCP 连接所用的地址解析与连接函数。
+ * 连接过程遵循 RFC 8305（Happy Eyeballs v2）：
+ * - 解析出的所有地址按地址族交错排列，首选族由解析结果的首个地址决定
+ * - 依次发起非阻塞连接，前一个尝试在 kConnectionAttemptDelayMs 内
+ *   未完成或已失败时立即开始下一个，多个尝试并行竞争
+ * - 第一个完成的连接胜出，其余连接全部关闭
+ * - 整个过程受调用方给出的超时约束，不会因为某条不可达的路由
+ *   （例如失效的 IPv6 路由）而等待内核的 SYN 重试周期
+ *
+ * 胜出的地址会按 "host:port" 记录在进程内，下次连接同一目标时优先尝试。
+ *
+ * 同机部署时目标也可以是 Unix 域套接字（unix:path、unix-abstract:name），
+ * 此时只有一个候选地址，连接不经过 TCP/IP 协议栈。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_CONNECTOR_H
+#define LITEGRPC_HTTP2_CONNECTOR_H
+
+#include <sys/socket.h>        // sockaddr_storage, socklen_t
+#include <functional>
+#include <string>
+#include <vector>
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 已解析的套接字地址
+ */
+struct ResolvedAddress {
+    struct sockaddr_storage storage;  ///< 地址数据
+    socklen_t length = 0;             ///< 地址长度
+
+    /**
+     * @brief 地址族（AF_INET / AF_INET6 / AF_UNIX）
+     */
+    int family() const { return storage.ss_family; }
+
+    /**
+     * @brief 转换为可读字符串，如 "127.0.0.1:80"、"[::1]:80" 或 "unix:/run/agent.sock"
+     */
+    std::string ToString() const;
+};
+
+/// Unix 域套接字目标的前缀：文件系统路径与 Linux 抽象命名空间
+static const char kUnixPrefix[] = "unix:";
+static const char kUnixAbstractPrefix[] = "unix-abstract:";
+
+/// 相邻两次连接尝试之间的间隔（RFC 8305 推荐值）
+static const int kConnectionAttemptDelayMs = 250;
+
+/**
+ * @brief 是否为 Unix 域套接字目标
+ * @param target 目标地址
+ * @return bool 以 unix: 或 unix-abstract: 开头时返回 true
+ */
+bool IsUnixSocketTarget(const std::string& target);
+
+/**
+ * @brief 解析主机名
+ * @param host 主机名、IP 地址字面量或 Unix 域套接字目标
+ * @param port 端口号（Unix 域套接字目标忽略）
+ * @param addresses 输出参数，按系统首选顺序（RFC 6724）排列的地址列表
+ * @return Status 解析状态，失败返回 UNAVAILABLE；Unix 域套接字路径无效时返回 INVALID_ARGUMENT
+ */
+Status ResolveHost(const std::string& host, int port, std::vector<ResolvedAddress>* addresses);
+
+/**
+ * @brief 以 Happy Eyeballs 方式连接到一组候选地址
+ * @param target 目标标识（"host:port"），用于记录和查找上次胜出的地址
+ * @param addresses 候选地址列表
+ * @param timeout_ms 超时时间（毫秒），-1 表示不限时
+ * @param fd 输出参数，已连接的非阻塞套接字
+ * @param prepare 可选，每个尝试的套接字在 connect 之前调用，用于设置
+ *        必须在握手前生效的选项（例如 SO_RCVBUF 决定 SYN 中的窗口缩放因子）
+ * @return Status 连接状态；超时返回 DEADLINE_EXCEEDED，
+ *         所有地址都失败返回 UNAVAILABLE（附最后一个错误）
+ *
+ * 返回的套接字已设置 O_NONBLOCK 和 FD_CLOEXEC。失败时不会遗留
+ * 任何打开的文件描述符。
+ */
+Status ConnectHappyEyeballs(const std::string& target,
+                            const std::vector<ResolvedAddress>& addresses,
+                            int timeout_ms, int* fd,
+                            const std::function<void(int)>& prepare = nullptr);
+
+/**
+ * @brief 等待非阻塞套接字可读或可写
+ * @param fd 套接字
+ * @param want_write true 等待可写，false 等待可读
+ * @param timeout_ms 超时时间（毫秒），-1 表示不限时
+ * @return Status 就绪返回 OK，超时返回 DEADLINE_EXCEEDED
+ *
+ * 用于连接阶段（例如非阻塞 TLS 握手）的同步等待。
+ */
+Status WaitForSocket(int fd, bool want_write, int timeout_ms);
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_CONNECTOR_H
@@ -0,0 +1,137 @@
+/**
+ * @file event_loop.cpp
+ * @brief HTTP/2 传输层事件循环实现文件
+ *
+ * 基于 Linux epoll 的边沿触发事件循环实现。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "event_loop.h"
+#include <sys/epoll.h>     // epoll 接口
+#include <sys/eventfd.h>   // eventfd 唤醒
+#include <unistd.h>        // close
+#include <cerrno>          // errno
+#include <cstring>         // strerror
+
+namespace litegrpc {
+namespace http2 {
+
+EventLoop::~EventLoop() {
+    Detach();
+}
+
+/**
+ * @brief 注册套接字
+ *
+ * 创建 epoll 实例并以边沿触发方式监听读、写和对端关闭事件，
+ * 同时注册一个水平触发的 eventfd 用于跨线程唤醒。
+ * 重复调用会先释放之前的注册。
+ */
+Status EventLoop::Attach(int fd) {
+    Detach();
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        return Status::Internal("Failed to create epoll instance: " + std::string(strerror(errno)));
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        int err = errno;
+        Detach();
+        return Status::Internal("Failed to register socket with epoll: " + std::string(strerror(err)));
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        int err = errno;
+        Detach();
+        return Status::Internal("Failed to create eventfd: " + std::string(strerror(err)));
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) < 0) {
+        int err = errno;
+        Detach();
+        return Status::Internal("Failed to register eventfd with epoll: " + std::string(strerror(err)));
+    }
+
+    fd_ = fd;
+    return Status::OK();
+}
+
+/**
+ * @brief 注销套接字
+ *
+ * 关闭 epoll 实例即可自动移除所有注册，套接字本身由调用方关闭。
+ */
+void EventLoop::Detach() {
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+    fd_ = -1;
+}
+
+/**
+ * @brief 唤醒等待线程
+ *
+ * eventfd 计数器溢出（EAGAIN）说明已有未处理的唤醒，可以忽略。
+ */
+void EventLoop::Wakeup() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t rv = write(wake_fd_, &one, sizeof(one));
+        (void)rv;
+    }
+}
+
+/**
+ * @brief 等待就绪事件
+ *
+ * 被信号中断（EINTR）时按超时返回，由调用方重新计算剩余时间。
+ */
+Status EventLoop::Wait(int timeout_ms, Events* events) {
+    *events = Events();
+    if (epoll_fd_ < 0) {
+        return Status::Unavailable("Event loop not attached");
+    }
+
+    struct epoll_event evs[2];
+    int n = epoll_wait(epoll_fd_, evs, 2, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) {
+            return Status::OK();
+        }
+        return Status::Internal("epoll_wait failed: " + std::string(strerror(errno)));
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const struct epoll_event& ev = evs[i];
+        if (ev.data.fd == wake_fd_) {
+            uint64_t count;
+            ssize_t rv = read(wake_fd_, &count, sizeof(count));  // 清空计数器
+            (void)rv;
+            events->woken = true;
+            continue;
+        }
+        events->readable = (ev.events & (EPOLLIN | EPOLLRDHUP)) != 0;
+        events->writable = (ev.events & EPOLLOUT) != 0;
+        events->error = (ev.events & (EPOLLERR | EPOLLHUP)) != 0;
+    }
+    return Status::OK();
+}
+
+} // namespace http2
+} // namespace litegrpc
@@ -0,0 +1,96 @@
+/**
+ * @file event_loop.h
+ * @brief HTTP/2 传输层事件循环头文件
+ *
+ * 此文件定义了基于 epoll 的非阻塞事件循环，供 Http2Client 驱动
+ * nghttp2 会话的读写。套接字以边沿触发（EPOLLET）方式注册，
+ * 调用方在读写返回 EAGAIN 之后才进入等待，从而避免忙等待和
+ * 固定的轮询延迟。另有一个 eventfd 用于其他线程唤醒正在等待的
+ * 事件循环（例如提交了新的请求）。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_EVENT_LOOP_H
+#define LITEGRPC_HTTP2_EVENT_LOOP_H
+
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 单套接字 epoll 事件循环
+ *
+ * 每个连接拥有一个 EventLoop 实例。套接字以 EPOLLIN | EPOLLOUT |
+ * EPOLLRDHUP | EPOLLET 注册一次，之后只需调用 Wait() 等待就绪事件。
+ *
+ * 边沿触发语义：
+ * - 调用方必须在读/写返回 EAGAIN 后才调用 Wait()
+ * - Wait() 只报告自上次等待以来新发生的就绪事件
+ *
+ * 线程安全性：
+ * - Attach()/Detach()/Wait() 由持有连接锁的线程调用
+ * - Wakeup() 可在任意线程调用
+ */
+class EventLoop {
+public:
+    /**
+     * @brief 就绪事件集合
+     */
+    struct Events {
+        bool readable = false;  ///< 套接字可读（或对端关闭）
+        bool writable = false;  ///< 套接字可写
+        bool error = false;     ///< 套接字出错或被挂断
+        bool woken = false;     ///< 被 Wakeup() 唤醒
+    };
+
+    EventLoop() = default;
+
+    /**
+     * @brief 析构函数，关闭 epoll 文件描述符
+     */
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief 将套接字注册到事件循环
+     * @param fd 已设置为非阻塞模式的套接字
+     * @return Status 注册状态
+     */
+    Status Attach(int fd);
+
+    /**
+     * @brief 注销套接字并释放 epoll 实例和唤醒用的 eventfd
+     */
+    void Detach();
+
+    /**
+     * @brief 唤醒阻塞在 Wait() 中的线程
+     *
+     * 未注册套接字时调用无效果。
+     */
+    void Wakeup();
+
+    /**
+     * @brief 等待套接字就绪
+     * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
+     * @param events 输出参数，返回就绪事件
+     * @return Status 等待状态；超时返回 OK 且 events 全为 false
+     */
+    Status Wait(int timeout_ms, Events* events);
+
+private:
+    int epoll_fd_ = -1;  ///< epoll 实例文件描述符
+    int wake_fd_ = -1;   ///< 跨线程唤醒用的 eventfd
+    int fd_ = -1;        ///< 被监听的套接字
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_EVENT_LOOP_H
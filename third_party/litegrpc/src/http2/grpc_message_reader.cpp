@@ -0,0 +1,134 @@
+/**
+ * @file grpc_message_reader.cpp
+ * @brief gRPC 长度前缀消息的增量解析器实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "grpc_message_reader.h"
+#include <algorithm>  // std::min
+#include <utility>    // std::move
+
+namespace litegrpc {
+namespace http2 {
+
+GrpcMessageReader::GrpcMessageReader(size_t max_message_size)
+    : max_message_size_(max_message_size) {}
+
+/**
+ * @brief 输入一段 DATA 帧负载
+ *
+ * 步骤：
+ * 1. 读取前缀：数据足够时直接解析，否则暂存到 prefix_ 中
+ * 2. 读取负载：按剩余长度从输入中复制，读满后完成消息
+ * 3. 重复以上步骤直到输入耗尽，一次调用可以完成多条消息
+ */
+Status GrpcMessageReader::Consume(const uint8_t* data, size_t len) {
+    while (len > 0 && state_ != State::kError) {
+        if (state_ == State::kPrefix) {
+            const size_t n = std::min(len, kPrefixSize - prefix_size_);
+            std::copy(data, data + n, prefix_ + prefix_size_);
+            prefix_size_ += n;
+            data += n;
+            len -= n;
+            if (prefix_size_ < kPrefixSize) {
+                break;
+            }
+            auto status = ParsePrefix();
+            if (!status.ok()) {
+                status_ = status;
+                state_ = State::kError;
+            }
+            continue;
+        }
+
+        // State::kPayload
+        const size_t n = std::min(len, remaining_);
+        current_.append(reinterpret_cast<const char*>(data), n);
+        remaining_ -= n;
+        data += n;
+        len -= n;
+        if (remaining_ == 0) {
+            CompleteMessage();
+        }
+    }
+    return status_;
+}
+
+/**
+ * @brief 确认响应体在消息边界处结束
+ */
+Status GrpcMessageReader::Finish() const {
+    if (state_ == State::kError) {
+        return status_;
+    }
+    if (state_ == State::kPayload || prefix_size_ > 0) {
+        return Status::Internal("Incomplete gRPC message at end of stream");
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 取出最早的一条完整消息
+ */
+bool GrpcMessageReader::PopMessage(std::string* message) {
+    if (messages_.empty()) {
+        return false;
+    }
+    *message = std::move(messages_.front());
+    messages_.pop_front();
+    return true;
+}
+
+/**
+ * @brief 解析已凑齐的前缀
+ *
+ * 步骤：
+ * 1. 校验压缩标志：0 表示未压缩；1 表示已压缩，但本客户端不发送
+ *    grpc-accept-encoding，服务器不应压缩响应
+ * 2. 校验声明的长度不超过上限，超限时在缓冲负载之前拒绝
+ * 3. 按声明的长度预留空间；长度为 0 的消息立即完成
+ */
+Status GrpcMessageReader::ParsePrefix() {
+    const uint8_t flag = prefix_[0];
+    if (flag == 1) {
+        return Status::Internal("Compressed gRPC message received but no compression was negotiated");
+    }
+    if (flag != 0) {
+        return Status::Internal("Invalid gRPC message compressed flag: " + std::to_string(flag));
+    }
+
+    const size_t length = (static_cast<size_t>(prefix_[1]) << 24) |
+                          (static_cast<size_t>(prefix_[2]) << 16) |
+                          (static_cast<size_t>(prefix_[3]) << 8) |
+                          static_cast<size_t>(prefix_[4]);
+    if (length > max_message_size_) {
+        return Status::ResourceExhausted("Received message larger than max (" +
+                                         std::to_string(length) + " vs. " +
+                                         std::to_string(max_message_size_) + ")");
+    }
+
+    prefix_size_ = 0;
+    remaining_ = length;
+    current_.clear();
+    current_.reserve(length);
+    state_ = State::kPayload;
+    if (remaining_ == 0) {
+        CompleteMessage();
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 完成当前消息
+ */
+void GrpcMessageReader::CompleteMessage() {
+    messages_.push_back(std::move(current_));
+    current_ = std::string();
+    state_ = State::kPrefix;
+}
+
+} // namespace http2
+} // namespace litegrpc
@@ -0,0 +1,119 @@
+/**
+ * @file grpc_message_reader.h
+ * @brief gRPC 长度前缀消息的增量解析器头文件
+ *
+ * 此文件定义了接收路径上的 gRPC 消息分帧器。gRPC 在 HTTP/2 DATA 帧中
+ * 以 [压缩标志 (1字节)] + [长度 (4字节，大端)] + [数据] 的格式传输消息，
+ * 一条消息可以跨越多个 DATA 帧，一个 DATA 帧也可以包含多条消息。
+ *
+ * 解析器直接由 DATA 帧回调驱动，以状态机方式处理：
+ * - 前缀可以被任意切分，凑齐 5 字节后才解析
+ * - 压缩标志只允许 0 或 1；未协商压缩算法时收到压缩消息视为错误
+ * - 声明的长度在缓冲任何负载之前与消息大小上限比较，超限的消息
+ *   不会占用内存
+ * - 负载按声明的长度一次性预留空间，从 DATA 帧直接复制到消息中，
+ *   完整的消息以移动方式交给调用方，不再整体复制
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_GRPC_MESSAGE_READER_H
+#define LITEGRPC_HTTP2_GRPC_MESSAGE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include "litegrpc/core.h"    // Config::DEFAULT_MAX_MESSAGE_SIZE
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief gRPC 消息增量解析器
+ *
+ * 线程安全性：非线程安全。由持有连接锁的回调写入，
+ * 移交给调用方后由调用方独占访问。
+ */
+class GrpcMessageReader {
+public:
+    static const size_t kPrefixSize = 5;  ///< 消息前缀长度（压缩标志 + 长度）
+
+    /**
+     * @brief 构造函数
+     * @param max_message_size 单条消息负载的最大字节数
+     */
+    explicit GrpcMessageReader(size_t max_message_size =
+                                   static_cast<size_t>(Config::DEFAULT_MAX_MESSAGE_SIZE));
+
+    /**
+     * @brief 输入一段 DATA 帧负载
+     * @param data 数据指针
+     * @param len 数据长度
+     * @return Status 解析状态；出错后不再接受数据，之后的调用返回同一错误
+     */
+    Status Consume(const uint8_t* data, size_t len);
+
+    /**
+     * @brief 确认响应体在消息边界处结束
+     * @return Status 存在未完成的消息时返回 INTERNAL，已出错时返回该错误
+     *
+     * 在流结束（END_STREAM）后调用。
+     */
+    Status Finish() const;
+
+    /**
+     * @brief 已解析完成、尚未取出的消息数量
+     */
+    size_t message_count() const { return messages_.size(); }
+
+    /**
+     * @brief 取出最早的一条完整消息
+     * @param message 输出参数，消息负载（不含前缀）
+     * @return bool 没有完整消息时返回 false
+     */
+    bool PopMessage(std::string* message);
+
+    /**
+     * @brief 解析状态
+     */
+    const Status& status() const { return status_; }
+
+private:
+    /**
+     * @brief 解析器状态
+     */
+    enum class State {
+        kPrefix,   ///< 正在读取 5 字节前缀
+        kPayload,  ///< 正在读取消息负载
+        kError     ///< 已出错，丢弃后续数据
+    };
+
+    /**
+     * @brief 解析已凑齐的前缀
+     * @return Status 前缀无效或消息超限时返回错误
+     */
+    Status ParsePrefix();
+
+    /**
+     * @brief 完成当前消息
+     */
+    void CompleteMessage();
+
+    size_t max_message_size_;           ///< 单条消息负载的最大字节数
+    State state_ = State::kPrefix;      ///< 当前状态
+    uint8_t prefix_[kPrefixSize];       ///< 被切分的前缀
+    size_t prefix_size_ = 0;            ///< 已读取的前缀字节数
+    size_t remaining_ = 0;              ///< 当前消息尚未读取的负载字节数
+    std::string current_;               ///< 正在组装的消息负载
+    std::deque<std::string> messages_;  ///< 已完成的消息
+    Status status_;                     ///< 解析错误
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_GRPC_MESSAGE_READER_H
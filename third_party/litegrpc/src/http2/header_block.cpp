@@ -0,0 +1,68 @@
+/**
+ * @file header_block.cpp
+ * @brief 预编译的 HTTP/2 请求头部块实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "header_block.h"
+#include <algorithm>  // std::stable_partition, std::find_if
+
+namespace litegrpc {
+namespace http2 {
+
+namespace {
+
+bool IsPseudoHeader(const HeaderBlock::Field& field) {
+    return !field.first.empty() && field.first[0] == ':';
+}
+
+} // namespace
+
+/**
+ * @brief 构造头部块
+ *
+ * 步骤：
+ * 1. 伪头部稳定地移动到最前，并去除重复的伪头部
+ * 2. fields_ 此后不再修改，按其中的字符串地址构造 nghttp2_nv 数组
+ */
+HeaderBlock::HeaderBlock(std::vector<Field> fields) {
+    auto regular = std::stable_partition(fields.begin(), fields.end(), IsPseudoHeader);
+    fields_.reserve(fields.size());
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+        if (it < regular && std::find_if(fields_.begin(), fields_.end(), [&](const Field& f) {
+                return f.first == it->first;
+            }) != fields_.end()) {
+            continue;
+        }
+        fields_.push_back(std::move(*it));
+    }
+
+    nva_.reserve(fields_.size());
+    for (const auto& field : fields_) {
+        nghttp2_nv nv = {
+            reinterpret_cast<uint8_t*>(const_cast<char*>(field.first.data())),
+            reinterpret_cast<uint8_t*>(const_cast<char*>(field.second.data())),
+            field.first.size(), field.second.size(),
+            NGHTTP2_NV_FLAG_NO_COPY_NAME | NGHTTP2_NV_FLAG_NO_COPY_VALUE
+        };
+        nva_.push_back(nv);
+    }
+}
+
+/**
+ * @brief 是否包含指定名称的头部
+ */
+bool HeaderBlock::Contains(const std::string& name) const {
+    for (const auto& field : fields_) {
+        if (field.first == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace http2
+} // namespace litegrpc
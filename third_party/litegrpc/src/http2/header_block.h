@@ -0,0 +1,80 @@
+/**
+ * @file header_block.h
+ * @brief 预编译的 HTTP/2 请求头部块头文件
+ *
+ * 此文件定义了不可变的请求头部块。同一通道上同一方法的每次调用，
+ * 伪头部（:method、:scheme、:path、:authority）和 gRPC 固定头部
+ * （content-type、te、user-agent）都完全相同，因此只在首次调用时
+ * 构造一次，之后每次调用直接复用其中的 nghttp2_nv 数组：
+ * - 所有字符串由头部块持有，地址在其生命周期内不变
+ * - 每个 nghttp2_nv 都带 NGHTTP2_NV_FLAG_NO_COPY_NAME | NO_COPY_VALUE，
+ *   nghttp2 提交请求时不复制名称和值
+ * - 头部块以 shared_ptr 共享，流上下文持有一份引用，保证 HEADERS 帧
+ *   发出之前数据一直有效
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_HEADER_BLOCK_H
+#define LITEGRPC_HTTP2_HEADER_BLOCK_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nghttp2/nghttp2.h>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 不可变的预编译头部块
+ *
+ * 线程安全性：构造完成后只读，可被多个线程同时使用。
+ */
+class HeaderBlock {
+public:
+    using Field = std::pair<std::string, std::string>;  ///< 头部名称与值
+
+    /**
+     * @brief 构造头部块
+     * @param fields 头部字段，名称应为小写
+     *
+     * 伪头部（以 ':' 开头）被稳定地移动到最前，满足 RFC 9113 8.3 的顺序要求；
+     * 重复的伪头部只保留第一个。
+     */
+    explicit HeaderBlock(std::vector<Field> fields);
+
+    HeaderBlock(const HeaderBlock&) = delete;
+    HeaderBlock& operator=(const HeaderBlock&) = delete;
+
+    /**
+     * @brief nghttp2 名值对数组
+     */
+    const nghttp2_nv* data() const { return nva_.data(); }
+
+    /**
+     * @brief 名值对数量
+     */
+    size_t size() const { return nva_.size(); }
+
+    /**
+     * @brief 是否包含指定名称的头部
+     * @param name 头部名称（小写）
+     * @return bool 包含时返回 true
+     *
+     * 用于过滤与固定头部重名的调用级元数据。
+     */
+    bool Contains(const std::string& name) const;
+
+private:
+    std::vector<Field> fields_;     ///< 头部字段存储，构造后不再修改
+    std::vector<nghttp2_nv> nva_;   ///< 指向 fields_ 的名值对数组
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_HEADER_BLOCK_H
@@ -24,20 +24,260 @@
  */
 
 #include "http2_client.h"
+#include "event_loop.h"    // epoll 事件循环
+#include "io_uring.h"      // io_uring 事件后端
+#include "output_queue.h"  // 批量输出队列
+#include "bdp_estimator.h" // 流量控制窗口自动调整
+#include "keepalive.h"     // 保活 PING
+#include "connector.h"     // Happy Eyeballs 连接建立
+#include "header_block.h"  // 预编译请求头部
+#include "tls_context.h"   // 共享 TLS 上下文
+#include "mpsc_queue.h"    // I/O 线程的调用提交队列
+#include "session_memory.h" // nghttp2 会话内存池
 #include <sys/socket.h>    // 套接字相关函数
+#include <sys/uio.h>       // iovec
 #include <netinet/in.h>    // 网络地址结构
+#include <arpa/inet.h>     // inet_pton
+#include <netinet/tcp.h>   // TCP_CORK
+#include <linux/errqueue.h>  // MSG_ZEROCOPY 完成通知
 #include <netdb.h>         // 主机名解析
 #include <unistd.h>        // UNIX 标准函数
 #include <openssl/ssl.h>   // OpenSSL SSL/TLS 支持
 #include <openssl/err.h>   // OpenSSL 错误处理
+#include <atomic>          // 原子连接状态
+#include <condition_variable>  // 流完成通知
+#include <cerrno>          // errno
 #include <cstring>         // C 字符串函数
 #include <iostream>        // 标准输入输出流
-#include <thread>          // 线程支持
 #include <chrono>          // 时间支持
+#include <algorithm>       // std::min
+#include <array>           // DATA 帧头存储
+#include <deque>           // 零拷贝发送记录
+#include <future>          // I/O 线程模式下的调用完成通知
+#include <thread>          // I/O 线程
 
 namespace litegrpc {
 namespace http2 {
 
+/**
+ * @brief 输出队列积压上限（字节）
+ * 
+ * 达到上限后发送回调返回 NGHTTP2_ERR_WOULDBLOCK，暂停生成新帧，
+ * 避免在对端读取缓慢时无限制地积压数据。
+ */
+static const size_t kMaxQueuedOutput = 1024 * 1024;
+
+/**
+ * @brief 单次写出的最大分片数（sendmsg 的 iovec 数、io_uring 发送链长度）
+ * 与 TLS 记录的最大明文长度
+ */
+static const size_t kMaxIov = 64;
+static const size_t kMaxTlsRecord = 16384;
+
+/**
+ * @brief 接收缓冲区容量范围（字节）与缩容判定轮数
+ */
+static const size_t kMinRecvBuffer = 16 * 1024;
+static const size_t kMaxRecvBuffer = 1024 * 1024;
+static const int kRecvShrinkRounds = 64;
+
+/**
+ * @brief BDP 自动调整的接收窗口上限（字节）
+ */
+static const int32_t kMaxBdpWindow = 16 * 1024 * 1024;
+
+/**
+ * @brief 栈上名值对数组的容量，头部总数不超过该值时提交请求无需分配内存
+ */
+static const size_t kInlineHeaderCount = 32;
+
+/**
+ * @brief BDP 探测 PING 的负载，用于与其他 PING 区分
+ */
+static const uint8_t kBdpPingPayload[8] = {'l', 'g', 'r', 'p', 'c', 'b', 'd', 'p'};
+
+/**
+ * @brief 保活 PING 的负载，用于与 BDP 探测区分
+ */
+static const uint8_t kKeepalivePingPayload[8] = {'l', 'g', 'r', 'p', 'c', 'k', 'a', 'p'};
+
+/**
+ * @brief 进程内 TLS 记录层路径计数，见 TlsPathCounters
+ */
+static std::atomic<uint64_t> g_tls_kernel_send{0};
+static std::atomic<uint64_t> g_tls_kernel_recv{0};
+static std::atomic<uint64_t> g_tls_user_space{0};
+
+/**
+ * @brief 进程内 TLS 会话恢复计数，见 TlsSessionCounters
+ */
+static std::atomic<uint64_t> g_tls_full_handshakes{0};
+static std::atomic<uint64_t> g_tls_resumption_offered{0};
+static std::atomic<uint64_t> g_tls_resumed{0};
+static std::atomic<uint64_t> g_tls_resumed_from_disk{0};
+
+/**
+ * @brief 在 connect 之前按传输层选项设置套接字
+ * @param fd 尚未连接的套接字
+ * @param family 套接字的地址族，Unix 域套接字跳过 TCP 层选项
+ * @param options 传输层选项
+ * 
+ * 缓冲区大小必须在握手前设置才能影响 SYN 中通告的窗口缩放因子。
+ * 设置失败的选项保持内核默认值，实际生效值在连接后由 ConfigureSocket() 读回。
+ */
+static void ApplySocketOptions(int fd, int family, const TransportOptions& options) {
+    const bool tcp = family != AF_UNIX;
+    int value = options.tcp_nodelay ? 1 : 0;
+    if (tcp) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+    }
+    if (options.send_buffer_size > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &options.send_buffer_size,
+                   sizeof(options.send_buffer_size));
+    }
+    if (options.recv_buffer_size > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &options.recv_buffer_size,
+                   sizeof(options.recv_buffer_size));
+    }
+#ifdef TCP_USER_TIMEOUT
+    if (tcp && options.user_timeout_ms > 0) {
+        unsigned int timeout = static_cast<unsigned int>(options.user_timeout_ms);
+        setsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &timeout, sizeof(timeout));
+    }
+#endif
+#ifdef SO_BUSY_POLL
+    if (options.busy_poll_us > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &options.busy_poll_us,
+                   sizeof(options.busy_poll_us));
+    }
+#endif
+}
+
+/**
+ * @brief 读取整型套接字选项
+ * @return int 选项值，读取失败时返回 0
+ */
+static int GetIntSocketOption(int fd, int level, int name) {
+    int value = 0;
+    socklen_t len = sizeof(value);
+    if (getsockopt(fd, level, name, &value, &len) < 0) {
+        return 0;
+    }
+    return value;
+}
+
+/**
+ * @brief 判断流的发送窗口是否未耗尽，供 WriteScheduler 使用
+ */
+static WriteScheduler::CanSend StreamCanSend(nghttp2_session* session) {
+    return [session](int32_t stream_id) {
+        return nghttp2_session_get_stream_remote_window_size(session, stream_id) > 0;
+    };
+}
+
+/**
+ * @brief 单个 HTTP/2 流的请求上下文
+ * 
+ * 由发起请求的线程创建，并作为 stream_user_data 挂接到 nghttp2 流上，
+ * 回调函数据此直接定位到对应的响应对象，无需查表。
+ * ConnectionState::streams 同时持有一份引用，保证调用方超时返回后
+ * 回调仍可安全访问，直到流真正关闭。
+ */
+struct Http2Client::StreamContext {
+    std::shared_ptr<const HeaderBlock> header_block;  ///< 请求头部块，以 NO_COPY 方式提交给 nghttp2
+    const std::string* request_body = nullptr;  ///< 请求体（通常指向调用方的缓冲区）
+    size_t body_offset = 0;                   ///< 请求体已进入输出队列的字节数
+    StreamPriority priority;                  ///< 流优先级
+    bool body_pending = false;                ///< 请求体是否仍登记在 WriteScheduler 中
+    std::string owned_body;                   ///< 调用方提前返回时保存的请求体副本
+    std::deque<std::array<uint8_t, 9>> frame_headers;  ///< 已生成、尚未回收的 DATA 帧头，供输出队列引用
+    size_t released_header_bytes = 0;         ///< 输出队列已不再引用、尚未回收的帧头字节数
+    int inflight_sends = 0;                   ///< 引用本流数据、尚未完成的零拷贝或 io_uring 发送数
+    Http2Response response;                   ///< 响应数据
+    bool closed = false;                      ///< 流是否已关闭
+    uint32_t error_code = NGHTTP2_NO_ERROR;   ///< 流关闭时的 HTTP/2 错误码
+    Status transport_status;                  ///< 连接失效时的错误状态
+    bool refused = false;                     ///< 服务器确定未处理该流，可以安全重试
+    
+    /**
+     * @brief 回收输出队列与内核都不再引用的 DATA 帧头
+     *
+     * 帧头按生成顺序被消费，队列每释放一个帧头长度的字节即可弹出队首。
+     * 零拷贝或 io_uring 发送在途时内核可能仍在读取已消费的帧头，
+     * 等在途发送全部完成后再回收。
+     */
+    void ReleaseFrameHeaders() {
+        if (inflight_sends > 0) {
+            return;
+        }
+        while (!frame_headers.empty() && released_header_bytes >= frame_headers.front().size()) {
+            released_header_bytes -= frame_headers.front().size();
+            frame_headers.pop_front();
+        }
+    }
+    
+    /**
+     * @brief 已结束的流的调用结果
+     */
+    Status Result() const {
+        if (!transport_status.ok()) {
+            return transport_status;
+        }
+        if (!response.messages.status().ok()) {
+            // 本端因响应消息无效而重置了流
+            return response.messages.status();
+        }
+        if (error_code != NGHTTP2_NO_ERROR) {
+            return Status::Unavailable("Stream reset by peer: " +
+                                       std::string(nghttp2_http2_strerror(error_code)));
+        }
+        return Status::OK();
+    }
+};
+
+/**
+ * @brief I/O 线程模式下的一次调用
+ * 
+ * 调用线程在等待期间保持头部、附加头部与请求体有效，I/O 线程可以直接引用。
+ * 状态只能从 kQueued 转为 kClaimed（I/O 线程取出）或 kWithdrawn（调用方在
+ * 被取出前超时放弃），两者以 CAS 竞争，保证放弃的调用不会再被提交。
+ */
+struct Http2Client::IoCall : MpscNode {
+    enum State { kQueued, kClaimed, kWithdrawn };
+    
+    std::shared_ptr<IoCall> self;             ///< 在提交队列中时保持自身存活
+    std::shared_ptr<StreamContext> stream;    ///< 流上下文，携带头部块与请求体
+    const nghttp2_nv* metadata = nullptr;     ///< 调用级的附加头部（调用方的内存）
+    size_t metadata_count = 0;                ///< 附加头部数量
+    int32_t stream_id = -1;                   ///< 提交后分配的流 ID（仅 I/O 线程访问）
+    std::atomic<int> state{kQueued};          ///< 提交状态
+    std::atomic<bool> cancel{false};          ///< 调用方已超时，请求 I/O 线程取消流
+    bool cancel_sent = false;                 ///< 是否已提交 RST_STREAM（仅 I/O 线程访问）
+    bool completed = false;                   ///< 是否已通知调用方（持锁访问）
+    std::promise<Status> done;                ///< 调用结果
+    
+    /**
+     * @brief 通知调用方，只生效一次
+     */
+    void Complete(const Status& status) {
+        if (!completed) {
+            completed = true;
+            done.set_value(cancel ? Status::DeadlineExceeded("Request deadline exceeded") : status);
+        }
+    }
+};
+
+/**
+ * @brief 一次 MSG_ZEROCOPY 发送的记录
+ * 
+ * 内核为每次零拷贝 sendmsg 分配递增的序号，完成通知按序号区间返回。
+ * 记录持有所涉及流的引用，保证在内核释放页面之前数据不被回收。
+ */
+struct ZeroCopyRecord {
+    uint32_t id;                      ///< 内核分配的发送序号
+    std::shared_ptr<void> owner;      ///< 被引用数据的所有者（StreamContext）
+};
+
 /**
  * @brief HTTP/2 客户端连接状态结构体
  * 
@@ -46,67 +286,193 @@ namespace http2 {
  * - 网络套接字连接
  * - SSL/TLS 加密上下文
  * - 请求/响应状态跟踪
+ * - 多线程共享连接所需的同步原语
  * 
  * 使用 PIMPL 模式将实现细节从头文件中隐藏，提供更好的
  * 编译时依赖管理和 ABI 稳定性。
  */
 struct Http2Client::ConnectionState {
     nghttp2_session* session = nullptr;    ///< nghttp2 会话指针，管理 HTTP/2 协议状态
+    SessionMemoryPool session_memory;      ///< 会话内部对象的内存池，会话销毁后才释放页面
     int socket_fd = -1;                    ///< 网络套接字文件描述符
-    SSL_CTX* ssl_ctx = nullptr;            ///< SSL 上下文，用于 TLS 连接
+    std::shared_ptr<TlsContext> tls_context;  ///< 共享的 TLS 上下文（来自凭证或进程默认）
     SSL* ssl = nullptr;                    ///< SSL 连接对象
     bool use_ssl = false;                  ///< 是否使用 SSL/TLS 加密
-    bool connected = false;                ///< 连接状态标志
+    bool tcp = true;                       ///< 是否为 TCP 连接（否则为 Unix 域套接字，不设置 TCP 层选项）
+    bool ktls_send = false;                ///< TLS 发送方向是否由内核加密（明文直接写入套接字）
+    std::atomic<bool> connected{false};    ///< 连接状态标志
+    std::atomic<bool> draining{false};     ///< 是否已收到 GOAWAY，不再接受新请求
+    int32_t goaway_last_stream_id = INT32_MAX;  ///< 服务器承诺处理的最大流 ID
+    EventLoop event_loop;                  ///< 套接字事件循环
+    
+    // ========== 写路径 ==========
+    TransportOptions options;              ///< 传输层选项
+    TransportStats stats;                  ///< 传输层统计信息
+    OutputQueue output_queue;              ///< 待写出的帧数据
+    std::string tls_staging;               ///< TLS 写出时拼接分片的缓冲区
+    bool zerocopy_enabled = false;         ///< 套接字是否已启用 SO_ZEROCOPY
+    uint32_t zerocopy_next_id = 0;         ///< 下一次零拷贝发送的内核序号
+    std::deque<ZeroCopyRecord> zerocopy_records;  ///< 尚未完成的零拷贝发送
+    WriteScheduler scheduler;              ///< 按紧急度约束 DATA 帧的写出顺序
+    
+    // ========== 读路径 ==========
+    std::vector<uint8_t> recv_buffer;      ///< 接收缓冲区，容量随吞吐量自适应
+    int recv_shrink_rounds = 0;            ///< 连续低利用率的唤醒次数
+    
+    // ========== io_uring 后端 ==========
+    IoUring uring;                         ///< io_uring 实例，未启用时不持有任何资源
+    bool uring_active = false;             ///< 本连接是否由 io_uring 驱动（否则使用 event_loop）
+    OutputQueue tls_output;                ///< io_uring 后端下已加密、待写出的 TLS 记录
+    std::vector<std::shared_ptr<void>> uring_send_owners;  ///< 在途发送链引用的数据所有者
+    
+    // ========== 流量控制 ==========
+    BdpEstimator bdp;                      ///< BDP 估计器
+    KeepaliveTracker keepalive;            ///< 保活 PING 计时与 RTT 采样
+    int32_t local_window = NGHTTP2_INITIAL_WINDOW_SIZE;       ///< 当前通告的流级接收窗口
+    int32_t connection_window = NGHTTP2_INITIAL_WINDOW_SIZE;  ///< 当前连接级接收窗口
+    
+    // ========== 并发控制 ==========
+    std::mutex mutex;                      ///< 保护会话及以下所有字段
+    std::condition_variable cv;            ///< 流完成或轮询权释放时通知等待线程
+    bool polling = false;                  ///< 是否已有线程在驱动事件循环
+    uint64_t closed_streams = 0;           ///< 已关闭流的累计数量，用于检测进展
+    Status last_error;                     ///< 最近一次导致连接失效的原因
+    
+    // ========== I/O 线程 ==========
+    std::atomic<bool> io_mode{false};      ///< 调用是否经 I/O 线程提交
+    std::atomic<bool> io_accepting{false}; ///< I/O 线程是否仍在接收新调用
+    std::atomic<bool> io_stop{false};      ///< 请求 I/O 线程退出
+    std::atomic<bool> io_wakeup_pending{false};  ///< 已有未处理的唤醒，生产者无需再次唤醒
+    std::atomic<int> io_producers{0};      ///< 正在入队或唤醒的线程数，见 WakeIoThread()
+    std::mutex io_producers_mutex;         ///< 配合 io_producers_cv 使用，生产者只在 I/O 线程退出时获取
+    std::condition_variable io_producers_cv;  ///< 最后一个生产者离开时通知退出中的 I/O 线程
+    MpscQueue io_queue;                    ///< 调用提交队列
+    std::vector<std::shared_ptr<IoCall>> io_calls;  ///< 已提交、尚未通知调用方的调用
+    std::thread io_thread;                 ///< I/O 线程
+    std::mutex io_thread_mutex;            ///< 串行化 I/O 线程的启动与停止
     
     // ========== 请求/响应状态管理 ==========
-    std::map<int32_t, Http2Response> responses;  ///< 流 ID 到响应对象的映射
-    int32_t current_stream_id = -1;              ///< 当前处理的流 ID
+    std::map<int32_t, std::shared_ptr<StreamContext>> streams;  ///< 未关闭的流
     
     /**
-     * @brief 析构函数 - 清理所有资源
+     * @brief 输出是否需要在用户态加密（TLS 连接且未启用内核 TLS 发送）
+     */
+    bool user_space_tls() const {
+        return use_ssl && !ktls_send;
+    }
+    
+    /**
+     * @brief 唤醒正在等待套接字事件的轮询线程
+     */
+    void Wakeup() {
+        if (uring_active) {
+            uring.Wakeup();
+        } else {
+            event_loop.Wakeup();
+        }
+    }
+    
+    /**
+     * @brief 生产者离开提交路径
+     * 
+     * I/O 线程已停止接收新调用时，最后一个离开的生产者通知它继续退出；
+     * 正常运行时只有一次原子减法，不获取任何锁。
+     */
+    void LeaveIoProducer() {
+        if (io_producers.fetch_sub(1) == 1 && !io_accepting) {
+            std::lock_guard<std::mutex> guard(io_producers_mutex);
+            io_producers_cv.notify_all();
+        }
+    }
+    
+    /**
+     * @brief 释放连接资源
+     * @param reason 所有未完成流的结束状态
      * 
      * 按照正确的顺序释放所有分配的资源：
-     * 1. 销毁 nghttp2 会话
-     * 2. 释放 SSL 连接和上下文
-     * 3. 关闭网络套接字
+     * 1. 将所有未完成的流标记为失败，通知经 I/O 线程提交的调用
+     * 2. 取消 io_uring 上的在途请求，之后才能释放其引用的输出数据
+     * 3. 销毁 nghttp2 会话，归还会话内存池的页面
+     * 4. 释放 SSL 连接和对共享 TLS 上下文的引用
+     * 5. 关闭事件循环和网络套接字
      * 
-     * 确保没有资源泄漏，即使在异常情况下也能正确清理。
+     * 调用方必须持有 mutex，且没有线程处于轮询中。
      */
-    ~ConnectionState() {
+    void Close(const Status& reason) {
+        for (auto& entry : streams) {
+            entry.second->closed = true;
+            entry.second->transport_status = reason;
+            entry.second->refused = draining && entry.first > goaway_last_stream_id;
+        }
+        streams.clear();
+        for (auto& call : io_calls) {
+            call->Complete(call->stream->Result());
+        }
+        io_calls.clear();
+        uring.Detach();
+        for (auto& owner : uring_send_owners) {
+            static_cast<StreamContext*>(owner.get())->inflight_sends--;
+        }
+        uring_send_owners.clear();
+        uring_active = false;
+        tls_output.Clear();
+        output_queue.Clear();
+        scheduler.Reset();
+        if (!zerocopy_records.empty()) {
+            // 内核仍引用着零拷贝发送的页面，以 RST 方式关闭可立即丢弃
+            // 发送队列，随后这些页面即可安全释放
+            if (socket_fd >= 0) {
+                struct linger abort_linger = {1, 0};
+                setsockopt(socket_fd, SOL_SOCKET, SO_LINGER, &abort_linger, sizeof(abort_linger));
+            }
+            for (auto& record : zerocopy_records) {
+                static_cast<StreamContext*>(record.owner.get())->inflight_sends = 0;
+            }
+            zerocopy_records.clear();
+        }
         if (session) {
             nghttp2_session_del(session);
+            session = nullptr;
         }
+        session_memory.Release();
         if (ssl) {
             SSL_free(ssl);
+            ssl = nullptr;
         }
-        if (ssl_ctx) {
-            SSL_CTX_free(ssl_ctx);
-        }
+        ktls_send = false;
+        tls_context.reset();
+        event_loop.Detach();
+        recv_buffer.clear();
+        recv_buffer.shrink_to_fit();
+        recv_shrink_rounds = 0;
         if (socket_fd >= 0) {
             close(socket_fd);
+            socket_fd = -1;
         }
+        connected = false;
+        draining = false;
+        goaway_last_stream_id = INT32_MAX;
+    }
+    
+    /**
+     * @brief 析构函数 - 清理所有资源
+     * 
+     * 确保没有资源泄漏，即使在异常情况下也能正确清理。
+     */
+    ~ConnectionState() {
+        Close(Status::Unavailable("Connection closed"));
     }
 };
 
 /**
  * @brief Http2Client 构造函数
  * 
- * 初始化 HTTP/2 客户端实例，创建连接状态对象并初始化 OpenSSL 库。
+ * 初始化 HTTP/2 客户端实例，创建连接状态对象。
  * 
- * 初始化步骤：
- * 1. 创建 ConnectionState 对象
- * 2. 初始化 OpenSSL 库
- * 3. 加载 SSL 错误字符串
- * 4. 添加所有加密算法
- * 
- * 注意：OpenSSL 的初始化是全局的，多次调用是安全的。
+ * OpenSSL 不在此处初始化：第一条 TLS 连接构建 TlsContext 时才一次性初始化，
+ * 只使用明文连接的进程不加载 SSL 库。
  */
-Http2Client::Http2Client() : state_(std::make_unique<ConnectionState>()) {
-    // 初始化 OpenSSL 库
-    SSL_library_init();           // 初始化 SSL 库
-    SSL_load_error_strings();     // 加载错误字符串，便于调试
-    OpenSSL_add_all_algorithms(); // 添加所有加密算法
-}
+Http2Client::Http2Client() : state_(std::make_unique<ConnectionState>()) {}
 
 /**
  * @brief Http2Client 析构函数
@@ -123,14 +489,17 @@ Http2Client::~Http2Client() {
  * @param host 服务器主机名或 IP 地址
  * @param port 服务器端口号
  * @param use_ssl 是否使用 SSL/TLS 加密
+ * @param options 传输层选项
+ * @param timeout_ms 连接超时时间（毫秒），-1 表示不限时
  * @return Status 连接状态
  * 
  * 建立到 HTTP/2 服务器的连接，包括以下步骤：
  * 1. 检查是否已连接，避免重复连接
- * 2. 创建 TCP 套接字并连接到服务器
+ * 2. 解析主机名，以 Happy Eyeballs 方式创建非阻塞 TCP 连接
  * 3. 如果需要，建立 SSL/TLS 加密连接
  * 4. 初始化 nghttp2 会话
  * 5. 执行 HTTP/2 协议握手
+ * 6. 启用了 I/O 线程时启动 I/O 线程
  * 
  * 支持的特性：
  * - HTTP 和 HTTPS 连接
@@ -138,40 +507,111 @@ Http2Client::~Http2Client() {
  * - 完整的错误处理
  * - 连接状态跟踪
  */
-Status Http2Client::Connect(const std::string& host, int port, bool use_ssl) {
-    if (state_->connected) {
-        return Status::OK();  // 已连接，直接返回成功
+Status Http2Client::Connect(const std::string& host, int port, bool use_ssl,
+                            const TransportOptions& options, int timeout_ms) {
+    if (state_->connected && !state_->draining) {
+        return Status::OK();
+    }
+    
+    std::vector<ResolvedAddress> addresses;
+    auto status = ResolveHost(host, port, &addresses);
+    if (!status.ok()) {
+        return status;
+    }
+    return Connect(host, port, addresses, use_ssl, options, timeout_ms);
+}
+
+/**
+ * @brief 使用已解析的地址连接到 HTTP/2 服务器
+ * @param host 服务器主机名
+ * @param port 服务器端口号
+ * @param addresses 候选地址列表
+ * @param use_ssl 是否使用 SSL/TLS 加密
+ * @param options 传输层选项
+ * @param timeout_ms 连接超时时间（毫秒），-1 表示不限时
+ * @return Status 连接状态
+ */
+Status Http2Client::Connect(const std::string& host, int port,
+                            const std::vector<ResolvedAddress>& addresses, bool use_ssl,
+                            const TransportOptions& options, int timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    auto remaining_ms = [&]() -> int {
+        if (timeout_ms < 0) {
+            return -1;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        return remaining > 0 ? static_cast<int>(remaining) : 0;
+    };
+    
+    // I/O 线程持有轮询权，重新连接前先将其停止
+    if (!state_->connected || state_->draining) {
+        StopIoThread();
+    }
+    
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->connected && !state_->draining) {
+        // 已连接（可能由其他线程建立），直接返回成功
+        lock.unlock();
+        if (state_->io_mode) {
+            StartIoThread();  // 可能刚被本线程停止
+        }
+        return Status::OK();
     }
     
+    // 释放上一次连接残留的资源
+    CloseConnection(lock, Status::Unavailable("Reconnecting"), false);
     state_->use_ssl = use_ssl;  // 保存 SSL 使用标志
+    state_->options = options;
+    state_->io_mode = false;
+    state_->stats = TransportStats();
+    state_->local_window = NGHTTP2_INITIAL_WINDOW_SIZE;
+    state_->connection_window = NGHTTP2_INITIAL_WINDOW_SIZE;
     
     // 第一步：创建网络套接字连接
-    auto status = CreateSocket(host, port);
-    if (!status.ok()) {
-        return status;  // 套接字创建失败
-    }
+    auto status = CreateSocket(host, port, addresses, remaining_ms());
     
     // 第二步：如果需要，设置 SSL/TLS 加密
-    if (use_ssl) {
-        status = SetupSsl();
-        if (!status.ok()) {
-            return status;  // SSL 设置失败
+    if (status.ok() && use_ssl) {
+        status = SetupSsl(host, port, remaining_ms());
+    }
+    
+    // 第三步：配置套接字并注册到事件后端（请求 io_uring 但不可用时回退到 epoll）
+    if (status.ok()) {
+        if (options.io_uring) {
+            AttachIoUring();
+        }
+        ConfigureSocket();
+        if (!state_->uring_active) {
+            status = state_->event_loop.Attach(state_->socket_fd);
         }
     }
     
-    // 第三步：初始化 HTTP/2 会话
-    status = InitializeSession();
-    if (!status.ok()) {
-        return status;  // 会话初始化失败
+    // 第四步：初始化 HTTP/2 会话
+    if (status.ok()) {
+        status = InitializeSession();
+    }
+    
+    // 第五步：执行 HTTP/2 协议握手
+    if (status.ok()) {
+        status = PerformHandshake();
     }
     
-    // 第四步：执行 HTTP/2 协议握手
-    status = PerformHandshake();
     if (!status.ok()) {
-        return status;  // 握手失败
+        CloseConnection(lock, status, false);
+        return status;
     }
     
+    state_->last_error = Status::OK();
     state_->connected = true;  // 标记为已连接
+    state_->io_mode = options.io_thread;
+    lock.unlock();
+    
+    // 第六步：按需启动 I/O 线程，此后由它独占事件循环
+    if (options.io_thread) {
+        StartIoThread();
+    }
     return Status::OK();
 }
 
@@ -181,18 +621,49 @@ Status Http2Client::Connect(const std::string& host, int port, bool use_ssl) {
  * 优雅地关闭 HTTP/2 连接，包括：
  * 1. 发送 GOAWAY 帧通知服务器连接即将关闭
  * 2. 终止 nghttp2 会话
- * 3. 更新连接状态
+ * 3. 释放套接字、SSL 和会话资源
  * 
  * 此方法是幂等的，可以安全地多次调用。
- * ConnectionState 的析构函数会处理底层资源的清理。
+ * 套接字为非阻塞模式，GOAWAY 只做尽力发送，不会阻塞调用方。
+ * 仍在等待响应的其他线程会收到 UNAVAILABLE。
+ * 启用了 I/O 线程时先停止 I/O 线程，由本线程关闭连接。
  */
 void Http2Client::Disconnect() {
-    if (state_->session) {
+    StopIoThread();
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    CloseConnection(lock, Status::Unavailable("Connection closed by client"), true);
+}
+
+/**
+ * @brief 关闭连接并释放底层资源
+ * @param lock 已持有的连接锁
+ * @param reason 关闭原因
+ * @param send_goaway 是否尽力发送 GOAWAY 帧
+ * 
+ * 正在 epoll 上等待的轮询线程不持有锁，因此先唤醒它并等待其
+ * 交还轮询权，再销毁会话和套接字，避免释放正在使用的资源。
+ */
+void Http2Client::CloseConnection(std::unique_lock<std::mutex>& lock,
+                                  const Status& reason, bool send_goaway) {
+    bool was_connected = state_->connected.exchange(false);
+    state_->last_error = reason;
+    
+    while (state_->polling) {
+        state_->Wakeup();
+        state_->cv.wait(lock);
+    }
+    
+    if (send_goaway && was_connected && state_->session) {
         // 优雅地终止 HTTP/2 会话
         nghttp2_session_terminate_session(state_->session, NGHTTP2_NO_ERROR);
-        SendData(); // 发送 GOAWAY 帧
+        SendData();  // 发送 GOAWAY 帧
+        if (state_->uring_active) {
+            state_->uring.Submit();  // 提交时内核即尝试写出
+        }
     }
-    state_->connected = false;  // 更新连接状态
+    
+    state_->Close(reason);
+    state_->cv.notify_all();
 }
 
 /**
@@ -203,7 +674,55 @@ void Http2Client::Disconnect() {
  * 可以在任何时候调用以检查连接是否可用。
  */
 bool Http2Client::IsConnected() const {
-    return state_->connected;
+    return state_->connected && !state_->draining;
+}
+
+/**
+ * @brief 连接是否正在排空
+ */
+bool Http2Client::IsDraining() const {
+    return state_->draining;
+}
+
+/**
+ * @brief 获取传输层统计信息
+ * @return TransportStats 统计信息快照
+ */
+TransportStats Http2Client::GetTransportStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    TransportStats stats = state_->stats;
+    stats.uring_enter_calls = state_->uring.enter_calls();
+    const SessionMemoryPool& memory = state_->session_memory;
+    stats.session_memory_in_use = memory.in_use();
+    stats.session_memory_reserved = memory.reserved();
+    stats.session_memory_peak = memory.peak_reserved();
+    stats.session_allocations = memory.allocations();
+    stats.session_system_allocations = memory.system_allocations();
+    stats.session_allocation_failures = memory.failures();
+    return stats;
+}
+
+/**
+ * @brief 获取进程内所有 TLS 连接的记录层路径计数
+ */
+TlsPathCounters Http2Client::GetTlsPathCounters() {
+    TlsPathCounters counters;
+    counters.kernel_send = g_tls_kernel_send.load(std::memory_order_relaxed);
+    counters.kernel_recv = g_tls_kernel_recv.load(std::memory_order_relaxed);
+    counters.user_space = g_tls_user_space.load(std::memory_order_relaxed);
+    return counters;
+}
+
+/**
+ * @brief 获取进程内所有 TLS 连接的会话恢复计数
+ */
+TlsSessionCounters Http2Client::GetTlsSessionCounters() {
+    TlsSessionCounters counters;
+    counters.full_handshakes = g_tls_full_handshakes.load(std::memory_order_relaxed);
+    counters.resumption_offered = g_tls_resumption_offered.load(std::memory_order_relaxed);
+    counters.resumed = g_tls_resumed.load(std::memory_order_relaxed);
+    counters.resumed_from_disk = g_tls_resumed_from_disk.load(std::memory_order_relaxed);
+    return counters;
 }
 
 /**
@@ -213,14 +732,70 @@ bool Http2Client::IsConnected() const {
  * @param headers 自定义 HTTP 头部映射
  * @param body 请求体内容（对于 POST/PUT 请求）
  * @param response 用于接收响应的对象指针
+ * @param timeout_ms 等待响应的超时时间（毫秒），-1 表示不限时
+ * @return Status 请求发送和处理状态
+ * 
+ * 通用接口：由参数构造一次性的头部块后发送。headers 中的 :authority
+ * 覆盖默认值，其余伪头部由参数和连接决定，不会重复发送。
+ */
+Status Http2Client::SendRequest(
+    const std::string& method,
+    const std::string& path,
+    const std::map<std::string, std::string>& headers,
+    const std::string& body,
+    Http2Response* response,
+    int timeout_ms) {
+    
+    std::string authority = "localhost";  // 默认值
+    auto authority_it = headers.find(":authority");
+    if (authority_it != headers.end()) {
+        authority = authority_it->second;
+    }
+    
+    bool use_ssl;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        use_ssl = state_->use_ssl;
+    }
+    
+    std::vector<HeaderBlock::Field> fields;
+    fields.reserve(headers.size() + 4);
+    fields.emplace_back(":method", method);
+    fields.emplace_back(":scheme", use_ssl ? "https" : "http");
+    fields.emplace_back(":path", path);
+    fields.emplace_back(":authority", authority);
+    for (const auto& header : headers) {
+        if (!header.first.empty() && header.first[0] != ':') {
+            fields.push_back(header);
+        }
+    }
+    
+    return SendRequest(std::make_shared<const HeaderBlock>(std::move(fields)),
+                       nullptr, 0, body, response, timeout_ms);
+}
+
+/**
+ * @brief 以预编译头部块发送 HTTP/2 请求
+ * @param headers 预编译头部块（伪头部与固定头部）
+ * @param metadata 调用级的附加头部，可为 nullptr
+ * @param metadata_count 附加头部数量
+ * @param body 请求体内容
+ * @param response 用于接收响应的对象指针
+ * @param timeout_ms 等待响应的超时时间（毫秒），-1 表示不限时
+ * @param priority 流优先级
  * @return Status 请求发送和处理状态
  * 
  * 发送完整的 HTTP/2 请求并等待响应，包括以下步骤：
  * 1. 验证连接状态
- * 2. 构建 HTTP/2 头部（包括伪头部和自定义头部）
- * 3. 提交请求到 nghttp2 会话
- * 4. 如果有请求体，发送数据
- * 5. 处理网络事件直到收到完整响应
+ * 2. 以 SubmitStream() 提交请求到 nghttp2 会话
+ * 3. 处理网络事件直到收到完整响应（请求体随之发送）
+ * 4. 移交响应数据
+ * 
+ * 连接启用了 I/O 线程时，请求改由 SendRequestOnIoThread() 交给 I/O 线程提交。
+ * 
+ * 头部块中的名值对带 NO_COPY 标志，nghttp2 不复制其内容，流上下文持有
+ * 头部块的引用直到流关闭；附加头部不带该标志，由 nghttp2 在提交时复制，
+ * 调用方返回后即可释放。
  * 
  * HTTP/2 特性支持：
  * - 自动流 ID 分配
@@ -235,379 +810,1548 @@ bool Http2Client::IsConnected() const {
  * - 超时处理
  */
 Status Http2Client::SendRequest(
-    const std::string& method,
-    const std::string& path,
-    const std::map<std::string, std::string>& headers,
+    const std::shared_ptr<const HeaderBlock>& headers,
+    const nghttp2_nv* metadata,
+    size_t metadata_count,
     const std::string& body,
-    Http2Response* response) {
+    Http2Response* response,
+    int timeout_ms,
+    const StreamPriority& priority) {
+    
+    if (state_->io_mode) {
+        return SendRequestOnIoThread(headers, metadata, metadata_count, body, response, timeout_ms,
+                                     priority);
+    }
     
     // 第一步：检查连接状态
+    std::unique_lock<std::mutex> lock(state_->mutex);
     if (!state_->connected) {
         return Status::Unavailable("Not connected");
     }
+    if (state_->draining) {
+        // 取得连接后、提交请求前服务器发来了 GOAWAY：请求尚未发出，可以重试
+        response->refused = true;
+        return Status::Unavailable("Connection is draining after GOAWAY");
+    }
     
-    // 第二步：准备 HTTP/2 头部
-    std::vector<nghttp2_nv> nva;  // nghttp2 名值对数组
+    // 第二步：提交请求，请求体以 NO_COPY 方式直接从调用方缓冲区写出
+    auto stream = std::make_shared<StreamContext>();
+    stream->header_block = headers;
+    stream->request_body = &body;
+    stream->priority = priority;
+    int32_t stream_id = SubmitStream(stream, metadata, metadata_count);
+    if (stream_id < 0) {
+        return SubmitError(stream_id);
+    }
     
-    // 第三步：添加 HTTP/2 伪头部（Pseudo Headers）
-    // HTTP/2 要求特定的伪头部，以冒号开头，必须在普通头部之前
+    // 若有其他线程正在等待 epoll，唤醒它以发送新提交的帧
+    if (state_->polling) {
+        state_->Wakeup();
+    }
     
-    // 添加 :method 伪头部（HTTP 方法）
-    nghttp2_nv method_nv = {
-        (uint8_t*)":method", (uint8_t*)method.c_str(),
-        7, method.length(), NGHTTP2_NV_FLAG_NONE
-    };
-    nva.push_back(method_nv);
+    // 第三步：处理请求/响应循环
+    // 这会发送请求并等待该流结束
+    auto status = ProcessEvents(lock, stream.get(), timeout_ms);
     
-    // 添加 :path 伪头部（请求路径）
-    nghttp2_nv path_nv = {
-        (uint8_t*)":path", (uint8_t*)path.c_str(),
-        5, path.length(), NGHTTP2_NV_FLAG_NONE
-    };
-    nva.push_back(path_nv);
+    // 调用方返回后请求体即失效：输出队列中尚未写出的引用转为副本
+    state_->output_queue.Detach(stream.get());
     
-    // 添加 :scheme 伪头部（协议方案：http 或 https）
-    nghttp2_nv scheme_nv = {
-        (uint8_t*)":scheme", (uint8_t*)(state_->use_ssl ? "https" : "http"),
-        7, static_cast<size_t>(state_->use_ssl ? 5 : 4), NGHTTP2_NV_FLAG_NONE
-    };
-    nva.push_back(scheme_nv);
+    if (!status.ok()) {
+        if (status.error_code() == StatusCode::DEADLINE_EXCEEDED && state_->connected &&
+            !stream->closed) {
+            // 调用方即将返回并释放请求体，而流在 RST_STREAM 发出前仍可能
+            // 读取剩余数据，因此先把请求体转存到流上下文中
+            if (stream->body_offset < body.size()) {
+                stream->owned_body = body;
+                stream->request_body = &stream->owned_body;
+            }
+            
+            // 超时：取消该流，连接本身仍可继续使用
+            nghttp2_submit_rst_stream(state_->session, NGHTTP2_FLAG_NONE, stream_id, NGHTTP2_CANCEL);
+            if (state_->polling) {
+                state_->Wakeup();
+            } else {
+                SendData();
+                if (state_->uring_active) {
+                    state_->uring.Submit();
+                }
+            }
+        }
+        if (stream->inflight_sends > 0) {
+            // 内核仍在引用调用方的请求体，只能放弃整条连接
+            CloseConnection(lock, Status::Unavailable("Send referencing request body not completed before deadline"),
+                            false);
+        }
+        response->refused = stream->refused;
+        return status;
+    }
     
-    // 添加 :authority 伪头部（必需的 gRPC 协议要求）
-    // 从 headers 中查找 :authority，如果没有则使用默认值
-    std::string authority_value = "localhost";  // 默认值
-    auto authority_it = headers.find(":authority");
-    if (authority_it != headers.end()) {
-        authority_value = authority_it->second;
+    // 第四步：移交响应数据
+    *response = std::move(stream->response);
+    return Status::OK();
+}
+
+/**
+ * @brief 在会话上提交请求并登记流
+ * 
+ * 步骤：
+ * 1. 拼接头部块与附加头部的名值对（不超过 kInlineHeaderCount 时使用栈上数组）
+ * 2. 调用方显式设置了优先级时追加 RFC 9218 的 priority 头部，并按紧急度
+ *    设置 HEADERS 帧中的 RFC 7540 流权重（不理解 priority 头部的旧实现仍可参考）
+ * 3. 提交请求，创建新的 HTTP/2 流并分配流 ID；流上下文作为 stream_user_data
+ *    供回调函数直接访问，请求体按偏移量分帧读取；没有请求体时
+ *    HEADERS 帧直接携带 END_STREAM
+ * 4. 在 WriteScheduler 中登记请求体；连接上首次出现显式优先级时，
+ *    TCP 连接设置 TCP_NOTSENT_LOWAT，限制内核中积压的低优先级数据
+ * 5. 登记未完成的流，直到 OnStreamCloseCallback 将其移除
+ * 
+ * nghttp2 客户端只按 RFC 7540 依赖树调度，RFC 9218 的紧急度
+ * 由 WriteScheduler 在本端执行。
+ */
+int32_t Http2Client::SubmitStream(const std::shared_ptr<StreamContext>& stream,
+                                  const nghttp2_nv* metadata, size_t metadata_count) {
+    static const int32_t kUrgencyWeights[kUrgencyLevels] = {256, 128, 64, 16, 8, 4, 2, 1};
+    const HeaderBlock& headers = *stream->header_block;
+    const StreamPriority& priority = stream->priority;
+    const size_t nvlen = headers.size() + metadata_count + (priority.signal ? 1 : 0);
+    nghttp2_nv inline_nva[kInlineHeaderCount];
+    std::vector<nghttp2_nv> heap_nva;
+    nghttp2_nv* nva = inline_nva;
+    if (nvlen > kInlineHeaderCount) {
+        heap_nva.resize(nvlen);
+        nva = heap_nva.data();
+    }
+    std::copy(headers.data(), headers.data() + headers.size(), nva);
+    if (metadata_count > 0) {
+        std::copy(metadata, metadata + metadata_count, nva + headers.size());
     }
     
-    nghttp2_nv authority_nv = {
-        (uint8_t*)":authority", (uint8_t*)authority_value.c_str(),
-        10, authority_value.length(), NGHTTP2_NV_FLAG_NONE
-    };
-    nva.push_back(authority_nv);
+    // 第二步：优先级信号（头部值由 nghttp2 在提交时复制）
+    char priority_value[8];
+    nghttp2_priority_spec pri_spec;
+    const nghttp2_priority_spec* pri_spec_ptr = nullptr;
+    if (priority.signal) {
+        int len = snprintf(priority_value, sizeof(priority_value), "u=%d%s",
+                           priority.urgency, priority.incremental ? ", i" : "");
+        nghttp2_nv& nv = nva[nvlen - 1];
+        nv.name = reinterpret_cast<uint8_t*>(const_cast<char*>("priority"));
+        nv.namelen = 8;
+        nv.value = reinterpret_cast<uint8_t*>(priority_value);
+        nv.valuelen = static_cast<size_t>(len);
+        nv.flags = NGHTTP2_NV_FLAG_NO_COPY_NAME;
+        nghttp2_priority_spec_init(&pri_spec, 0, kUrgencyWeights[priority.urgency], 0);
+        pri_spec_ptr = &pri_spec;
+    }
     
-    // 第四步：添加自定义 HTTP 头部
-    // 使用 header_storage 确保字符串在 nghttp2_nv 使用期间保持有效
-    std::vector<std::string> header_storage;
-    for (const auto& header : headers) {
-        // 将头部名称和值存储到 vector 中，确保内存有效性
-        header_storage.push_back(header.first);
-        header_storage.push_back(header.second);
-        
-        // 创建 nghttp2 名值对结构
-        nghttp2_nv header_nv = {
-            (uint8_t*)header_storage[header_storage.size()-2].c_str(),  // 头部名称
-            (uint8_t*)header_storage[header_storage.size()-1].c_str(),  // 头部值
-            header.first.length(), header.second.length(),
-            NGHTTP2_NV_FLAG_NONE
-        };
-        nva.push_back(header_nv);
-    }
-    
-    // 第五步：提交请求到 nghttp2 会话
-    // 这会创建一个新的 HTTP/2 流并分配唯一的流 ID
-    int32_t stream_id = nghttp2_submit_request(
-        state_->session, nullptr, nva.data(), nva.size(), nullptr, nullptr);
+    // 第三步：提交请求
+    nghttp2_data_provider data_prd;
+    data_prd.source.ptr = stream.get();
+    data_prd.read_callback = DataSourceReadCallback;
     
+    int32_t stream_id = nghttp2_submit_request(
+        state_->session, pri_spec_ptr, nva, nvlen,
+        stream->request_body->empty() ? nullptr : &data_prd, stream.get());
     if (stream_id < 0) {
-        return Status::Internal("Failed to submit request");
+        return stream_id;
+    }
+    
+    // 第四步：登记请求体，按需启用套接字上的约束
+    if (!stream->request_body->empty()) {
+        stream->body_pending = true;
+        state_->scheduler.AddBody(stream_id, priority.urgency);
+    }
+    if (priority.signal && state_->scheduler.Enable()) {
+        state_->stats.priority_scheduling = true;
+        if (state_->tcp) {
+            int lowat = kPriorityNotSentLowat;
+            setsockopt(state_->socket_fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &lowat, sizeof(lowat));
+        }
+    }
+    
+    // 第五步：登记未完成的流
+    state_->streams[stream_id] = stream;
+    state_->keepalive.OnDataSent();
+    return stream_id;
+}
+
+/**
+ * @brief 提交请求失败时返回给调用方的状态
+ * @param error SubmitStream() 返回的 nghttp2 错误码
+ * 
+ * 会话内存池超出预算时返回 RESOURCE_EXHAUSTED，连接本身仍可继续使用，
+ * 已有调用完成、释放内存后即可提交新请求。
+ */
+Status Http2Client::SubmitError(int error) {
+    if (error == NGHTTP2_ERR_NOMEM) {
+        return Status::ResourceExhausted("HTTP/2 session memory limit reached");
+    }
+    return Status::Internal("Failed to submit request");
+}
+
+/**
+ * @brief 经 I/O 线程发送请求并等待响应
+ * 
+ * 步骤：
+ * 1. 创建调用描述，放入无锁提交队列并唤醒 I/O 线程（不获取连接锁）
+ * 2. 在 future 上等待 I/O 线程通知结果
+ * 3. 超时时若调用尚未被取出，直接撤回并返回 DEADLINE_EXCEEDED；
+ *    否则请求 I/O 线程取消流，等待其确认不再引用请求体后返回
+ * 4. 移交响应数据
+ * 
+ * 撤回或未提交即失败的调用没有发出任何帧，标记为可以安全重试。
+ */
+Status Http2Client::SendRequestOnIoThread(const std::shared_ptr<const HeaderBlock>& headers,
+                                          const nghttp2_nv* metadata, size_t metadata_count,
+                                          const std::string& body, Http2Response* response,
+                                          int timeout_ms, const StreamPriority& priority) {
+    // 第一步：入队并唤醒 I/O 线程
+    auto call = std::make_shared<IoCall>();
+    call->stream = std::make_shared<StreamContext>();
+    call->stream->header_block = headers;
+    call->stream->request_body = &body;
+    call->stream->priority = priority;
+    call->metadata = metadata;
+    call->metadata_count = metadata_count;
+    std::future<Status> result = call->done.get_future();
+    
+    state_->io_producers.fetch_add(1);
+    if (!state_->io_accepting) {
+        state_->LeaveIoProducer();
+        return Status::Unavailable("Not connected");
+    }
+    call->self = call;
+    state_->io_queue.Push(call.get());
+    if (!state_->io_wakeup_pending.exchange(true)) {
+        state_->Wakeup();
+    }
+    state_->LeaveIoProducer();
+    
+    // 第二步：等待结果
+    if (timeout_ms < 0) {
+        result.wait();
+    } else if (result.wait_for(std::chrono::milliseconds(timeout_ms)) == std::future_status::timeout) {
+        // 第三步：超时
+        int expected = IoCall::kQueued;
+        if (call->state.compare_exchange_strong(expected, IoCall::kWithdrawn)) {
+            return Status::DeadlineExceeded("Request deadline exceeded");
+        }
+        call->cancel = true;
+        WakeIoThread();
+        result.wait();
+    }
+    
+    // 第四步：移交响应数据
+    Status status = result.get();
+    if (!status.ok()) {
+        response->refused = call->stream->refused;
+        return status;
+    }
+    *response = std::move(call->stream->response);
+    return Status::OK();
+}
+
+/**
+ * @brief 唤醒 I/O 线程
+ * 
+ * 唤醒写入的是连接的事件文件描述符，I/O 线程退出时会关闭它。
+ * io_producers 计数保证 I/O 线程在停止接收新调用后，等所有已经开始
+ * 入队或唤醒的线程离开，才关闭连接，不会写入已关闭（甚至被复用）的描述符。
+ */
+bool Http2Client::WakeIoThread() {
+    state_->io_producers.fetch_add(1);
+    const bool accepting = state_->io_accepting;
+    if (accepting) {
+        state_->io_wakeup_pending = true;
+        state_->Wakeup();
+    }
+    state_->LeaveIoProducer();
+    return accepting;
+}
+
+/**
+ * @brief 启动 I/O 线程
+ */
+void Http2Client::StartIoThread() {
+    std::lock_guard<std::mutex> guard(state_->io_thread_mutex);
+    if (state_->io_thread.joinable()) {
+        if (state_->io_accepting) {
+            return;
+        }
+        state_->io_thread.join();  // 已因连接失效而退出
+    }
+    state_->io_stop = false;
+    state_->io_accepting = true;
+    state_->io_thread = std::thread(&Http2Client::IoThreadMain, this);
+}
+
+/**
+ * @brief 停止并回收 I/O 线程
+ */
+void Http2Client::StopIoThread() {
+    std::lock_guard<std::mutex> guard(state_->io_thread_mutex);
+    if (!state_->io_thread.joinable()) {
+        return;
+    }
+    state_->io_stop = true;
+    WakeIoThread();
+    state_->io_thread.join();
+}
+
+/**
+ * @brief I/O 线程主循环
+ * 
+ * I/O 线程持有轮询权直到退出，调用线程从不驱动事件循环。每一轮：
+ * 1. 清除唤醒标志后取出提交队列中的调用并提交请求
+ *    （先清除标志，之后入队的调用必然再次唤醒本线程）
+ * 2. 处理取消请求，通知已结束的调用
+ * 3. 执行一轮事件处理（发送、接收，无事可做时在 epoll/io_uring 上等待）
+ * 
+ * 退出时先停止接收新调用，在条件变量上等待正在入队的线程离开；连接失效时关闭连接，
+ * 已提交的调用随之失败；最后让提交队列中剩余的调用失败。
+ */
+void Http2Client::IoThreadMain() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->polling = true;
+    state_->stats.io_thread = true;
+    
+    Status status;
+    while (!state_->io_stop) {
+        state_->io_wakeup_pending = false;
+        state_->stats.io_thread_wakeups++;
+        SubmitIoCalls();
+        CompleteIoCalls();
+        status = PollOnce(lock, -1);
+        if (!status.ok()) {
+            break;
+        }
+    }
+    CompleteIoCalls();
+    
+    state_->polling = false;
+    state_->io_accepting = false;
+    {
+        // 先停止接收再检查计数：此后离开的最后一个生产者必然看到停止并通知
+        std::unique_lock<std::mutex> producers_lock(state_->io_producers_mutex);
+        state_->io_producers_cv.wait(producers_lock, [this]() { return state_->io_producers == 0; });
+    }
+    if (!status.ok()) {
+        CloseConnection(lock, status, false);
+    }
+    SubmitIoCalls();  // 连接已不可用或线程已停止：剩余调用全部失败
+    state_->cv.notify_all();
+}
+
+/**
+ * @brief 取出提交队列中的全部调用并提交请求
+ * 
+ * 调用线程在被取出前可能已撤回调用，此时只释放其引用。
+ */
+void Http2Client::SubmitIoCalls() {
+    while (MpscNode* node = state_->io_queue.Pop()) {
+        IoCall* raw = static_cast<IoCall*>(node);
+        std::shared_ptr<IoCall> call = std::move(raw->self);
+        int expected = IoCall::kQueued;
+        if (!call->state.compare_exchange_strong(expected, IoCall::kClaimed)) {
+            continue;  // 已被调用方撤回
+        }
+        state_->stats.io_thread_submissions++;
+        
+        if (!state_->io_accepting || !state_->connected) {
+            call->stream->refused = true;
+            call->Complete(state_->connected || state_->last_error.ok()
+                               ? Status::Unavailable("I/O thread stopped") : state_->last_error);
+            continue;
+        }
+        if (state_->draining) {
+            call->stream->refused = true;
+            call->Complete(Status::Unavailable("Connection is draining after GOAWAY"));
+            continue;
+        }
+        call->stream_id = SubmitStream(call->stream, call->metadata, call->metadata_count);
+        if (call->stream_id < 0) {
+            call->Complete(SubmitError(call->stream_id));
+            continue;
+        }
+        state_->io_calls.push_back(std::move(call));
+    }
+}
+
+/**
+ * @brief 处理取消请求并通知已结束的调用
+ * 
+ * 取消与调用方线程驱动时的超时处理相同：尚未写出的请求体转存为副本，
+ * 输出队列中的引用转为副本，再提交 RST_STREAM。调用方在收到通知前
+ * 一直等待，因此其请求体在此期间始终有效。流结束（或被取消）且没有
+ * 引用请求体的在途发送后才通知调用方。
+ */
+void Http2Client::CompleteIoCalls() {
+    auto& calls = state_->io_calls;
+    for (size_t i = 0; i < calls.size();) {
+        IoCall& call = *calls[i];
+        StreamContext& stream = *call.stream;
+        if (call.cancel && !call.cancel_sent) {
+            call.cancel_sent = true;
+            state_->output_queue.Detach(&stream);
+            if (!stream.closed) {
+                if (stream.body_offset < stream.request_body->size()) {
+                    stream.owned_body = *stream.request_body;
+                    stream.request_body = &stream.owned_body;
+                }
+                nghttp2_submit_rst_stream(state_->session, NGHTTP2_FLAG_NONE, call.stream_id,
+                                          NGHTTP2_CANCEL);
+            }
+        }
+        if ((stream.closed || call.cancel_sent) && stream.inflight_sends == 0) {
+            state_->output_queue.Detach(&stream);
+            call.Complete(stream.Result());
+            calls[i] = std::move(calls.back());
+            calls.pop_back();
+            continue;
+        }
+        ++i;
+    }
+}
+
+/**
+ * @brief 创建网络套接字并连接到服务器
+ * @param host 目标主机名、IP 地址或 Unix 域套接字目标
+ * @param port 目标端口号
+ * @param addresses 候选地址列表
+ * @param timeout_ms 连接超时时间（毫秒），-1 表示不限时
+ * @return Status 套接字创建和连接状态
+ * 
+ * 以 Happy Eyeballs（RFC 8305）方式并行竞争连接各个地址，
+ * 保存胜出的非阻塞套接字。每个尝试的套接字在 connect 前按
+ * 传输层选项设置。失败时不会遗留打开的套接字。
+ * Unix 域套接字只有一个候选地址，不设置 TCP 层选项（TCP_NODELAY、
+ * TCP_USER_TIMEOUT、TCP_CORK、TCP_QUICKACK），以 h2c 明文通信。
+ */
+Status Http2Client::CreateSocket(const std::string& host, int port,
+                                 const std::vector<ResolvedAddress>& addresses, int timeout_ms) {
+    int fd = -1;
+    const TransportOptions& options = state_->options;
+    const std::string target = IsUnixSocketTarget(host) ? host : host + ":" + std::to_string(port);
+    auto status = ConnectHappyEyeballs(target, addresses, timeout_ms, &fd, [&options](int s) {
+        ApplySocketOptions(s, GetIntSocketOption(s, SOL_SOCKET, SO_DOMAIN), options);
+    });
+    if (!status.ok()) {
+        return status;
+    }
+    
+    state_->socket_fd = fd;
+    state_->tcp = GetIntSocketOption(fd, SOL_SOCKET, SO_DOMAIN) != AF_UNIX;
+    return Status::OK();
+}
+
+/**
+ * @brief 设置 SSL/TLS 加密连接
+ * @param host 服务器主机名或 IP 地址字面量，用于 SNI 与证书校验
+ * @param port 服务器端口，与主机名一起作为会话缓存的键
+ * @param timeout_ms 握手超时时间（毫秒），-1 表示不限时
+ * @return Status SSL 设置状态
+ * 
+ * 在现有 TCP 连接上建立 SSL/TLS 加密层：
+ * 1. 取得共享的 TLS 上下文：优先使用传输层选项中由凭证构建的上下文，
+ *    否则使用进程默认上下文。根证书、ALPN 与密码套件都已在其中配置好，
+ *    每个连接只需 SSL_new
+ * 2. 创建 SSL 连接对象，设置 SNI 与期望的主机名（IP 字面量按 IP 校验，不发送 SNI），
+ *    启用 kTLS 选项时设置 SSL_OP_ENABLE_KTLS
+ * 3. 启用会话恢复时从上下文的缓存（或磁盘票据存储）取出该目标的会话
+ * 4. 执行 SSL 握手（套接字为非阻塞模式，按 WANT_READ/WANT_WRITE 等待）；
+ *    服务器拒绝会话时 OpenSSL 自动退回完整握手
+ * 5. 记录会话是否被恢复以及内核 TLS 实际生效的方向
+ * 
+ * 
+ * 内核 TLS 由 OpenSSL 在握手中安装密钥时尝试开启（TCP_ULP "tls"）；
+ * 内核未加载 tls 模块或密码套件不受支持时 OpenSSL 静默保持用户态记录层，
+ * 因此只能在握手完成后通过 BIO 查询实际结果。
+ */
+Status Http2Client::SetupSsl(const std::string& host, int port, int timeout_ms) {
+    // 取得共享的 TLS 上下文
+    state_->tls_context = state_->options.tls_context;
+    if (!state_->tls_context) {
+        auto status = TlsContext::GetDefault(&state_->tls_context);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    
+    // 创建 SSL 连接对象（增加上下文的引用计数，不复制证书存储）
+    state_->ssl = SSL_new(state_->tls_context->get());
+    if (!state_->ssl) {
+        return Status::Internal("Failed to create SSL object");
+    }
+    
+    // 设置 SNI 与证书校验的期望主机名
+    unsigned char addr[sizeof(struct in6_addr)];
+    const bool is_ip = inet_pton(AF_INET, host.c_str(), addr) == 1 ||
+                       inet_pton(AF_INET6, host.c_str(), addr) == 1;
+    if (is_ip) {
+        X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(state_->ssl), host.c_str());
+    } else {
+        SSL_set_tlsext_host_name(state_->ssl, host.c_str());
+        SSL_set1_host(state_->ssl, host.c_str());
+    }
+    
+#ifdef SSL_OP_ENABLE_KTLS
+    if (state_->options.ktls) {
+        SSL_set_options(state_->ssl, SSL_OP_ENABLE_KTLS);
+    }
+#endif
+    
+    // 提供缓存的会话，同时登记新会话的保存位置
+    TlsSessionSource session_source = TlsSessionSource::kNone;
+    if (state_->options.tls_session_resumption) {
+        session_source = state_->tls_context->PrepareSession(
+            state_->ssl, host + ":" + std::to_string(port), state_->options.tls_ticket_store);
+    }
+    
+    // 将 SSL 对象绑定到套接字
+    SSL_set_fd(state_->ssl, state_->socket_fd);
+    
+    // 执行 SSL 握手，直到完成、失败或超时
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    while (true) {
+        int rv = SSL_connect(state_->ssl);
+        if (rv == 1) {
+            break;
+        }
+        int err = SSL_get_error(state_->ssl, rv);
+        if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+            ERR_clear_error();
+            const long verify = SSL_get_verify_result(state_->ssl);
+            if (verify != X509_V_OK) {
+                return Status::Unavailable("SSL handshake failed: certificate verification failed: " +
+                                           std::string(X509_verify_cert_error_string(verify)));
+            }
+            return Status::Unavailable("SSL handshake failed");
+        }
+        
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            wait_ms = static_cast<int>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count()));
+        }
+        auto status = WaitForSocket(state_->socket_fd, err == SSL_ERROR_WANT_WRITE, wait_ms);
+        if (!status.ok()) {
+            return status.error_code() == StatusCode::DEADLINE_EXCEEDED
+                ? Status::DeadlineExceeded("SSL handshake timed out") : status;
+        }
+    }
+    
+    // 记录会话恢复结果
+    const bool resumed = SSL_session_reused(state_->ssl) == 1;
+    state_->stats.tls_resumed = resumed;
+    if (session_source != TlsSessionSource::kNone) {
+        g_tls_resumption_offered.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (resumed) {
+        g_tls_resumed.fetch_add(1, std::memory_order_relaxed);
+        if (session_source == TlsSessionSource::kDisk) {
+            g_tls_resumed_from_disk.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else {
+        g_tls_full_handshakes.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // 查询内核 TLS 实际生效的方向（OpenSSL 3.0 之前没有这两个查询，视为未启用）
+    bool ktls_send = false;
+    bool ktls_recv = false;
+#if defined(BIO_get_ktls_send) && defined(BIO_get_ktls_recv)
+    ktls_send = BIO_get_ktls_send(SSL_get_wbio(state_->ssl)) > 0;
+    ktls_recv = BIO_get_ktls_recv(SSL_get_rbio(state_->ssl)) > 0;
+#endif
+    state_->ktls_send = ktls_send;
+    state_->stats.ktls_send = ktls_send;
+    state_->stats.ktls_recv = ktls_recv;
+    if (ktls_send) {
+        g_tls_kernel_send.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (ktls_recv) {
+        g_tls_kernel_recv.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!ktls_send && !ktls_recv) {
+        g_tls_user_space.fetch_add(1, std::memory_order_relaxed);
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 按传输层选项配置套接字
+ * 
+ * 零拷贝只用于 epoll 后端的明文连接：用户态 TLS 需要先加密，
+ * 发送的已经是 OpenSSL 内部缓冲区中的副本；内核 TLS 套接字在加密时
+ * 复制明文，并拒绝 MSG_ZEROCOPY；io_uring 后端以异步 send 写出，
+ * 不使用 MSG_ZEROCOPY。
+ * 连接前设置的套接字选项在此读回实际生效值，记录到统计信息中。
+ */
+void Http2Client::ConfigureSocket() {
+    const int fd = state_->socket_fd;
+    SocketSettings& effective = state_->stats.socket;
+    effective.tcp_nodelay = GetIntSocketOption(fd, IPPROTO_TCP, TCP_NODELAY) != 0;
+    effective.send_buffer_size = GetIntSocketOption(fd, SOL_SOCKET, SO_SNDBUF);
+    effective.recv_buffer_size = GetIntSocketOption(fd, SOL_SOCKET, SO_RCVBUF);
+#ifdef TCP_USER_TIMEOUT
+    effective.user_timeout_ms = GetIntSocketOption(fd, IPPROTO_TCP, TCP_USER_TIMEOUT);
+#endif
+#ifdef SO_BUSY_POLL
+    effective.busy_poll_us = GetIntSocketOption(fd, SOL_SOCKET, SO_BUSY_POLL);
+#endif
+#ifdef TCP_QUICKACK
+    effective.quickack = state_->options.quickack && state_->tcp;
+#endif
+    
+
+    state_->zerocopy_enabled = false;
+    state_->zerocopy_next_id = 0;
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+    if (state_->options.zerocopy_threshold > 0 && !state_->use_ssl && !state_->uring_active) {
+        int on = 1;
+        state_->zerocopy_enabled =
+            setsockopt(state_->socket_fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) == 0;
+    }
+#endif
+}
+
+/**
+ * @brief 按需发起 BDP 探测
+ * 
+ * 只有在有数据到达时才探测，空闲连接上不会产生 PING。
+ */
+void Http2Client::MaybeStartBdpPing() {
+    if (!state_->options.bdp_probe) {
+        return;
+    }
+    const auto now = BdpEstimator::Clock::now();
+    if (!state_->bdp.NeedPing(now)) {
+        return;
+    }
+    if (nghttp2_submit_ping(state_->session, NGHTTP2_FLAG_NONE, kBdpPingPayload) == 0) {
+        state_->bdp.StartPing(now);
+        state_->stats.bdp_pings++;
+    }
+}
+
+/**
+ * @brief 推进保活计时
+ * 
+ * 步骤：
+ * 1. 在途 PING 超时（期间也没有任何数据到达）时判定连接失效，
+ *    由调用方关闭连接，所有未完成的调用以 UNAVAILABLE 结束，
+ *    下一次调用重新建立连接
+ * 2. 空闲达到 keepalive_time 时提交保活 PING，随本轮 SendData() 写出
+ */
+Status Http2Client::CheckKeepalive() {
+    KeepaliveTracker& keepalive = state_->keepalive;
+    if (!keepalive.enabled()) {
+        return Status::OK();
+    }
+    const auto now = KeepaliveTracker::Clock::now();
+    if (keepalive.TimedOut(now)) {
+        return Status::Unavailable("Keepalive ping timed out");
+    }
+    if (keepalive.NeedPing(now, !state_->streams.empty()) &&
+        nghttp2_submit_ping(state_->session, NGHTTP2_FLAG_NONE, kKeepalivePingPayload) == 0) {
+        keepalive.StartPing(now);
+        state_->stats.keepalive_pings++;
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 以距下一个保活事件的时间限制本轮等待
+ */
+int Http2Client::KeepaliveWaitMs(int wait_ms) const {
+    const int keepalive_ms = state_->keepalive.WaitMs(KeepaliveTracker::Clock::now(),
+                                                      !state_->streams.empty());
+    if (keepalive_ms < 0) {
+        return wait_ms;
+    }
+    return wait_ms < 0 ? keepalive_ms : std::min(wait_ms, keepalive_ms);
+}
+
+/**
+ * @brief 扩大接收窗口
+ * @param window_size 目标窗口大小（字节）
+ * @return Status 提交状态
+ * 
+ * 新的 SETTINGS_INITIAL_WINDOW_SIZE 对已打开的流同样生效（RFC 9113 6.9.2），
+ * 对端会按差值调整其发送窗口。连接级窗口不小于流级窗口，
+ * 否则多个并发流会共同受限于连接窗口。
+ */
+Status Http2Client::GrowReceiveWindow(int32_t window_size) {
+    if (window_size > state_->local_window) {
+        nghttp2_settings_entry iv = {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE,
+                                     static_cast<uint32_t>(window_size)};
+        int rv = nghttp2_submit_settings(state_->session, NGHTTP2_FLAG_NONE, &iv, 1);
+        if (rv != 0) {
+            return Status::Internal("Failed to submit settings: " + std::string(nghttp2_strerror(rv)));
+        }
+        state_->local_window = window_size;
+        state_->stats.local_window_size = window_size;
+    }
+    if (window_size > state_->connection_window) {
+        int rv = nghttp2_session_set_local_window_size(state_->session, NGHTTP2_FLAG_NONE, 0,
+                                                       window_size);
+        if (rv != 0) {
+            return Status::Internal("Failed to set connection window size: " +
+                                    std::string(nghttp2_strerror(rv)));
+        }
+        state_->connection_window = window_size;
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 初始化 nghttp2 会话
+ * @return Status 会话初始化状态
+ * 
+ * 创建并配置 nghttp2 客户端会话：
+ * 1. 创建回调函数集合
+ * 2. 设置各种事件回调函数
+ * 3. 创建客户端会话，会话内部对象从本连接的 SessionMemoryPool 分配，
+ *    受 TransportOptions::session_memory_limit 约束
+ * 4. 清理临时资源
+ * 
+ * 回调函数用于处理 HTTP/2 协议事件，如数据发送、
+ * 帧接收、头部处理等。
+ */
+Status Http2Client::InitializeSession() {
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+    
+    // 设置各种回调函数
+    nghttp2_session_callbacks_set_send_callback(callbacks, SendCallback);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, OnFrameRecvCallback);
+    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, OnDataChunkRecvCallback);
+    nghttp2_session_callbacks_set_on_header_callback(callbacks, OnHeaderCallback);
+    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, OnStreamCloseCallback);
+    nghttp2_session_callbacks_set_send_data_callback(callbacks, OnSendDataCallback);
+    
+    // 创建客户端会话，会话内部对象从本连接的内存池分配
+    state_->session_memory.set_limit(state_->options.session_memory_limit);
+    int rv = nghttp2_session_client_new3(&state_->session, callbacks, this, nullptr,
+                                         state_->session_memory.mem());
+    nghttp2_session_callbacks_del(callbacks);  // 清理回调函数集合
+    
+    if (rv == NGHTTP2_ERR_NOMEM) {
+        return Status::ResourceExhausted("HTTP/2 session memory limit too small to create session");
+    }
+    if (rv != 0) {
+        return Status::Internal("Failed to create HTTP/2 session");
+    }
+    
+    return Status::OK();
+}
+
+/**
+ * @brief 执行 HTTP/2 协议握手
+ * @return Status 握手状态
+ * 
+ * 发送 HTTP/2 连接设置帧，建立协议参数：
+ * 1. 配置最大并发流数量
+ * 2. 提交设置帧到 nghttp2 会话
+ * 3. 发送设置数据到服务器
+ * 
+ * 这是 HTTP/2 连接建立的最后一步，确保客户端和服务器
+ * 就协议参数达成一致。
+ */
+Status Http2Client::PerformHandshake() {
+    const TransportOptions& options = state_->options;
+    
+    // 配置 HTTP/2 连接设置
+    nghttp2_settings_entry iv[2];
+    size_t niv = 0;
+    iv[niv++] = {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, 100};  // 最大并发流数量
+    if (options.initial_window_size > 0) {
+        // 流级接收窗口
+        iv[niv++] = {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE,
+                     static_cast<uint32_t>(options.initial_window_size)};
+        state_->local_window = options.initial_window_size;
+    }
+    
+    // 提交设置帧
+    int rv = nghttp2_submit_settings(state_->session, NGHTTP2_FLAG_NONE, iv, niv);
+    if (rv != 0) {
+        return Status::Internal("Failed to submit settings");
+    }
+    
+    // 连接级接收窗口只能通过 WINDOW_UPDATE 扩大
+    if (options.connection_window_size > state_->connection_window) {
+        rv = nghttp2_session_set_local_window_size(state_->session, NGHTTP2_FLAG_NONE, 0,
+                                                   options.connection_window_size);
+        if (rv != 0) {
+            return Status::Internal("Failed to set connection window size");
+        }
+        state_->connection_window = options.connection_window_size;
+    }
+    
+    // 窗口按 BDP 的两倍设置，估计值从当前窗口的一半开始
+    state_->bdp = BdpEstimator(state_->local_window / 2);
+    state_->stats.bdp_estimate = state_->bdp.estimate();
+    state_->stats.local_window_size = state_->local_window;
+    
+    state_->keepalive = KeepaliveTracker(options.keepalive_time_ms, options.keepalive_timeout_ms,
+                                         options.keepalive_permit_without_calls,
+                                         options.max_pings_without_data,
+                                         options.min_ping_interval_without_data_ms);
+    
+    // 发送设置数据
+    auto status = SendData();
+    if (status.ok() && state_->uring_active) {
+        status = state_->uring.Submit();  // io_uring 后端的发送请求在提交后才进入内核
+    }
+    return status;
+}
+
+/**
+ * @brief 发送待发送的数据
+ * @return Status 发送状态
+ * 
+ * 将 nghttp2 会话中缓冲的数据发送到网络：
+ * 1. 调用 nghttp2_session_send 生成所有可发送的帧，
+ *    帧数据通过 SendCallback/OnSendDataCallback 追加到输出队列
+ * 2. 调用 FlushOutput() 以尽量少的系统调用批量写出
+ * 3. 若队列写空而 nghttp2 仍有数据（队列达到上限时会暂停生成），重复以上步骤
+ * 
+ * 每次生成帧后检查暂停的流：让路的对象只因自身流窗口耗尽而无法发送时
+ * 立即恢复它们，不让链路空闲。
+ * 
+ * 这个方法是 HTTP/2 数据发送的核心，处理所有类型的
+ * HTTP/2 帧（HEADERS、DATA、SETTINGS 等）。
+ */
+Status Http2Client::SendData() {
+    while (true) {
+        int rv = nghttp2_session_send(state_->session);
+        if (rv != 0) {
+            return Status::Unavailable("Failed to send data: " + std::string(nghttp2_strerror(rv)));
+        }
+        if (state_->scheduler.has_deferred()) {
+            auto unblocked = state_->scheduler.TakeUnblocked(StreamCanSend(state_->session));
+            for (int32_t stream_id : unblocked) {
+                nghttp2_session_resume_data(state_->session, stream_id);
+            }
+            if (!unblocked.empty()) {
+                continue;
+            }
+        }
+        if (state_->output_queue.empty()) {
+            return Status::OK();  // 没有新产生的数据（例如受流量控制限制）
+        }
+        
+        auto status = FlushOutput();
+        if (!status.ok()) {
+            return status;
+        }
+        if (!state_->output_queue.empty() || !nghttp2_session_want_write(state_->session)) {
+            return Status::OK();  // 套接字已满，或已全部发送
+        }
+    }
+}
+
+/**
+ * @brief 批量写出输出队列
+ * @return Status 写出状态
+ * 
+ * 明文连接与内核 TLS 发送的连接：
+ * - 每次 sendmsg 携带最多 kMaxIov 个分片，队列中还有后续数据时附带
+ *   MSG_MORE，让内核把它们合并到尽量满的报文段（内核 TLS 下同时
+ *   合并为尽量满的 TLS 记录）
+ * - 启用零拷贝时，引用段（DATA 帧）与复制段分批写出，达到阈值的
+ *   引用段以 MSG_ZEROCOPY 发送，并登记到 zerocopy_records
+ * 
+ * 用户态 TLS 连接：分片拼接到 tls_staging，每次 SSL_write 一个最大长度的记录。
+ * 失败后重试时队首数据不变，满足 SSL_write 的重试要求。
+ * 
+ * 需要多次系统调用时，若启用了 tcp_cork 则用 TCP_CORK 包裹整批写入。
+ */
+Status Http2Client::FlushOutput() {
+    if (state_->uring_active) {
+        return FlushOutputUring();
+    }
+    
+    OutputQueue& queue = state_->output_queue;
+    
+    const bool cork = state_->options.tcp_cork && state_->tcp &&
+        (state_->user_space_tls() ? queue.size() > kMaxTlsRecord : queue.segment_count() > kMaxIov);
+    if (cork) {
+        int on = 1;
+        setsockopt(state_->socket_fd, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+    }
+    
+    Status result;
+    while (!queue.empty()) {
+        OutputQueue::Slice slices[kMaxIov];
+        size_t n = queue.Peek(slices, kMaxIov);
+        
+        ssize_t rv;
+        if (state_->user_space_tls()) {
+            // 拼接为一个 TLS 记录
+            std::string& staging = state_->tls_staging;
+            staging.clear();
+            for (size_t i = 0; i < n && staging.size() < kMaxTlsRecord; ++i) {
+                size_t take = std::min(slices[i].len, kMaxTlsRecord - staging.size());
+                staging.append(reinterpret_cast<const char*>(slices[i].data), take);
+            }
+            rv = SocketSend(staging.data(), staging.size());
+        } else {
+            // 启用零拷贝时只取与队首同类（引用/复制）的连续分片
+            bool zerocopy = false;
+            if (state_->zerocopy_enabled) {
+                size_t run = 1;
+                size_t run_bytes = slices[0].len;
+                while (run < n && (slices[run].owner != nullptr) == (slices[0].owner != nullptr)) {
+                    run_bytes += slices[run].len;
+                    ++run;
+                }
+                n = run;
+                zerocopy = slices[0].owner != nullptr &&
+                           run_bytes >= state_->options.zerocopy_threshold;
+            }
+            
+            struct iovec iov[kMaxIov];
+            size_t batch_bytes = 0;
+            for (size_t i = 0; i < n; ++i) {
+                iov[i].iov_base = const_cast<uint8_t*>(slices[i].data);
+                iov[i].iov_len = slices[i].len;
+                batch_bytes += slices[i].len;
+            }
+            
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = n;
+            int flags = MSG_NOSIGNAL;
+            if (batch_bytes < queue.size()) {
+                flags |= MSG_MORE;  // 后面还有数据
+            }
+#ifdef MSG_ZEROCOPY
+            if (zerocopy) {
+                flags |= MSG_ZEROCOPY;
+            }
+#endif
+            rv = sendmsg(state_->socket_fd, &msg, flags);
+#ifdef MSG_ZEROCOPY
+            if (rv < 0 && zerocopy && errno == ENOBUFS) {
+                // 超出 optmem 限制，本批回退为普通发送
+                zerocopy = false;
+                rv = sendmsg(state_->socket_fd, &msg, flags & ~MSG_ZEROCOPY);
+            }
+#endif
+            if (rv >= 0 && zerocopy) {
+                // 登记本次发送涉及的所有者，直到收到完成通知
+                const uint32_t id = state_->zerocopy_next_id++;
+                size_t covered = 0;
+                const void* last_owner = nullptr;
+                for (size_t i = 0; i < n && covered < static_cast<size_t>(rv); ++i) {
+                    covered += slices[i].len;
+                    const std::shared_ptr<void>& owner = *slices[i].owner;
+                    if (owner.get() == last_owner) {
+                        continue;
+                    }
+                    last_owner = owner.get();
+                    static_cast<StreamContext*>(owner.get())->inflight_sends++;
+                    state_->zerocopy_records.push_back(ZeroCopyRecord{id, owner});
+                }
+                state_->stats.zerocopy_calls++;
+            }
+        }
+        
+        if (rv < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                result = Status::Unavailable("Failed to send data: " + std::string(strerror(errno)));
+            }
+            break;  // 套接字已满，等待可写事件
+        }
+        
+        state_->stats.write_calls++;
+        state_->stats.bytes_written += static_cast<uint64_t>(rv);
+        queue.Consume(static_cast<size_t>(rv));
+    }
+    
+    if (cork) {
+        int off = 0;
+        setsockopt(state_->socket_fd, IPPROTO_TCP, TCP_CORK, &off, sizeof(off));
+    }
+    return result;
+}
+
+/**
+ * @brief 处理零拷贝发送的完成通知
+ * 
+ * 每条通知给出一个已完成的序号区间 [ee_info, ee_data]。
+ * ee_code 带有 SO_EE_CODE_ZEROCOPY_COPIED 时表示内核实际做了复制
+ * （例如回环设备），统计到 zerocopy_copied 中以便判断是否值得启用。
+ * 流的在途发送全部完成时唤醒等待者：流关闭后仍在等待在途发送的
+ * 调用方此时才能返回。
+ */
+void Http2Client::ReapZeroCopyCompletions() {
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+    while (!state_->zerocopy_records.empty()) {
+        char control[128];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(state_->socket_fd, &msg, MSG_ERRQUEUE) < 0) {
+            return;  // 暂无通知（EAGAIN）
+        }
+        
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                  (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))) {
+                continue;
+            }
+            const auto* err = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cm));
+            if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            const uint32_t lo = err->ee_info;
+            const uint32_t hi = err->ee_data;
+            if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                state_->stats.zerocopy_copied += hi - lo + 1;
+            }
+            state_->stats.zerocopy_completions += hi - lo + 1;
+            
+            auto& records = state_->zerocopy_records;
+            for (auto it = records.begin(); it != records.end();) {
+                if (it->id - lo <= hi - lo) {  // 序号回绕安全的区间判断
+                    auto* stream = static_cast<StreamContext*>(it->owner.get());
+                    if (--stream->inflight_sends == 0) {
+                        stream->ReleaseFrameHeaders();
+                        state_->cv.notify_all();
+                    }
+                    it = records.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+#endif
+}
+
+/**
+ * @brief 接收并处理网络数据
+ * @return Status 接收状态
+ * 
+ * 从网络接收数据并交给 nghttp2 处理：
+ * 1. 循环从非阻塞套接字读取数据到接收缓冲区，直到返回 EAGAIN 或缓冲区写满
+ * 2. 将已读取的整段数据一次性传递给 nghttp2 会话处理
+ * 3. 缓冲区写满说明套接字中还有积压，扩大缓冲区后继续读取
+ * 
+ * 缓冲区容量在 kMinRecvBuffer 与 kMaxRecvBuffer 之间自适应：
+ * 一次唤醒内写满即翻倍；连续 kRecvShrinkRounds 次唤醒的读取量都
+ * 不足容量的四分之一时减半，小消息场景不会长期占用大块内存。
+ * 
+ * nghttp2 会解析 HTTP/2 帧并触发相应的回调函数。
+ */
+Status Http2Client::ReceiveData() {
+    std::vector<uint8_t>& buf = state_->recv_buffer;
+    if (buf.size() < kMinRecvBuffer) {
+        buf.resize(kMinRecvBuffer);
     }
     
-    // 保存流 ID 并初始化响应对象
-    state_->current_stream_id = stream_id;
-    state_->responses[stream_id] = Http2Response();
+    size_t filled = 0;       // 缓冲区中尚未解析的字节数
+    size_t round_bytes = 0;  // 本次唤醒读取的总字节数
+    Status result;
     
-    // 第六步：发送请求体数据（如果存在）
-    if (!body.empty()) {
-        // 设置数据提供者，用于向 nghttp2 提供请求体数据
-        nghttp2_data_provider data_prd;
-        data_prd.source.ptr = (void*)body.c_str();
+    while (true) {
+        ssize_t readlen = SocketRecv(buf.data() + filled, buf.size() - filled);
         
-        // 数据读取回调函数 - 当 nghttp2 需要发送数据时调用
-        data_prd.read_callback = [](nghttp2_session* session, int32_t stream_id,
-                                   uint8_t* buf, size_t length, uint32_t* data_flags,
-                                   nghttp2_data_source* source, void* user_data) -> ssize_t {
-            const char* data = (const char*)source->ptr;
-            size_t data_len = strlen(data);
-            
-            // 检查缓冲区是否足够大
-            if (data_len > length) {
-                return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+        if (readlen < 0) {
+            if (errno == EINTR) {
+                continue;
             }
-            
-            // 复制数据到 nghttp2 缓冲区
-            memcpy(buf, data, data_len);
-            *data_flags |= NGHTTP2_DATA_FLAG_EOF;  // 标记数据结束
-            return data_len;
-        };
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                result = Status::Unavailable("Failed to receive data: " + std::string(strerror(errno)));
+            }
+            break;  // 已读空，等待下一次可读事件
+        }
         
-        // 提交数据帧，并标记流结束
-        nghttp2_submit_data(state_->session, NGHTTP2_FLAG_END_STREAM, stream_id, &data_prd);
+        if (readlen == 0) {
+            result = Status::Unavailable("Connection closed");  // 连接已关闭
+            break;
+        }
+        
+        state_->stats.read_calls++;
+        state_->stats.bytes_read += static_cast<uint64_t>(readlen);
+        filled += static_cast<size_t>(readlen);
+        round_bytes += static_cast<size_t>(readlen);
+        
+        if (filled == buf.size()) {
+            // 缓冲区已满：先交给 nghttp2 解析，再按需扩容后继续读取
+            auto status = FeedSession(buf.data(), filled);
+            if (!status.ok()) {
+                return status;
+            }
+            filled = 0;
+            if (buf.size() < kMaxRecvBuffer) {
+                buf.resize(std::min(buf.size() * 2, kMaxRecvBuffer));
+            }
+            state_->recv_shrink_rounds = 0;
+        }
     }
     
-    // 第七步：处理请求/响应循环
-    // 这会发送请求并等待完整的响应
-    auto status = ProcessEvents();
-    if (!status.ok()) {
-        return status;
+#ifdef TCP_QUICKACK
+    // TCP_QUICKACK 不是持久选项，内核可能随时回到延迟确认模式，每次读取后重新设置
+    if (state_->options.quickack && state_->tcp && round_bytes > 0) {
+        int on = 1;
+        setsockopt(state_->socket_fd, IPPROTO_TCP, TCP_QUICKACK, &on, sizeof(on));
     }
+#endif
     
-    // 第八步：获取并返回响应
-    auto it = state_->responses.find(stream_id);
-    if (it != state_->responses.end()) {
-        *response = it->second;           // 复制响应数据
-        state_->responses.erase(it);      // 清理响应缓存
-        return Status::OK();
+    // 解析剩余数据（连接关闭前到达的数据同样需要处理）
+    if (filled > 0) {
+        auto status = FeedSession(buf.data(), filled);
+        if (!status.ok()) {
+            return status;
+        }
     }
     
-    return Status::Internal("Response not found");
+    // 持续低利用率时缩小缓冲区
+    if (round_bytes < buf.size() / 4 && buf.size() > kMinRecvBuffer) {
+        if (++state_->recv_shrink_rounds >= kRecvShrinkRounds) {
+            buf.resize(buf.size() / 2);
+            buf.shrink_to_fit();
+            state_->recv_shrink_rounds = 0;
+        }
+    } else {
+        state_->recv_shrink_rounds = 0;
+    }
+    state_->stats.recv_buffer_size = buf.size();
+    return result;
 }
 
 /**
- * @brief 创建网络套接字并连接到服务器
- * @param host 目标主机名或 IP 地址
- * @param port 目标端口号
- * @return Status 套接字创建和连接状态
- * 
- * 执行以下步骤创建 TCP 连接：
- * 1. 使用 getaddrinfo 解析主机名到 IP 地址
- * 2. 创建套接字
- * 3. 连接到目标服务器
- * 
- * 支持 IPv4 和 IPv6 地址，自动选择最佳协议。
+ * @brief 将接收到的数据交给 nghttp2 解析
+ * @param data 数据指针
+ * @param len 数据长度
+ * @return Status 解析状态
  */
-Status Http2Client::CreateSocket(const std::string& host, int port) {
-    struct addrinfo hints, *result;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_UNSPEC;      // 支持 IPv4 和 IPv6
-    hints.ai_socktype = SOCK_STREAM;  // TCP 套接字
-    
-    // 解析主机名到 IP 地址
-    int rv = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result);
-    if (rv != 0) {
-        return Status::Unavailable("Failed to resolve host: " + std::string(gai_strerror(rv)));
-    }
-    
-    // 创建套接字
-    state_->socket_fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
-    if (state_->socket_fd < 0) {
-        freeaddrinfo(result);
-        return Status::Unavailable("Failed to create socket");
+Status Http2Client::FeedSession(const uint8_t* data, size_t len) {
+    state_->stats.parse_calls++;
+    if (state_->keepalive.enabled()) {
+        state_->keepalive.OnRead(KeepaliveTracker::Clock::now());
     }
-    
-    // 连接到服务器
-    if (connect(state_->socket_fd, result->ai_addr, result->ai_addrlen) < 0) {
-        freeaddrinfo(result);
-        return Status::Unavailable("Failed to connect");
+    ssize_t rv = nghttp2_session_mem_recv(state_->session, data, len);
+    if (rv < 0) {
+        return Status::Internal("Failed to process received data: " +
+                                std::string(nghttp2_strerror(static_cast<int>(rv))));
     }
-    
-    freeaddrinfo(result);
     return Status::OK();
 }
 
 /**
- * @brief 设置 SSL/TLS 加密连接
- * @return Status SSL 设置状态
+ * @brief 尝试以 io_uring 驱动本连接
  * 
- * 在现有 TCP 连接上建立 SSL/TLS 加密层：
- * 1. 创建 SSL 上下文
- * 2. 配置 ALPN 协议协商（用于 HTTP/2）
- * 3. 创建 SSL 连接对象
- * 4. 执行 SSL 握手
+ * 步骤：
+ * 1. 检查构建与内核是否支持（结果在进程内缓存）
+ * 2. 为套接字创建 io_uring 实例
+ * 3. TLS 连接把 SSL 对象的读写端换成内存 BIO：密文由 io_uring 收发，
+ *    OpenSSL 只负责加解密。握手已在套接字上完成，且未启用 read_ahead，
+ *    套接字中尚未读取的数据不会滞留在旧的 BIO 中
  * 
- * 使用 ALPN 扩展确保服务器支持 HTTP/2 协议。
+ * 内核 TLS 已生效的连接不能换成内存 BIO（记录层状态在内核中），
+ * 保持 epoll。任何一步失败都保持 uring_active 为 false，由调用方回退到 epoll。
  */
-Status Http2Client::SetupSsl() {
-    // 创建 SSL 上下文
-    state_->ssl_ctx = SSL_CTX_new(TLS_client_method());
-    if (!state_->ssl_ctx) {
-        return Status::Internal("Failed to create SSL context");
+void Http2Client::AttachIoUring() {
+    if (state_->stats.ktls_send || state_->stats.ktls_recv) {
+        return;
     }
-    
-    // 设置 ALPN 协议协商，指定支持 HTTP/2
-    const unsigned char alpn_protos[] = "\x02h2";  // "h2" 表示 HTTP/2
-    SSL_CTX_set_alpn_protos(state_->ssl_ctx, alpn_protos, sizeof(alpn_protos) - 1);
-    
-    // 创建 SSL 连接对象
-    state_->ssl = SSL_new(state_->ssl_ctx);
-    if (!state_->ssl) {
-        return Status::Internal("Failed to create SSL object");
+    if (!IoUring::Supported() || !state_->uring.Attach(state_->socket_fd).ok()) {
+        state_->uring.Detach();
+        return;
     }
-    
-    // 将 SSL 对象绑定到套接字
-    SSL_set_fd(state_->ssl, state_->socket_fd);
-    
-    // 执行 SSL 握手
-    if (SSL_connect(state_->ssl) <= 0) {
-        return Status::Internal("SSL handshake failed");
+    if (state_->use_ssl) {
+        BIO* rbio = BIO_new(BIO_s_mem());
+        BIO* wbio = BIO_new(BIO_s_mem());
+        if (!rbio || !wbio) {
+            BIO_free(rbio);
+            BIO_free(wbio);
+            state_->uring.Detach();
+            return;
+        }
+        BIO_set_mem_eof_return(rbio, -1);  // 没有数据时返回"重试"而不是 EOF
+        SSL_set_bio(state_->ssl, rbio, wbio);
     }
-    
-    return Status::OK();
+    state_->uring_active = true;
+    state_->stats.io_uring = true;
 }
 
 /**
- * @brief 初始化 nghttp2 会话
- * @return Status 会话初始化状态
+ * @brief 以 io_uring 写出输出队列
+ * @return Status 写出状态
  * 
- * 创建并配置 nghttp2 客户端会话：
- * 1. 创建回调函数集合
- * 2. 设置各种事件回调函数
- * 3. 创建客户端会话
- * 4. 清理临时资源
+ * 明文连接：队首最多 kMaxIov 个分片直接作为链接的 send 请求提交，
+ * 不复制；引用段的所有者计入 inflight_sends，直到发送链完成。
  * 
- * 回调函数用于处理 HTTP/2 协议事件，如数据发送、
- * 帧接收、头部处理等。
+ * TLS 连接：明文分片以 SSL_write 加密到内存 BIO（不会阻塞），密文
+ * 追加到 tls_output 后提交。已加密但未写出的密文达到 kMaxQueuedOutput
+ * 时暂停加密，积压经输出队列反压到 nghttp2。
+ * 
+ * 同一时刻只有一条发送链在途，链完成后由 PollOnceUring() 再次调用。
+ * 提交的请求在下一次 io_uring_enter 时进入内核。
  */
-Status Http2Client::InitializeSession() {
-    nghttp2_session_callbacks* callbacks;
-    nghttp2_session_callbacks_new(&callbacks);
-    
-    // 设置各种回调函数
-    nghttp2_session_callbacks_set_send_callback(callbacks, SendCallback);
-    nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, OnFrameRecvCallback);
-    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, OnDataChunkRecvCallback);
-    nghttp2_session_callbacks_set_on_header_callback(callbacks, OnHeaderCallback);
-    nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, OnStreamCloseCallback);
+Status Http2Client::FlushOutputUring() {
+    OutputQueue* queue = &state_->output_queue;
+    if (state_->use_ssl) {
+        OutputQueue& plain = state_->output_queue;
+        std::string& staging = state_->tls_staging;
+        while (!plain.empty() && state_->tls_output.size() < kMaxQueuedOutput) {
+            OutputQueue::Slice slices[kMaxIov];
+            size_t n = plain.Peek(slices, kMaxIov);
+            staging.clear();
+            for (size_t i = 0; i < n && staging.size() < kMaxTlsRecord; ++i) {
+                size_t take = std::min(slices[i].len, kMaxTlsRecord - staging.size());
+                staging.append(reinterpret_cast<const char*>(slices[i].data), take);
+            }
+            ssize_t rv = SocketSend(staging.data(), staging.size());
+            if (rv < 0) {
+                return Status::Internal("Failed to encrypt data");
+            }
+            plain.Consume(static_cast<size_t>(rv));
+        }
+        
+        // 取出内存 BIO 中的密文（也包括 SSL_read 期间产生的 TLS 控制消息）
+        BIO* wbio = SSL_get_wbio(state_->ssl);
+        char* cipher = nullptr;
+        long cipher_len = BIO_get_mem_data(wbio, &cipher);
+        if (cipher_len > 0) {
+            state_->tls_output.Append(cipher, static_cast<size_t>(cipher_len));
+            (void)BIO_reset(wbio);
+        }
+        queue = &state_->tls_output;
+    }
     
-    // 创建客户端会话
-    int rv = nghttp2_session_client_new(&state_->session, callbacks, this);
-    nghttp2_session_callbacks_del(callbacks);  // 清理回调函数集合
+    if (queue->empty() || state_->uring.send_in_flight()) {
+        return Status::OK();
+    }
     
-    if (rv != 0) {
-        return Status::Internal("Failed to create HTTP/2 session");
+    OutputQueue::Slice slices[kMaxIov];
+    size_t n = queue->Peek(slices, kMaxIov);
+    struct iovec iov[kMaxIov];
+    for (size_t i = 0; i < n; ++i) {
+        iov[i].iov_base = const_cast<uint8_t*>(slices[i].data);
+        iov[i].iov_len = slices[i].len;
+    }
+    n = state_->uring.SubmitSend(iov, n);
+    if (n == 0) {
+        return Status::OK();  // 提交队列已满，下一轮重试
     }
     
+    // 内核读取完成之前，已提交的分段不能再被修改
+    queue->Seal();
+    for (size_t i = 0; i < n; ++i) {
+        if (!slices[i].owner) {
+            continue;
+        }
+        const std::shared_ptr<void>& owner = *slices[i].owner;
+        auto& owners = state_->uring_send_owners;
+        if (owners.empty() || owners.back().get() != owner.get()) {
+            static_cast<StreamContext*>(owner.get())->inflight_sends++;
+            owners.push_back(owner);
+        }
+    }
+    state_->stats.write_calls++;
     return Status::OK();
 }
 
 /**
- * @brief 执行 HTTP/2 协议握手
- * @return Status 握手状态
- * 
- * 发送 HTTP/2 连接设置帧，建立协议参数：
- * 1. 配置最大并发流数量
- * 2. 提交设置帧到 nghttp2 会话
- * 3. 发送设置数据到服务器
+ * @brief 处理 io_uring 收到的一段数据
+ * @param data 内核填充的接收缓冲区，只在调用期间有效
+ * @param len 数据长度
+ * @return Status 处理状态
  * 
- * 这是 HTTP/2 连接建立的最后一步，确保客户端和服务器
- * 就协议参数达成一致。
+ * 明文连接直接把接收缓冲区交给 nghttp2 解析，不再复制；
+ * TLS 连接把密文写入内存 BIO，解密到 recv_buffer 后再解析。
  */
-Status Http2Client::PerformHandshake() {
-    // 配置 HTTP/2 连接设置
-    nghttp2_settings_entry iv[1] = {
-        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, 100}  // 最大并发流数量
-    };
-    
-    // 提交设置帧
-    int rv = nghttp2_submit_settings(state_->session, NGHTTP2_FLAG_NONE, iv, 1);
-    if (rv != 0) {
-        return Status::Internal("Failed to submit settings");
+Status Http2Client::OnUringData(const uint8_t* data, size_t len) {
+    state_->stats.read_calls++;
+    state_->stats.bytes_read += static_cast<uint64_t>(len);
+    if (!state_->use_ssl) {
+        return FeedSession(data, len);
     }
     
-    // 发送设置数据
-    return SendData();
+    BIO_write(SSL_get_rbio(state_->ssl), data, static_cast<int>(len));
+    std::vector<uint8_t>& buf = state_->recv_buffer;
+    if (buf.size() < kMinRecvBuffer) {
+        buf.resize(kMinRecvBuffer);
+        state_->stats.recv_buffer_size = buf.size();
+    }
+    while (true) {
+        ssize_t n = SocketRecv(buf.data(), buf.size());
+        if (n > 0) {
+            auto status = FeedSession(buf.data(), static_cast<size_t>(n));
+            if (!status.ok()) {
+                return status;
+            }
+            continue;
+        }
+        if (n == 0) {
+            return Status::Unavailable("Connection closed");  // 对端发送了 close_notify
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return Status::OK();  // 内存 BIO 中已没有完整的记录
+        }
+        return Status::Unavailable("Failed to decrypt data");
+    }
 }
 
 /**
- * @brief 发送待发送的数据
- * @return Status 发送状态
- * 
- * 将 nghttp2 会话中缓冲的数据发送到网络：
- * - 调用 nghttp2_session_send 处理所有待发送数据
- * - 数据通过 SendCallback 回调函数实际发送
+ * @brief 以 io_uring 执行一轮事件循环
+ * @param lock 已持有的连接锁
+ * @param wait_ms 本轮最长等待时间（毫秒），-1 表示不限时
+ * @return Status 事件处理状态
  * 
- * 这个方法是 HTTP/2 数据发送的核心，处理所有类型的
- * HTTP/2 帧（HEADERS、DATA、SETTINGS 等）。
+ * 一轮事件处理包括：
+ * 1. 收割完成事件：解析收到的数据，按已写出的字节数消费输出队列，
+ *    发送链完成时释放其引用的数据所有者
+ * 2. 生成待发送的帧；没有在途发送链时提交新的发送链
+ * 3. 若本轮有流结束或发送链完成，提交请求后立即返回，由调用方检查
+ * 4. 否则释放连接锁，以一次 io_uring_enter 同时提交请求并等待完成事件
  */
-Status Http2Client::SendData() {
-    int rv = nghttp2_session_send(state_->session);
-    if (rv != 0) {
-        return Status::Internal("Failed to send data");
+Status Http2Client::PollOnceUring(std::unique_lock<std::mutex>& lock, int wait_ms) {
+    const uint64_t closed_before = state_->closed_streams;
+    
+    IoUring::Completions completions;
+    auto status = CheckKeepalive();
+    if (!status.ok()) {
+        return status;
+    }
+    status = state_->uring.Reap(
+        [this](const uint8_t* data, size_t len) { return OnUringData(data, len); },
+        &completions);
+    if (!status.ok()) {
+        return status;
+    }
+    
+    if (completions.sent_bytes > 0) {
+        OutputQueue& queue = state_->use_ssl ? state_->tls_output : state_->output_queue;
+        queue.Consume(completions.sent_bytes);
+        state_->stats.bytes_written += static_cast<uint64_t>(completions.sent_bytes);
+    }
+    if (completions.send_done) {
+        for (auto& owner : state_->uring_send_owners) {
+            auto* stream = static_cast<StreamContext*>(owner.get());
+            if (--stream->inflight_sends == 0) {
+                stream->ReleaseFrameHeaders();
+                state_->cv.notify_all();  // 流关闭后仍在等待本次发送的调用方可以返回
+            }
+        }
+        state_->uring_send_owners.clear();
+    }
+    if (completions.send_error != 0) {
+        return Status::Unavailable("Failed to send data: " +
+                                   std::string(strerror(completions.send_error)));
+    }
+    if (completions.recv_error != 0) {
+        return Status::Unavailable("Failed to receive data: " +
+                                   std::string(strerror(completions.recv_error)));
+    }
+    if (completions.recv_eof) {
+        return Status::Unavailable("Connection closed");
+    }
+    
+#ifdef TCP_QUICKACK
+    if (state_->options.quickack && state_->tcp && completions.recv_count > 0) {
+        int on = 1;
+        setsockopt(state_->socket_fd, IPPROTO_TCP, TCP_QUICKACK, &on, sizeof(on));
+    }
+#endif
+    
+    // 解析过程中可能产生新的帧；发送链完成后继续写出剩余数据
+    status = SendData();
+    if (!status.ok()) {
+        return status;
+    }
+    status = FlushOutputUring();
+    if (!status.ok()) {
+        return status;
+    }
+    
+    // 唤醒已在收割时被消费，不能再进入等待：I/O 线程模式下提交调用的线程
+    // 不持有连接锁，它的唤醒可能恰好在收割时到达，新调用仍在提交队列中
+    if (state_->closed_streams != closed_before || completions.send_done || completions.woken) {
+        return state_->uring.Submit();  // 有流结束、发送链完成或被唤醒，交由调用方检查
+    }
+    
+    // 会话已不再需要任何读写
+    if (nghttp2_session_want_read(state_->session) == 0 &&
+        nghttp2_session_want_write(state_->session) == 0 &&
+        state_->output_queue.empty() && state_->tls_output.empty() &&
+        !state_->uring.send_in_flight()) {
+        return Status::Unavailable("HTTP/2 session closed");
+    }
+    
+    // 释放连接锁等待完成事件，期间其他线程可以提交新的请求
+    wait_ms = KeepaliveWaitMs(wait_ms);
+    lock.unlock();
+    status = state_->uring.Wait(wait_ms);
+    lock.lock();
+    if (!status.ok()) {
+        return status;
+    }
+    
+    if (!state_->connected) {
+        return state_->last_error;  // 等待期间连接被关闭
     }
     return Status::OK();
 }
 
 /**
- * @brief 接收并处理网络数据
- * @return Status 接收状态
+ * @brief 等待指定流结束
+ * @param lock 已持有的连接锁
+ * @param stream 等待结束的流
+ * @param timeout_ms 超时时间（毫秒），-1 表示不限时
+ * @return Status 事件处理状态
  * 
- * 从网络接收数据并交给 nghttp2 处理：
- * 1. 从套接字读取数据到缓冲区
- * 2. 检查连接状态和数据长度
- * 3. 将数据传递给 nghttp2 会话处理
+ * 采用"领导者/跟随者"模式在多个调用线程之间共享一条连接：
+ * - 若没有线程在驱动事件循环，调用线程成为轮询者，反复执行
+ *   PollOnce() 直到自己的流结束，期间也会完成其他线程的流
+ * - 否则在条件变量上等待，直到本流被轮询者完成，或轮询者
+ *   退出后由本线程接替轮询
  * 
- * nghttp2 会解析 HTTP/2 帧并触发相应的回调函数。
+ * 轮询者退出时通知所有等待者，保证连接上始终有线程推进 I/O。
  */
-Status Http2Client::ReceiveData() {
-    uint8_t buf[8192];  // 接收缓冲区
-    ssize_t readlen = SocketRecv(buf, sizeof(buf));
+Status Http2Client::ProcessEvents(std::unique_lock<std::mutex>& lock,
+                                  StreamContext* stream, int timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+    bool is_poller = false;
+    Status result;
     
-    if (readlen < 0) {
-        return Status::Internal("Failed to receive data");
+    // 流结束后还需等待引用其请求体的零拷贝发送完成
+    while (!stream->closed || stream->inflight_sends > 0) {
+        // 计算本次等待的超时时间
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                result = Status::DeadlineExceeded("Request deadline exceeded");
+                break;
+            }
+            wait_ms = static_cast<int>(remaining);
+        }
+        
+        if (!is_poller) {
+            if (state_->polling) {
+                // 其他线程正在驱动事件循环，等待本流完成或接替轮询
+                if (wait_ms < 0) {
+                    state_->cv.wait(lock);
+                } else {
+                    state_->cv.wait_for(lock, std::chrono::milliseconds(wait_ms));
+                }
+                continue;
+            }
+            state_->polling = is_poller = true;
+        }
+        
+        auto status = PollOnce(lock, wait_ms);
+        if (!status.ok()) {
+            // 连接已不可用：交还轮询权并让所有未完成的流失败
+            state_->polling = is_poller = false;
+            CloseConnection(lock, status, false);
+        }
     }
     
-    if (readlen == 0) {
-        return Status::Unavailable("Connection closed");  // 连接已关闭
+    if (is_poller) {
+        state_->polling = false;
+        state_->cv.notify_all();
     }
     
-    // 将接收到的数据传递给 nghttp2 处理
-    ssize_t rv = nghttp2_session_mem_recv(state_->session, buf, readlen);
-    if (rv < 0) {
-        return Status::Internal("Failed to process received data");
+    if (!result.ok()) {
+        return result;
     }
-    
-    return Status::OK();
+    return stream->Result();
 }
 
 /**
- * @brief 处理 HTTP/2 事件循环
+ * @brief 执行一轮 HTTP/2 事件循环
+ * @param lock 已持有的连接锁
+ * @param wait_ms 本轮最长等待时间（毫秒），-1 表示不限时
  * @return Status 事件处理状态
  * 
- * 执行完整的 HTTP/2 事件处理循环：
- * 1. 发送待发送的数据
- * 2. 检查会话是否需要读写操作
- * 3. 如果需要读取，接收并处理数据
- * 4. 重复直到没有待处理事件
+ * 一轮事件处理包括：
+ * 1. 发送 nghttp2 中所有待发送的帧，直到发送完毕或套接字不可写
+ * 2. 读取套接字直到 EAGAIN，并交给 nghttp2 解析
+ * 3. 若本轮有流结束则立即返回，由调用方检查
+ * 4. 否则释放连接锁，在 epoll 上等待套接字就绪或被其他线程唤醒
  * 
- * 这是 HTTP/2 通信的核心循环，确保所有数据
- * 正确发送和接收。
+ * 套接字以边沿触发方式注册，读写都进行到 EAGAIN 后才进入等待，
+ * 因此不会遗漏事件，也不存在固定的轮询延迟。
  */
-Status Http2Client::ProcessEvents() {
-    int max_iterations = 100;  // 防止无限循环
-    int iteration_count = 0;
+Status Http2Client::PollOnce(std::unique_lock<std::mutex>& lock, int wait_ms) {
+    if (state_->uring_active) {
+        return PollOnceUring(lock, wait_ms);
+    }
     
-    while (iteration_count < max_iterations) {
-        iteration_count++;
-        
-        // 发送待发送的数据
-        auto status = SendData();
+    const uint64_t closed_before = state_->closed_streams;
+    const uint64_t completions_before = state_->stats.zerocopy_completions;
+    
+    // 回收已完成的零拷贝发送
+    ReapZeroCopyCompletions();
+    
+    // 保活 PING 超时即放弃连接，到期时提交新的 PING
+    auto status = CheckKeepalive();
+    if (!status.ok()) {
+        return status;
+    }
+    
+    // 发送待发送的数据
+    status = SendData();
+    if (!status.ok()) {
+        return status;
+    }
+    
+    // 读取所有已到达的数据
+    if (nghttp2_session_want_read(state_->session)) {
+        status = ReceiveData();
         if (!status.ok()) {
             return status;
         }
         
-        // 检查是否还有待处理的读写操作
-        if (nghttp2_session_want_read(state_->session) == 0 &&
-            nghttp2_session_want_write(state_->session) == 0) {
-            break;  // 没有待处理操作，退出循环
-        }
-        
-        // 如果需要读取数据
-        if (nghttp2_session_want_read(state_->session)) {
-            status = ReceiveData();
-            if (!status.ok()) {
-                return status;
-            }
+        // 解析过程中可能产生新的帧（SETTINGS ACK、WINDOW_UPDATE 等）
+        status = SendData();
+        if (!status.ok()) {
+            return status;
         }
-        
-        // 添加短暂延迟避免忙等待
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
     
-    if (iteration_count >= max_iterations) {
-        return Status::Internal("ProcessEvents exceeded maximum iterations");
+    if (state_->stats.zerocopy_completions != completions_before) {
+        state_->cv.notify_all();  // 等待在途发送的调用方可能已可返回
+        return Status::OK();
+    }
+    if (state_->closed_streams != closed_before) {
+        return Status::OK();  // 有流结束，交由调用方检查
+    }
+    
+    // 会话已不再需要任何读写
+    if (nghttp2_session_want_read(state_->session) == 0 &&
+        nghttp2_session_want_write(state_->session) == 0 &&
+        state_->output_queue.empty() && state_->zerocopy_records.empty()) {
+        return Status::Unavailable("HTTP/2 session closed");
+    }
+    
+    // 释放连接锁等待套接字就绪，期间其他线程可以提交新的请求
+    EventLoop::Events events;
+    wait_ms = KeepaliveWaitMs(wait_ms);
+    lock.unlock();
+    status = state_->event_loop.Wait(wait_ms, &events);
+    lock.lock();
+    if (!status.ok()) {
+        return status;
     }
     
+    if (!state_->connected) {
+        return state_->last_error;  // 等待期间连接被关闭
+    }
     return Status::OK();
 }
 
@@ -623,9 +2367,15 @@ Status Http2Client::ProcessEvents() {
  */
 ssize_t Http2Client::SocketSend(const void* data, size_t len) {
     if (state_->use_ssl) {
-        return SSL_write(state_->ssl, data, len);  // SSL 加密发送
+        int rv = SSL_write(state_->ssl, data, static_cast<int>(len));  // SSL 加密发送
+        if (rv <= 0) {
+            int err = SSL_get_error(state_->ssl, rv);
+            errno = (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) ? EAGAIN : EIO;
+            return -1;
+        }
+        return rv;
     } else {
-        return send(state_->socket_fd, data, len, 0);  // 普通套接字发送
+        return send(state_->socket_fd, data, len, MSG_NOSIGNAL);  // 普通套接字发送
     }
 }
 
@@ -641,7 +2391,16 @@ ssize_t Http2Client::SocketSend(const void* data, size_t len) {
  */
 ssize_t Http2Client::SocketRecv(void* data, size_t len) {
     if (state_->use_ssl) {
-        return SSL_read(state_->ssl, data, len);  // SSL 加密接收
+        int rv = SSL_read(state_->ssl, data, static_cast<int>(len));  // SSL 加密接收
+        if (rv <= 0) {
+            int err = SSL_get_error(state_->ssl, rv);
+            if (err == SSL_ERROR_ZERO_RETURN) {
+                return 0;  // 对端发送了 close_notify
+            }
+            errno = (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) ? EAGAIN : EIO;
+            return -1;
+        }
+        return rv;
     } else {
         return recv(state_->socket_fd, data, len, 0);  // 普通套接字接收
     }
@@ -662,12 +2421,18 @@ ssize_t Http2Client::SocketRecv(void* data, size_t len) {
  * @return ssize_t 实际发送的字节数，失败返回负值
  * 
  * 当 nghttp2 需要发送数据时调用此回调函数。
- * 函数将数据转发给 Http2Client 的 SocketSend 方法进行实际发送。
+ * data 只在回调期间有效，因此复制到输出队列，由 FlushOutput() 批量写出。
+ * 队列积压达到上限时返回 NGHTTP2_ERR_WOULDBLOCK，nghttp2 会保留剩余数据。
  */
 ssize_t Http2Client::SendCallback(nghttp2_session* session, const uint8_t* data,
                                  size_t length, int flags, void* user_data) {
     Http2Client* client = static_cast<Http2Client*>(user_data);
-    return client->SocketSend(data, length);
+    OutputQueue& queue = client->state_->output_queue;
+    if (queue.size() >= kMaxQueuedOutput) {
+        return NGHTTP2_ERR_WOULDBLOCK;
+    }
+    queue.Append(data, length);
+    return static_cast<ssize_t>(length);
 }
 
 /**
@@ -678,13 +2443,48 @@ ssize_t Http2Client::SendCallback(nghttp2_session* session, const uint8_t* data,
  * @return int 处理结果，0 表示成功
  * 
  * 当接收到完整的 HTTP/2 帧时调用此回调函数。
- * 可以在此处理特定类型的帧（如 HEADERS、DATA、SETTINGS 等）。
- * 当前实现为基础版本，可根据需要扩展具体的帧处理逻辑。
+ * 目前处理的帧类型：
+ * - PING ACK：BDP 探测完成，估计值增长时将接收窗口扩大到估计值的两倍；
+ *   保活 PING 完成，记录 RTT 采样
+ * - GOAWAY：连接进入排空状态，不再接受新请求；编号不超过 last_stream_id
+ *   的流继续完成，更大的流由 nghttp2 以 REFUSED_STREAM 关闭。服务器可能先后
+ *   发送多个 GOAWAY（先以最大流 ID 预告，再给出实际值），取最小值
  */
 int Http2Client::OnFrameRecvCallback(nghttp2_session* session,
                                     const nghttp2_frame* frame, void* user_data) {
-    // 处理帧接收事件
-    // 可根据 frame->hd.type 处理不同类型的帧
+    Http2Client* client = static_cast<Http2Client*>(user_data);
+    ConnectionState* state = client->state_.get();
+    
+    if (frame->hd.type == NGHTTP2_PING && (frame->hd.flags & NGHTTP2_FLAG_ACK) &&
+        memcmp(frame->ping.opaque_data, kBdpPingPayload, sizeof(kBdpPingPayload)) == 0) {
+        if (state->bdp.ping_in_flight() && state->bdp.CompletePing(BdpEstimator::Clock::now())) {
+            state->stats.bdp_estimate = state->bdp.estimate();
+            // nghttp2 在消费了半个窗口后才发送 WINDOW_UPDATE，稳态下每个 RTT
+            // 只能收到约半个窗口的数据，因此窗口取估计值的两倍
+            int32_t window = static_cast<int32_t>(
+                std::min<int64_t>(state->bdp.estimate() * 2, kMaxBdpWindow));
+            if (!client->GrowReceiveWindow(window).ok()) {
+                return NGHTTP2_ERR_CALLBACK_FAILURE;
+            }
+        }
+    } else if (frame->hd.type == NGHTTP2_GOAWAY) {
+        state->draining = true;
+        state->goaway_last_stream_id = std::min(state->goaway_last_stream_id,
+                                                frame->goaway.last_stream_id);
+        state->stats.goaway_received = true;
+        state->stats.goaway_last_stream_id = state->goaway_last_stream_id;
+        state->stats.goaway_error_code = frame->goaway.error_code;
+        state->cv.notify_all();
+    } else if (frame->hd.type == NGHTTP2_PING && (frame->hd.flags & NGHTTP2_FLAG_ACK) &&
+               memcmp(frame->ping.opaque_data, kKeepalivePingPayload, sizeof(kKeepalivePingPayload)) == 0) {
+        KeepaliveTracker& keepalive = state->keepalive;
+        if (keepalive.CompletePing(KeepaliveTracker::Clock::now()) >= 0) {
+            state->stats.rtt_samples = keepalive.rtt_samples();
+            state->stats.last_rtt_us = keepalive.last_rtt_us();
+            state->stats.min_rtt_us = keepalive.min_rtt_us();
+            state->stats.smoothed_rtt_us = keepalive.smoothed_rtt_us();
+        }
+    }
     return 0;
 }
 
@@ -699,14 +2499,25 @@ int Http2Client::OnFrameRecvCallback(nghttp2_session* session,
  * @return int 处理结果，0 表示成功
  * 
  * 当接收到 HTTP/2 DATA 帧的数据块时调用此回调函数。
- * 函数将接收到的数据追加到对应流的响应体中。
+ * 函数将接收到的数据交给对应流的 gRPC 消息解析器，并为 BDP 估计累计字节数。
+ * 解析出错（前缀无效或消息超限）时以 CANCEL 重置该流，不再接收其余数据，
+ * 调用方从解析器取得错误状态。
  */
 int Http2Client::OnDataChunkRecvCallback(nghttp2_session* session, uint8_t flags,
                                         int32_t stream_id, const uint8_t* data,
                                         size_t len, void* user_data) {
+    auto* stream = static_cast<StreamContext*>(
+        nghttp2_session_get_stream_user_data(session, stream_id));
+    if (stream && stream->response.messages.status().ok()) {
+        if (!stream->response.messages.Consume(data, len).ok()) {
+            nghttp2_submit_rst_stream(session, NGHTTP2_FLAG_NONE, stream_id, NGHTTP2_CANCEL);
+        }
+    }
+    
+    // 累计 BDP 样本
     Http2Client* client = static_cast<Http2Client*>(user_data);
-    auto& response = client->state_->responses[stream_id];
-    response.body.append(reinterpret_cast<const char*>(data), len);
+    client->state_->bdp.AddIncomingBytes(static_cast<int64_t>(len));
+    client->MaybeStartBdpPing();
     return 0;
 }
 
@@ -724,26 +2535,35 @@ int Http2Client::OnDataChunkRecvCallback(nghttp2_session* session, uint8_t flags
  * 
  * 当接收到 HTTP/2 HEADERS 帧中的头部字段时调用此回调函数。
  * 函数处理 HTTP 响应头部，包括：
- * - `:status` 伪头部：设置响应状态码
- * - 其他头部：存储到响应的头部映射中
+ * - `:status` 伪头部：不抛出异常地解析为响应状态码
+ * - 其他头部：追加到响应的头部表中，不为每个头部分配内存
  */
 int Http2Client::OnHeaderCallback(nghttp2_session* session,
                                  const nghttp2_frame* frame,
                                  const uint8_t* name, size_t namelen,
                                  const uint8_t* value, size_t valuelen,
                                  uint8_t flags, void* user_data) {
-    Http2Client* client = static_cast<Http2Client*>(user_data);
+    if (frame->hd.type != NGHTTP2_HEADERS) {
+        return 0;
+    }
+    auto* stream = static_cast<StreamContext*>(
+        nghttp2_session_get_stream_user_data(session, frame->hd.stream_id));
+    if (!stream) {
+        return 0;
+    }
     
-    // 转换头部名称和值为字符串
-    std::string header_name(reinterpret_cast<const char*>(name), namelen);
-    std::string header_value(reinterpret_cast<const char*>(value), valuelen);
+    // 名称和值直接以 string_view 引用 nghttp2 的缓冲区，由头部表复制到自身存储区
+    const std::string_view header_name(reinterpret_cast<const char*>(name), namelen);
+    const std::string_view header_value(reinterpret_cast<const char*>(value), valuelen);
     
-    // 处理 HTTP/2 伪头部 :status
+    // 处理 HTTP/2 伪头部 :status，格式错误时保持为 0，由调用方按非 200 处理
     if (header_name == ":status") {
-        client->state_->responses[frame->hd.stream_id].status_code = std::stoi(header_value);
+        if (!ParseNonNegativeInt(header_value, &stream->response.status_code)) {
+            stream->response.status_code = 0;
+        }
     } else {
-        // 存储普通 HTTP 头部
-        client->state_->responses[frame->hd.stream_id].headers[header_name] = header_value;
+        // 存储普通 HTTP 头部与 trailers
+        stream->response.metadata.Add(header_name, header_value);
     }
     
     return 0;
@@ -758,15 +2578,141 @@ int Http2Client::OnHeaderCallback(nghttp2_session* session,
  * @return int 处理结果，0 表示成功
  * 
  * 当 HTTP/2 流关闭时调用此回调函数。
- * 可以在此处理流关闭事件，如清理资源、记录日志等。
- * 当前实现为基础版本，可根据需要扩展具体的清理逻辑。
+ * 记录该流的关闭状态和错误码，并唤醒所有等待中的调用线程，
+ * 各线程据此判断自己的请求是否完成。
  */
 int Http2Client::OnStreamCloseCallback(nghttp2_session* session, int32_t stream_id,
                                       uint32_t error_code, void* user_data) {
-    // 流已关闭
-    // 可在此处添加流关闭后的清理逻辑
+    Http2Client* client = static_cast<Http2Client*>(user_data);
+    auto& state = *client->state_;
+    
+    auto it = state.streams.find(stream_id);
+    if (it != state.streams.end()) {
+        it->second->closed = true;
+        it->second->error_code = error_code;
+        // REFUSED_STREAM 表示服务器没有处理该流（RFC 9113 第 8.7 节）；
+        // nghttp2 在收到 GOAWAY 时也以该错误码关闭编号更大的流
+        it->second->refused = error_code == NGHTTP2_REFUSED_STREAM;
+        client->FinishBody(stream_id, it->second.get());
+        state.streams.erase(it);
+    }
+    state.closed_streams++;
+    state.cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 请求体数据读取回调函数
+ * @param session nghttp2 会话指针
+ * @param stream_id 流 ID
+ * @param buf nghttp2 提供的缓冲区（未使用）
+ * @param length 本帧允许的最大负载长度
+ * @param data_flags 输出的数据标志
+ * @param source 数据源（StreamContext）
+ * @param user_data 用户数据指针（Http2Client 实例）
+ * @return ssize_t 本帧负载长度
+ * 
+ * 根据已发送偏移量计算下一帧的负载长度。请求体可以是任意二进制
+ * 数据（gRPC 帧本身就包含 NUL 字节），长度取自 std::string::size()。
+ * 设置 NO_COPY 标志后，nghttp2 不会复制负载，而是在发送时调用
+ * OnSendDataCallback。
+ * 
+ * 有更紧急的流还有请求体未写出、且其流窗口未耗尽时返回 NGHTTP2_ERR_DEFERRED
+ * 暂停本流，由 FinishBody() 在那些流写完后恢复，或由 SendData() 在它们
+ * 耗尽流窗口后恢复。
+ */
+ssize_t Http2Client::DataSourceReadCallback(nghttp2_session* session, int32_t stream_id,
+                                           uint8_t* buf, size_t length, uint32_t* data_flags,
+                                           nghttp2_data_source* source, void* user_data) {
+    auto* stream = static_cast<StreamContext*>(source->ptr);
+    auto& state = *static_cast<Http2Client*>(user_data)->state_;
+    if (state.scheduler.ShouldDefer(stream->priority.urgency, StreamCanSend(session))) {
+        state.scheduler.Defer(stream_id, stream->priority.urgency);
+        state.stats.priority_deferrals++;
+        return NGHTTP2_ERR_DEFERRED;
+    }
+    const size_t remaining = stream->request_body->size() - stream->body_offset;
+    const size_t n = std::min(length, remaining);
+    
+    *data_flags |= NGHTTP2_DATA_FLAG_NO_COPY;
+    if (n == remaining) {
+        *data_flags |= NGHTTP2_DATA_FLAG_EOF;  // 最后一帧，同时结束流
+    }
+    return static_cast<ssize_t>(n);
+}
+
+/**
+ * @brief DATA 帧发送回调函数
+ * @param session nghttp2 会话指针
+ * @param frame 待发送的 DATA 帧
+ * @param framehd 9 字节帧头
+ * @param length 负载长度
+ * @param source 数据源（StreamContext）
+ * @param user_data 用户数据指针（Http2Client 实例）
+ * @return int 0 表示成功，NGHTTP2_ERR_WOULDBLOCK 表示稍后重试
+ * 
+ * nghttp2 要求此回调整帧提交，因此帧头复制到流上下文中保存，
+ * 帧头与负载切片都以引用方式追加到输出队列，已写出的帧头在生成
+ * 下一帧或在途发送完成时回收。队列段持有流上下文的
+ * 引用，即使流在写出前被关闭，被引用的数据也保持有效。
+ * 负载直接从调用方缓冲区写入套接字，没有中间拷贝。
+ * 
+ * 启用优先级约束后，非最高紧急度的帧只在队列积压较少时加入，
+ * 见 WriteScheduler::QueueLimit()。
+ * 每个 DATA 帧都重置保活 PING 的无数据计数，长时间上传期间的 PING
+ * 不受 max_pings_without_data 限制。
+ */
+int Http2Client::OnSendDataCallback(nghttp2_session* session, nghttp2_frame* frame,
+                                   const uint8_t* framehd, size_t length,
+                                   nghttp2_data_source* source, void* user_data) {
+    Http2Client* client = static_cast<Http2Client*>(user_data);
+    OutputQueue& queue = client->state_->output_queue;
+    auto it = client->state_->streams.find(frame->hd.stream_id);
+    if (it == client->state_->streams.end()) {
+        return NGHTTP2_ERR_CALLBACK_FAILURE;
+    }
+    const std::shared_ptr<StreamContext>& stream = it->second;
+    if (queue.size() >= client->state_->scheduler.QueueLimit(stream->priority.urgency, kMaxQueuedOutput)) {
+        return NGHTTP2_ERR_WOULDBLOCK;
+    }
+    
+    stream->ReleaseFrameHeaders();
+    stream->frame_headers.emplace_back();
+    std::array<uint8_t, 9>& header = stream->frame_headers.back();
+    memcpy(header.data(), framehd, header.size());
+    
+    const uint8_t* payload =
+        reinterpret_cast<const uint8_t*>(stream->request_body->data()) + stream->body_offset;
+    queue.AppendRef(header.data(), header.size(), stream, &stream->released_header_bytes);
+    queue.AppendRef(payload, length, stream);
+    stream->body_offset += length;
+    if (stream->body_offset == stream->request_body->size()) {
+        client->FinishBody(frame->hd.stream_id, stream.get());
+    }
+    client->state_->keepalive.OnDataSent();
     return 0;
 }
 
+/**
+ * @brief 流的请求体已全部进入输出队列或流已关闭，从 WriteScheduler 中注销
+ * @param stream_id 流 ID
+ * @param stream 流上下文
+ * 
+ * 该紧急度上已没有未写出的请求体时，恢复所有暂停的流；仍需让路的流
+ * 会在下一次生成 DATA 帧时再次暂停。已关闭的流恢复失败，直接忽略。
+ * 调用方必须持有连接锁。
+ */
+void Http2Client::FinishBody(int32_t stream_id, StreamContext* stream) {
+    if (!stream->body_pending) {
+        return;
+    }
+    stream->body_pending = false;
+    if (state_->scheduler.RemoveBody(stream_id, stream->priority.urgency)) {
+        for (int32_t stream_id : state_->scheduler.TakeDeferred()) {
+            nghttp2_session_resume_data(state_->session, stream_id);
+        }
+    }
+}
+
 } // namespace http2
-} // namespace litegrpc
\ No newline at end of file
+} // namespace litegrpc
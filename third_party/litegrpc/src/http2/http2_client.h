@@ -27,12 +27,22 @@
 #ifndef LITEGRPC_HTTP2_CLIENT_H
 #define LITEGRPC_HTTP2_CLIENT_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <nghttp2/nghttp2.h>  // nghttp2 库，提供 HTTP/2 协议实现
 #include "litegrpc/status.h"  // LiteGRPC 状态码定义
+#include "connector.h"          // ResolvedAddress
+#include "header_block.h"       // HeaderBlock
+#include "grpc_message_reader.h"  // GrpcMessageReader
+#include "response_metadata.h"  // ResponseMetadata
+#include "tls_context.h"        // TlsContext
+#include "tls_ticket_store.h"   // TlsTicketStore
+#include "write_scheduler.h"    // StreamPriority
 
 namespace litegrpc {
 namespace http2 {
@@ -44,14 +54,243 @@ namespace http2 {
  * 用于在客户端接收和处理服务器响应时传递数据。
  * 
  * 字段说明：
- * - status_code: HTTP 状态码（如 200, 404, 500 等）
- * - headers: HTTP 头部字段的键值对映射
- * - body: 响应体内容（对于 gRPC，通常是序列化的 protobuf 数据）
+ * - status_code: HTTP 状态码（如 200, 404, 500 等），缺失或格式错误时为 0
+ * - metadata: 响应头部与 trailers（不含伪头部），gRPC 常用头部可按槽位直接读取
+ * - messages: 响应体中的 gRPC 消息，由 DATA 帧增量解析，不缓存原始响应体
+ * - refused: 请求失败时，服务器是否确定没有处理该请求
  */
 struct Http2Response {
     int status_code = 0;                                ///< HTTP 状态码
-    std::map<std::string, std::string> headers;         ///< HTTP 头部字段
-    std::string body;                                   ///< 响应体内容
+    ResponseMetadata metadata;                          ///< 响应头部与 trailers
+    GrpcMessageReader messages;                         ///< 响应体中的 gRPC 消息
+    bool refused = false;                               ///< 服务器未处理该请求（GOAWAY 之后的流或 REFUSED_STREAM），可以安全重试
+};
+
+/**
+ * @brief 传输层选项
+ * 
+ * 由通道根据 ChannelArguments 构造，在 Connect() 时传入。
+ * 默认值即为未配置时的行为。
+ */
+struct TransportOptions {
+    /**
+     * 一次发送需要多个系统调用（例如 TLS 连接上超过一个记录的输出）
+     * 时，用 TCP_CORK 包裹整批写入，避免产生不满的报文段
+     */
+    bool tcp_cork = false;
+    
+    /**
+     * 明文连接上单次写出的 DATA 帧数据达到该字节数时使用
+     * MSG_ZEROCOPY 发送，0 表示禁用。内核不支持时自动回退为普通发送
+     */
+    size_t zerocopy_threshold = 0;
+    
+    /**
+     * 通过 SETTINGS_INITIAL_WINDOW_SIZE 通告的流级接收窗口（字节），
+     * 0 表示使用协议默认值 65535
+     */
+    int32_t initial_window_size = 0;
+    
+    /**
+     * 连接级接收窗口（字节），握手时以 WINDOW_UPDATE 扩大，
+     * 0 表示使用协议默认值 65535
+     */
+    int32_t connection_window_size = 0;
+    
+    /**
+     * 是否以 PING 探测带宽时延积并自动扩大流级与连接级接收窗口。
+     * 以上两个窗口作为起始值，窗口只增不减，最大 16MB
+     */
+    bool bdp_probe = true;
+    
+    /**
+     * nghttp2 会话内存池的字节预算，0 表示不限。会话内部对象（流结构、
+     * HPACK 动态表、帧缓冲区等）都从每个连接独占的内存池分配，
+     * 池向系统申请的总量达到预算后，新请求以 RESOURCE_EXHAUSTED 失败；
+     * 解析收到的帧时超出预算则关闭连接。会话本身约占 34KB，预算还需容纳并发调用的流对象
+     */
+    size_t session_memory_limit = 0;
+    
+    // ========== 保活 ==========
+    
+    /**
+     * 连接上多久没有收到任何数据后发送保活 PING（毫秒），0 表示不启用。
+     * 用于发现半开的 TCP 连接：对端断电或网络中断时套接字不会报错，
+     * 调用会一直等到自己的截止时间
+     */
+    int keepalive_time_ms = 0;
+    
+    /** 保活 PING 发出后等待 ACK（或任何数据）的时间（毫秒），超时即关闭连接 */
+    int keepalive_timeout_ms = 20000;
+    
+    /**
+     * 没有未完成的调用时是否也发送保活 PING。只在 io_thread 为 true 时生效：
+     * 否则事件循环由发起调用的线程驱动，没有调用时无人发送 PING，
+     * 空闲连接的检查推迟到下一次调用开始时
+     */
+    bool keepalive_permit_without_calls = false;
+    
+    /** 两次发送 HEADERS/DATA 之间最多发送的保活 PING 数，0 表示不限 */
+    int max_pings_without_data = 2;
+    
+    /** 没有发送数据时两次保活 PING 的最小间隔（毫秒） */
+    int min_ping_interval_without_data_ms = 0;
+    
+    // ========== 套接字选项 ==========
+    
+    /** 是否设置 TCP_NODELAY，关闭 Nagle 算法。写路径已自行合并输出，默认开启 */
+    bool tcp_nodelay = true;
+    
+    /** SO_SNDBUF（字节），0 表示保留内核自动调整 */
+    int send_buffer_size = 0;
+    
+    /** SO_RCVBUF（字节），0 表示保留内核自动调整。在 connect 前设置，影响窗口缩放因子 */
+    int recv_buffer_size = 0;
+    
+    /** TCP_USER_TIMEOUT（毫秒）：已发送数据多久未被确认即断开连接，0 表示内核默认 */
+    int user_timeout_ms = 0;
+    
+    /** SO_BUSY_POLL（微秒）：读取时忙轮询网卡队列的时长，0 表示禁用。
+     *  超过 net.core.busy_read 的值需要 CAP_NET_ADMIN */
+    int busy_poll_us = 0;
+    
+    /** 是否在每次读取后重新设置 TCP_QUICKACK，立即确认收到的数据 */
+    bool quickack = false;
+    
+    // ========== I/O 后端 ==========
+    
+    /**
+     * 是否使用 io_uring 代替 epoll 驱动套接字读写（多发 recv + 注册的接收
+     * 缓冲区环 + 链接的 send）。需要以 LITEGRPC_WITH_IO_URING 构建且内核
+     * 支持（5.19 及以上），否则自动回退到 epoll。启用后不使用 MSG_ZEROCOPY
+     */
+    bool io_uring = false;
+    
+    /**
+     * 是否由每个连接独占的 I/O 线程驱动事件循环。调用线程只把请求放入
+     * 无锁提交队列并唤醒 I/O 线程，不获取连接锁、不竞争轮询权，
+     * 由 I/O 线程提交请求、读写套接字并通知调用完成。
+     * 适合大量线程在同一连接上并发发起短调用的场景；
+     * 关闭（默认）时由发起调用的线程轮流驱动事件循环
+     */
+    bool io_thread = false;
+    
+    // ========== TLS ==========
+    
+    /**
+     * 是否在 TLS 握手后把记录层交给内核（kTLS，OpenSSL 3 的
+     * SSL_OP_ENABLE_KTLS）。发送方向生效后明文直接以 sendmsg 批量写出，
+     * 由内核加密；接收方向生效后 SSL_read 不再在用户态解密。
+     * OpenSSL、内核（CONFIG_TLS）或协商出的密码套件不支持时自动保持用户态 TLS。
+     * 内核 TLS 生效的连接不使用 io_uring 后端
+     */
+    bool ktls = false;
+    
+    /**
+     * TLS 连接使用的共享上下文（根证书、客户端证书、ALPN、密码套件），
+     * 通常由 SslChannelCredentialsImpl 构建一次后在所有连接间共享。
+     * 为空时使用进程默认上下文（系统根证书，无客户端证书）
+     */
+    std::shared_ptr<TlsContext> tls_context;
+    
+    /**
+     * 是否在重连时以上一次连接获得的会话恢复 TLS（TLS 1.3 票据或 TLS 1.2 会话），
+     * 省去证书链传输、校验与一次非对称运算。会话按凭证与目标地址缓存在 TLS 上下文中
+     */
+    bool tls_session_resumption = true;
+    
+    /**
+     * 会话的磁盘存储，为空时会话只缓存在进程内。
+     * 设置后进程重启后的第一次连接也能恢复会话
+     */
+    std::shared_ptr<TlsTicketStore> tls_ticket_store;
+};
+
+/**
+ * @brief 套接字选项的实际生效值
+ * 
+ * 连接建立后通过 getsockopt 读回，用于诊断。
+ * 内核可能调整请求的值（例如 SO_SNDBUF/SO_RCVBUF 会翻倍并受 wmem_max/rmem_max 限制），
+ * 权限不足时选项可能完全没有生效。
+ */
+struct SocketSettings {
+    bool tcp_nodelay = false;            ///< TCP_NODELAY
+    int send_buffer_size = 0;            ///< SO_SNDBUF（字节）
+    int recv_buffer_size = 0;            ///< SO_RCVBUF（字节）
+    int user_timeout_ms = 0;             ///< TCP_USER_TIMEOUT（毫秒）
+    int busy_poll_us = 0;                ///< SO_BUSY_POLL（微秒）
+    bool quickack = false;               ///< 是否在每次读取后启用 TCP_QUICKACK
+};
+
+/**
+ * @brief 传输层统计信息
+ * 
+ * 用于观察读写路径的批量效果（每次系统调用平均携带的字节数、
+ * 每次交给 nghttp2 解析的字节数）。
+ * 计数在连接的整个生命周期内累积，重新连接时清零。
+ */
+struct TransportStats {
+    uint64_t write_calls = 0;            ///< 写系统调用次数（writev/sendmsg/SSL_write），io_uring 下为提交的发送链数
+    uint64_t bytes_written = 0;          ///< 写出的总字节数
+    uint64_t zerocopy_calls = 0;         ///< 使用 MSG_ZEROCOPY 的写调用次数
+    uint64_t zerocopy_completions = 0;   ///< 已收到完成通知的零拷贝发送次数
+    uint64_t zerocopy_copied = 0;        ///< 内核实际回退为复制的零拷贝发送次数
+    uint64_t read_calls = 0;             ///< 成功读取数据的读调用次数（recv/SSL_read），io_uring 下为接收完成事件数
+    uint64_t bytes_read = 0;             ///< 读取的总字节数
+    uint64_t parse_calls = 0;            ///< nghttp2_session_mem_recv 调用次数
+    size_t recv_buffer_size = 0;         ///< 当前接收缓冲区容量（字节）
+    uint64_t bdp_pings = 0;              ///< 已发送的 BDP 探测 PING 数
+    int64_t bdp_estimate = 0;            ///< 当前 BDP 估计值（字节）
+    int32_t local_window_size = 0;       ///< 当前通告的流级接收窗口（字节）
+    SocketSettings socket;               ///< 套接字选项的实际生效值
+    bool io_uring = false;               ///< 本连接是否由 io_uring 驱动（否则为 epoll）
+    bool io_thread = false;              ///< 本连接是否由独占的 I/O 线程驱动
+    uint64_t io_thread_submissions = 0;  ///< I/O 线程从提交队列取出的调用数
+    uint64_t io_thread_wakeups = 0;      ///< I/O 线程的事件循环轮数
+    uint64_t uring_enter_calls = 0;      ///< io_uring_enter 系统调用次数
+    bool ktls_send = false;              ///< TLS 发送方向是否由内核加密
+    bool ktls_recv = false;              ///< TLS 接收方向是否由内核解密
+    bool tls_resumed = false;            ///< TLS 握手是否以会话恢复完成
+    bool goaway_received = false;        ///< 是否收到了 GOAWAY（连接正在排空）
+    int32_t goaway_last_stream_id = 0;   ///< GOAWAY 中服务器最后处理的流 ID
+    uint32_t goaway_error_code = 0;      ///< GOAWAY 中的错误码
+    uint64_t keepalive_pings = 0;        ///< 已发送的保活 PING 数
+    uint64_t rtt_samples = 0;            ///< 保活 PING 的 RTT 采样数
+    int64_t last_rtt_us = 0;             ///< 最近一次 RTT（微秒）
+    int64_t min_rtt_us = 0;              ///< 最小 RTT（微秒）
+    int64_t smoothed_rtt_us = 0;         ///< 平滑 RTT（微秒）
+    bool priority_scheduling = false;    ///< 是否已启用输出队列与套接字上的优先级约束
+    uint64_t priority_deferrals = 0;     ///< 因更紧急的流尚有请求体未写出而暂停生成 DATA 帧的次数
+    size_t session_memory_in_use = 0;    ///< nghttp2 会话当前占用的内存（字节，按内存池的块大小计）
+    size_t session_memory_reserved = 0;  ///< 会话内存池向系统申请的内存（字节）
+    size_t session_memory_peak = 0;      ///< 会话内存池向系统申请的内存峰值（字节）
+    uint64_t session_allocations = 0;    ///< nghttp2 的内存分配请求次数
+    uint64_t session_system_allocations = 0;  ///< 会话内存池向系统申请内存的次数
+    uint64_t session_allocation_failures = 0; ///< 超出预算而失败的分配次数
+};
+
+/**
+ * @brief 进程内 TLS 连接记录层路径的累计计数
+ * 
+ * 每条 TLS 连接握手成功后按实际生效的路径计数一次，
+ * 用于确认 kTLS 在当前内核与密码套件下是否真正生效。
+ */
+struct TlsPathCounters {
+    uint64_t kernel_send = 0;            ///< 发送方向由内核加密的连接数
+    uint64_t kernel_recv = 0;            ///< 接收方向由内核解密的连接数
+    uint64_t user_space = 0;             ///< 两个方向都在用户态处理的连接数
+};
+
+/**
+ * @brief 进程内 TLS 会话恢复的累计计数
+ * 
+ * 每条 TLS 连接握手成功后计数一次，用于确认重连是否真正省去了完整握手。
+ */
+struct TlsSessionCounters {
+    uint64_t full_handshakes = 0;        ///< 完整握手的连接数（包括会话被服务器拒绝的连接）
+    uint64_t resumption_offered = 0;     ///< 握手时提供了缓存会话的连接数
+    uint64_t resumed = 0;                ///< 以会话恢复完成握手的连接数
+    uint64_t resumed_from_disk = 0;      ///< 其中会话来自磁盘票据存储的连接数
 };
 
 /**
@@ -73,8 +312,9 @@ struct Http2Response {
  * - 需要 HTTP/2 协议支持的网络库
  * 
  * 线程安全性：
- * - 非线程安全，需要外部同步
- * - 建议每个线程使用独立的实例
+ * - 所有公有方法均可从多个线程并发调用
+ * - 并发的 SendRequest() 以独立的流复用同一条 TCP 连接
+ * - 同一时刻只有一个调用线程驱动事件循环，其余线程等待各自的流完成
  * 
  * 使用示例：
  * @code
@@ -113,10 +353,12 @@ public:
      * @param host 服务器主机名或 IP 地址
      * @param port 服务器端口号
      * @param use_ssl 是否使用 SSL/TLS 加密连接
-     * @return Status 连接状态，成功返回 OK
+     * @param options 传输层选项
+     * @param timeout_ms 连接超时时间（毫秒），覆盖地址连接与 TLS 握手，-1 表示不限时
+     * @return Status 连接状态，成功返回 OK；超时返回 DEADLINE_EXCEEDED
      * 
      * 建立到指定服务器的 HTTP/2 连接。此方法会：
-     * 1. 创建 TCP 套接字连接
+     * 1. 以 Happy Eyeballs 方式并行尝试所有解析出的地址，创建 TCP 连接
      * 2. 如果启用 SSL，进行 TLS 握手
      * 3. 执行 HTTP/2 协议握手
      * 4. 初始化 nghttp2 会话
@@ -126,7 +368,26 @@ public:
      * - SSL 连接需要有效的证书验证
      * - 连接失败时会返回相应的错误状态
      */
-    Status Connect(const std::string& host, int port, bool use_ssl);
+    Status Connect(const std::string& host, int port, bool use_ssl,
+                   const TransportOptions& options = TransportOptions(),
+                   int timeout_ms = -1);
+    
+    /**
+     * @brief 使用已解析的地址连接到 HTTP/2 服务器
+     * @param host 服务器主机名，用于记录胜出地址
+     * @param port 服务器端口号
+     * @param addresses 候选地址列表（已包含端口），由调用方解析（例如经过 DNS 缓存）
+     * @param use_ssl 是否使用 SSL/TLS 加密连接
+     * @param options 传输层选项
+     * @param timeout_ms 连接超时时间（毫秒），-1 表示不限时
+     * @return Status 连接状态，成功返回 OK；超时返回 DEADLINE_EXCEEDED
+     * 
+     * 与上一个重载相同，但跳过主机名解析。
+     */
+    Status Connect(const std::string& host, int port,
+                   const std::vector<ResolvedAddress>& addresses, bool use_ssl,
+                   const TransportOptions& options = TransportOptions(),
+                   int timeout_ms = -1);
     
     /**
      * @brief 断开连接
@@ -148,10 +409,38 @@ public:
      * 检查当前是否有活跃的 HTTP/2 连接。此方法会验证：
      * - TCP 套接字是否有效
      * - nghttp2 会话是否正常
-     * - 连接是否可用于发送请求
+     * - 连接是否可用于发送请求（收到 GOAWAY 后不再可用）
      */
     bool IsConnected() const;
     
+    /**
+     * @brief 连接是否正在排空
+     * @return bool 收到 GOAWAY 后返回 true
+     * 
+     * 排空中的连接不再接受新请求，编号不超过 GOAWAY last_stream_id 的流
+     * 继续完成。调用方应为新请求建立另一条连接，而不是在本实例上
+     * 重新 Connect()（那会让仍在进行的流失败）。
+     */
+    bool IsDraining() const;
+    
+    /**
+     * @brief 获取当前连接的传输层统计信息
+     * @return TransportStats 统计信息快照
+     */
+    TransportStats GetTransportStats() const;
+    
+    /**
+     * @brief 获取进程内所有 TLS 连接的记录层路径计数
+     * @return TlsPathCounters 计数快照
+     */
+    static TlsPathCounters GetTlsPathCounters();
+    
+    /**
+     * @brief 获取进程内所有 TLS 连接的会话恢复计数
+     * @return TlsSessionCounters 计数快照
+     */
+    static TlsSessionCounters GetTlsSessionCounters();
+    
     // ========== HTTP/2 请求接口 ==========
     
     /**
@@ -161,7 +450,8 @@ public:
      * @param headers HTTP 头部字段的键值对映射
      * @param body 请求体内容（对于 gRPC，通常是序列化的 protobuf 数据）
      * @param response 输出参数，用于接收服务器响应
-     * @return Status 请求状态，成功返回 OK
+     * @param timeout_ms 等待响应的超时时间（毫秒），-1 表示不限时
+     * @return Status 请求状态，成功返回 OK；超时返回 DEADLINE_EXCEEDED
      * 
      * 发送 HTTP/2 请求并等待响应。此方法会：
      * 1. 创建新的 HTTP/2 流
@@ -179,14 +469,45 @@ public:
      * 注意：
      * - 必须在连接建立后调用
      * - 此方法是同步的，会阻塞直到响应完成
+     * - 多个线程可同时调用，各请求在同一会话上以不同的流并发传输
      * - 网络错误或协议错误会返回相应状态码
+     * - 超时后会向服务器发送 RST_STREAM 取消该流
+     * - 连接正在排空，或服务器以 GOAWAY/REFUSED_STREAM 表明未处理该流时，
+     *   返回 UNAVAILABLE 并设置 response->refused，调用方可在新连接上重试
      */
     Status SendRequest(
         const std::string& method,
         const std::string& path,
         const std::map<std::string, std::string>& headers,
         const std::string& body,
-        Http2Response* response);
+        Http2Response* response,
+        int timeout_ms = -1);
+    
+    /**
+     * @brief 以预编译头部块发送 HTTP/2 请求
+     * @param headers 预编译头部块，包含全部伪头部和固定头部
+     * @param metadata 调用级附加头部（不带 NO_COPY 标志，提交时由 nghttp2 复制），可为 nullptr
+     * @param metadata_count 附加头部数量
+     * @param body 请求体内容
+     * @param response 输出参数，用于接收服务器响应
+     * @param timeout_ms 等待响应的超时时间（毫秒），-1 表示不限时
+     * @param priority 流优先级，见 WriteScheduler
+     * @return Status 请求状态，成功返回 OK；超时返回 DEADLINE_EXCEEDED
+     * 
+     * 供 gRPC 通道按（通道，方法）缓存头部块后反复使用，头部总数不超过
+     * 32 个时组装头部不分配堆内存。其余行为与上一个重载相同。
+     * 
+     * priority.signal 为 true 时附加 RFC 9218 的 priority 头部，
+     * 并在 HEADERS 帧中携带按紧急度换算的流权重。
+     */
+    Status SendRequest(
+        const std::shared_ptr<const HeaderBlock>& headers,
+        const nghttp2_nv* metadata,
+        size_t metadata_count,
+        const std::string& body,
+        Http2Response* response,
+        int timeout_ms = -1,
+        const StreamPriority& priority = StreamPriority());
     
 private:
     // ========== 内部状态管理 ==========
@@ -200,6 +521,22 @@ private:
     struct ConnectionState;
     std::unique_ptr<ConnectionState> state_;  ///< 连接状态的智能指针
     
+    /**
+     * @brief 单个流的请求上下文（前向声明）
+     * 
+     * 通过 nghttp2 的 stream_user_data 与流关联，保存该流的响应
+     * 和完成状态，由 OnStreamCloseCallback 标记完成。
+     */
+    struct StreamContext;
+    
+    /**
+     * @brief I/O 线程模式下的一次调用（前向声明）
+     * 
+     * 由调用线程创建并放入提交队列，I/O 线程取出后提交请求，
+     * 流结束后通过 promise 通知调用线程。
+     */
+    struct IoCall;
+    
     // ========== nghttp2 回调函数 ==========
     
     /**
@@ -212,6 +549,8 @@ private:
      * @return 实际发送的字节数，或错误码
      * 
      * 当 nghttp2 需要发送数据时调用此回调。实现将数据写入底层套接字。
+     * 套接字暂时不可写时返回 NGHTTP2_ERR_WOULDBLOCK，由事件循环在
+     * 可写事件到来后重试。
      */
     static ssize_t SendCallback(nghttp2_session* session, const uint8_t* data,
                                size_t length, int flags, void* user_data);
@@ -280,6 +619,41 @@ private:
     static int OnStreamCloseCallback(nghttp2_session* session, int32_t stream_id,
                                     uint32_t error_code, void* user_data);
     
+    /**
+     * @brief 请求体数据读取回调函数
+     * @param session nghttp2 会话指针
+     * @param stream_id 流 ID
+     * @param buf nghttp2 提供的缓冲区（NO_COPY 模式下不使用）
+     * @param length 本帧允许的最大负载长度
+     * @param data_flags 输出参数，设置 EOF/NO_COPY 标志
+     * @param source 数据源，指向该流的 StreamContext
+     * @param user_data 用户数据指针（指向 Http2Client 实例）
+     * @return 本帧负载长度
+     * 
+     * 只计算下一个 DATA 帧的长度并设置 NGHTTP2_DATA_FLAG_NO_COPY，
+     * 实际负载由 OnSendDataCallback 直接从调用方缓冲区写出。
+     */
+    static ssize_t DataSourceReadCallback(nghttp2_session* session, int32_t stream_id,
+                                         uint8_t* buf, size_t length, uint32_t* data_flags,
+                                         nghttp2_data_source* source, void* user_data);
+    
+    /**
+     * @brief DATA 帧发送回调函数
+     * @param session nghttp2 会话指针
+     * @param frame 待发送的 DATA 帧
+     * @param framehd 9 字节的帧头
+     * @param length 帧负载长度
+     * @param source 数据源，指向该流的 StreamContext
+     * @param user_data 用户数据指针（指向 Http2Client 实例）
+     * @return 0 表示整帧已进入输出队列，或 NGHTTP2_ERR_WOULDBLOCK
+     * 
+     * 帧头和请求体切片以引用方式追加到输出队列，不经过 nghttp2 的
+     * 中间缓冲区，也不复制负载。
+     */
+    static int OnSendDataCallback(nghttp2_session* session, nghttp2_frame* frame,
+                                 const uint8_t* framehd, size_t length,
+                                 nghttp2_data_source* source, void* user_data);
+    
     // ========== 内部方法 ==========
     
     /**
@@ -307,21 +681,102 @@ private:
      */
     Status SendData();
     
+    /**
+     * @brief 批量写出输出队列
+     * @return Status 写出状态，套接字不可写时返回 OK 并保留剩余数据
+     * 
+     * 明文连接以 sendmsg 一次写出最多 kMaxIov 个分片，后面还有数据时
+     * 附带 MSG_MORE；TLS 连接把分片拼成最大记录长度后调用 SSL_write。
+     */
+    Status FlushOutput();
+    
+    /**
+     * @brief 以 io_uring 写出输出队列
+     * @return Status 写出状态
+     * 
+     * 没有在途发送链时，把队首分片（TLS 连接为加密后的记录）作为
+     * 链接的 send 请求提交；请求在下一次 io_uring_enter 时进入内核。
+     */
+    Status FlushOutputUring();
+    
+    /**
+     * @brief 处理零拷贝发送的完成通知
+     * 
+     * 从套接字错误队列读取 MSG_ZEROCOPY 完成通知，释放对应的缓冲区引用。
+     */
+    void ReapZeroCopyCompletions();
+    
     /**
      * @brief 接收网络数据
      * @return Status 接收状态
      * 
-     * 从网络套接字接收数据并提交给 nghttp2 处理。
+     * 从非阻塞套接字循环读取数据直到 EAGAIN，累积在连接级接收缓冲区中，
+     * 缓冲区满或读空时整段提交给 nghttp2 处理。缓冲区容量随吞吐量自适应。
+     * 套接字采用边沿触发方式监听，因此每次唤醒都必须读空。
      */
     Status ReceiveData();
     
     /**
-     * @brief 处理 nghttp2 事件
+     * @brief 将一段已接收的数据交给 nghttp2 解析
+     * @param data 数据指针
+     * @param len 数据长度
+     * @return Status 解析状态
+     */
+    Status FeedSession(const uint8_t* data, size_t len);
+    
+    /**
+     * @brief 处理 io_uring 收到的一段数据
+     * @param data 内核填充的接收缓冲区
+     * @param len 数据长度
      * @return Status 处理状态
+     */
+    Status OnUringData(const uint8_t* data, size_t len);
+    
+    /**
+     * @brief 等待指定流结束
+     * @param lock 已持有的连接锁
+     * @param stream 等待结束的流
+     * @param timeout_ms 超时时间（毫秒），-1 表示不限时
+     * @return Status 处理状态；超时返回 DEADLINE_EXCEEDED
+     * 
+     * 若当前没有线程在驱动事件循环，则由调用线程接管并运行
+     * PollOnce()；否则在条件变量上等待，直到本流完成或轮询权被释放。
+     */
+    Status ProcessEvents(std::unique_lock<std::mutex>& lock,
+                         StreamContext* stream, int timeout_ms);
+    
+    /**
+     * @brief 执行一轮事件循环
+     * @param lock 已持有的连接锁，等待 epoll 期间会临时释放
+     * @param wait_ms 本轮最长等待时间（毫秒），-1 表示不限时
+     * @return Status 处理状态，失败表示连接已不可用
+     * 
+     * 根据 nghttp2_session_want_read/want_write 驱动读写，
+     * 在没有可处理的数据时阻塞在 epoll 上等待套接字就绪或被唤醒。
+     */
+    Status PollOnce(std::unique_lock<std::mutex>& lock, int wait_ms);
+    
+    /**
+     * @brief 以 io_uring 执行一轮事件循环
+     * @param lock 已持有的连接锁，等待完成事件期间会临时释放
+     * @param wait_ms 本轮最长等待时间（毫秒），-1 表示不限时
+     * @return Status 处理状态，失败表示连接已不可用
      * 
-     * 让 nghttp2 处理接收到的数据，触发相应的回调函数。
+     * 收割完成事件、生成并提交待发送的帧，没有可处理的事件时
+     * 以一次 io_uring_enter 同时提交请求并等待。
      */
-    Status ProcessEvents();
+    Status PollOnceUring(std::unique_lock<std::mutex>& lock, int wait_ms);
+    
+    /**
+     * @brief 关闭连接并释放底层资源
+     * @param lock 已持有的连接锁
+     * @param reason 关闭原因，会作为所有未完成流的结果
+     * @param send_goaway 是否在关闭前尽力发送 GOAWAY 帧
+     * 
+     * 若有线程正在等待 epoll，先将其唤醒并等待其退出轮询。
+     */
+    void CloseConnection(std::unique_lock<std::mutex>& lock,
+                         const Status& reason, bool send_goaway);
     
     // ========== 套接字操作 ==========
     
@@ -329,20 +784,163 @@ private:
      * @brief 创建网络套接字
      * @param host 目标主机名或 IP 地址
      * @param port 目标端口号
+     * @param addresses 候选地址列表
+     * @param timeout_ms 连接超时时间（毫秒），-1 表示不限时
      * @return Status 创建状态
      * 
-     * 创建 TCP 套接字并连接到指定的主机和端口。
+     * 以 Happy Eyeballs 方式竞争连接所有地址，得到非阻塞的 TCP 套接字。
      */
-    Status CreateSocket(const std::string& host, int port);
+    Status CreateSocket(const std::string& host, int port,
+                        const std::vector<ResolvedAddress>& addresses, int timeout_ms);
     
     /**
      * @brief 设置 SSL/TLS 连接
+     * @param host 服务器主机名或 IP 地址字面量
+     * @param port 服务器端口，与主机名一起作为会话缓存的键
+     * @param timeout_ms 握手超时时间（毫秒），-1 表示不限时
      * @return Status 设置状态
      * 
-     * 在现有套接字上建立 SSL/TLS 加密连接，
-     * 执行 TLS 握手并验证服务器证书。
+     * 在现有套接字上以共享的 TLS 上下文建立 SSL/TLS 加密连接，
+     * 有缓存的会话时尝试恢复，否则执行完整握手并验证服务器证书与主机名。
+     */
+    Status SetupSsl(const std::string& host, int port, int timeout_ms);
+    
+    /**
+     * @brief 按传输层选项配置已连接的套接字
+     * 
+     * 配置失败的选项会被忽略（例如内核不支持 SO_ZEROCOPY），
+     * 连接仍以默认行为工作。套接字选项的实际生效值记录到
+     * TransportStats::socket。
+     */
+    void ConfigureSocket();
+    
+    /**
+     * @brief 尝试以 io_uring 驱动本连接
+     * 
+     * 成功时设置 uring_active，TLS 连接改为经内存 BIO 加解密；
+     * 构建或内核不支持时不做任何修改，由调用方回退到 epoll。
+     */
+    void AttachIoUring();
+    
+    // ========== 流量控制 ==========
+    
+    /**
+     * @brief 收到 DATA 后按需发起 BDP 探测
+     * 
+     * 由 OnDataChunkRecvCallback 调用，可能提交一个 PING 帧。
+     */
+    void MaybeStartBdpPing();
+    
+    // ========== 保活 ==========
+    
+    /**
+     * @brief 推进保活计时
+     * @return Status 在途 PING 超时时返回 UNAVAILABLE，调用方随即关闭连接
+     * 
+     * 由轮询线程在每轮事件处理开始时调用，到期时提交保活 PING。
+     */
+    Status CheckKeepalive();
+    
+    /**
+     * @brief 以距下一个保活事件的时间限制本轮等待
+     * @param wait_ms 调用方的等待时间（毫秒），-1 表示不限时
+     * @return int 实际的等待时间（毫秒）
+     */
+    int KeepaliveWaitMs(int wait_ms) const;
+    
+    // ========== 请求提交 ==========
+    
+    /**
+     * @brief 在会话上提交请求并登记流
+     * @param stream 已设置头部块与请求体的流上下文
+     * @param metadata 调用级的附加头部，可为 nullptr
+     * @param metadata_count 附加头部数量
+     * @return int32_t 流 ID；提交失败时返回负数
+     * 
+     * 调用方必须持有连接锁且连接可用。
+     */
+    int32_t SubmitStream(const std::shared_ptr<StreamContext>& stream,
+                         const nghttp2_nv* metadata, size_t metadata_count);
+    
+    /**
+     * @brief 流的请求体已全部进入输出队列或流已关闭，从 WriteScheduler 中注销
+     * @param stream_id 流 ID
+     * @param stream 流上下文
+     * 
+     * 调用方必须持有连接锁。
+     */
+    void FinishBody(int32_t stream_id, StreamContext* stream);
+    
+    /**
+     * @brief 提交请求失败时返回给调用方的状态
+     * @param error SubmitStream() 返回的 nghttp2 错误码
+     */
+    static Status SubmitError(int error);
+    
+    // ========== I/O 线程 ==========
+    
+    /**
+     * @brief 经 I/O 线程发送请求并等待响应
+     * 
+     * 参数与返回值同 SendRequest()。
+     */
+    Status SendRequestOnIoThread(const std::shared_ptr<const HeaderBlock>& headers,
+                                 const nghttp2_nv* metadata, size_t metadata_count,
+                                 const std::string& body, Http2Response* response,
+                                 int timeout_ms, const StreamPriority& priority);
+    
+    /**
+     * @brief 唤醒 I/O 线程
+     * @return bool I/O 线程仍在运行时返回 true
+     * 
+     * 可从任意线程调用，不获取连接锁。
+     */
+    bool WakeIoThread();
+    
+    /**
+     * @brief 启动 I/O 线程（已在运行时不做任何事）
+     * 
+     * 调用方不得持有连接锁。
+     */
+    void StartIoThread();
+    
+    /**
+     * @brief 停止并回收 I/O 线程
+     * 
+     * 已提交的调用留在连接上，由下一个 I/O 线程或关闭连接时完成；
+     * 尚在提交队列中的调用以 UNAVAILABLE 结束并标记为可重试。
+     * 调用方不得持有连接锁。
+     */
+    void StopIoThread();
+    
+    /**
+     * @brief I/O 线程主循环
+     */
+    void IoThreadMain();
+    
+    /**
+     * @brief 取出提交队列中的全部调用并提交请求
+     * 
+     * 连接不可用时取出的调用直接以失败结束。由 I/O 线程持锁调用。
+     */
+    void SubmitIoCalls();
+    
+    /**
+     * @brief 处理调用方的取消请求并通知已结束的调用
+     * 
+     * 由 I/O 线程持锁调用。
+     */
+    void CompleteIoCalls();
+    
+    /**
+     * @brief 将接收窗口扩大到指定大小
+     * @param window_size 目标窗口大小（字节）
+     * @return Status 提交状态
+     * 
+     * 以 SETTINGS_INITIAL_WINDOW_SIZE 调整所有流的窗口，
+     * 并以 WINDOW_UPDATE 将连接级窗口扩大到不小于该值。
      */
-    Status SetupSsl();
+    Status GrowReceiveWindow(int32_t window_size);
     
     /**
      * @brief 套接字数据发送
@@ -351,6 +949,7 @@ private:
      * @return 实际发送的字节数，或负数表示错误
      * 
      * 向套接字发送数据，支持 SSL 和非 SSL 连接。
+     * 返回 -1 且 errno 为 EAGAIN 表示套接字暂时不可写。
      */
     ssize_t SocketSend(const void* data, size_t len);
     
@@ -358,9 +957,10 @@ private:
      * @brief 套接字数据接收
      * @param data 接收数据的缓冲区
      * @param len 缓冲区大小
-     * @return 实际接收的字节数，或负数表示错误
+     * @return 实际接收的字节数，0 表示连接关闭，或负数表示错误
      * 
      * 从套接字接收数据，支持 SSL 和非 SSL 连接。
+     * 返回 -1 且 errno 为 EAGAIN 表示暂无数据可读。
      */
     ssize_t SocketRecv(void* data, size_t len);
 };
@@ -0,0 +1,624 @@
+/**
+ * @file io_uring.cpp
+ * @brief HTTP/2 传输层 io_uring 后端实现文件
+ *
+ * 直接使用 io_uring_setup/io_uring_enter/io_uring_register 系统调用和
+ * <linux/io_uring.h> 中的内核接口定义，不依赖 liburing。
+ * 未定义 LITEGRPC_HAVE_IO_URING 时只编译空实现，Supported() 恒为 false。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "io_uring.h"
+
+#ifdef LITEGRPC_HAVE_IO_URING
+#include <linux/io_uring.h>  // io_uring 内核接口
+#include <sys/eventfd.h>     // eventfd 唤醒
+#include <sys/mman.h>        // 环形队列映射
+#include <sys/socket.h>      // socketpair
+#include <sys/syscall.h>     // __NR_io_uring_*
+#include <endian.h>          // __BYTE_ORDER
+#include <poll.h>            // POLLIN
+#include <signal.h>          // _NSIG
+#include <unistd.h>          // close, syscall
+#include <algorithm>         // std::min, std::max
+#include <cerrno>            // errno
+#include <chrono>            // 探测超时
+#include <cstring>           // memset, strerror
+#endif
+
+namespace litegrpc {
+namespace http2 {
+
+#ifdef LITEGRPC_HAVE_IO_URING
+
+namespace {
+
+/**
+ * @brief 完成事件的 user_data，标识请求类型
+ */
+const uint64_t kRecvTag = 1;    ///< 多发 recv
+const uint64_t kSendTag = 2;    ///< 发送链中的 send
+const uint64_t kWakeTag = 3;    ///< 唤醒用的多发 poll
+const uint64_t kCancelTag = 4;  ///< 取消请求
+
+const uint16_t kBufferGroup = 0;  ///< 缓冲区环的组号
+
+int SysSetup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int SysEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+             const void* arg, size_t argsz) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                                    arg, argsz));
+}
+
+int SysRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+/**
+ * @brief 与内核共享的环形队列指针，按 acquire/release 语义访问
+ */
+template <typename T>
+T LoadAcquire(const T* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void StoreRelease(T* p, T value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+void* MapRing(size_t size, int fd, off_t offset) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+void* MapAnonymous(size_t size) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+/**
+ * @brief 在一对本地套接字上验证后端可用
+ *
+ * 步骤：
+ * 1. 创建实例（验证 io_uring_setup、所需特性与缓冲区环注册）
+ * 2. 向对端写入 1 字节，等待多发 recv 的完成事件
+ * 3. 收到数据且 recv 仍然有效（IORING_CQE_F_MORE）才认为支持
+ */
+bool ProbeSupport() {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) < 0) {
+        return false;
+    }
+
+    bool supported = false;
+    {
+        IoUring ring;
+        const char byte = 0;
+        if (ring.Attach(sv[0]).ok() && ring.Submit().ok() &&
+            send(sv[1], &byte, 1, MSG_NOSIGNAL) == 1) {
+            size_t received = 0;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while (received == 0 && std::chrono::steady_clock::now() < deadline) {
+                IoUring::Completions completions;
+                if (!ring.Wait(100).ok() ||
+                    !ring.Reap([&received](const uint8_t*, size_t len) {
+                        received += len;
+                        return Status::OK();
+                    }, &completions).ok() ||
+                    completions.recv_error != 0 || completions.recv_eof) {
+                    break;
+                }
+            }
+            supported = received == 1;
+        }
+    }
+
+    close(sv[0]);
+    close(sv[1]);
+    return supported;
+}
+
+} // namespace
+
+bool IoUring::Supported() {
+    static const bool supported = ProbeSupport();
+    return supported;
+}
+
+IoUring::~IoUring() {
+    Detach();
+}
+
+/**
+ * @brief 创建实例
+ *
+ * 步骤：
+ * 1. io_uring_setup 创建环，要求 IORING_FEAT_NODROP（完成队列满时内核
+ *    暂存事件而不是丢弃）和 IORING_FEAT_EXT_ARG（带超时的等待）
+ * 2. 映射提交队列、完成队列和提交队列项数组
+ * 3. 分配接收缓冲区并以 IORING_REGISTER_PBUF_RING 注册缓冲区环
+ * 4. 创建 eventfd，准备多发 recv 和多发 poll
+ */
+Status IoUring::Attach(int fd) {
+    Detach();
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = kQueueDepth * 4;  // 多发 recv 一次提交产生多个完成事件
+    ring_fd_ = SysSetup(kQueueDepth, &params);
+    if (ring_fd_ < 0) {
+        ring_fd_ = -1;
+        return Status::Unavailable("io_uring_setup failed: " + std::string(strerror(errno)));
+    }
+    if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        Release();
+        return Status::Unimplemented("io_uring lacks required features");
+    }
+
+    // 映射环形队列
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = MapRing(sq_ring_size_, ring_fd_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_ : MapRing(cq_ring_size_, ring_fd_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = MapRing(sqes_size_, ring_fd_, IORING_OFF_SQES);
+    if (!sq_ring_ || !cq_ring_ || !sqes_) {
+        int err = errno;
+        Release();
+        return Status::Internal("Failed to map io_uring queues: " + std::string(strerror(err)));
+    }
+
+    char* sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    local_sq_tail_ = *sq_tail_;
+
+    char* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = cq + params.cq_off.cqes;
+
+    // 注册接收缓冲区环
+    buf_ring_size_ = kBufferCount * sizeof(struct io_uring_buf);
+    buf_ring_ = MapAnonymous(buf_ring_size_);
+    buffers_ = static_cast<uint8_t*>(MapAnonymous(kBufferCount * kBufferSize));
+    if (!buf_ring_ || !buffers_) {
+        Release();
+        return Status::ResourceExhausted("Failed to allocate io_uring receive buffers");
+    }
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+    reg.ring_entries = kBufferCount;
+    reg.bgid = kBufferGroup;
+    if (SysRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int err = errno;
+        Release();
+        return Status::Unimplemented("io_uring buffer ring not supported: " + std::string(strerror(err)));
+    }
+    buf_tail_ = 0;
+    for (uint16_t bid = 0; bid < kBufferCount; ++bid) {
+        RecycleBuffer(bid);
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        int err = errno;
+        Release();
+        return Status::Internal("Failed to create eventfd: " + std::string(strerror(err)));
+    }
+
+    socket_fd_ = fd;
+    ArmRecv();
+    ArmWakeup();
+    return Status::OK();
+}
+
+/**
+ * @brief 取消所有在途请求并销毁实例
+ *
+ * 以 IORING_ASYNC_CANCEL_ANY 取消全部请求，然后收割完成事件直到
+ * 每个请求都已结束，保证内核不再访问发送数据和接收缓冲区。
+ * 最多等待 1 秒，避免内核异常时关闭连接的线程永久阻塞。
+ */
+void IoUring::Detach() {
+    if (ring_fd_ < 0) {
+        Release();
+        return;
+    }
+
+    detaching_ = true;
+    if (ops_in_flight_ > 0) {
+        if (SqSpace() == 0) {
+            Submit();
+        }
+        auto* sqe = static_cast<struct io_uring_sqe*>(NextSqe());
+        if (sqe) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            sqe->user_data = kCancelTag;
+            ops_in_flight_++;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (ops_in_flight_ > 0 && std::chrono::steady_clock::now() < deadline) {
+            if (!Wait(100).ok()) {
+                break;
+            }
+            Completions completions;
+            Reap(nullptr, &completions);
+        }
+    }
+    Release();
+}
+
+/**
+ * @brief 唤醒等待线程
+ *
+ * eventfd 计数器溢出（EAGAIN）说明已有未处理的唤醒，可以忽略。
+ */
+void IoUring::Wakeup() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t rv = write(wake_fd_, &one, sizeof(one));
+        (void)rv;
+    }
+}
+
+/**
+ * @brief 以链接的 send 请求写出一批分片
+ *
+ * 除最后一个以外的请求都带 IOSQE_IO_LINK，内核在前一个完成后才开始
+ * 下一个，保证字节顺序。MSG_WAITALL 使内核在套接字缓冲区满时继续等待
+ * 直到整个分片写出，只有出错时才会提前结束并取消链上其余请求。
+ */
+size_t IoUring::SubmitSend(const struct iovec* iov, size_t count) {
+    if (ring_fd_ < 0 || sends_in_flight_ > 0 || count == 0) {
+        return 0;
+    }
+    const size_t n = std::min<size_t>(count, SqSpace());
+    for (size_t i = 0; i < n; ++i) {
+        auto* sqe = static_cast<struct io_uring_sqe*>(NextSqe());
+        const bool last = i + 1 == n;
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = socket_fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(iov[i].iov_base);
+        sqe->len = static_cast<uint32_t>(iov[i].iov_len);
+        sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL | (last ? 0 : MSG_MORE);
+        sqe->flags = last ? 0 : IOSQE_IO_LINK;
+        sqe->user_data = kSendTag;
+    }
+    sends_in_flight_ = static_cast<unsigned>(n);
+    ops_in_flight_ += static_cast<unsigned>(n);
+    send_failed_ = false;
+    return n;
+}
+
+Status IoUring::Submit() {
+    return Enter(0, 0);
+}
+
+Status IoUring::Wait(int timeout_ms) {
+    return Enter(1, timeout_ms);
+}
+
+/**
+ * @brief 收割所有已完成的事件
+ *
+ * 步骤：
+ * 1. 从完成队列头读到尾，按 user_data 分派：
+ *    - recv：把缓冲区交给 on_data 后归还；0 表示 EOF；
+ *      -ENOBUFS/-ECANCELED 只表示多发 recv 终止，需要重新提交
+ *    - send：累计连续写出的字节数；被取消的请求不计入
+ *    - poll：清空 eventfd 计数器，记录收到唤醒
+ * 2. 发布新的完成队列头
+ * 3. 失效的多发请求重新提交（不在取消过程中时）
+ */
+Status IoUring::Reap(const DataHandler& on_data, Completions* completions) {
+    *completions = Completions();
+    Status result;
+    if (ring_fd_ < 0) {
+        return result;
+    }
+
+    const auto* cqes = static_cast<const struct io_uring_cqe*>(cqes_);
+    unsigned head = *cq_head_;
+    const unsigned tail = LoadAcquire(cq_tail_);
+    for (; head != tail; ++head) {
+        const struct io_uring_cqe& cqe = cqes[head & cq_mask_];
+        const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        if (!more) {
+            ops_in_flight_--;
+        }
+
+        switch (cqe.user_data) {
+        case kRecvTag:
+            if (!more) {
+                recv_armed_ = false;
+            }
+            if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+                const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                completions->recv_count++;
+                if (result.ok() && on_data) {
+                    result = on_data(buffers_ + static_cast<size_t>(bid) * kBufferSize,
+                                     static_cast<size_t>(cqe.res));
+                }
+                RecycleBuffer(bid);
+            } else if (cqe.res == 0) {
+                completions->recv_eof = true;
+                recv_closed_ = true;
+            } else if (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED) {
+                completions->recv_error = -cqe.res;
+                recv_closed_ = true;
+            }
+            break;
+        case kSendTag:
+            sends_in_flight_--;
+            if (cqe.res >= 0 && !send_failed_) {
+                completions->sent_bytes += static_cast<size_t>(cqe.res);
+            } else if (cqe.res < 0) {
+                send_failed_ = true;
+                if (cqe.res != -ECANCELED && completions->send_error == 0) {
+                    completions->send_error = -cqe.res;
+                }
+            }
+            if (sends_in_flight_ == 0) {
+                completions->send_done = true;
+            }
+            break;
+        case kWakeTag:
+            if (!more) {
+                wake_armed_ = false;
+            }
+            if (cqe.res > 0) {
+                uint64_t count;
+                ssize_t rv = read(wake_fd_, &count, sizeof(count));  // 清空计数器
+                (void)rv;
+                completions->woken = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    StoreRelease(cq_head_, head);
+
+    if (!detaching_) {
+        if (!recv_armed_ && !recv_closed_) {
+            ArmRecv();
+        }
+        if (!wake_armed_) {
+            ArmWakeup();
+        }
+    }
+    return result;
+}
+
+void* IoUring::NextSqe() {
+    if (SqSpace() == 0) {
+        return nullptr;
+    }
+    const unsigned index = local_sq_tail_ & sq_mask_;
+    auto* sqe = static_cast<struct io_uring_sqe*>(sqes_) + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    local_sq_tail_++;
+    return sqe;
+}
+
+unsigned IoUring::SqSpace() const {
+    return sq_entries_ - (local_sq_tail_ - LoadAcquire(sq_head_));
+}
+
+/**
+ * @brief 准备多发 recv 请求
+ *
+ * 不指定缓冲区，由内核从缓冲区环中选取（IOSQE_BUFFER_SELECT）。
+ * 提交队列已满时留待下一次 Reap() 重试。
+ */
+void IoUring::ArmRecv() {
+    auto* sqe = static_cast<struct io_uring_sqe*>(NextSqe());
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket_fd_;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = kRecvTag;
+    recv_armed_ = true;
+    ops_in_flight_++;
+}
+
+/**
+ * @brief 准备唤醒用的多发 poll 请求
+ */
+void IoUring::ArmWakeup() {
+    auto* sqe = static_cast<struct io_uring_sqe*>(NextSqe());
+    if (!sqe) {
+        return;
+    }
+    uint32_t mask = POLLIN;
+#if __BYTE_ORDER == __BIG_ENDIAN
+    mask = (mask << 16) | (mask >> 16);  // poll32_events 按半字交换存放
+#endif
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = wake_fd_;
+    sqe->poll32_events = mask;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = kWakeTag;
+    wake_armed_ = true;
+    ops_in_flight_++;
+}
+
+/**
+ * @brief 将接收缓冲区归还给缓冲区环
+ *
+ * 环尾与 bufs[0].resv 共用存储，只写 addr/len/bid 三个字段。
+ * 缓冲区项按 struct io_uring_buf 数组直接寻址：内核头文件中的
+ * __DECLARE_FLEX_ARRAY 在 C++ 下会把 bufs 成员偏移 8 字节，与内核布局不一致。
+ */
+void IoUring::RecycleBuffer(uint16_t bid) {
+    auto* ring = static_cast<struct io_uring_buf_ring*>(buf_ring_);
+    struct io_uring_buf* buf =
+        static_cast<struct io_uring_buf*>(buf_ring_) + (buf_tail_ & (kBufferCount - 1));
+    buf->addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(bid) * kBufferSize);
+    buf->len = static_cast<uint32_t>(kBufferSize);
+    buf->bid = bid;
+    buf_tail_++;
+    StoreRelease(&ring->tail, buf_tail_);
+}
+
+/**
+ * @brief 调用 io_uring_enter
+ *
+ * 一次系统调用同时提交所有已准备的请求并等待完成事件。
+ * 被信号中断、超时（ETIME）或完成队列暂时溢出（EBUSY）时返回 OK，
+ * 由调用方收割后重新计算剩余时间。
+ */
+Status IoUring::Enter(unsigned min_complete, int timeout_ms) {
+    if (ring_fd_ < 0) {
+        return Status::Unavailable("io_uring not attached");
+    }
+    StoreRelease(sq_tail_, local_sq_tail_);
+    const unsigned to_submit = local_sq_tail_ - LoadAcquire(sq_head_);
+    if (to_submit == 0 && min_complete == 0) {
+        return Status::OK();
+    }
+
+    unsigned flags = 0;
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    const void* argp = nullptr;
+    size_t argsz = 0;
+    if (min_complete > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+        if (timeout_ms >= 0) {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+            memset(&arg, 0, sizeof(arg));
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+            flags |= IORING_ENTER_EXT_ARG;
+            argp = &arg;
+            argsz = sizeof(arg);
+        }
+    }
+
+    enter_calls_.fetch_add(1, std::memory_order_relaxed);
+    if (SysEnter(ring_fd_, to_submit, min_complete, flags, argp, argsz) < 0) {
+        if (errno == EINTR || errno == ETIME || errno == EBUSY || errno == EAGAIN) {
+            return Status::OK();
+        }
+        return Status::Unavailable("io_uring_enter failed: " + std::string(strerror(errno)));
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 释放所有资源
+ *
+ * 关闭 io_uring 文件描述符后内核会取消仍未完成的请求，
+ * 调用方应先通过 Detach() 等待它们结束。
+ */
+void IoUring::Release() {
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+    if (sqes_) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_) {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = nullptr;
+    }
+    if (buf_ring_) {
+        munmap(buf_ring_, buf_ring_size_);
+        buf_ring_ = nullptr;
+    }
+    if (buffers_) {
+        munmap(buffers_, kBufferCount * kBufferSize);
+        buffers_ = nullptr;
+    }
+    socket_fd_ = -1;
+    sq_head_ = sq_tail_ = sq_array_ = nullptr;
+    cq_head_ = cq_tail_ = nullptr;
+    cqes_ = nullptr;
+    sq_mask_ = sq_entries_ = cq_mask_ = 0;
+    local_sq_tail_ = 0;
+    buf_tail_ = 0;
+    recv_armed_ = wake_armed_ = recv_closed_ = detaching_ = send_failed_ = false;
+    sends_in_flight_ = 0;
+    ops_in_flight_ = 0;
+}
+
+#else // !LITEGRPC_HAVE_IO_URING
+
+bool IoUring::Supported() {
+    return false;
+}
+
+IoUring::~IoUring() {}
+
+Status IoUring::Attach(int fd) {
+    (void)fd;
+    return Status::Unimplemented("io_uring backend not built (LITEGRPC_WITH_IO_URING=OFF)");
+}
+
+void IoUring::Detach() {}
+
+void IoUring::Wakeup() {}
+
+size_t IoUring::SubmitSend(const struct iovec* iov, size_t count) {
+    (void)iov;
+    (void)count;
+    return 0;
+}
+
+Status IoUring::Submit() {
+    return Status::OK();
+}
+
+Status IoUring::Wait(int timeout_ms) {
+    (void)timeout_ms;
+    return Status::OK();
+}
+
+Status IoUring::Reap(const DataHandler& on_data, Completions* completions) {
+    (void)on_data;
+    *completions = Completions();
+    return Status::OK();
+}
+
+#endif // LITEGRPC_HAVE_IO_URING
+
+} // namespace http2
+} // namespace litegrpc
@@ -0,0 +1,247 @@
+/**
+ * @file io_uring.h
+ * @brief HTTP/2 传输层 io_uring 后端头文件
+ *
+ * 此文件定义了单套接字的 io_uring 实例，作为 EventLoop（epoll）之外
+ * 的可选 I/O 后端。与 epoll 的"就绪通知 + 每次唤醒一次 recv/send"不同，
+ * 读写都由内核异步完成，调用方只需收割完成事件：
+ * - 接收：套接字上常驻一个多发（multishot）recv 请求，数据直接写入
+ *   预先向内核注册的缓冲区环（IORING_REGISTER_PBUF_RING），每个完成
+ *   事件携带一个已填充的缓冲区，处理后归还给环，无需再次提交
+ * - 发送：一批分片以 IOSQE_IO_LINK 链接的 send 请求提交，内核按顺序
+ *   写出；带 MSG_WAITALL，某个分片失败时链上其余请求被取消
+ * - 唤醒：eventfd 上常驻一个多发 poll 请求，其他线程写 eventfd 即可
+ *   唤醒阻塞在 Wait() 中的线程
+ *
+ * 仅在以 LITEGRPC_WITH_IO_URING 构建（定义 LITEGRPC_HAVE_IO_URING）时
+ * 可用；内核不支持所需特性（5.19 之前的内核、被 seccomp 或
+ * io_uring_disabled 禁用）时 Supported() 返回 false，调用方回退到 epoll。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_IO_URING_H
+#define LITEGRPC_HTTP2_IO_URING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <sys/uio.h>          // iovec
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 单套接字 io_uring 实例
+ *
+ * 每个连接拥有一个实例。同一时刻最多只有一条发送链在途，
+ * 链上引用的数据在 Reap() 报告 send_done 之前必须保持有效。
+ *
+ * 线程安全性：
+ * - Attach()/Detach()/SubmitSend()/Submit()/Wait()/Reap() 由持有连接锁
+ *   的线程（或释放锁等待中的轮询线程）调用，不能并发
+ * - Wakeup() 可在任意线程调用
+ */
+class IoUring {
+public:
+    /**
+     * @brief 一轮收割的结果
+     */
+    struct Completions {
+        size_t sent_bytes = 0;  ///< 本轮完成的发送字节数，按提交顺序连续
+        bool send_done = false; ///< 在途的发送链已全部完成（成功、失败或被取消）
+        int send_error = 0;     ///< 发送失败的 errno，0 表示没有失败
+        int recv_error = 0;     ///< 接收失败的 errno，0 表示没有失败
+        bool recv_eof = false;  ///< 对端已关闭连接
+        size_t recv_count = 0;  ///< 本轮收到数据的完成事件数
+        bool woken = false;     ///< 收到了 Wakeup() 发出的唤醒
+    };
+
+    /**
+     * @brief 接收数据处理函数，data 只在调用期间有效
+     */
+    using DataHandler = std::function<Status(const uint8_t* data, size_t len)>;
+
+    /**
+     * @brief 检查当前构建与内核是否支持本后端
+     * @return bool 支持时返回 true
+     *
+     * 首次调用时在一对本地套接字上实际验证缓冲区环与多发 recv，
+     * 结果在进程内缓存。
+     */
+    static bool Supported();
+
+    IoUring() = default;
+
+    /**
+     * @brief 析构函数，取消所有在途请求并释放资源
+     */
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * @brief 为套接字创建 io_uring 实例
+     * @param fd 已连接的套接字
+     * @return Status 创建状态；失败时不持有任何资源
+     *
+     * 创建环、注册缓冲区环，并提交多发 recv 与唤醒用的多发 poll，
+     * 两者在下一次 Submit()/Wait() 时进入内核。
+     */
+    Status Attach(int fd);
+
+    /**
+     * @brief 取消所有在途请求，等待内核释放缓冲区后销毁实例
+     *
+     * 返回后内核不再引用任何发送数据或接收缓冲区。
+     */
+    void Detach();
+
+    /**
+     * @brief 是否已创建实例
+     */
+    bool attached() const { return ring_fd_ >= 0; }
+
+    /**
+     * @brief 是否有在途的发送链
+     */
+    bool send_in_flight() const { return sends_in_flight_ > 0; }
+
+    /**
+     * @brief 唤醒阻塞在 Wait() 中的线程
+     */
+    void Wakeup();
+
+    /**
+     * @brief 以链接的 send 请求写出一批分片
+     * @param iov 分片数组，数据在 send_done 之前必须保持有效
+     * @param count 分片数量
+     * @return size_t 实际加入链中的分片数（受提交队列余量限制），0 表示未提交
+     *
+     * 已有发送链在途时不提交。请求在下一次 Submit()/Wait() 时进入内核。
+     */
+    size_t SubmitSend(const struct iovec* iov, size_t count);
+
+    /**
+     * @brief 将已准备的请求提交给内核，不等待
+     * @return Status 提交状态
+     */
+    Status Submit();
+
+    /**
+     * @brief 提交已准备的请求，并等待至少一个完成事件
+     * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
+     * @return Status 等待状态；超时或被信号中断时返回 OK
+     */
+    Status Wait(int timeout_ms);
+
+    /**
+     * @brief 收割所有已完成的事件
+     * @param on_data 接收数据的处理函数，按到达顺序调用
+     * @param completions 输出参数，本轮收割的结果
+     * @return Status on_data 返回的第一个错误
+     *
+     * 多发 recv 因缓冲区耗尽等原因终止时自动重新提交。
+     */
+    Status Reap(const DataHandler& on_data, Completions* completions);
+
+    /**
+     * @brief io_uring_enter 系统调用次数
+     *
+     * 等待完成事件时不持有连接锁，计数以原子变量记录，可在任意线程读取。
+     */
+    uint64_t enter_calls() const { return enter_calls_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief 获取一个空闲的提交队列项
+     * @return void* 提交队列项（struct io_uring_sqe），队列已满时返回 nullptr
+     */
+    void* NextSqe();
+
+    /**
+     * @brief 提交队列的剩余容量
+     */
+    unsigned SqSpace() const;
+
+    /**
+     * @brief 准备多发 recv 请求
+     */
+    void ArmRecv();
+
+    /**
+     * @brief 准备唤醒用的多发 poll 请求
+     */
+    void ArmWakeup();
+
+    /**
+     * @brief 将接收缓冲区归还给缓冲区环
+     * @param bid 缓冲区编号
+     */
+    void RecycleBuffer(uint16_t bid);
+
+    /**
+     * @brief 调用 io_uring_enter
+     * @param min_complete 需要等待的完成事件数
+     * @param timeout_ms 超时时间（毫秒），-1 表示无限等待
+     * @return Status 系统调用状态
+     */
+    Status Enter(unsigned min_complete, int timeout_ms);
+
+    /**
+     * @brief 释放所有资源，不等待在途请求
+     */
+    void Release();
+
+    static const unsigned kQueueDepth = 64;       ///< 提交队列深度
+    static const unsigned kBufferCount = 16;      ///< 接收缓冲区数量（2 的幂）
+    static const size_t kBufferSize = 16 * 1024;  ///< 单个接收缓冲区大小（字节）
+
+    int ring_fd_ = -1;                 ///< io_uring 文件描述符
+    int socket_fd_ = -1;               ///< 被服务的套接字
+    int wake_fd_ = -1;                 ///< 跨线程唤醒用的 eventfd
+
+    // ========== 共享内存映射 ==========
+    void* sq_ring_ = nullptr;          ///< 提交队列环映射
+    size_t sq_ring_size_ = 0;          ///< 提交队列环映射大小
+    void* cq_ring_ = nullptr;          ///< 完成队列环映射（单映射时与 sq_ring_ 相同）
+    size_t cq_ring_size_ = 0;          ///< 完成队列环映射大小
+    void* sqes_ = nullptr;             ///< 提交队列项数组映射
+    size_t sqes_size_ = 0;             ///< 提交队列项数组映射大小
+    unsigned* sq_head_ = nullptr;      ///< 提交队列头（内核更新）
+    unsigned* sq_tail_ = nullptr;      ///< 提交队列尾（本端更新）
+    unsigned* sq_array_ = nullptr;     ///< 提交队列下标数组
+    unsigned sq_mask_ = 0;             ///< 提交队列下标掩码
+    unsigned sq_entries_ = 0;          ///< 提交队列容量
+    unsigned* cq_head_ = nullptr;      ///< 完成队列头（本端更新）
+    unsigned* cq_tail_ = nullptr;      ///< 完成队列尾（内核更新）
+    unsigned cq_mask_ = 0;             ///< 完成队列下标掩码
+    void* cqes_ = nullptr;             ///< 完成队列项数组（struct io_uring_cqe）
+    unsigned local_sq_tail_ = 0;       ///< 已准备但尚未发布的提交队列尾
+
+    // ========== 接收缓冲区环 ==========
+    void* buf_ring_ = nullptr;         ///< 缓冲区环（struct io_uring_buf_ring）
+    size_t buf_ring_size_ = 0;         ///< 缓冲区环映射大小
+    uint8_t* buffers_ = nullptr;       ///< 接收缓冲区内存
+    uint16_t buf_tail_ = 0;            ///< 缓冲区环尾
+
+    // ========== 在途请求 ==========
+    bool recv_armed_ = false;          ///< 多发 recv 是否仍然有效
+    bool wake_armed_ = false;          ///< 唤醒 poll 是否仍然有效
+    bool recv_closed_ = false;         ///< 已收到 EOF 或接收错误，不再重新提交 recv
+    bool detaching_ = false;           ///< 正在取消所有请求，不再重新提交任何请求
+    unsigned sends_in_flight_ = 0;     ///< 在途发送链中尚未完成的请求数
+    bool send_failed_ = false;         ///< 当前发送链是否已出现失败
+    unsigned ops_in_flight_ = 0;       ///< 尚未收到最终完成事件的请求数
+    std::atomic<uint64_t> enter_calls_{0};  ///< io_uring_enter 调用次数
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_IO_URING_H
@@ -0,0 +1,107 @@
+/**
+ * @file keepalive.cpp
+ * @brief HTTP/2 保活 PING 跟踪器实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "keepalive.h"
+#include <algorithm>  // std::max, std::min
+
+namespace litegrpc {
+namespace http2 {
+
+KeepaliveTracker::KeepaliveTracker(int time_ms, int timeout_ms, bool permit_without_calls,
+                                   int max_pings_without_data, int min_interval_without_data_ms,
+                                   Clock::time_point now)
+    : time_(std::max(time_ms, 0)),
+      timeout_(std::max(timeout_ms, 0)),
+      permit_without_calls_(permit_without_calls),
+      max_pings_without_data_(std::max(max_pings_without_data, 0)),
+      min_interval_without_data_(std::max(min_interval_without_data_ms, 0)),
+      last_read_(now),
+      ping_start_(now) {
+}
+
+/**
+ * @brief 是否应发送保活 PING
+ */
+bool KeepaliveTracker::NeedPing(Clock::time_point now, bool has_calls) const {
+    return !ping_in_flight_ && PingAllowed(has_calls) && now >= NextPingTime();
+}
+
+/**
+ * @brief 标记保活 PING 已提交
+ */
+void KeepaliveTracker::StartPing(Clock::time_point now) {
+    ping_in_flight_ = true;
+    ping_start_ = now;
+    pings_without_data_++;
+    pings_sent_++;
+}
+
+/**
+ * @brief 处理保活 PING 的 ACK
+ *
+ * 平滑 RTT 按 SRTT = 7/8 * SRTT + 1/8 * RTT 更新（RFC 6298），第一个采样直接作为初值。
+ */
+int64_t KeepaliveTracker::CompletePing(Clock::time_point now) {
+    if (!ping_in_flight_) {
+        return -1;
+    }
+    ping_in_flight_ = false;
+
+    const int64_t rtt = std::chrono::duration_cast<std::chrono::microseconds>(now - ping_start_).count();
+    last_rtt_us_ = rtt;
+    min_rtt_us_ = rtt_samples_ == 0 ? rtt : std::min(min_rtt_us_, rtt);
+    smoothed_rtt_us_ = rtt_samples_ == 0 ? rtt : (smoothed_rtt_us_ * 7 + rtt) / 8;
+    rtt_samples_++;
+    return rtt;
+}
+
+/**
+ * @brief 在途 PING 是否已超时
+ *
+ * 超时从 PING 发出或之后最近一次读到数据起计算：大量数据排在 ACK 之前
+ * 到达时连接显然仍然存活，不应判定失效。
+ */
+bool KeepaliveTracker::TimedOut(Clock::time_point now) const {
+    return ping_in_flight_ && now - std::max(ping_start_, last_read_) >= timeout_;
+}
+
+/**
+ * @brief 距下一个保活事件的时间
+ */
+int KeepaliveTracker::WaitMs(Clock::time_point now, bool has_calls) const {
+    Clock::time_point next;
+    if (ping_in_flight_) {
+        next = std::max(ping_start_, last_read_) + timeout_;
+    } else if (enabled() && PingAllowed(has_calls)) {
+        next = NextPingTime();
+    } else {
+        return -1;
+    }
+    if (next <= now) {
+        return 0;
+    }
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(next - now).count();
+    return static_cast<int>(std::min<int64_t>((us + 999) / 1000, INT32_MAX));
+}
+
+KeepaliveTracker::Clock::time_point KeepaliveTracker::NextPingTime() const {
+    Clock::time_point next = last_read_ + time_;
+    if (pings_without_data_ > 0) {
+        next = std::max(next, ping_start_ + min_interval_without_data_);
+    }
+    return next;
+}
+
+bool KeepaliveTracker::PingAllowed(bool has_calls) const {
+    return enabled() && (has_calls || permit_without_calls_) &&
+           (max_pings_without_data_ == 0 || pings_without_data_ < max_pings_without_data_);
+}
+
+} // namespace http2
+} // namespace litegrpc
@@ -0,0 +1,169 @@
+/**
+ * @file keepalive.h
+ * @brief HTTP/2 保活 PING 跟踪器头文件
+ *
+ * 此文件定义了按 GRPC_ARG_KEEPALIVE_* 通道参数发送保活 PING 的计时逻辑，
+ * 语义与官方 gRPC 客户端一致：
+ * - 连接上 keepalive_time 内没有收到任何数据时发送一个 PING
+ * - PING 发出后 keepalive_timeout 内既没有 ACK 也没有任何数据到达，
+ *   判定连接已失效（半开的 TCP 连接不会产生任何错误，只能靠超时发现）
+ * - 默认只在有未完成的调用时发送，permit_without_calls 允许空闲时也发送
+ * - 两次发送 HEADERS/DATA 之间最多发送 max_pings_without_data 个 PING，
+ *   避免被服务器以 ENHANCE_YOUR_CALM 拒绝
+ *
+ * 每个 PING ACK 同时是一次 RTT 采样，供负载均衡和诊断使用。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_KEEPALIVE_H
+#define LITEGRPC_HTTP2_KEEPALIVE_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 保活 PING 跟踪器
+ *
+ * 只负责计时，不发送任何帧。调用方在读到数据时调用 OnRead()，
+ * 发送 HEADERS 或 DATA 帧时调用 OnDataSent()，在 NeedPing() 为 true 时发送 PING
+ * 并调用 StartPing()，收到对应的 PING ACK 后调用 CompletePing()；
+ * 等待套接字事件前以 WaitMs() 限制等待时间，醒来后检查 TimedOut()。
+ *
+ * 线程安全性：非线程安全，由持有连接锁的线程访问。
+ */
+class KeepaliveTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 构造函数
+     * @param time_ms 空闲多久后发送 PING（毫秒），0 表示不启用保活
+     * @param timeout_ms 等待 ACK 的时间（毫秒）
+     * @param permit_without_calls 没有未完成的调用时是否也发送
+     * @param max_pings_without_data 两次发送数据之间最多发送的 PING 数，0 表示不限
+     * @param min_interval_without_data_ms 没有发送数据时两次 PING 的最小间隔（毫秒）
+     * @param now 连接建立的时间
+     */
+    KeepaliveTracker(int time_ms = 0, int timeout_ms = 20000, bool permit_without_calls = false,
+                     int max_pings_without_data = 2, int min_interval_without_data_ms = 0,
+                     Clock::time_point now = Clock::now());
+
+    /**
+     * @brief 是否启用了保活
+     */
+    bool enabled() const { return time_.count() > 0; }
+
+    /**
+     * @brief 记录读到了数据（任何数据都证明连接仍然存活）
+     * @param now 当前时间
+     */
+    void OnRead(Clock::time_point now) { last_read_ = now; }
+
+    /**
+     * @brief 记录发送了 HEADERS 或 DATA，重置无数据 PING 计数
+     */
+    void OnDataSent() { pings_without_data_ = 0; }
+
+    /**
+     * @brief 是否应发送保活 PING
+     * @param now 当前时间
+     * @param has_calls 是否有未完成的调用
+     * @return bool 已空闲 keepalive_time、没有 PING 在途且未超过发送限制时返回 true
+     */
+    bool NeedPing(Clock::time_point now, bool has_calls) const;
+
+    /**
+     * @brief 标记保活 PING 已提交
+     * @param now 当前时间
+     */
+    void StartPing(Clock::time_point now);
+
+    /**
+     * @brief 处理保活 PING 的 ACK
+     * @param now 当前时间
+     * @return int64_t 本次 RTT 采样（微秒）；没有 PING 在途时返回 -1
+     */
+    int64_t CompletePing(Clock::time_point now);
+
+    /**
+     * @brief 在途 PING 是否已超时
+     * @param now 当前时间
+     * @return bool 发出 PING 后 keepalive_timeout 内没有任何数据到达时返回 true
+     */
+    bool TimedOut(Clock::time_point now) const;
+
+    /**
+     * @brief 距下一个保活事件（发送 PING 或判定超时）的时间
+     * @param now 当前时间
+     * @param has_calls 是否有未完成的调用
+     * @return int 毫秒数（向上取整），没有待处理的事件时返回 -1
+     */
+    int WaitMs(Clock::time_point now, bool has_calls) const;
+
+    /**
+     * @brief 保活 PING 是否在途
+     */
+    bool ping_in_flight() const { return ping_in_flight_; }
+
+    /**
+     * @brief 已发送的保活 PING 数
+     */
+    uint64_t pings_sent() const { return pings_sent_; }
+
+    /**
+     * @brief 最近一次 RTT 采样（微秒），尚无采样时为 0
+     */
+    int64_t last_rtt_us() const { return last_rtt_us_; }
+
+    /**
+     * @brief 最小 RTT（微秒），尚无采样时为 0
+     */
+    int64_t min_rtt_us() const { return min_rtt_us_; }
+
+    /**
+     * @brief 平滑 RTT（微秒，新采样权重 1/8，与 TCP SRTT 相同），尚无采样时为 0
+     */
+    int64_t smoothed_rtt_us() const { return smoothed_rtt_us_; }
+
+    /**
+     * @brief RTT 采样数
+     */
+    uint64_t rtt_samples() const { return rtt_samples_; }
+
+private:
+    /**
+     * @brief 不考虑在途 PING 时，允许发送下一个 PING 的最早时间
+     */
+    Clock::time_point NextPingTime() const;
+
+    /**
+     * @brief 是否允许在当前状态下发送 PING（不考虑时间）
+     */
+    bool PingAllowed(bool has_calls) const;
+
+    std::chrono::milliseconds time_;                 ///< 空闲多久后发送 PING
+    std::chrono::milliseconds timeout_;              ///< 等待 ACK 的时间
+    bool permit_without_calls_;                      ///< 没有调用时是否也发送
+    int max_pings_without_data_;                     ///< 两次发送数据之间的 PING 上限
+    std::chrono::milliseconds min_interval_without_data_;  ///< 无数据时的 PING 最小间隔
+    Clock::time_point last_read_;                    ///< 最近一次读到数据的时间
+    Clock::time_point ping_start_;                   ///< 最近一次 PING 的发送时间
+    bool ping_in_flight_ = false;                    ///< 是否有 PING 未被确认
+    int pings_without_data_ = 0;                     ///< 上次发送数据以来的 PING 数
+    uint64_t pings_sent_ = 0;                        ///< 已发送的 PING 数
+    int64_t last_rtt_us_ = 0;                        ///< 最近一次 RTT
+    int64_t min_rtt_us_ = 0;                         ///< 最小 RTT
+    int64_t smoothed_rtt_us_ = 0;                    ///< 平滑 RTT
+    uint64_t rtt_samples_ = 0;                       ///< RTT 采样数
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_KEEPALIVE_H
@@ -0,0 +1,66 @@
+/**
+ * @file mpsc_queue.cpp
+ * @brief 无锁多生产者单消费者队列实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "mpsc_queue.h"
+
+namespace litegrpc {
+namespace http2 {
+
+MpscQueue::MpscQueue() : tail_(&stub_), head_(&stub_) {}
+
+/**
+ * @brief 入队
+ *
+ * 先以原子交换取得旧的尾节点，再把旧尾节点链接到新节点。
+ * 两步之间消费者看到的链表暂时断开，见 Pop()。
+ */
+void MpscQueue::Push(MpscNode* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    MpscNode* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+/**
+ * @brief 出队
+ *
+ * 步骤：
+ * 1. 跳过位于队首的占位节点
+ * 2. 队首节点有后继时直接出队
+ * 3. 队首节点是尾节点时重新入队占位节点，使队首节点获得后继后出队；
+ *    有生产者正在入队（尾节点已交换但链接尚未完成）时返回 nullptr
+ */
+MpscNode* MpscQueue::Pop() {
+    MpscNode* head = head_;
+    MpscNode* next = head->next.load(std::memory_order_acquire);
+    if (head == &stub_) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        head_ = next;
+        head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+        head_ = next;
+        return head;
+    }
+    if (head != tail_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    Push(&stub_);
+    next = head->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        head_ = next;
+        return head;
+    }
+    return nullptr;
+}
+
+} // namespace http2
+} // namespace litegrpc
@@ -0,0 +1,70 @@
+/**
+ * @file mpsc_queue.h
+ * @brief 无锁多生产者单消费者队列头文件
+ *
+ * 此文件定义了 I/O 线程模式下提交调用所用的侵入式队列（Vyukov MPSC 队列）：
+ * - 生产者（发起调用的线程）入队只需一次原子交换，不获取连接锁，
+ *   也不会被正在处理网络事件的 I/O 线程阻塞
+ * - 消费者（I/O 线程）出队不需要任何原子读改写操作
+ * - 节点由调用方分配并嵌入在调用描述中，入队出队都不分配内存
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_MPSC_QUEUE_H
+#define LITEGRPC_HTTP2_MPSC_QUEUE_H
+
+#include <atomic>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 队列节点，由元素类型继承
+ */
+struct MpscNode {
+    std::atomic<MpscNode*> next{nullptr};  ///< 下一个节点，由队列维护
+};
+
+/**
+ * @brief 侵入式无锁多生产者单消费者队列
+ *
+ * 队列不持有节点的所有权，节点在出队之前必须保持有效。
+ *
+ * 线程安全性：Push() 可从任意多个线程并发调用；Pop() 只能由同一个线程调用。
+ */
+class MpscQueue {
+public:
+    MpscQueue();
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief 入队
+     * @param node 尚未在任何队列中的节点
+     */
+    void Push(MpscNode* node);
+
+    /**
+     * @brief 出队
+     * @return MpscNode* 最早入队的节点；队列为空时返回 nullptr
+     *
+     * 某个生产者已交换了尾指针、尚未链接前驱节点时，其后的节点暂时不可见，
+     * 此时同样返回 nullptr。生产者在 Push() 之后会唤醒消费者，
+     * 因此消费者在下一次被唤醒时必然能取到这些节点。
+     */
+    MpscNode* Pop();
+
+private:
+    std::atomic<MpscNode*> tail_;  ///< 最后入队的节点，生产者交换
+    MpscNode* head_;               ///< 下一个出队节点的前驱，只由消费者访问
+    MpscNode stub_;                ///< 占位节点，保证队列中始终至少有一个节点
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_MPSC_QUEUE_H
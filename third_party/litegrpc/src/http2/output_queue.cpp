@@ -0,0 +1,123 @@
+/**
+ * @file output_queue.cpp
+ * @brief HTTP/2 传输层输出队列实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "output_queue.h"
+#include <algorithm>  // std::min
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 复制并追加数据
+ *
+ * 队尾复制段未被冻结且拼接后不超过 kCoalesceLimit 时直接拼接；
+ * 否则新建一个复制段。
+ */
+void OutputQueue::Append(const void* data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (segments_.size() <= sealed_ || segments_.back().ref != nullptr ||
+        segments_.back().owned.size() + len > kCoalesceLimit) {
+        segments_.emplace_back();
+        segments_.back().owned.reserve(std::max(len, static_cast<size_t>(1024)));
+    }
+    segments_.back().owned.append(static_cast<const char*>(data), len);
+    bytes_ += len;
+}
+
+/**
+ * @brief 以引用方式追加数据
+ */
+void OutputQueue::AppendRef(const void* data, size_t len, std::shared_ptr<void> owner,
+                            size_t* released) {
+    if (len == 0) {
+        return;
+    }
+    Segment segment;
+    segment.ref = static_cast<const uint8_t*>(data);
+    segment.ref_len = len;
+    segment.owner = std::move(owner);
+    segment.released = released;
+    segments_.push_back(std::move(segment));
+    bytes_ += len;
+}
+
+/**
+ * @brief 将指定所有者的引用段转为复制段
+ */
+void OutputQueue::Detach(const void* owner) {
+    for (Segment& segment : segments_) {
+        if (segment.ref == nullptr || segment.owner.get() != owner) {
+            continue;
+        }
+        segment.owned.assign(reinterpret_cast<const char*>(segment.data()), segment.remaining());
+        if (segment.released) {
+            *segment.released += segment.remaining();
+            segment.released = nullptr;
+        }
+        segment.ref = nullptr;
+        segment.ref_len = 0;
+        segment.offset = 0;
+        segment.owner.reset();
+    }
+}
+
+/**
+ * @brief 取得队首的连续分片
+ */
+size_t OutputQueue::Peek(Slice* slices, size_t max_slices) const {
+    size_t n = 0;
+    for (auto it = segments_.begin(); it != segments_.end() && n < max_slices; ++it, ++n) {
+        slices[n].data = it->data();
+        slices[n].len = it->remaining();
+        slices[n].owner = it->ref ? &it->owner : nullptr;
+    }
+    return n;
+}
+
+/**
+ * @brief 消费队首指定字节数
+ */
+void OutputQueue::Consume(size_t bytes) {
+    bytes = std::min(bytes, bytes_);
+    bytes_ -= bytes;
+    while (bytes > 0) {
+        Segment& front = segments_.front();
+        size_t n = std::min(bytes, front.remaining());
+        front.offset += n;
+        bytes -= n;
+        if (front.released) {
+            *front.released += n;
+        }
+        if (front.remaining() == 0) {
+            segments_.pop_front();
+            if (sealed_ > 0) {
+                sealed_--;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 清空队列
+ */
+void OutputQueue::Clear() {
+    for (Segment& segment : segments_) {
+        if (segment.released) {
+            *segment.released += segment.remaining();
+        }
+    }
+    segments_.clear();
+    bytes_ = 0;
+    sealed_ = 0;
+}
+
+} // namespace http2
+} // namespace litegrpc
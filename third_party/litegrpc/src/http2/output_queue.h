@@ -0,0 +1,142 @@
+/**
+ * @file output_queue.h
+ * @brief HTTP/2 传输层输出队列头文件
+ *
+ * 此文件定义了连接级的输出队列。nghttp2 在一轮发送中产生的所有帧
+ * （SETTINGS ACK、HEADERS、DATA、WINDOW_UPDATE 等）先追加到队列，
+ * 再由 Http2Client 以一次 writev/sendmsg 批量写出，从而把每个 RPC
+ * 的多次小写入合并为少量系统调用。
+ *
+ * 队列中的数据段分为两类：
+ * - 复制段：nghttp2 回调中的临时数据，复制后追加，相邻的小段会合并
+ * - 引用段：DATA 帧负载等生命周期可控的数据，只记录指针，不复制；
+ *   段上附带所有者引用，保证数据在写出前一直有效
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_OUTPUT_QUEUE_H
+#define LITEGRPC_HTTP2_OUTPUT_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 待写出数据的分段队列
+ *
+ * 只负责数据的组织，不执行任何 I/O。写出方通过 Peek() 取得队首的
+ * 若干连续分片构造 iovec，写出后调用 Consume() 前移。
+ *
+ * 线程安全性：非线程安全，由持有连接锁的线程访问。
+ */
+class OutputQueue {
+public:
+    /**
+     * @brief 队首数据分片
+     *
+     * 指针在下一次修改队列之前有效。
+     */
+    struct Slice {
+        const uint8_t* data = nullptr;  ///< 分片起始地址
+        size_t len = 0;                 ///< 分片长度
+        const std::shared_ptr<void>* owner = nullptr;  ///< 引用段的所有者，复制段为 nullptr
+    };
+
+    /**
+     * @brief 复制并追加数据
+     * @param data 数据指针
+     * @param len 数据长度
+     *
+     * 若队尾是尚有余量的复制段则直接拼接，避免产生大量小分片。
+     */
+    void Append(const void* data, size_t len);
+
+    /**
+     * @brief 以引用方式追加数据
+     * @param data 数据指针，必须在被写出或 Detach() 之前保持有效
+     * @param len 数据长度
+     * @param owner 数据的所有者，队列持有其引用直到该段被消费
+     * @param released 可选的计数器，该段的字节被消费、转为复制段或清空时
+     *        累加相应字节数，所有者据此得知哪些数据已不再被队列引用；
+     *        计数器须由 owner 持有
+     */
+    void AppendRef(const void* data, size_t len, std::shared_ptr<void> owner,
+                   size_t* released = nullptr);
+
+    /**
+     * @brief 将指定所有者的引用段转为复制段
+     * @param owner 所有者指针
+     *
+     * 所有者即将释放其引用的外部缓冲区（例如调用方提前返回）时调用，
+     * 只复制尚未写出的部分。
+     */
+    void Detach(const void* owner);
+
+    /**
+     * @brief 取得队首的连续分片
+     * @param slices 输出数组
+     * @param max_slices 数组容量
+     * @return size_t 实际填充的分片数
+     */
+    size_t Peek(Slice* slices, size_t max_slices) const;
+
+    /**
+     * @brief 消费队首指定字节数
+     * @param bytes 已写出的字节数，不得超过 size()
+     */
+    void Consume(size_t bytes);
+
+    /**
+     * @brief 冻结当前所有分段
+     *
+     * 之后追加的数据不再拼接到已有分段，已取得的分片地址在被消费之前
+     * 保持有效。用于异步写出（io_uring）时保护内核仍在读取的数据。
+     */
+    void Seal() { sealed_ = segments_.size(); }
+
+    /**
+     * @brief 清空队列并释放所有所有者引用
+     */
+    void Clear();
+
+    size_t size() const { return bytes_; }                    ///< 待写出的总字节数
+    size_t segment_count() const { return segments_.size(); } ///< 分段数量
+    bool empty() const { return bytes_ == 0; }                ///< 队列是否为空
+
+private:
+    /**
+     * @brief 队列分段
+     */
+    struct Segment {
+        std::string owned;              ///< 复制段的数据
+        const uint8_t* ref = nullptr;   ///< 引用段的数据，复制段为 nullptr
+        size_t ref_len = 0;             ///< 引用段的总长度
+        size_t offset = 0;              ///< 已消费的字节数
+        std::shared_ptr<void> owner;    ///< 引用段的所有者
+        size_t* released = nullptr;     ///< 引用段不再被引用的字节计数器，可为空
+
+        const uint8_t* data() const {
+            return (ref ? ref : reinterpret_cast<const uint8_t*>(owned.data())) + offset;
+        }
+        size_t remaining() const { return (ref ? ref_len : owned.size()) - offset; }
+    };
+
+    static const size_t kCoalesceLimit = 16384;  ///< 复制段合并的上限
+
+    std::deque<Segment> segments_;  ///< 分段列表
+    size_t bytes_ = 0;              ///< 待写出的总字节数
+    size_t sealed_ = 0;             ///< 队首被冻结、不可再拼接的分段数
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_OUTPUT_QUEUE_H
@@ -0,0 +1,304 @@
+/**
+ * @file response_metadata.cpp
+ * @brief HTTP/2 响应头部表实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "response_metadata.h"
+#include <charconv>  // std::from_chars
+#include <utility>   // std::move
+
+namespace litegrpc {
+namespace http2 {
+
+namespace {
+
+/**
+ * @brief 常用头部名称，顺序与 WellKnownHeader 一致
+ */
+const std::string_view kWellKnownNames[] = {
+    "grpc-status",
+    "grpc-message",
+    "content-type",
+    "grpc-encoding",
+};
+
+static_assert(sizeof(kWellKnownNames) / sizeof(kWellKnownNames[0]) ==
+              static_cast<size_t>(WellKnownHeader::kCount),
+              "kWellKnownNames must match WellKnownHeader");
+
+/**
+ * @brief 识别常用头部
+ * @return int 槽位下标，不是常用头部时返回 -1
+ *
+ * 先按长度和末字符筛选，绝大多数头部无需逐字节比较。
+ */
+int LookupWellKnown(std::string_view name) {
+    for (size_t i = 0; i < static_cast<size_t>(WellKnownHeader::kCount); ++i) {
+        const std::string_view known = kWellKnownNames[i];
+        if (name.size() == known.size() && name.back() == known.back() && name == known) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 十六进制字符的数值
+ * @return int 不是十六进制字符时返回 -1
+ */
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief base64 字符的数值
+ * @return int 不是 base64 字符时返回 -1
+ */
+int Base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if (c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    if (c == '+') {
+        return 62;
+    }
+    if (c == '/') {
+        return 63;
+    }
+    return -1;
+}
+
+/// 二进制头部名称的后缀
+const std::string_view kBinarySuffix = "-bin";
+
+} // namespace
+
+/**
+ * @brief 以十进制解析非负整数
+ */
+bool ParseNonNegativeInt(std::string_view text, int* value) {
+    if (text.empty()) {
+        return false;
+    }
+    int result = 0;
+    auto rv = std::from_chars(text.data(), text.data() + text.size(), result);
+    if (rv.ec != std::errc() || rv.ptr != text.data() + text.size() || result < 0) {
+        return false;
+    }
+    *value = result;
+    return true;
+}
+
+/**
+ * @brief 解码 grpc-message 的百分号编码
+ */
+std::string PercentDecode(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size()) {
+            const int high = HexValue(text[i + 1]);
+            const int low = HexValue(text[i + 2]);
+            if (high >= 0 && low >= 0) {
+                result.push_back(static_cast<char>(high << 4 | low));
+                i += 2;
+                continue;
+            }
+        }
+        result.push_back(text[i]);
+    }
+    return result;
+}
+
+/**
+ * @brief 解码二进制头部的 base64 值
+ *
+ * 接受带或不带 '=' 填充的标准 base64（gRPC 发送方可以省略填充），
+ * 填充只能出现在末尾，剩余 1 个字符的长度不合法。
+ */
+bool Base64Decode(std::string_view text, std::string* value) {
+    while (!text.empty() && text.back() == '=' && text.size() % 4 != 1) {
+        text.remove_suffix(1);
+    }
+    if (text.size() % 4 == 1) {
+        return false;
+    }
+    std::string result;
+    result.reserve(text.size() * 3 / 4);
+    uint32_t bits = 0;
+    int bit_count = 0;
+    for (char c : text) {
+        const int v = Base64Value(c);
+        if (v < 0) {
+            return false;
+        }
+        bits = bits << 6 | static_cast<uint32_t>(v);
+        bit_count += 6;
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            result.push_back(static_cast<char>((bits >> bit_count) & 0xff));
+        }
+    }
+    *value = std::move(result);
+    return true;
+}
+
+ResponseMetadata::ResponseMetadata() {
+    for (auto& slot : slots_) {
+        slot = -1;
+    }
+}
+
+/**
+ * @brief 追加一个头部
+ *
+ * 步骤：
+ * 1. 名称和值追加到存储区，对象内容量不足时整体转移到堆上
+ * 2. 条目追加到条目表，对象内容量不足时同样整体转移
+ * 3. 常用头部记录槽位，grpc-status 同时解析为整数
+ */
+void ResponseMetadata::Add(std::string_view name, std::string_view value) {
+    Span entry;
+    entry.name_offset = AppendToArena(name);
+    entry.name_length = static_cast<uint32_t>(name.size());
+    entry.value_offset = AppendToArena(value);
+    entry.value_length = static_cast<uint32_t>(value.size());
+
+    if (heap_entries_.empty() && count_ < kInlineEntryCount) {
+        inline_entries_[count_] = entry;
+    } else {
+        if (heap_entries_.empty()) {
+            heap_entries_.assign(inline_entries_, inline_entries_ + count_);
+        }
+        heap_entries_.push_back(entry);
+    }
+    const size_t index = count_++;
+
+    const int slot = name.empty() ? -1 : LookupWellKnown(name);
+    if (slot >= 0) {
+        slots_[slot] = static_cast<int32_t>(index);
+        if (slot == static_cast<int>(WellKnownHeader::kGrpcStatus) &&
+            !ParseNonNegativeInt(value, &grpc_status_)) {
+            grpc_status_ = -1;
+        }
+    }
+}
+
+/**
+ * @brief 获取第 index 个头部
+ */
+ResponseMetadata::Entry ResponseMetadata::at(size_t index) const {
+    const Span& s = span(index);
+    const char* base = arena();
+    return Entry{std::string_view(base + s.name_offset, s.name_length),
+                 std::string_view(base + s.value_offset, s.value_length)};
+}
+
+/**
+ * @brief 查找头部
+ *
+ * 常用头部直接按槽位返回，其余头部从后向前线性查找。
+ */
+bool ResponseMetadata::Find(std::string_view name, std::string_view* value) const {
+    const int slot = name.empty() ? -1 : LookupWellKnown(name);
+    if (slot >= 0) {
+        return Get(static_cast<WellKnownHeader>(slot), value);
+    }
+    for (size_t i = count_; i-- > 0;) {
+        Entry entry = at(i);
+        if (entry.name == name) {
+            *value = entry.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 获取常用头部
+ */
+bool ResponseMetadata::Get(WellKnownHeader header, std::string_view* value) const {
+    const int32_t index = slots_[Slot(header)];
+    if (index < 0) {
+        return false;
+    }
+    *value = at(static_cast<size_t>(index)).value;
+    return true;
+}
+
+/**
+ * @brief 获取解码后的 grpc-message
+ */
+bool ResponseMetadata::GetGrpcMessage(std::string* message) const {
+    std::string_view value;
+    if (!Get(WellKnownHeader::kGrpcMessage, &value)) {
+        return false;
+    }
+    *message = PercentDecode(value);
+    return true;
+}
+
+/**
+ * @brief 查找二进制头部并解码
+ */
+bool ResponseMetadata::FindBinary(std::string_view name, std::string* value) const {
+    if (name.size() <= kBinarySuffix.size() ||
+        name.substr(name.size() - kBinarySuffix.size()) != kBinarySuffix) {
+        return false;
+    }
+    std::string_view encoded;
+    return Find(name, &encoded) && Base64Decode(encoded, value);
+}
+
+/**
+ * @brief 清空所有头部
+ */
+void ResponseMetadata::Clear() {
+    heap_arena_.clear();
+    heap_entries_.clear();
+    arena_size_ = 0;
+    count_ = 0;
+    for (auto& slot : slots_) {
+        slot = -1;
+    }
+    grpc_status_ = -1;
+}
+
+/**
+ * @brief 将数据追加到存储区
+ */
+uint32_t ResponseMetadata::AppendToArena(std::string_view data) {
+    const uint32_t offset = static_cast<uint32_t>(arena_size_);
+    if (heap_arena_.empty() && arena_size_ + data.size() <= kInlineArenaSize) {
+        data.copy(inline_arena_ + arena_size_, data.size());
+    } else {
+        if (heap_arena_.empty()) {
+            heap_arena_.reserve(2 * (arena_size_ + data.size()));
+            heap_arena_.assign(inline_arena_, inline_arena_ + arena_size_);
+        }
+        heap_arena_.insert(heap_arena_.end(), data.begin(), data.end());
+    }
+    arena_size_ += data.size();
+    return offset;
+}
+
+} // namespace http2
+} // namespace litegrpc
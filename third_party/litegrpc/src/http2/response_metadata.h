@@ -0,0 +1,197 @@
+/**
+ * @file response_metadata.h
+ * @brief HTTP/2 响应头部表头文件
+ *
+ * 此文件定义了存放响应头部与 trailers 的紧凑结构，取代逐个头部
+ * 构造 std::string 并插入 std::map 的做法：
+ * - 所有名称和值顺序追加到同一块内存区域，条目只记录偏移和长度
+ * - 内存区域和条目表先使用对象内的固定容量，超出后才转移到堆上，
+ *   常见的 gRPC 响应（十个以内的头部、数百字节）不分配内存
+ * - 常用的 gRPC 头部（grpc-status、grpc-message、content-type、
+ *   grpc-encoding）在写入时识别并记录到固定槽位，查找无需比较字符串
+ * - grpc-status 在写入时解析为整数，不使用可能抛出异常的 std::stoi
+ * - grpc-message 按百分号编码解码，"-bin" 后缀的二进制头部按 base64 解码，
+ *   只在读取时进行，写入路径不做额外处理
+ *
+ * 条目以偏移而不是指针记录位置，对象可以安全地移动和复制。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_RESPONSE_METADATA_H
+#define LITEGRPC_HTTP2_RESPONSE_METADATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 固定槽位的常用头部
+ */
+enum class WellKnownHeader : uint8_t {
+    kGrpcStatus = 0,   ///< grpc-status
+    kGrpcMessage,      ///< grpc-message
+    kContentType,      ///< content-type
+    kGrpcEncoding,     ///< grpc-encoding
+    kCount             ///< 槽位数量
+};
+
+/**
+ * @brief 以十进制解析非负整数，不抛出异常
+ * @param text 待解析的文本，必须全部为数字
+ * @param value 输出参数，解析结果
+ * @return bool 格式正确且未溢出时返回 true
+ */
+bool ParseNonNegativeInt(std::string_view text, int* value);
+
+/**
+ * @brief 解码 grpc-message 的百分号编码
+ * @param text 头部值
+ * @return std::string 解码结果
+ *
+ * 按 gRPC 协议的要求宽松解码：不构成合法 "%XX" 的 '%' 原样保留。
+ */
+std::string PercentDecode(std::string_view text);
+
+/**
+ * @brief 解码二进制头部的 base64 值
+ * @param text 头部值，可以省略末尾的 '=' 填充
+ * @param value 输出参数，解码结果
+ * @return bool 格式正确时返回 true
+ */
+bool Base64Decode(std::string_view text, std::string* value);
+
+/**
+ * @brief 响应头部表
+ *
+ * 线程安全性：非线程安全。由持有连接锁的回调写入，
+ * 移交给调用方后由调用方独占访问。
+ */
+class ResponseMetadata {
+public:
+    /**
+     * @brief 一个头部条目
+     */
+    struct Entry {
+        std::string_view name;   ///< 头部名称
+        std::string_view value;  ///< 头部值
+    };
+
+    ResponseMetadata();
+
+    /**
+     * @brief 追加一个头部
+     * @param name 头部名称
+     * @param value 头部值
+     *
+     * 同名头部（例如重复的元数据）全部保留；常用头部的槽位指向最后一次出现。
+     */
+    void Add(std::string_view name, std::string_view value);
+
+    /**
+     * @brief 头部数量
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief 获取第 index 个头部
+     * @param index 下标，必须小于 size()
+     * @return Entry 指向内部存储的名称和值，追加新头部后失效
+     */
+    Entry at(size_t index) const;
+
+    /**
+     * @brief 查找头部
+     * @param name 头部名称
+     * @param value 输出参数，最后一个同名头部的值
+     * @return bool 找到时返回 true
+     */
+    bool Find(std::string_view name, std::string_view* value) const;
+
+    /**
+     * @brief 获取常用头部
+     * @param header 头部槽位
+     * @param value 输出参数，头部的值
+     * @return bool 头部存在时返回 true
+     */
+    bool Get(WellKnownHeader header, std::string_view* value) const;
+
+    /**
+     * @brief 获取解码后的 grpc-message
+     * @param message 输出参数，百分号解码后的错误消息
+     * @return bool 头部存在时返回 true
+     */
+    bool GetGrpcMessage(std::string* message) const;
+
+    /**
+     * @brief 查找二进制头部并解码
+     * @param name 头部名称，必须以 "-bin" 结尾
+     * @param value 输出参数，base64 解码后的值
+     * @return bool 头部存在且格式正确时返回 true
+     */
+    bool FindBinary(std::string_view name, std::string* value) const;
+
+    /**
+     * @brief grpc-status 是否存在
+     */
+    bool has_grpc_status() const { return slots_[Slot(WellKnownHeader::kGrpcStatus)] >= 0; }
+
+    /**
+     * @brief grpc-status 的数值
+     * @return int 状态码；头部不存在或格式错误时返回 -1
+     */
+    int grpc_status() const { return grpc_status_; }
+
+    /**
+     * @brief 清空所有头部
+     */
+    void Clear();
+
+private:
+    static const size_t kInlineArenaSize = 256;  ///< 对象内存储区容量（字节）
+    static const size_t kInlineEntryCount = 8;   ///< 对象内条目表容量
+
+    /**
+     * @brief 条目在存储区中的位置
+     */
+    struct Span {
+        uint32_t name_offset;
+        uint32_t name_length;
+        uint32_t value_offset;
+        uint32_t value_length;
+    };
+
+    static size_t Slot(WellKnownHeader header) { return static_cast<size_t>(header); }
+
+    /**
+     * @brief 将数据追加到存储区
+     * @return uint32_t 数据在存储区中的偏移
+     */
+    uint32_t AppendToArena(std::string_view data);
+
+    const char* arena() const { return heap_arena_.empty() ? inline_arena_ : heap_arena_.data(); }
+    const Span& span(size_t index) const {
+        return heap_entries_.empty() ? inline_entries_[index] : heap_entries_[index];
+    }
+
+    char inline_arena_[kInlineArenaSize];         ///< 对象内存储区
+    std::vector<char> heap_arena_;                ///< 溢出后的存储区（包含全部数据）
+    size_t arena_size_ = 0;                       ///< 已使用的字节数
+    Span inline_entries_[kInlineEntryCount];      ///< 对象内条目表
+    std::vector<Span> heap_entries_;              ///< 溢出后的条目表（包含全部条目）
+    size_t count_ = 0;                            ///< 条目数量
+    int32_t slots_[static_cast<size_t>(WellKnownHeader::kCount)];  ///< 常用头部 -> 条目下标，-1 表示不存在
+    int grpc_status_ = -1;                        ///< 解析后的 grpc-status
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_RESPONSE_METADATA_H
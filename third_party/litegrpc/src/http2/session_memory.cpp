@@ -0,0 +1,247 @@
+/**
+ * @file session_memory.cpp
+ * @brief nghttp2 会话内存池实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "session_memory.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace litegrpc {
+namespace http2 {
+
+const size_t SessionMemoryPool::kClassCount;
+const size_t SessionMemoryPool::kMinBlockSize;
+const size_t SessionMemoryPool::kMaxSlabSize;
+const size_t SessionMemoryPool::kBlockHeaderSize;
+
+namespace {
+
+/**
+ * @brief 每个块前的块头，记录块所属的分级与块大小
+ *
+ * 按 max_align_t 的对齐要求对齐（而不是占用 sizeof(max_align_t) 字节），
+ * 块头之后的数据满足 malloc 的对齐保证，最小分级仍可容纳 16 字节的请求。
+ * 空闲块的块头位置用于保存空闲链表的下一个块。
+ */
+struct alignas(alignof(std::max_align_t)) BlockHeader {
+    size_t cls;   ///< 分级，kLargeClass 表示直接向系统申请的块
+    size_t size;  ///< 块大小（含块头）
+};
+
+static_assert(sizeof(BlockHeader) == SessionMemoryPool::kBlockHeaderSize, "block header size mismatch");
+
+const size_t kLargeClass = SessionMemoryPool::kClassCount;  ///< 直接向系统申请的块
+const size_t kMinSlabSize = 2048;                           ///< 单个页面的最小字节数
+
+size_t BlockSize(size_t cls) {
+    return SessionMemoryPool::kMinBlockSize << cls;
+}
+
+/**
+ * @brief 一个分级每次申请的页面大小：至少 8 个块，不超过 kMaxSlabSize
+ */
+size_t SlabSize(size_t cls) {
+    return std::min(SessionMemoryPool::kMaxSlabSize, std::max(kMinSlabSize, BlockSize(cls) * 8));
+}
+
+BlockHeader* HeaderOf(void* ptr) {
+    return static_cast<BlockHeader*>(ptr) - 1;
+}
+
+} // namespace
+
+SessionMemoryPool::SessionMemoryPool() {
+    mem_.mem_user_data = this;
+    mem_.malloc = MallocThunk;
+    mem_.free = FreeThunk;
+    mem_.calloc = CallocThunk;
+    mem_.realloc = ReallocThunk;
+}
+
+SessionMemoryPool::~SessionMemoryPool() {
+    Release();
+}
+
+void SessionMemoryPool::Release() {
+    for (void* slab : slabs_) {
+        free(slab);
+    }
+    slabs_.clear();
+    std::fill(free_lists_, free_lists_ + kClassCount, nullptr);
+    in_use_ = 0;
+    reserved_ = 0;
+    peak_reserved_ = 0;
+    allocations_ = 0;
+    system_allocations_ = 0;
+    failures_ = 0;
+}
+
+/**
+ * @brief 在预算内登记向系统申请的字节数
+ * @return bool 超出预算时返回 false
+ */
+bool SessionMemoryPool::Reserve(size_t bytes) {
+    if (limit_ > 0 && (bytes > limit_ || reserved_ > limit_ - bytes)) {
+        return false;
+    }
+    reserved_ += bytes;
+    peak_reserved_ = std::max(peak_reserved_, reserved_);
+    return true;
+}
+
+/**
+ * @brief 为一个分级申请新页面并切分为空闲块
+ *
+ * 预算不足一个整页时退而只申请一个块，预算中的每个字节都可用。
+ */
+bool SessionMemoryPool::Refill(size_t cls) {
+    const size_t block = BlockSize(cls);
+    size_t slab_size = SlabSize(cls);
+    if (!Reserve(slab_size)) {
+        slab_size = block;
+        if (!Reserve(slab_size)) {
+            return false;
+        }
+    }
+    char* slab = static_cast<char*>(malloc(slab_size));
+    if (!slab) {
+        reserved_ -= slab_size;
+        return false;
+    }
+    system_allocations_++;
+    slabs_.push_back(slab);
+    for (size_t offset = slab_size; offset >= block; offset -= block) {
+        void* node = slab + offset - block;
+        *static_cast<void**>(node) = free_lists_[cls];
+        free_lists_[cls] = node;
+    }
+    return true;
+}
+
+/**
+ * @brief 分配内存
+ *
+ * 步骤：
+ * 1. 加上块头后不超过最大分级的请求，从对应分级的空闲链表取块，
+ *    链表为空时先申请新页面
+ * 2. 更大的请求在预算内直接向系统申请
+ * 3. 记录块头并返回块头之后的地址
+ */
+void* SessionMemoryPool::Allocate(size_t size) {
+    allocations_++;
+    if (size > std::numeric_limits<size_t>::max() - sizeof(BlockHeader)) {
+        failures_++;
+        return nullptr;
+    }
+    const size_t need = size + sizeof(BlockHeader);
+    BlockHeader* header = nullptr;
+    size_t cls = 0;
+    while (cls < kClassCount && BlockSize(cls) < need) {
+        cls++;
+    }
+    if (cls < kClassCount) {
+        if (!free_lists_[cls] && !Refill(cls)) {
+            failures_++;
+            return nullptr;
+        }
+        void* node = free_lists_[cls];
+        free_lists_[cls] = *static_cast<void**>(node);
+        header = static_cast<BlockHeader*>(node);
+        header->size = BlockSize(cls);
+    } else {
+        if (!Reserve(need)) {
+            failures_++;
+            return nullptr;
+        }
+        header = static_cast<BlockHeader*>(malloc(need));
+        if (!header) {
+            reserved_ -= need;
+            failures_++;
+            return nullptr;
+        }
+        system_allocations_++;
+        header->size = need;
+    }
+    header->cls = cls;
+    in_use_ += header->size;
+    return header + 1;
+}
+
+void SessionMemoryPool::Free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    BlockHeader* header = HeaderOf(ptr);
+    in_use_ -= header->size;
+    if (header->cls == kLargeClass) {
+        reserved_ -= header->size;
+        free(header);
+        return;
+    }
+    const size_t cls = header->cls;
+    *reinterpret_cast<void**>(header) = free_lists_[cls];
+    free_lists_[cls] = header;
+}
+
+/**
+ * @brief 调整块大小
+ *
+ * 新大小仍在块容量内时原地返回；否则分配新块、复制数据后释放旧块。
+ * 分配失败时旧块保持有效，与 realloc 一致。
+ */
+void* SessionMemoryPool::Reallocate(void* ptr, size_t size) {
+    if (!ptr) {
+        return Allocate(size);
+    }
+    if (size == 0) {
+        Free(ptr);
+        return nullptr;
+    }
+    const size_t capacity = HeaderOf(ptr)->size - sizeof(BlockHeader);
+    if (size <= capacity) {
+        return ptr;
+    }
+    void* moved = Allocate(size);
+    if (!moved) {
+        return nullptr;
+    }
+    memcpy(moved, ptr, capacity);
+    Free(ptr);
+    return moved;
+}
+
+void* SessionMemoryPool::MallocThunk(size_t size, void* user_data) {
+    return static_cast<SessionMemoryPool*>(user_data)->Allocate(size);
+}
+
+void SessionMemoryPool::FreeThunk(void* ptr, void* user_data) {
+    static_cast<SessionMemoryPool*>(user_data)->Free(ptr);
+}
+
+void* SessionMemoryPool::CallocThunk(size_t nmemb, size_t size, void* user_data) {
+    auto* pool = static_cast<SessionMemoryPool*>(user_data);
+    if (size != 0 && nmemb > std::numeric_limits<size_t>::max() / size) {
+        pool->failures_++;
+        return nullptr;
+    }
+    void* ptr = pool->Allocate(nmemb * size);
+    if (ptr) {
+        memset(ptr, 0, nmemb * size);
+    }
+    return ptr;
+}
+
+void* SessionMemoryPool::ReallocThunk(void* ptr, size_t size, void* user_data) {
+    return static_cast<SessionMemoryPool*>(user_data)->Reallocate(ptr, size);
+}
+
+} // namespace http2
+} // namespace litegrpc
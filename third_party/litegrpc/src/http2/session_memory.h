@@ -0,0 +1,106 @@
+/**
+ * @file session_memory.h
+ * @brief nghttp2 会话内存池头文件
+ *
+ * nghttp2 默认以 malloc 分配会话内部的所有对象：每个流的流结构与
+ * 发送队列项、HPACK 动态表条目、收到的头部名值等，每次调用都会在
+ * 全局堆上分配并释放若干次。此文件定义的 SessionMemoryPool 作为
+ * nghttp2_mem 交给 nghttp2_session_client_new3()，每个连接独占一个：
+ * - 小块按 2 的幂分级，从按级申请的整页（slab）中切出，释放后挂回
+ *   本级空闲链表复用，稳定运行后每次调用不再向系统申请内存
+ * - 超过最大分级的块（会话结构、HPACK 缓冲区、帧缓冲区等）只在
+ *   建立会话时分配，直接向系统申请，释放时归还
+ * - 可设置字节预算：池向系统申请的总量超过预算时分配失败，
+ *   nghttp2 返回 NGHTTP2_ERR_NOMEM，单个连接的内存占用有确定的上限
+ * - 统计当前占用、已申请与峰值字节数，供按连接观察内存
+ *
+ * 页面只在会话销毁后由 Release() 一并归还系统。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_SESSION_MEMORY_H
+#define LITEGRPC_HTTP2_SESSION_MEMORY_H
+
+#include <nghttp2/nghttp2.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 按连接分配 nghttp2 会话内存的分级内存池
+ *
+ * 线程安全性：非线程安全。会话的所有操作都由持有连接锁的线程执行，
+ * 内存池随之串行化。
+ */
+class SessionMemoryPool {
+public:
+    static const size_t kClassCount = 6;         ///< 分级数（32 ~ 1024 字节，含块头）
+    static const size_t kMinBlockSize = 32;      ///< 最小分级的块大小（字节）
+    static const size_t kMaxSlabSize = 8 * 1024; ///< 单个页面的最大字节数
+    static const size_t kBlockHeaderSize = 16;   ///< 每个块的块头字节数
+
+    SessionMemoryPool();
+    ~SessionMemoryPool();
+
+    SessionMemoryPool(const SessionMemoryPool&) = delete;
+    SessionMemoryPool& operator=(const SessionMemoryPool&) = delete;
+
+    /**
+     * @brief 设置字节预算
+     * @param limit 池向系统申请的字节数上限，0 表示不限
+     */
+    void set_limit(size_t limit) { limit_ = limit; }
+
+    /**
+     * @brief 交给 nghttp2 的分配器
+     *
+     * 返回的结构指向本对象，本对象必须比使用它的会话存活得更久。
+     */
+    nghttp2_mem* mem() { return &mem_; }
+
+    /**
+     * @brief 归还所有页面，清零统计（会话销毁后调用）
+     */
+    void Release();
+
+    size_t in_use() const { return in_use_; }            ///< 已分配给 nghttp2 的字节数（按块大小计）
+    size_t reserved() const { return reserved_; }        ///< 向系统申请且尚未归还的字节数
+    size_t peak_reserved() const { return peak_reserved_; }  ///< reserved() 的峰值
+    uint64_t allocations() const { return allocations_; }    ///< nghttp2 的分配请求次数
+    uint64_t system_allocations() const { return system_allocations_; }  ///< 向系统申请内存的次数
+    uint64_t failures() const { return failures_; }      ///< 超出预算而失败的分配次数
+
+private:
+    void* Allocate(size_t size);
+    void Free(void* ptr);
+    void* Reallocate(void* ptr, size_t size);
+    bool Refill(size_t cls);
+    bool Reserve(size_t bytes);
+
+    static void* MallocThunk(size_t size, void* user_data);
+    static void FreeThunk(void* ptr, void* user_data);
+    static void* CallocThunk(size_t nmemb, size_t size, void* user_data);
+    static void* ReallocThunk(void* ptr, size_t size, void* user_data);
+
+    nghttp2_mem mem_;                        ///< 交给 nghttp2 的分配器
+    size_t limit_ = 0;                       ///< 字节预算，0 表示不限
+    void* free_lists_[kClassCount] = {};     ///< 各级的空闲块链表
+    std::vector<void*> slabs_;               ///< 已申请的页面
+    size_t in_use_ = 0;                      ///< 已分配给 nghttp2 的字节数
+    size_t reserved_ = 0;                    ///< 向系统申请且尚未归还的字节数
+    size_t peak_reserved_ = 0;               ///< reserved_ 的峰值
+    uint64_t allocations_ = 0;               ///< nghttp2 的分配请求次数
+    uint64_t system_allocations_ = 0;        ///< 向系统申请内存的次数
+    uint64_t failures_ = 0;                  ///< 超出预算而失败的分配次数
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_SESSION_MEMORY_H
@@ -0,0 +1,415 @@
+/**
+ * @file tls_context.cpp
+ * @brief 共享 TLS 上下文实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "tls_context.h"
+#include <openssl/err.h>   // OpenSSL 错误队列
+#include <openssl/pem.h>   // PEM 解析
+#include <openssl/x509.h>  // 证书与证书存储
+#include <cstdio>            // snprintf
+#include <ctime>             // time
+#include <mutex>             // std::call_once
+#include <string>
+#include "tls_ticket_store.h"
+
+namespace litegrpc {
+namespace http2 {
+
+namespace {
+
+/**
+ * @brief TLS 1.2 下允许的密码套件
+ *
+ * HTTP/2 要求 TLS 1.2 连接使用带前向保密的 AEAD 套件（RFC 7540 第 9.2.2 节），
+ * 其余套件会被服务器以 INADEQUATE_SECURITY 拒绝。TLS 1.3 套件均满足要求，
+ * 保持 OpenSSL 默认值。
+ */
+const char kTls12CipherList[] =
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+
+/**
+ * @brief 一次性初始化 OpenSSL
+ * @return bool 初始化是否成功，之后的调用返回同一结果
+ *
+ * 只在构建第一个 TLS 上下文时执行，只使用明文连接的进程不会触发。
+ * OpenSSL 1.1.0 起库会自动初始化，这里显式调用以便在失败时报告错误，
+ * 并提前加载错误字符串；旧版本的初始化函数不是线程安全的，由 call_once 串行化。
+ */
+bool InitializeOpenSsl() {
+    static std::once_flag once;
+    static bool initialized = false;
+    std::call_once(once, []() {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+        initialized = OPENSSL_init_ssl(OPENSSL_INIT_LOAD_SSL_STRINGS |
+                                       OPENSSL_INIT_LOAD_CRYPTO_STRINGS, nullptr) == 1;
+#else
+        SSL_library_init();
+        SSL_load_error_strings();
+        OpenSSL_add_all_algorithms();
+        initialized = true;
+#endif
+    });
+    return initialized;
+}
+
+/**
+ * @brief 取出 OpenSSL 错误队列中最早的错误并拼接到消息后
+ */
+std::string OpenSslError(const std::string& message) {
+    unsigned long err = ERR_get_error();
+    ERR_clear_error();
+    if (err == 0) {
+        return message;
+    }
+    char buf[256];
+    ERR_error_string_n(err, buf, sizeof(buf));
+    return message + ": " + buf;
+}
+
+/**
+ * @brief 以只读内存 BIO 包装 PEM 字符串
+ */
+BIO* PemBio(const std::string& pem) {
+    return BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+}
+
+/**
+ * @brief 解析 PEM 根证书并加入证书存储
+ * @return Status 一个证书都没有解析出时返回 INVALID_ARGUMENT
+ */
+Status LoadRootCerts(SSL_CTX* ctx, const std::string& pem, size_t* count) {
+    BIO* bio = PemBio(pem);
+    if (!bio) {
+        return Status::ResourceExhausted("Failed to allocate BIO for pem_root_certs");
+    }
+    X509_STORE* store = SSL_CTX_get_cert_store(ctx);
+    size_t loaded = 0;
+    while (X509* cert = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr)) {
+        X509_STORE_add_cert(store, cert);  // 存储增加自己的引用，重复证书忽略
+        X509_free(cert);
+        loaded++;
+    }
+    ERR_clear_error();  // 读到末尾时队列中会留下 "no start line"
+    BIO_free(bio);
+    if (loaded == 0) {
+        return Status::InvalidArgument("No certificate found in pem_root_certs");
+    }
+    *count = loaded;
+    return Status::OK();
+}
+
+/**
+ * @brief 解析客户端证书链与私钥
+ *
+ * 证书链中第一个证书是客户端证书，其余作为中间证书随握手发送。
+ */
+Status LoadClientIdentity(SSL_CTX* ctx, const std::string& cert_chain, const std::string& key) {
+    BIO* bio = PemBio(cert_chain);
+    if (!bio) {
+        return Status::ResourceExhausted("Failed to allocate BIO for pem_cert_chain");
+    }
+    X509* leaf = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr);
+    if (!leaf) {
+        BIO_free(bio);
+        return Status::InvalidArgument(OpenSslError("Failed to parse pem_cert_chain"));
+    }
+    int rv = SSL_CTX_use_certificate(ctx, leaf);
+    X509_free(leaf);
+    if (rv != 1) {
+        BIO_free(bio);
+        return Status::InvalidArgument(OpenSslError("Failed to use client certificate"));
+    }
+    while (X509* intermediate = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr)) {
+        if (SSL_CTX_add0_chain_cert(ctx, intermediate) != 1) {  // 成功时接管所有权
+            X509_free(intermediate);
+        }
+    }
+    ERR_clear_error();
+    BIO_free(bio);
+
+    bio = PemBio(key);
+    if (!bio) {
+        return Status::ResourceExhausted("Failed to allocate BIO for pem_private_key");
+    }
+    EVP_PKEY* pkey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+    if (!pkey) {
+        return Status::InvalidArgument(OpenSslError("Failed to parse pem_private_key"));
+    }
+    rv = SSL_CTX_use_PrivateKey(ctx, pkey);
+    EVP_PKEY_free(pkey);
+    if (rv != 1 || SSL_CTX_check_private_key(ctx) != 1) {
+        return Status::InvalidArgument(OpenSslError("Private key does not match client certificate"));
+    }
+    return Status::OK();
+}
+
+/**
+ * @brief 凭证指纹：根证书与客户端证书链的 FNV-1a 64 位哈希（十六进制）
+ *
+ * 私钥由证书链唯一确定，不参与哈希，也就不会以任何形式写入磁盘。
+ */
+std::string CredentialFingerprint(const SslCredentialsOptions& options) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::string& data) {
+        for (unsigned char c : data) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xff) * 1099511628211ull;  // 分隔两个字段
+    };
+    mix(options.pem_root_certs);
+    mix(options.pem_cert_chain);
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+/**
+ * @brief 连接上绑定的会话保存位置，由 PrepareSession 设置
+ */
+struct SessionBinding {
+    std::string target;                     ///< 目标地址
+    std::shared_ptr<TlsTicketStore> store;  ///< 磁盘票据存储，可为空
+};
+
+/**
+ * @brief SSL 对象释放时销毁绑定
+ */
+void FreeSessionBinding(void* /*parent*/, void* ptr, CRYPTO_EX_DATA* /*ad*/, int /*idx*/,
+                        long /*argl*/, void* /*argp*/) {
+    delete static_cast<SessionBinding*>(ptr);
+}
+
+/**
+ * @brief SessionBinding 在 SSL 扩展数据中的下标
+ */
+int SessionBindingIndex() {
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, FreeSessionBinding);
+    return index;
+}
+
+/**
+ * @brief 会话是否仍可用于恢复
+ */
+bool SessionUsable(const SSL_SESSION* session) {
+    return SSL_SESSION_is_resumable(session) &&
+           SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) >
+               static_cast<long>(time(nullptr));
+}
+
+/**
+ * @brief 会话是否只能使用一次
+ *
+ * TLS 1.3 票据复用会让被动观察者关联同一客户端的多条连接，
+ * TLS 1.2 会话在恢复时不会重新下发，只能重复使用。
+ */
+bool SessionSingleUse(const SSL_SESSION* session) {
+    return SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION;
+}
+
+} // namespace
+
+/**
+ * @brief 按 SSL 凭证配置构建上下文
+ *
+ * 步骤：
+ * 1. 首次调用时初始化 OpenSSL
+ * 2. 创建客户端 SSL_CTX，限定 TLS 1.2 及以上与 HTTP/2 允许的密码套件
+ * 3. 设置 ALPN 为 h2，启用非阻塞写所需的模式
+ * 4. 加载根证书：提供 pem_root_certs 时只信任其中的证书，否则使用系统默认路径
+ * 5. 提供客户端证书时加载证书链与私钥；只提供其中之一视为配置错误
+ * 6. 启用对端证书验证（主机名在每个连接上单独设置）
+ * 7. 启用客户端会话缓存：不使用 OpenSSL 内部存储（客户端的内部存储不会被
+ *    查找），由新会话回调按目标地址保存
+ */
+Status TlsContext::Create(const SslCredentialsOptions& options, std::shared_ptr<TlsContext>* context) {
+    if (!InitializeOpenSsl()) {
+        return Status::Internal(OpenSslError("Failed to initialize OpenSSL"));
+    }
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    if (!ctx) {
+        return Status::Internal(OpenSslError("Failed to create SSL context"));
+    }
+    std::shared_ptr<TlsContext> result(new TlsContext(ctx));
+    result->fingerprint_ = CredentialFingerprint(options);
+
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    if (SSL_CTX_set_cipher_list(ctx, kTls12CipherList) != 1) {
+        return Status::Internal(OpenSslError("Failed to set TLS cipher list"));
+    }
+
+    const unsigned char alpn_protos[] = "\x02h2";  // "h2" 表示 HTTP/2
+    SSL_CTX_set_alpn_protos(ctx, alpn_protos, sizeof(alpn_protos) - 1);
+
+    // 非阻塞写可能只写出部分数据，重试时缓冲区地址也可能变化
+    SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
+    if (!options.pem_root_certs.empty()) {
+        auto status = LoadRootCerts(ctx, options.pem_root_certs, &result->root_cert_count_);
+        if (!status.ok()) {
+            return status;
+        }
+    } else if (SSL_CTX_set_default_verify_paths(ctx) != 1) {
+        return Status::Internal(OpenSslError("Failed to load system root certificates"));
+    }
+
+    const bool has_chain = !options.pem_cert_chain.empty();
+    const bool has_key = !options.pem_private_key.empty();
+    if (has_chain != has_key) {
+        return Status::InvalidArgument(
+            "pem_private_key and pem_cert_chain must be provided together");
+    }
+    if (has_chain) {
+        auto status = LoadClientIdentity(ctx, options.pem_cert_chain, options.pem_private_key);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+
+    SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+
+    SSL_CTX_set_app_data(ctx, result.get());
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, OnNewSession);
+    *context = std::move(result);
+    return Status::OK();
+}
+
+/**
+ * @brief 获取进程内共享的默认上下文
+ */
+Status TlsContext::GetDefault(std::shared_ptr<TlsContext>* context) {
+    struct Default {
+        Status status;
+        std::shared_ptr<TlsContext> context;
+        Default() { status = Create(SslCredentialsOptions(), &context); }
+    };
+    static const Default instance;
+    *context = instance.context;
+    return instance.status;
+}
+
+TlsContext::~TlsContext() {
+    for (auto& entry : sessions_) {
+        SSL_SESSION_free(entry.second);
+    }
+    SSL_CTX_free(ctx_);
+}
+
+/**
+ * @brief 为尚未握手的连接准备会话恢复
+ *
+ * 步骤：
+ * 1. 绑定目标地址与存储，供新会话回调使用
+ * 2. 先查进程内缓存，未命中再查磁盘存储（DER 解码）
+ * 3. 丢弃过期或不可恢复的会话；TLS 1.3 票据从缓存与存储中同时删除
+ * 4. 以 SSL_set_session 提供给握手
+ */
+TlsSessionSource TlsContext::PrepareSession(SSL* ssl, const std::string& target,
+                                            const std::shared_ptr<TlsTicketStore>& store) {
+    SSL_set_ex_data(ssl, SessionBindingIndex(), new SessionBinding{target, store});
+    const std::string disk_key = fingerprint_ + "/" + target;
+
+    SSL_SESSION* session = nullptr;
+    TlsSessionSource source = TlsSessionSource::kNone;
+    {
+        std::lock_guard<std::mutex> lock(session_mutex_);
+        auto it = sessions_.find(target);
+        if (it != sessions_.end()) {
+            session = it->second;
+            if (!SessionUsable(session) || SessionSingleUse(session)) {
+                sessions_.erase(it);  // 取出缓存的引用
+            } else {
+                SSL_SESSION_up_ref(session);
+            }
+            if (SessionUsable(session)) {
+                source = TlsSessionSource::kMemory;
+            } else {
+                SSL_SESSION_free(session);
+                session = nullptr;
+            }
+        }
+    }
+
+    if (!session && store) {
+        std::string der;
+        if (store->Load(disk_key, &der)) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(der.data());
+            session = d2i_SSL_SESSION(nullptr, &p, static_cast<long>(der.size()));
+            if (session && SessionUsable(session)) {
+                source = TlsSessionSource::kDisk;
+            } else {
+                SSL_SESSION_free(session);
+                session = nullptr;
+                store->Erase(disk_key);
+            }
+        }
+    }
+
+    if (!session) {
+        return TlsSessionSource::kNone;
+    }
+    if (store && SessionSingleUse(session)) {
+        store->Erase(disk_key);
+    }
+    const int rv = SSL_set_session(ssl, session);  // 连接增加自己的引用
+    SSL_SESSION_free(session);
+    return rv == 1 ? source : TlsSessionSource::kNone;
+}
+
+/**
+ * @brief 新会话回调，保存服务器下发的会话
+ *
+ * TLS 1.3 的票据在握手之后的 SSL_read 中到达，一条连接可能收到多张，
+ * 每个目标只保留最新的一张。写入磁盘时过期时间取会话的签发时间加有效期。
+ *
+ * 内存缓存保存会话的副本而不是接管传入的对象：连接未经 SSL_shutdown
+ * 关闭时（断线、重连），OpenSSL 会把连接当前的会话标记为不可恢复。
+ */
+int TlsContext::OnNewSession(SSL* ssl, SSL_SESSION* session) {
+    auto* binding = static_cast<SessionBinding*>(SSL_get_ex_data(ssl, SessionBindingIndex()));
+    auto* self = static_cast<TlsContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    if (!binding || !self || !SSL_SESSION_is_resumable(session)) {
+        return 0;
+    }
+
+    if (binding->store) {
+        const int len = i2d_SSL_SESSION(session, nullptr);
+        if (len > 0) {
+            std::string der(static_cast<size_t>(len), '\0');
+            unsigned char* p = reinterpret_cast<unsigned char*>(&der[0]);
+            i2d_SSL_SESSION(session, &p);
+            const int64_t expires_at = static_cast<int64_t>(SSL_SESSION_get_time(session)) +
+                                       SSL_SESSION_get_timeout(session);
+            binding->store->Store(self->fingerprint_ + "/" + binding->target, der, expires_at);
+        }
+    }
+
+    SSL_SESSION* copy = SSL_SESSION_dup(session);
+    if (!copy) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(self->session_mutex_);
+    auto it = self->sessions_.find(binding->target);
+    if (it != self->sessions_.end()) {
+        SSL_SESSION_free(it->second);
+        it->second = copy;
+        return 0;
+    }
+    if (self->sessions_.size() >= kMaxCachedSessions) {
+        SSL_SESSION_free(self->sessions_.begin()->second);
+        self->sessions_.erase(self->sessions_.begin());
+    }
+    self->sessions_.emplace(binding->target, copy);
+    return 0;
+}
+
+} // namespace http2
+} // namespace litegrpc
@@ -0,0 +1,138 @@
+/**
+ * @file tls_context.h
+ * @brief 共享 TLS 上下文头文件
+ *
+ * 此文件定义了由 SSL 凭证构建的不可变 SSL_CTX 封装。构建时一次性完成：
+ * - 解析 PEM 根证书并放入证书存储；未提供时加载系统默认根证书
+ * - 解析客户端证书链与私钥（双向认证），并校验二者匹配
+ * - 设置 ALPN（h2）、最低协议版本（TLS 1.2）和 HTTP/2 允许的密码套件
+ * - 启用对端证书验证
+ *
+ * 构建完成后配置不再修改，可以被任意多个连接并发引用（SSL_new 只增加引用计数），
+ * 重连时无需重新解析证书。
+ *
+ * 上下文同时保存客户端会话缓存（按目标地址），重连时以会话恢复代替完整握手，
+ * 省去证书链传输与校验以及一次非对称运算：
+ * - 服务器下发的会话（TLS 1.3 票据或 TLS 1.2 会话）通过新会话回调存入缓存
+ * - TLS 1.3 票据只使用一次（RFC 8446 附录 C.4），取出后即从缓存删除，
+ *   恢复后的连接会收到新的票据
+ * - 可选地写入 TlsTicketStore，进程重启后仍可恢复
+ * 会话缓存是上下文中唯一可变的部分，由独立的互斥锁保护。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_TLS_CONTEXT_H
+#define LITEGRPC_HTTP2_TLS_CONTEXT_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <openssl/ssl.h>      // SSL_CTX
+#include "litegrpc/core.h"    // SslCredentialsOptions
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace http2 {
+
+class TlsTicketStore;
+
+/**
+ * @brief 提供给握手的会话来源
+ */
+enum class TlsSessionSource {
+    kNone,    ///< 没有可用会话，执行完整握手
+    kMemory,  ///< 来自进程内缓存
+    kDisk     ///< 来自磁盘票据存储
+};
+
+/**
+ * @brief 共享 TLS 上下文（配置不可变，附带会话缓存）
+ *
+ * 线程安全性：配置构建完成后只读，会话缓存由内部互斥锁保护，
+ * 可在多个线程中同时用于创建连接。
+ */
+class TlsContext {
+public:
+    /**
+     * @brief 按 SSL 凭证配置构建上下文
+     * @param options 根证书、客户端私钥与证书链（PEM）
+     * @param context 输出参数，构建成功的上下文
+     * @return Status 构建状态；PEM 无法解析或私钥与证书不匹配时返回 INVALID_ARGUMENT
+     */
+    static Status Create(const SslCredentialsOptions& options, std::shared_ptr<TlsContext>* context);
+
+    /**
+     * @brief 获取进程内共享的默认上下文（系统根证书，无客户端证书）
+     * @param context 输出参数，默认上下文
+     * @return Status 首次调用时的构建状态，之后返回同一结果
+     *
+     * 用于未提供 SSL 凭证的 TLS 连接（例如 "https://" 目标配合明文凭证）。
+     */
+    static Status GetDefault(std::shared_ptr<TlsContext>* context);
+
+    /**
+     * @brief 析构函数，释放 SSL_CTX 的引用
+     *
+     * 仍存活的 SSL 连接各自持有 SSL_CTX 的引用，不受影响。
+     */
+    ~TlsContext();
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    /**
+     * @brief 底层 SSL_CTX，仅用于 SSL_new
+     */
+    SSL_CTX* get() const { return ctx_; }
+
+    /**
+     * @brief 从 pem_root_certs 解析出的根证书数量，使用系统根证书时为 0
+     */
+    size_t root_cert_count() const { return root_cert_count_; }
+
+    /**
+     * @brief 凭证指纹（根证书与客户端证书链的哈希），用作磁盘存储键的前缀
+     */
+    const std::string& fingerprint() const { return fingerprint_; }
+
+    /**
+     * @brief 为尚未握手的连接准备会话恢复
+     * @param ssl 由本上下文创建、尚未握手的连接
+     * @param target 目标地址（host:port），与凭证一起决定会话能否复用
+     * @param store 磁盘票据存储，为空时只使用进程内缓存
+     * @return TlsSessionSource 提供给握手的会话来源
+     *
+     * 同时把目标地址与存储绑定到连接上，握手后服务器下发的新会话
+     * 保存到对应的缓存。不调用此方法的连接既不恢复也不保存会话。
+     */
+    TlsSessionSource PrepareSession(SSL* ssl, const std::string& target,
+                                    const std::shared_ptr<TlsTicketStore>& store);
+
+private:
+    static const size_t kMaxCachedSessions = 256;  ///< 进程内缓存的目标数上限
+
+    explicit TlsContext(SSL_CTX* ctx) : ctx_(ctx) {}
+
+    /**
+     * @brief 新会话回调（SSL_CTX_sess_set_new_cb），保存服务器下发的会话
+     * @return int 始终为 0（缓存保存副本，不接管传入会话的引用）
+     */
+    static int OnNewSession(SSL* ssl, SSL_SESSION* session);
+
+    SSL_CTX* ctx_;                ///< 已配置完成的 SSL 上下文
+    size_t root_cert_count_ = 0;  ///< 解析出的根证书数量
+    std::string fingerprint_;     ///< 凭证指纹
+
+    std::mutex session_mutex_;                      ///< 保护 sessions_
+    std::map<std::string, SSL_SESSION*> sessions_;  ///< 目标地址 -> 最近一次下发的会话
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_TLS_CONTEXT_H
@@ -0,0 +1,306 @@
+/**
+ * @file tls_ticket_store.cpp
+ * @brief TLS 会话票据的磁盘存储实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "tls_ticket_store.h"
+#include <fcntl.h>      // open
+#include <sys/file.h>   // flock
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close, ftruncate
+#include <cerrno>       // errno
+#include <cstring>      // memcpy, memset, strerror
+#include <ctime>        // time
+#include <map>
+
+namespace litegrpc {
+namespace http2 {
+
+namespace {
+
+const uint32_t kMagic = 0x4b54474c;  ///< "LGTK"
+const uint32_t kVersion = 1;         ///< 文件格式版本
+const size_t kHeaderSize = 64;       ///< 文件头大小（字节）
+
+/**
+ * @brief 文件头
+ */
+struct FileHeader {
+    uint32_t magic;       ///< 魔数
+    uint32_t version;     ///< 格式版本
+    uint32_t slot_count;  ///< 槽位数
+    uint32_t slot_size;   ///< 槽位大小
+};
+
+/**
+ * @brief 槽位头，其后依次是键与会话数据
+ *
+ * checksum 为 0 表示空槽位。
+ */
+struct SlotHeader {
+    uint32_t checksum;    ///< 覆盖槽位头其余字段、键与数据的校验和
+    uint32_t key_len;     ///< 键长度
+    uint32_t data_len;    ///< 会话数据长度
+    uint32_t reserved;    ///< 保留
+    int64_t stored_at;    ///< 写入时间（Unix 秒），用于替换最早的槽位
+    int64_t expires_at;   ///< 会话过期时间（Unix 秒）
+};
+
+static_assert(sizeof(FileHeader) <= kHeaderSize, "file header too large");
+
+/**
+ * @brief 槽位的 FNV-1a 校验和，结果不为 0
+ */
+uint32_t SlotChecksum(const SlotHeader& header, const uint8_t* payload) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const uint8_t* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            hash = (hash ^ p[i]) * 16777619u;
+        }
+    };
+    mix(reinterpret_cast<const uint8_t*>(&header) + sizeof(header.checksum),
+        sizeof(header) - sizeof(header.checksum));
+    mix(payload, header.key_len + header.data_len);
+    return hash == 0 ? 1 : hash;
+}
+
+/**
+ * @brief 槽位是否保存了完整有效的数据
+ */
+bool SlotValid(const SlotHeader& header, const uint8_t* payload) {
+    return header.checksum != 0 &&
+           header.key_len <= TlsTicketStore::kMaxKeySize &&
+           sizeof(SlotHeader) + header.key_len + header.data_len <= TlsTicketStore::kSlotSize &&
+           header.checksum == SlotChecksum(header, payload);
+}
+
+/**
+ * @brief 进程内共享的存储，按路径索引
+ */
+std::mutex g_registry_mutex;
+std::map<std::string, std::weak_ptr<TlsTicketStore>> g_registry;
+
+/**
+ * @brief 持有 flock 的作用域对象
+ */
+class FileLock {
+public:
+    explicit FileLock(int fd) : fd_(fd) { flock(fd_, LOCK_EX); }
+    ~FileLock() { flock(fd_, LOCK_UN); }
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+/**
+ * @brief 打开（必要时创建）存储文件
+ *
+ * 步骤：
+ * 1. 同一路径已打开时返回共享实例
+ * 2. 以 0600 权限打开文件（不跟随符号链接），已有文件不是本用户所有的
+ *    普通文件或对其他用户开放权限时拒绝，然后加锁
+ * 3. 已有文件头有效且大小与其槽位数一致时沿用；否则（新文件、损坏或
+ *    其他格式）按请求的槽位数清空重建
+ * 4. 以 MAP_SHARED 映射整个文件
+ *
+ * 沿用已有文件的槽位数而不是按请求的值截断，避免正在映射同一文件的
+ * 其他进程访问到被截掉的页面（SIGBUS）。
+ */
+Status TlsTicketStore::Open(const std::string& path, size_t slot_count,
+                            std::shared_ptr<TlsTicketStore>* store) {
+    std::lock_guard<std::mutex> registry_lock(g_registry_mutex);
+    auto existing = g_registry[path].lock();
+    if (existing) {
+        *store = existing;
+        return Status::OK();
+    }
+    if (slot_count == 0) {
+        slot_count = kDefaultSlotCount;
+    }
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (fd < 0) {
+        return Status::Unavailable("Failed to open TLS ticket store " + path + ": " + strerror(errno));
+    }
+    // O_CREAT 的权限只在新建时生效：已有文件必须属于本用户且不允许他人访问，
+    // 否则他人可以读取恢复密钥，或写入伪造的会话跳过证书校验
+    struct stat owner;
+    if (fstat(fd, &owner) < 0 || !S_ISREG(owner.st_mode) || owner.st_uid != geteuid() ||
+        (owner.st_mode & 077) != 0) {
+        close(fd);
+        return Status::Unavailable("TLS ticket store " + path +
+                                   " must be a regular file owned by the current user with mode 0600");
+    }
+
+    void* map = MAP_FAILED;
+    size_t map_size = 0;
+    {
+        FileLock lock(fd);
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            int err = errno;
+            close(fd);
+            return Status::Unavailable("Failed to stat TLS ticket store: " + std::string(strerror(err)));
+        }
+
+        FileHeader header;
+        memset(&header, 0, sizeof(header));
+        if (static_cast<size_t>(st.st_size) >= kHeaderSize &&
+            pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+            header.magic == kMagic && header.version == kVersion && header.slot_size == kSlotSize &&
+            header.slot_count > 0 &&
+            static_cast<size_t>(st.st_size) == kHeaderSize + header.slot_count * kSlotSize) {
+            slot_count = header.slot_count;
+        } else {
+            header.magic = kMagic;
+            header.version = kVersion;
+            header.slot_count = static_cast<uint32_t>(slot_count);
+            header.slot_size = static_cast<uint32_t>(kSlotSize);
+            const off_t size = static_cast<off_t>(kHeaderSize + slot_count * kSlotSize);
+            if (ftruncate(fd, 0) < 0 || ftruncate(fd, size) < 0 ||
+                pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+                int err = errno;
+                close(fd);
+                return Status::Unavailable("Failed to initialize TLS ticket store: " +
+                                           std::string(strerror(err)));
+            }
+        }
+
+        map_size = kHeaderSize + slot_count * kSlotSize;
+        map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        return Status::Unavailable("Failed to map TLS ticket store: " + std::string(strerror(err)));
+    }
+
+    std::shared_ptr<TlsTicketStore> result(new TlsTicketStore(path, fd, map, map_size, slot_count));
+    g_registry[path] = result;
+    *store = std::move(result);
+    return Status::OK();
+}
+
+TlsTicketStore::TlsTicketStore(const std::string& path, int fd, void* map, size_t map_size,
+                               size_t slot_count)
+    : path_(path), fd_(fd), map_(map), map_size_(map_size), slot_count_(slot_count) {}
+
+TlsTicketStore::~TlsTicketStore() {
+    munmap(map_, map_size_);
+    close(fd_);
+}
+
+/**
+ * @brief 读取键对应的会话
+ */
+bool TlsTicketStore::Load(const std::string& key, std::string* session) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    FileLock lock(fd_);
+    const size_t index = Find(key);
+    if (index == slot_count_) {
+        return false;
+    }
+    const uint8_t* slot = Slot(index);
+    SlotHeader header;
+    memcpy(&header, slot, sizeof(header));
+    if (header.expires_at <= static_cast<int64_t>(time(nullptr))) {
+        return false;
+    }
+    session->assign(reinterpret_cast<const char*>(slot + sizeof(header) + header.key_len),
+                    header.data_len);
+    return true;
+}
+
+/**
+ * @brief 保存键对应的会话
+ *
+ * 选择槽位的顺序：同一个键的槽位、空槽位或已过期的槽位、最早写入的槽位。
+ * 先清零校验和使槽位失效，写完数据后再写入校验和。
+ */
+bool TlsTicketStore::Store(const std::string& key, const std::string& session, int64_t expires_at) {
+    if (key.empty() || key.size() > kMaxKeySize ||
+        sizeof(SlotHeader) + key.size() + session.size() > kSlotSize) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    FileLock lock(fd_);
+    const int64_t now = static_cast<int64_t>(time(nullptr));
+    size_t index = Find(key);
+    if (index == slot_count_) {
+        int64_t oldest = INT64_MAX;
+        for (size_t i = 0; i < slot_count_; ++i) {
+            SlotHeader header;
+            memcpy(&header, Slot(i), sizeof(header));
+            if (!SlotValid(header, Slot(i) + sizeof(header)) || header.expires_at <= now) {
+                index = i;
+                break;
+            }
+            if (header.stored_at < oldest) {
+                oldest = header.stored_at;
+                index = i;
+            }
+        }
+    }
+
+    uint8_t* slot = Slot(index);
+    SlotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(slot, &header, sizeof(header));  // 写入期间槽位无效
+
+    header.key_len = static_cast<uint32_t>(key.size());
+    header.data_len = static_cast<uint32_t>(session.size());
+    header.stored_at = now;
+    header.expires_at = expires_at;
+    uint8_t* payload = slot + sizeof(header);
+    memcpy(payload, key.data(), key.size());
+    memcpy(payload + key.size(), session.data(), session.size());
+    header.checksum = SlotChecksum(header, payload);
+    memcpy(slot, &header, sizeof(header));
+    return true;
+}
+
+/**
+ * @brief 删除键对应的会话
+ */
+void TlsTicketStore::Erase(const std::string& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    FileLock lock(fd_);
+    const size_t index = Find(key);
+    if (index != slot_count_) {
+        memset(Slot(index), 0, sizeof(SlotHeader));
+    }
+}
+
+uint8_t* TlsTicketStore::Slot(size_t index) const {
+    return static_cast<uint8_t*>(map_) + kHeaderSize + index * kSlotSize;
+}
+
+/**
+ * @brief 查找键所在的槽位
+ *
+ * 槽位数很少（默认 64），线性扫描即可，无需在文件中维护索引。
+ */
+size_t TlsTicketStore::Find(const std::string& key) const {
+    for (size_t i = 0; i < slot_count_; ++i) {
+        const uint8_t* slot = Slot(i);
+        SlotHeader header;
+        memcpy(&header, slot, sizeof(header));
+        const uint8_t* payload = slot + sizeof(header);
+        if (header.key_len == key.size() && SlotValid(header, payload) &&
+            memcmp(payload, key.data(), key.size()) == 0) {
+            return i;
+        }
+    }
+    return slot_count_;
+}
+
+} // namespace http2
+} // namespace litegrpc
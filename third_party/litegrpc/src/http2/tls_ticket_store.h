@@ -0,0 +1,125 @@
+/**
+ * @file tls_ticket_store.h
+ * @brief TLS 会话票据的磁盘存储头文件
+ *
+ * 此文件定义了跨进程重启保存 TLS 会话（TLS 1.3 票据或 TLS 1.2 会话）的
+ * 定长文件存储，使设备重启后的第一次连接也能以会话恢复代替完整握手。
+ *
+ * 文件布局：固定大小的文件头 + kSlotCount 个定长槽位，整个文件以
+ * MAP_SHARED 映射到内存，读写不经过 read/write 系统调用，由内核回写磁盘：
+ * - 文件大小在打开时确定，不会随写入增长
+ * - 每个槽位保存一个键（凭证指纹 + 目标地址）对应的最新会话（DER 编码）
+ * - 槽位带校验和，断电造成的半写槽位在读取时被丢弃
+ * - 同一个键覆盖原槽位；没有空闲槽位时替换最早写入的槽位
+ *
+ * 会话中包含可以恢复连接的密钥材料，文件以 0600 权限创建；已有文件
+ * 必须属于当前用户且不对其他用户开放，否则拒绝使用。
+ * 多个进程可以共享同一文件，读写时以 flock 互斥。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_TLS_TICKET_STORE_H
+#define LITEGRPC_HTTP2_TLS_TICKET_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "litegrpc/status.h"  // LiteGRPC 状态码定义
+
+namespace litegrpc {
+namespace http2 {
+
+/**
+ * @brief 以内存映射文件保存的 TLS 会话存储
+ *
+ * 通过 Open() 获取与路径对应的共享实例，同一进程内使用同一路径的
+ * 通道共享映射。
+ *
+ * 线程安全性：所有公有方法均可从多个线程并发调用。
+ */
+class TlsTicketStore {
+public:
+    static const size_t kDefaultSlotCount = 64;  ///< 默认槽位数
+    static const size_t kSlotSize = 8192;        ///< 单个槽位大小（字节），含槽位头与键
+    static const size_t kMaxKeySize = 256;       ///< 键的最大长度（字节）
+
+    /**
+     * @brief 打开（必要时创建）存储文件
+     * @param path 文件路径
+     * @param slot_count 槽位数，决定文件大小上限（slot_count × kSlotSize）
+     * @param store 输出参数，与路径对应的共享实例
+     * @return Status 打开状态；文件无法创建或映射、路径是符号链接、已有文件
+     *         不属于当前用户或权限不是仅属主可读写时返回 UNAVAILABLE
+     *
+     * 已有文件格式有效时沿用其槽位数（忽略 slot_count）；格式无效时按 slot_count 清空重建。
+     */
+    static Status Open(const std::string& path, size_t slot_count,
+                       std::shared_ptr<TlsTicketStore>* store);
+
+    /**
+     * @brief 析构函数，解除映射并关闭文件
+     */
+    ~TlsTicketStore();
+
+    TlsTicketStore(const TlsTicketStore&) = delete;
+    TlsTicketStore& operator=(const TlsTicketStore&) = delete;
+
+    /**
+     * @brief 读取键对应的会话
+     * @param key 键
+     * @param session 输出参数，DER 编码的会话
+     * @return bool 存在未过期且校验通过的会话时返回 true
+     */
+    bool Load(const std::string& key, std::string* session);
+
+    /**
+     * @brief 保存键对应的会话
+     * @param key 键，超过 kMaxKeySize 时不保存
+     * @param session DER 编码的会话，超过槽位容量时不保存
+     * @param expires_at 会话过期时间（Unix 秒）
+     * @return bool 是否已保存
+     */
+    bool Store(const std::string& key, const std::string& session, int64_t expires_at);
+
+    /**
+     * @brief 删除键对应的会话
+     * @param key 键
+     */
+    void Erase(const std::string& key);
+
+    /**
+     * @brief 文件路径
+     */
+    const std::string& path() const { return path_; }
+
+private:
+    TlsTicketStore(const std::string& path, int fd, void* map, size_t map_size, size_t slot_count);
+
+    /**
+     * @brief 获取第 index 个槽位的起始地址
+     */
+    uint8_t* Slot(size_t index) const;
+
+    /**
+     * @brief 查找键所在的槽位
+     * @return size_t 槽位下标，不存在时返回 slot_count_
+     */
+    size_t Find(const std::string& key) const;
+
+    std::string path_;         ///< 文件路径
+    int fd_;                   ///< 文件描述符，用于 flock
+    void* map_;                ///< 文件映射
+    size_t map_size_;          ///< 映射大小
+    size_t slot_count_;        ///< 槽位数
+    std::mutex mutex_;         ///< 进程内互斥（flock 只在进程间互斥）
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_TLS_TICKET_STORE_H
@@ -0,0 +1,106 @@
+/**
+ * @file write_scheduler.cpp
+ * @brief 按 RFC 9218 紧急度调度本端写出的实现文件
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#include "write_scheduler.h"
+#include <algorithm>
+
+namespace litegrpc {
+namespace http2 {
+
+void WriteScheduler::Reset() {
+    enabled_ = false;
+    for (auto& streams : pending_) {
+        streams.clear();
+    }
+    deferred_.clear();
+}
+
+bool WriteScheduler::Enable() {
+    if (enabled_) {
+        return false;
+    }
+    enabled_ = true;
+    return true;
+}
+
+void WriteScheduler::AddBody(int32_t stream_id, int urgency) {
+    pending_[urgency].push_back(stream_id);
+}
+
+bool WriteScheduler::RemoveBody(int32_t stream_id, int urgency) {
+    auto& streams = pending_[urgency];
+    streams.erase(std::remove(streams.begin(), streams.end(), stream_id), streams.end());
+    return streams.empty() && !deferred_.empty();
+}
+
+/**
+ * @brief 该紧急度的流是否应暂停生成 DATA 帧
+ *
+ * 请求体未写出的流数量很少，逐个检查窗口即可。
+ */
+bool WriteScheduler::ShouldDefer(int urgency, const CanSend& can_send) const {
+    for (int level = 0; level < urgency; ++level) {
+        for (int32_t stream_id : pending_[level]) {
+            if (can_send(stream_id)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WriteScheduler::Defer(int32_t stream_id, int urgency) {
+    deferred_.emplace_back(stream_id, urgency);
+}
+
+std::vector<int32_t> WriteScheduler::TakeDeferred() {
+    std::vector<int32_t> streams;
+    streams.reserve(deferred_.size());
+    for (const auto& entry : deferred_) {
+        streams.push_back(entry.first);
+    }
+    deferred_.clear();
+    return streams;
+}
+
+/**
+ * @brief 取出不再需要让路的暂停流
+ *
+ * 更紧急的流在暂停其他流之后可能耗尽了自己的流窗口：它不再产生 DATA 帧，
+ * 也就不会写完请求体触发恢复。对端不读取该流时，暂停的流会一直等到截止时间，
+ * 因此每次生成帧之后检查一次，恢复不再需要让路的流。
+ */
+std::vector<int32_t> WriteScheduler::TakeUnblocked(const CanSend& can_send) {
+    std::vector<int32_t> streams;
+    size_t kept = 0;
+    for (const auto& entry : deferred_) {
+        if (ShouldDefer(entry.second, can_send)) {
+            deferred_[kept++] = entry;
+        } else {
+            streams.push_back(entry.first);
+        }
+    }
+    deferred_.resize(kept);
+    return streams;
+}
+
+/**
+ * @brief DATA 帧可加入的输出队列积压上限
+ *
+ * 最高紧急度的流不受限制：它之后不会再有需要抢先写出的数据。
+ */
+size_t WriteScheduler::QueueLimit(int urgency, size_t default_limit) const {
+    if (!enabled_ || urgency == 0) {
+        return default_limit;
+    }
+    return std::min(default_limit, kLowPriorityQueueLimit);
+}
+
+} // namespace http2
+} // namespace litegrpc
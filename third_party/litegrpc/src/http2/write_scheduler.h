@@ -0,0 +1,153 @@
+/**
+ * @file write_scheduler.h
+ * @brief 按 RFC 9218 紧急度调度本端写出的头文件
+ *
+ * 多个流共用一条连接时，大请求体（例如音频上传）会在心跳等小调用之前
+ * 占满写路径。此文件定义的 WriteScheduler 记录各紧急度上仍有请求体
+ * 未进入输出队列的流，供 Http2Client 在三处约束写出顺序：
+ * - 生成 DATA 帧时：更紧急的流还有请求体未写出且流窗口未耗尽，较不紧急的
+ *   流暂停（数据源回调返回 NGHTTP2_ERR_DEFERRED）；更紧急的流写完、或只因
+ *   自身的流量控制窗口而无法发送时恢复，链路不会因等待它而空闲
+ * - 输出队列：连接上出现过显式优先级后，非最高紧急度的 DATA 帧
+ *   只在队列积压不超过 kLowPriorityQueueLimit 时加入，
+ *   之后到达的紧急帧前面最多排着这么多低优先级数据
+ * - 套接字：同时设置 TCP_NOTSENT_LOWAT，内核中尚未发送的数据也限制在
+ *   kPriorityNotSentLowat 以内，不会在发送缓冲区中积压数兆字节
+ *
+ * HEADERS、WINDOW_UPDATE、PING 等控制帧本就由 nghttp2 排在 DATA 帧之前，
+ * 因此只需约束 DATA 帧。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ * @version 1.0
+ */
+
+#ifndef LITEGRPC_HTTP2_WRITE_SCHEDULER_H
+#define LITEGRPC_HTTP2_WRITE_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace litegrpc {
+namespace http2 {
+
+/// 紧急度级数（RFC 9218：0 最高，7 最低）
+static const int kUrgencyLevels = 8;
+
+/// 未设置优先级的流的紧急度
+static const int kDefaultUrgency = 3;
+
+/// 启用优先级调度后，非最高紧急度的 DATA 帧可加入的输出队列积压上限（字节）
+static const size_t kLowPriorityQueueLimit = 64 * 1024;
+
+/// 启用优先级调度后套接字的 TCP_NOTSENT_LOWAT（字节）
+static const int kPriorityNotSentLowat = 64 * 1024;
+
+/**
+ * @brief 流的优先级
+ */
+struct StreamPriority {
+    int urgency = kDefaultUrgency;  ///< 紧急度，0 最高、7 最低
+    bool incremental = false;       ///< 响应是否可以与同紧急度的其他响应交错处理
+    bool signal = false;            ///< 是否向服务器发送优先级信号（调用方显式设置了优先级）
+};
+
+/**
+ * @brief 按紧急度约束 DATA 帧的写出顺序
+ *
+ * 线程安全性：非线程安全，由持有连接锁的线程访问。
+ */
+class WriteScheduler {
+public:
+    /**
+     * @brief 恢复初始状态（连接关闭时调用）
+     */
+    void Reset();
+
+    /**
+     * @brief 启用输出队列与套接字上的优先级约束
+     * @return bool 首次启用时返回 true，调用方据此设置套接字选项
+     */
+    bool Enable();
+
+    /**
+     * @brief 是否已启用输出队列与套接字上的优先级约束
+     */
+    bool enabled() const { return enabled_; }
+
+    /**
+     * @brief 判断流当前能否发送 DATA 帧（流量控制窗口未耗尽）
+     */
+    using CanSend = std::function<bool(int32_t stream_id)>;
+
+    /**
+     * @brief 登记一个请求体尚未写出的流
+     * @param stream_id 流 ID
+     * @param urgency 流的紧急度
+     */
+    void AddBody(int32_t stream_id, int urgency);
+
+    /**
+     * @brief 一个流的请求体已全部进入输出队列（或流已关闭）
+     * @param stream_id 流 ID
+     * @param urgency 流的紧急度
+     * @return bool 该紧急度上已没有未写出的请求体、且有暂停的流需要恢复时返回 true
+     */
+    bool RemoveBody(int32_t stream_id, int urgency);
+
+    /**
+     * @brief 该紧急度的流是否应暂停生成 DATA 帧
+     * @param urgency 流的紧急度
+     * @param can_send 判断流能否发送
+     * @return bool 有更紧急、请求体未写出且能够发送的流时返回 true
+     *
+     * 只因自身流窗口耗尽而无法发送的流不占用链路，不要求其他流让路。
+     */
+    bool ShouldDefer(int urgency, const CanSend& can_send) const;
+
+    /**
+     * @brief 记录暂停的流
+     * @param stream_id 流 ID
+     * @param urgency 流的紧急度
+     */
+    void Defer(int32_t stream_id, int urgency);
+
+    /**
+     * @brief 是否有暂停的流
+     */
+    bool has_deferred() const { return !deferred_.empty(); }
+
+    /**
+     * @brief 取出所有暂停的流，由调用方以 nghttp2_session_resume_data 恢复
+     *
+     * 恢复后仍需让路的流会在下一次生成 DATA 帧时再次暂停。
+     */
+    std::vector<int32_t> TakeDeferred();
+
+    /**
+     * @brief 取出不再需要让路的暂停流（更紧急的流已无法发送）
+     * @param can_send 判断流能否发送
+     * @return std::vector<int32_t> 需要以 nghttp2_session_resume_data 恢复的流，按暂停顺序
+     */
+    std::vector<int32_t> TakeUnblocked(const CanSend& can_send);
+
+    /**
+     * @brief 该紧急度的 DATA 帧可加入的输出队列积压上限
+     * @param urgency 流的紧急度
+     * @param default_limit 未启用优先级约束时的上限
+     */
+    size_t QueueLimit(int urgency, size_t default_limit) const;
+
+private:
+    bool enabled_ = false;                   ///< 是否已启用输出队列与套接字上的约束
+    std::vector<int32_t> pending_[kUrgencyLevels];      ///< 各紧急度上请求体尚未写出的流
+    std::vector<std::pair<int32_t, int>> deferred_;     ///< 暂停生成 DATA 帧的流及其紧急度
+};
+
+} // namespace http2
+} // namespace litegrpc
+
+#endif // LITEGRPC_HTTP2_WRITE_SCHEDULER_H
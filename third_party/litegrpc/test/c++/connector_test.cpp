@@ -0,0 +1,267 @@
+/**
+ * @file connector_test.cpp
+ * @brief 连接建立单元测试
+ *
+ * 覆盖 Unix 域套接字目标的地址构造：相对路径与绝对路径、unix:// 必须
+ * 跟绝对路径、sun_path 的长度上限、抽象命名空间的地址长度与空名字；
+ * 以及在回环地址上的 Happy Eyeballs 连接：关闭的端口失败后回退到
+ * 监听中的端口并在下一次连接时优先尝试胜出的地址、所有地址都失败、
+ * 0 毫秒超时返回 DEADLINE_EXCEEDED，且失败时不遗留文件描述符。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/connector.h"
+#include "test_util.h"
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using litegrpc::StatusCode;
+using litegrpc::http2::ConnectHappyEyeballs;
+using litegrpc::http2::IsUnixSocketTarget;
+using litegrpc::http2::ResolveHost;
+using litegrpc::http2::ResolvedAddress;
+
+namespace {
+
+const size_t kPathOffset = offsetof(struct sockaddr_un, sun_path);
+
+const struct sockaddr_un* Sun(const ResolvedAddress& address) {
+    return reinterpret_cast<const struct sockaddr_un*>(&address.storage);
+}
+
+/**
+ * @brief 进程当前打开的文件描述符数
+ */
+int OpenFdCount() {
+    int count = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir) {
+        return -1;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        count += entry->d_name[0] != '.';
+    }
+    closedir(dir);
+    return count - 1;  // 不计 opendir 自身
+}
+
+/**
+ * @brief 127.0.0.1 上的地址
+ */
+ResolvedAddress Loopback(uint16_t port) {
+    ResolvedAddress address;
+    memset(&address.storage, 0, sizeof(address.storage));
+    auto* sin = reinterpret_cast<struct sockaddr_in*>(&address.storage);
+    sin->sin_family = AF_INET;
+    sin->sin_port = htons(port);
+    sin->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.length = sizeof(*sin);
+    return address;
+}
+
+uint16_t LocalPort(int fd) {
+    struct sockaddr_in sin;
+    socklen_t len = sizeof(sin);
+    getsockname(fd, reinterpret_cast<struct sockaddr*>(&sin), &len);
+    return ntohs(sin.sin_port);
+}
+
+/**
+ * @brief 在 127.0.0.1 的临时端口上监听
+ */
+int Listen(uint16_t* port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    ResolvedAddress address = Loopback(0);
+    if (bind(fd, reinterpret_cast<const struct sockaddr*>(&address.storage), address.length) < 0 ||
+        listen(fd, 16) < 0) {
+        close(fd);
+        return -1;
+    }
+    *port = LocalPort(fd);
+    return fd;
+}
+
+/**
+ * @brief 取得一个没有监听者的端口
+ */
+uint16_t ClosedPort() {
+    uint16_t port = 0;
+    int fd = Listen(&port);
+    close(fd);
+    return port;
+}
+
+uint16_t PeerPort(int fd) {
+    struct sockaddr_in sin;
+    socklen_t len = sizeof(sin);
+    getpeername(fd, reinterpret_cast<struct sockaddr*>(&sin), &len);
+    return ntohs(sin.sin_port);
+}
+
+StatusCode ResolveCode(const std::string& target) {
+    std::vector<ResolvedAddress> addresses;
+    return ResolveHost(target, 0, &addresses).error_code();
+}
+
+void TestUnixPath() {
+    CHECK(IsUnixSocketTarget("unix:agent.sock"));
+    CHECK(IsUnixSocketTarget("unix-abstract:agent"));
+    CHECK(!IsUnixSocketTarget("localhost"));
+
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(ResolveHost("unix:run/agent.sock", 443, &addresses));
+    CHECK_EQ(addresses.size(), 1u);
+    CHECK_EQ(addresses[0].family(), AF_UNIX);
+    CHECK(std::string(Sun(addresses[0])->sun_path) == "run/agent.sock");
+    CHECK_EQ(static_cast<size_t>(addresses[0].length), kPathOffset + sizeof("run/agent.sock"));
+    CHECK(addresses[0].ToString() == "unix:run/agent.sock");
+
+    CHECK_OK(ResolveHost("unix:/run/agent.sock", 0, &addresses));
+    CHECK(std::string(Sun(addresses[0])->sun_path) == "/run/agent.sock");
+    CHECK_OK(ResolveHost("unix:///run/agent.sock", 0, &addresses));
+    CHECK(std::string(Sun(addresses[0])->sun_path) == "/run/agent.sock");
+
+    // unix:// 之后必须是绝对路径
+    CHECK_EQ(ResolveCode("unix://run/agent.sock"), StatusCode::INVALID_ARGUMENT);
+    CHECK_EQ(ResolveCode("unix://"), StatusCode::INVALID_ARGUMENT);
+    CHECK_EQ(ResolveCode("unix:"), StatusCode::INVALID_ARGUMENT);
+
+    // sun_path 为 108 字节，路径需要留出结尾的 NUL
+    const std::string longest = "/" + std::string(sizeof(Sun(addresses[0])->sun_path) - 2, 'p');
+    CHECK_EQ(longest.size(), 107u);
+    CHECK_OK(ResolveHost("unix:" + longest, 0, &addresses));
+    CHECK(std::string(Sun(addresses[0])->sun_path) == longest);
+    CHECK_EQ(ResolveCode("unix:" + longest + "p"), StatusCode::INVALID_ARGUMENT);
+}
+
+void TestUnixAbstract() {
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(ResolveHost("unix-abstract:agent", 0, &addresses));
+    CHECK_EQ(addresses.size(), 1u);
+    CHECK_EQ(Sun(addresses[0])->sun_path[0], '\0');
+    CHECK(std::string(Sun(addresses[0])->sun_path + 1, 5) == "agent");
+    CHECK_EQ(static_cast<size_t>(addresses[0].length), kPathOffset + 1 + 5);
+    CHECK(addresses[0].ToString() == "unix-abstract:agent");
+
+    // 名字中可以包含任意字节，地址长度只覆盖名字本身
+    const std::string binary("a\0b", 3);
+    CHECK_OK(ResolveHost("unix-abstract:" + binary, 0, &addresses));
+    CHECK_EQ(static_cast<size_t>(addresses[0].length), kPathOffset + 1 + 3);
+    CHECK(addresses[0].ToString() == "unix-abstract:" + binary);
+
+    // 前导 NUL 占一个字节，名字最长 107 字节
+    const std::string longest(107, 'n');
+    CHECK_OK(ResolveHost("unix-abstract:" + longest, 0, &addresses));
+    CHECK_EQ(static_cast<size_t>(addresses[0].length), kPathOffset + 108);
+    CHECK_EQ(ResolveCode("unix-abstract:" + longest + "n"), StatusCode::INVALID_ARGUMENT);
+
+    CHECK_EQ(ResolveCode("unix-abstract:"), StatusCode::INVALID_ARGUMENT);
+}
+
+void TestUnixConnect() {
+    const std::string target = "unix-abstract:litegrpc-connector-test-" + std::to_string(getpid());
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(ResolveHost(target, 0, &addresses));
+
+    int fd = -1;
+    CHECK_EQ(ConnectHappyEyeballs(target, addresses, 1000, &fd).error_code(), StatusCode::UNAVAILABLE);
+    CHECK_EQ(fd, -1);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    CHECK(listener >= 0);
+    CHECK(bind(listener, reinterpret_cast<const struct sockaddr*>(&addresses[0].storage),
+               addresses[0].length) == 0);
+    CHECK(listen(listener, 4) == 0);
+    CHECK_OK(ConnectHappyEyeballs(target, addresses, 1000, &fd));
+    CHECK(fd >= 0);
+    close(fd);
+    close(listener);
+}
+
+void TestFallbackAndPreferred() {
+    uint16_t open_port = 0;
+    int listener = Listen(&open_port);
+    CHECK(listener >= 0);
+    const std::string target = "fallback.test:" + std::to_string(open_port);
+    const std::vector<ResolvedAddress> addresses = {Loopback(ClosedPort()), Loopback(open_port)};
+    int attempts = 0;
+    auto count_attempts = [&attempts](int) { ++attempts; };
+
+    // 第一个地址被拒绝后回退到第二个
+    int fd = -1;
+    const int fds_before = OpenFdCount();
+    CHECK_OK(ConnectHappyEyeballs(target, addresses, 5000, &fd, count_attempts));
+    CHECK_EQ(attempts, 2);
+    CHECK_EQ(PeerPort(fd), open_port);
+    close(fd);
+    CHECK_EQ(OpenFdCount(), fds_before);
+
+    // 再次连接同一目标时胜出的地址排在最前
+    attempts = 0;
+    fd = -1;
+    CHECK_OK(ConnectHappyEyeballs(target, addresses, 5000, &fd, count_attempts));
+    CHECK_EQ(attempts, 1);
+    CHECK_EQ(PeerPort(fd), open_port);
+    close(fd);
+
+    // 不同目标不受影响
+    attempts = 0;
+    fd = -1;
+    CHECK_OK(ConnectHappyEyeballs("other.test:1", addresses, 5000, &fd, count_attempts));
+    CHECK_EQ(attempts, 2);
+    close(fd);
+    close(listener);
+}
+
+void TestAllFailed() {
+    const std::vector<ResolvedAddress> addresses = {Loopback(ClosedPort()), Loopback(ClosedPort())};
+    const int fds_before = OpenFdCount();
+    int fd = -1;
+    auto status = ConnectHappyEyeballs("closed.test:1", addresses, 5000, &fd);
+    CHECK_EQ(status.error_code(), StatusCode::UNAVAILABLE);
+    CHECK(status.error_message().find("127.0.0.1") != std::string::npos);
+    CHECK_EQ(fd, -1);
+    CHECK_EQ(OpenFdCount(), fds_before);
+
+    CHECK_EQ(ConnectHappyEyeballs("empty.test:1", {}, 5000, &fd).error_code(), StatusCode::UNAVAILABLE);
+}
+
+void TestZeroTimeout() {
+    uint16_t open_port = 0;
+    int listener = Listen(&open_port);
+    CHECK(listener >= 0);
+    const std::vector<ResolvedAddress> addresses = {Loopback(open_port)};
+    const int fds_before = OpenFdCount();
+    int fd = -1;
+    int attempts = 0;
+    CHECK_EQ(ConnectHappyEyeballs("timeout.test:1", addresses, 0, &fd,
+                                  [&attempts](int) { ++attempts; }).error_code(),
+             StatusCode::DEADLINE_EXCEEDED);
+    CHECK_EQ(fd, -1);
+    CHECK_EQ(attempts, 0);
+    CHECK_EQ(OpenFdCount(), fds_before);
+    close(listener);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("UnixPath", TestUnixPath);
+    litegrpc::test::RunTest("UnixAbstract", TestUnixAbstract);
+    litegrpc::test::RunTest("UnixConnect", TestUnixConnect);
+    litegrpc::test::RunTest("FallbackAndPreferred", TestFallbackAndPreferred);
+    litegrpc::test::RunTest("AllFailed", TestAllFailed);
+    litegrpc::test::RunTest("ZeroTimeout", TestZeroTimeout);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,307 @@
+/**
+ * @file dns_resolver_test.cpp
+ * @brief DnsResolver 单元测试
+ *
+ * 覆盖 hosts 文件查找、TTL 过期后的刷新、刷新失败时继续返回旧结果，
+ * 以及指定 DNS 服务器时对畸形应答的拒绝。DNS 服务器由测试内的
+ * UDP 替身扮演，不访问外部网络。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "client/dns_resolver.h"
+#include "test_util.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using litegrpc::DnsResolver;
+using litegrpc::ResolverOptions;
+using litegrpc::Status;
+using litegrpc::StatusCode;
+using litegrpc::http2::ResolvedAddress;
+
+namespace {
+
+/// TTL 的下限，hosts 文件模式下以此作为缓存时间，缩短测试耗时
+const int kTtlMs = 1000;
+
+std::string First(const std::vector<ResolvedAddress>& addresses) {
+    return addresses.empty() ? std::string() : addresses.front().ToString();
+}
+
+void Rewrite(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::trunc);
+    file << content;
+}
+
+/**
+ * @brief 等待后台解析线程开始第 lookups 次解析，再留出写回缓存的时间
+ */
+bool WaitForLookups(const DnsResolver& resolver, uint64_t lookups) {
+    for (int i = 0; i < 200; ++i) {
+        if (resolver.GetStats().lookups >= lookups) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+/**
+ * @brief 本地 DNS 替身服务器
+ *
+ * 对每个查询先发送若干畸形报文，再按 valid 决定是否发送合法应答。
+ * A 查询应答 192.0.2.7，AAAA 查询应答 2001:db8::7，TTL 均为 60 秒。
+ */
+class FakeNameserver {
+public:
+    explicit FakeNameserver(bool valid) : valid_(valid) {
+        fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread(&FakeNameserver::Serve, this);
+    }
+
+    ~FakeNameserver() {
+        stop_ = true;
+        thread_.join();
+        close(fd_);
+    }
+
+    std::string address() const { return "127.0.0.1:" + std::to_string(port_); }
+    int queries() const { return queries_; }
+
+private:
+    void Serve() {
+        while (!stop_) {
+            struct pollfd pfd = {fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) {
+                continue;
+            }
+            uint8_t query[512];
+            struct sockaddr_storage peer;
+            socklen_t peer_len = sizeof(peer);
+            ssize_t n = recvfrom(fd_, query, sizeof(query), 0,
+                                 reinterpret_cast<struct sockaddr*>(&peer), &peer_len);
+            if (n < 12) {
+                continue;
+            }
+            queries_++;
+            auto reply = [&](const std::vector<uint8_t>& packet) {
+                sendto(fd_, packet.data(), packet.size(), 0,
+                       reinterpret_cast<struct sockaddr*>(&peer), peer_len);
+            };
+
+            const std::vector<uint8_t> answer = BuildAnswer(query, static_cast<size_t>(n));
+            reply(std::vector<uint8_t>(answer.begin(), answer.begin() + 5));          // 不足报文头
+            reply(std::vector<uint8_t>(answer.begin(), answer.end() - 6));            // 应答记录被截断
+            reply(std::vector<uint8_t>(query, query + n));                            // QR 位为 0
+            std::vector<uint8_t> overcount = answer;
+            overcount[7] = 3;                                                         // ANCOUNT 多于实际记录
+            reply(overcount);
+            if (valid_) {
+                reply(answer);
+            }
+        }
+    }
+
+    /**
+     * @brief 按查询构造应答：复制报文头与问题段，追加一条应答记录
+     */
+    static std::vector<uint8_t> BuildAnswer(const uint8_t* query, size_t len) {
+        size_t qname_end = 12;
+        while (qname_end < len && query[qname_end] != 0) {
+            qname_end += query[qname_end] + 1;
+        }
+        const size_t question_end = qname_end + 5;  // 结尾的 0、QTYPE、QCLASS
+        std::vector<uint8_t> packet(query, query + std::min(question_end, len));
+        packet[2] = 0x81;  // QR = 1, RD = 1
+        packet[3] = 0x80;  // RA = 1, RCODE = NOERROR
+        const bool aaaa = packet[qname_end + 2] == 28;
+        packet[7] = 1;  // ANCOUNT = 1
+        const uint8_t record[] = {
+            0xc0, 0x0c,                                // 指向问题段中的名称
+            0x00, static_cast<uint8_t>(aaaa ? 28 : 1), // TYPE = AAAA / A
+            0x00, 0x01,                                // CLASS = IN
+            0x00, 0x00, 0x00, 0x3c,                    // TTL = 60
+            0x00, static_cast<uint8_t>(aaaa ? 16 : 4)  // RDLENGTH
+        };
+        const uint8_t ipv4[] = {192, 0, 2, 7};
+        const uint8_t ipv6[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x07};
+        packet.insert(packet.end(), record, record + sizeof(record));
+        if (aaaa) {
+            packet.insert(packet.end(), ipv6, ipv6 + sizeof(ipv6));
+        } else {
+            packet.insert(packet.end(), ipv4, ipv4 + sizeof(ipv4));
+        }
+        return packet;
+    }
+
+    int fd_ = -1;
+    int port_ = 0;
+    bool valid_;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> queries_{0};
+    std::thread thread_;
+};
+
+void TestHostsFileLookup() {
+    const std::string path = litegrpc::test::WriteTempFile(
+        "# comment line\n"
+        "10.0.0.1   svc.test alias.test   # trailing comment\n"
+        "fd00::1    svc.test\n"
+        "10.0.0.2   other.test\n");
+    ResolverOptions options;
+    options.hosts_file = path;
+    DnsResolver resolver(options);
+
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(resolver.Resolve("SVC.test", 50051, 1000, &addresses));
+    CHECK_EQ(addresses.size(), 2u);
+    CHECK_EQ(First(addresses), "10.0.0.1:50051");
+    CHECK(addresses.size() == 2 && addresses[1].ToString() == "[fd00::1]:50051");
+
+    CHECK_OK(resolver.Resolve("alias.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:80");
+
+    // 缓存命中时使用本次调用的端口
+    CHECK_OK(resolver.Resolve("svc.test", 443, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:443");
+    CHECK_EQ(resolver.GetStats().hits, 1u);
+
+    // 不存在的主机返回 UNAVAILABLE，并按 negative_ttl_ms 缓存失败结果
+    Status status = resolver.Resolve("missing.test", 80, 1000, &addresses);
+    CHECK_EQ(status.error_code(), StatusCode::UNAVAILABLE);
+    CHECK(addresses.empty());
+    status = resolver.Resolve("missing.test", 80, 1000, &addresses);
+    CHECK_EQ(status.error_code(), StatusCode::UNAVAILABLE);
+    CHECK_EQ(resolver.GetStats().negative_hits, 1u);
+
+    // IP 字面量不经过缓存
+    const uint64_t lookups = resolver.GetStats().lookups;
+    CHECK_OK(resolver.Resolve("127.0.0.1", 8080, 1000, &addresses));
+    CHECK_EQ(First(addresses), "127.0.0.1:8080");
+    CHECK_EQ(resolver.GetStats().lookups, lookups);
+    unlink(path.c_str());
+}
+
+void TestTtlExpiry() {
+    const std::string path = litegrpc::test::WriteTempFile("10.0.0.1 svc.test\n");
+    ResolverOptions options;
+    options.hosts_file = path;
+    options.default_ttl_ms = kTtlMs;
+    DnsResolver resolver(options);
+
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:80");
+
+    // TTL 内修改文件不影响结果
+    Rewrite(path, "10.0.0.9 svc.test\n");
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:80");
+    CHECK_EQ(resolver.GetStats().lookups, 1u);
+
+    // 过期后立即返回旧结果，同时在后台刷新
+    std::this_thread::sleep_for(std::chrono::milliseconds(kTtlMs + 100));
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:80");
+    CHECK_EQ(resolver.GetStats().stale_hits, 1u);
+
+    CHECK(WaitForLookups(resolver, 2));
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.9:80");
+    CHECK_EQ(resolver.GetStats().refreshes, 1u);
+    unlink(path.c_str());
+}
+
+void TestStaleOnRefreshFailure() {
+    const std::string path = litegrpc::test::WriteTempFile("10.0.0.1 svc.test\n");
+    ResolverOptions options;
+    options.hosts_file = path;
+    options.default_ttl_ms = kTtlMs;
+    options.negative_ttl_ms = 100;
+    DnsResolver resolver(options);
+
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+
+    // 刷新失败（主机已从文件中删除）时保留原有的成功结果
+    Rewrite(path, "10.0.0.2 other.test\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(kTtlMs + 100));
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:80");
+    CHECK(WaitForLookups(resolver, 2));
+
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.1:80");
+    CHECK_EQ(resolver.GetStats().negative_hits, 0u);
+
+    // negative_ttl_ms 后再次尝试，文件恢复后得到新结果
+    Rewrite(path, "10.0.0.3 svc.test\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK(WaitForLookups(resolver, 3));
+    CHECK_OK(resolver.Resolve("svc.test", 80, 1000, &addresses));
+    CHECK_EQ(First(addresses), "10.0.0.3:80");
+    unlink(path.c_str());
+}
+
+void TestMalformedRepliesIgnored() {
+    FakeNameserver server(true);
+    ResolverOptions options;
+    options.nameserver = server.address();
+    DnsResolver resolver(options);
+
+    // 畸形报文不能占用查询，随后到达的合法应答仍被接受
+    std::vector<ResolvedAddress> addresses;
+    CHECK_OK(resolver.Resolve("svc.test", 80, 5000, &addresses));
+    CHECK_EQ(addresses.size(), 2u);
+    CHECK_EQ(First(addresses), "[2001:db8::7]:80");  // AAAA 在前
+    CHECK(addresses.size() == 2 && addresses[1].ToString() == "192.0.2.7:80");
+    CHECK_EQ(server.queries(), 2);  // AAAA 与 A 各一次，没有重发
+}
+
+void TestOnlyMalformedReplies() {
+    FakeNameserver server(false);
+    ResolverOptions options;
+    options.nameserver = server.address();
+    DnsResolver resolver(options);
+
+    // 只收到畸形报文等同于没有应答：重发一次后失败
+    std::vector<ResolvedAddress> addresses;
+    Status status = resolver.Resolve("svc.test", 80, 10000, &addresses);
+    CHECK_EQ(status.error_code(), StatusCode::UNAVAILABLE);
+    CHECK(addresses.empty());
+    CHECK_EQ(server.queries(), 4);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("HostsFileLookup", TestHostsFileLookup);
+    litegrpc::test::RunTest("TtlExpiry", TestTtlExpiry);
+    litegrpc::test::RunTest("StaleOnRefreshFailure", TestStaleOnRefreshFailure);
+    litegrpc::test::RunTest("MalformedRepliesIgnored", TestMalformedRepliesIgnored);
+    litegrpc::test::RunTest("OnlyMalformedReplies", TestOnlyMalformedReplies);
+    return litegrpc::test::TestResult();
+}
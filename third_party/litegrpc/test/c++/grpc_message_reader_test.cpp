@@ -0,0 +1,144 @@
+/**
+ * @file grpc_message_reader_test.cpp
+ * @brief GrpcMessageReader 单元测试
+ *
+ * 覆盖前缀与负载被任意切分、一个数据块包含多条消息、长度为 0 的消息、
+ * 超限消息在缓冲前被拒绝、压缩标志校验，以及流结束时的边界检查。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/grpc_message_reader.h"
+#include "test_util.h"
+
+#include <cstdint>
+#include <string>
+
+using litegrpc::Status;
+using litegrpc::StatusCode;
+using litegrpc::http2::GrpcMessageReader;
+
+namespace {
+
+/**
+ * @brief 构造一条带长度前缀的消息
+ */
+std::string Frame(const std::string& payload, uint8_t flag = 0) {
+    const uint32_t len = static_cast<uint32_t>(payload.size());
+    std::string framed;
+    framed.push_back(static_cast<char>(flag));
+    framed.push_back(static_cast<char>(len >> 24));
+    framed.push_back(static_cast<char>(len >> 16));
+    framed.push_back(static_cast<char>(len >> 8));
+    framed.push_back(static_cast<char>(len));
+    return framed + payload;
+}
+
+/**
+ * @brief 构造只有前缀、声明长度为 length 的消息头
+ */
+std::string Prefix(uint32_t length) {
+    std::string prefix = Frame("");
+    prefix[1] = static_cast<char>(length >> 24);
+    prefix[2] = static_cast<char>(length >> 16);
+    prefix[3] = static_cast<char>(length >> 8);
+    prefix[4] = static_cast<char>(length);
+    return prefix;
+}
+
+Status Feed(GrpcMessageReader* reader, const std::string& data) {
+    return reader->Consume(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+void TestSingleMessage() {
+    GrpcMessageReader reader;
+    CHECK_OK(Feed(&reader, Frame("hello")));
+    CHECK_OK(reader.Finish());
+    CHECK_EQ(reader.message_count(), 1u);
+    std::string message;
+    CHECK(reader.PopMessage(&message));
+    CHECK_EQ(message, "hello");
+    CHECK(!reader.PopMessage(&message));
+}
+
+void TestSplitAtEveryOffset() {
+    const std::string body = Frame("first message") + Frame("") + Frame(std::string(300, 'x'));
+    for (size_t chunk = 1; chunk <= body.size(); ++chunk) {
+        GrpcMessageReader reader;
+        for (size_t offset = 0; offset < body.size(); offset += chunk) {
+            CHECK_OK(Feed(&reader, body.substr(offset, chunk)));
+        }
+        CHECK_OK(reader.Finish());
+        std::string message;
+        CHECK(reader.PopMessage(&message) && message == "first message");
+        CHECK(reader.PopMessage(&message) && message.empty());
+        CHECK(reader.PopMessage(&message) && message == std::string(300, 'x'));
+        CHECK_EQ(reader.message_count(), 0u);
+    }
+}
+
+void TestSplitPrefixFinish() {
+    // 流在前缀中间结束
+    GrpcMessageReader reader;
+    const std::string framed = Frame("abc");
+    CHECK_OK(Feed(&reader, framed.substr(0, 3)));
+    CHECK_EQ(reader.Finish().error_code(), StatusCode::INTERNAL);
+    CHECK_OK(Feed(&reader, framed.substr(3)));
+    CHECK_OK(reader.Finish());
+
+    // 流在负载中间结束
+    GrpcMessageReader partial;
+    CHECK_OK(Feed(&partial, framed.substr(0, 6)));
+    CHECK_EQ(partial.message_count(), 0u);
+    CHECK_EQ(partial.Finish().error_code(), StatusCode::INTERNAL);
+}
+
+void TestOversizedMessage() {
+    GrpcMessageReader reader(16);
+    CHECK_OK(Feed(&reader, Frame(std::string(16, 'a'))));  // 恰好等于上限
+    CHECK_EQ(reader.message_count(), 1u);
+
+    // 只收到前缀即拒绝，不等待负载
+    Status status = Feed(&reader, Prefix(17));
+    CHECK_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+
+    // 出错后不再接受数据，之后的调用返回同一错误
+    status = Feed(&reader, Frame("ok"));
+    CHECK_EQ(status.error_code(), StatusCode::RESOURCE_EXHAUSTED);
+    CHECK_EQ(reader.Finish().error_code(), StatusCode::RESOURCE_EXHAUSTED);
+    CHECK_EQ(reader.message_count(), 1u);
+
+    // 默认上限为 Config::DEFAULT_MAX_MESSAGE_SIZE，声明 4GB 的前缀被拒绝
+    GrpcMessageReader defaults;
+    CHECK_EQ(Feed(&defaults, Prefix(0xffffffffu)).error_code(), StatusCode::RESOURCE_EXHAUSTED);
+}
+
+void TestCompressedFlag() {
+    GrpcMessageReader compressed;
+    Status status = Feed(&compressed, Frame("zzz", 1));
+    CHECK_EQ(status.error_code(), StatusCode::INTERNAL);
+    CHECK_EQ(compressed.message_count(), 0u);
+
+    GrpcMessageReader invalid;
+    status = Feed(&invalid, Frame("zzz", 2));
+    CHECK_EQ(status.error_code(), StatusCode::INTERNAL);
+    CHECK_EQ(invalid.Finish().error_code(), StatusCode::INTERNAL);
+
+    // 前面的合法消息保留，错误发生在第二条消息的前缀
+    GrpcMessageReader mixed;
+    status = Feed(&mixed, Frame("good") + Frame("bad", 1));
+    CHECK_EQ(status.error_code(), StatusCode::INTERNAL);
+    CHECK_EQ(mixed.message_count(), 1u);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("SingleMessage", TestSingleMessage);
+    litegrpc::test::RunTest("SplitAtEveryOffset", TestSplitAtEveryOffset);
+    litegrpc::test::RunTest("SplitPrefixFinish", TestSplitPrefixFinish);
+    litegrpc::test::RunTest("OversizedMessage", TestOversizedMessage);
+    litegrpc::test::RunTest("CompressedFlag", TestCompressedFlag);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,171 @@
+/**
+ * @file inproc_test.cpp
+ * @brief 进程内通道单元测试
+ *
+ * 覆盖回显与元数据透传、处理函数失败时清空响应、处理函数返回时已超过
+ * 截止时间返回 DEADLINE_EXCEEDED，以及已缓存端点的通道感知注册、
+ * 注销与同名重新注册。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "litegrpc/channel.h"
+#include "litegrpc/client_context.h"
+#include "litegrpc/credentials.h"
+#include "litegrpc/inproc.h"
+#include "test_util.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using litegrpc::Channel;
+using litegrpc::ClientContext;
+using litegrpc::Status;
+using litegrpc::StatusCode;
+
+namespace {
+
+std::shared_ptr<Channel> MakeChannel(const std::string& target) {
+    return litegrpc::CreateChannel(target, litegrpc::InsecureChannelCredentials());
+}
+
+void TestEchoAndMetadata() {
+    CHECK_OK(litegrpc::RegisterInprocHandler("echo",
+        [](const std::string& method, ClientContext* context,
+           const std::string& request, std::string* response) {
+            *response = method + "|" + request;
+            if (context) {
+                auto it = context->GetMetadata().find("x-trace-id");
+                if (it != context->GetMetadata().end()) {
+                    *response += "|" + it->second;
+                }
+            }
+            return Status::OK();
+        }));
+    CHECK_EQ(litegrpc::RegisterInprocHandler("echo",
+        [](const std::string&, ClientContext*, const std::string&, std::string*) {
+            return Status::OK();
+        }).error_code(), StatusCode::ALREADY_EXISTS);
+    CHECK_EQ(litegrpc::RegisterInprocHandler("", nullptr).error_code(), StatusCode::INVALID_ARGUMENT);
+
+    // inproc:// 与 inproc: 两种写法指向同一端点
+    auto channel = MakeChannel("inproc://echo");
+    CHECK(std::dynamic_pointer_cast<litegrpc::InprocChannel>(channel) != nullptr);
+    CHECK_OK(channel->Connect());
+    CHECK(channel->IsConnected());
+
+    ClientContext context;
+    context.AddMetadata("x-trace-id", "abc");
+    std::string response;
+    CHECK_OK(channel->ExecuteRequest("/pkg.Svc/Echo", &context, "payload", &response));
+    CHECK(response == "/pkg.Svc/Echo|payload|abc");
+
+    auto short_form = MakeChannel("inproc:echo");
+    CHECK_OK(short_form->ExecuteRequest("/pkg.Svc/Echo", nullptr, "x", &response));
+    CHECK(response == "/pkg.Svc/Echo|x");
+
+    litegrpc::UnregisterInprocHandler("echo");
+}
+
+void TestHandlerError() {
+    CHECK_OK(litegrpc::RegisterInprocHandler("failing",
+        [](const std::string&, ClientContext*, const std::string&, std::string* response) {
+            *response = "partial";
+            return Status::InvalidArgument("bad request");
+        }));
+    auto channel = MakeChannel("inproc://failing");
+    std::string response = "stale";
+    Status status = channel->ExecuteRequest("/pkg.Svc/Fail", nullptr, "x", &response);
+    CHECK_EQ(status.error_code(), StatusCode::INVALID_ARGUMENT);
+    CHECK(status.error_message() == "bad request");
+    CHECK(response.empty());
+    litegrpc::UnregisterInprocHandler("failing");
+}
+
+void TestDeadline() {
+    int calls = 0;
+    CHECK_OK(litegrpc::RegisterInprocHandler("slow",
+        [&calls](const std::string&, ClientContext*, const std::string&, std::string* response) {
+            ++calls;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            *response = "late";
+            return Status::OK();
+        }));
+    auto channel = MakeChannel("inproc://slow");
+
+    // 处理函数返回时已超过截止时间：丢弃响应
+    ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    std::string response;
+    CHECK_EQ(channel->ExecuteRequest("/pkg.Svc/Slow", &context, "x", &response).error_code(),
+             StatusCode::DEADLINE_EXCEEDED);
+    CHECK(response.empty());
+    CHECK_EQ(calls, 1);
+
+    // 调用前已超过截止时间：不执行处理函数
+    CHECK_EQ(channel->ExecuteRequest("/pkg.Svc/Slow", &context, "x", &response).error_code(),
+             StatusCode::DEADLINE_EXCEEDED);
+    CHECK_EQ(calls, 1);
+
+    ClientContext relaxed;
+    relaxed.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(10));
+    CHECK_OK(channel->ExecuteRequest("/pkg.Svc/Slow", &relaxed, "x", &response));
+    CHECK(response == "late");
+    litegrpc::UnregisterInprocHandler("slow");
+}
+
+void TestReregister() {
+    // 通道先于端点创建
+    auto channel = MakeChannel("inproc://swap");
+    std::string response;
+    CHECK(!channel->IsConnected());
+    CHECK_EQ(channel->Connect().error_code(), StatusCode::UNAVAILABLE);
+    CHECK_EQ(channel->ExecuteRequest("/pkg.Svc/M", nullptr, "x", &response).error_code(),
+             StatusCode::UNAVAILABLE);
+    CHECK(!channel->WaitForConnected(std::chrono::system_clock::now() + std::chrono::milliseconds(20)));
+
+    auto respond_with = [](const std::string& tag) {
+        return [tag](const std::string&, ClientContext*, const std::string&, std::string* out) {
+            *out = tag;
+            return Status::OK();
+        };
+    };
+
+    // 注册后无需重建通道
+    CHECK_OK(litegrpc::RegisterInprocHandler("swap", respond_with("first")));
+    CHECK(channel->WaitForConnected(std::chrono::system_clock::now() + std::chrono::seconds(1)));
+    CHECK_OK(channel->ExecuteRequest("/pkg.Svc/M", nullptr, "x", &response));
+    CHECK(response == "first");
+
+    // 注销后缓存的端点失效
+    litegrpc::UnregisterInprocHandler("swap");
+    CHECK(!channel->IsConnected());
+    CHECK_EQ(channel->ExecuteRequest("/pkg.Svc/M", nullptr, "x", &response).error_code(),
+             StatusCode::UNAVAILABLE);
+
+    // 同名重新注册后改用新的处理函数
+    CHECK_OK(litegrpc::RegisterInprocHandler("swap", respond_with("second")));
+    CHECK_OK(channel->ExecuteRequest("/pkg.Svc/M", nullptr, "x", &response));
+    CHECK(response == "second");
+    CHECK(channel->IsConnected());
+
+    channel->Disconnect();
+    CHECK(!channel->IsConnected());
+    CHECK_OK(channel->ExecuteRequest("/pkg.Svc/M", nullptr, "x", &response));
+    CHECK(response == "second");
+    litegrpc::UnregisterInprocHandler("swap");
+    litegrpc::UnregisterInprocHandler("swap");  // 重复注销无影响
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("EchoAndMetadata", TestEchoAndMetadata);
+    litegrpc::test::RunTest("HandlerError", TestHandlerError);
+    litegrpc::test::RunTest("Deadline", TestDeadline);
+    litegrpc::test::RunTest("Reregister", TestReregister);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,138 @@
+/**
+ * @file keepalive_test.cpp
+ * @brief KeepaliveTracker 单元测试
+ *
+ * 以固定的时间点驱动跟踪器，覆盖空闲后发送 PING、读到数据推迟 PING、
+ * ACK 与数据对超时的影响、WaitMs() 的取值、permit_without_calls、
+ * max_pings_without_data 与无数据时的最小间隔，以及 RTT 采样。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/keepalive.h"
+#include "test_util.h"
+
+#include <chrono>
+
+using litegrpc::http2::KeepaliveTracker;
+
+namespace {
+
+using Clock = KeepaliveTracker::Clock;
+using std::chrono::milliseconds;
+
+void TestDisabled() {
+    const Clock::time_point t0 = Clock::now();
+    KeepaliveTracker tracker(0, 20000, true, 2, 0, t0);
+    CHECK(!tracker.enabled());
+    CHECK(!tracker.NeedPing(t0 + milliseconds(100000), true));
+    CHECK_EQ(tracker.WaitMs(t0, true), -1);
+    CHECK(!tracker.TimedOut(t0 + milliseconds(100000)));
+}
+
+void TestPingAndTimeout() {
+    const Clock::time_point t0 = Clock::now();
+    KeepaliveTracker tracker(1000, 500, false, 0, 0, t0);
+    CHECK(tracker.enabled());
+
+    // 空闲达到 keepalive_time 之前不发送
+    CHECK(!tracker.NeedPing(t0 + milliseconds(999), true));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(400), true), 600);
+
+    // 读到数据重新计时
+    tracker.OnRead(t0 + milliseconds(800));
+    CHECK(!tracker.NeedPing(t0 + milliseconds(1500), true));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(1500), true), 300);
+    CHECK(tracker.NeedPing(t0 + milliseconds(1800), true));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(1900), true), 0);
+
+    // PING 在途：不再发送，等待时间为 ACK 超时
+    tracker.StartPing(t0 + milliseconds(1800));
+    CHECK(tracker.ping_in_flight());
+    CHECK_EQ(tracker.pings_sent(), 1u);
+    CHECK(!tracker.NeedPing(t0 + milliseconds(5000), true));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(2000), true), 300);
+    CHECK(!tracker.TimedOut(t0 + milliseconds(2299)));
+
+    // 在途期间读到数据推迟超时
+    tracker.OnRead(t0 + milliseconds(2200));
+    CHECK(!tracker.TimedOut(t0 + milliseconds(2600)));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(2600), true), 100);
+    CHECK(tracker.TimedOut(t0 + milliseconds(2700)));
+
+    // ACK 之后不再超时，RTT 从 PING 发出起计算
+    CHECK_EQ(tracker.CompletePing(t0 + milliseconds(2700)), 900000);
+    CHECK(!tracker.ping_in_flight());
+    CHECK(!tracker.TimedOut(t0 + milliseconds(10000)));
+    CHECK_EQ(tracker.CompletePing(t0 + milliseconds(2800)), -1);
+}
+
+void TestPermitWithoutCalls() {
+    const Clock::time_point t0 = Clock::now();
+    KeepaliveTracker idle(1000, 500, false, 0, 0, t0);
+    CHECK(!idle.NeedPing(t0 + milliseconds(5000), false));
+    CHECK_EQ(idle.WaitMs(t0, false), -1);
+    CHECK(idle.NeedPing(t0 + milliseconds(5000), true));
+
+    KeepaliveTracker permitted(1000, 500, true, 0, 0, t0);
+    CHECK(permitted.NeedPing(t0 + milliseconds(5000), false));
+    CHECK_EQ(permitted.WaitMs(t0, false), 1000);
+}
+
+void TestPingLimits() {
+    const Clock::time_point t0 = Clock::now();
+    KeepaliveTracker tracker(100, 50, false, 2, 1000, t0);
+
+    // 第一个 PING 不受最小间隔限制
+    CHECK(tracker.NeedPing(t0 + milliseconds(100), true));
+    tracker.StartPing(t0 + milliseconds(100));
+    tracker.OnRead(t0 + milliseconds(110));
+    tracker.CompletePing(t0 + milliseconds(110));
+
+    // 第二个 PING 与第一个至少相隔 min_interval_without_data
+    CHECK(!tracker.NeedPing(t0 + milliseconds(500), true));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(500), true), 600);
+    CHECK(tracker.NeedPing(t0 + milliseconds(1100), true));
+    tracker.StartPing(t0 + milliseconds(1100));
+    tracker.OnRead(t0 + milliseconds(1110));
+    tracker.CompletePing(t0 + milliseconds(1110));
+
+    // 达到 max_pings_without_data 后不再发送，直到发送数据
+    CHECK(!tracker.NeedPing(t0 + milliseconds(100000), true));
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(100000), true), -1);
+    tracker.OnDataSent();
+    CHECK(tracker.NeedPing(t0 + milliseconds(100000), true));
+
+    // 发送数据后不再受最小间隔限制
+    CHECK_EQ(tracker.WaitMs(t0 + milliseconds(1110), true), 100);
+    CHECK_EQ(tracker.pings_sent(), 2u);
+}
+
+void TestRtt() {
+    const Clock::time_point t0 = Clock::now();
+    KeepaliveTracker tracker(1000, 500, true, 0, 0, t0);
+    CHECK_EQ(tracker.rtt_samples(), 0u);
+    CHECK_EQ(tracker.smoothed_rtt_us(), 0);
+
+    tracker.StartPing(t0);
+    CHECK_EQ(tracker.CompletePing(t0 + milliseconds(8)), 8000);
+    CHECK_EQ(tracker.smoothed_rtt_us(), 8000);
+    tracker.StartPing(t0 + milliseconds(100));
+    CHECK_EQ(tracker.CompletePing(t0 + milliseconds(116)), 16000);
+    CHECK_EQ(tracker.last_rtt_us(), 16000);
+    CHECK_EQ(tracker.min_rtt_us(), 8000);
+    CHECK_EQ(tracker.smoothed_rtt_us(), 9000);  // 8000 * 7/8 + 16000 / 8
+    CHECK_EQ(tracker.rtt_samples(), 2u);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("Disabled", TestDisabled);
+    litegrpc::test::RunTest("PingAndTimeout", TestPingAndTimeout);
+    litegrpc::test::RunTest("PermitWithoutCalls", TestPermitWithoutCalls);
+    litegrpc::test::RunTest("PingLimits", TestPingLimits);
+    litegrpc::test::RunTest("Rtt", TestRtt);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,201 @@
+/**
+ * @file mpsc_queue_test.cpp
+ * @brief MpscQueue 单元测试
+ *
+ * 覆盖单线程的先进先出与节点复用、生产者尚未链接前驱节点时 Pop()
+ * 暂时返回 nullptr 并在链接完成后取到全部节点、多个生产者与一个消费者
+ * 并发时不丢失节点且每个生产者的节点保持入队顺序，以及 I/O 线程模式
+ * 提交调用所用的取出/撤回竞争（kQueued 只能转为其中一个状态）。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/mpsc_queue.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using litegrpc::http2::MpscNode;
+using litegrpc::http2::MpscQueue;
+
+namespace {
+
+/**
+ * @brief 带来源与序号的测试节点
+ */
+struct Item : MpscNode {
+    enum State { kQueued, kClaimed, kWithdrawn };
+
+    int producer = 0;                 ///< 生产者编号
+    int seq = 0;                      ///< 生产者内的入队序号
+    std::atomic<int> state{kQueued};  ///< 与 IoCall 相同的提交状态
+};
+
+void TestSingleThread() {
+    MpscQueue queue;
+    CHECK(queue.Pop() == nullptr);
+
+    Item items[3];
+    for (int round = 0; round < 3; ++round) {
+        for (auto& item : items) {
+            queue.Push(&item);
+        }
+        for (auto& item : items) {
+            CHECK(queue.Pop() == &item);
+        }
+        CHECK(queue.Pop() == nullptr);
+    }
+
+    // 出队与入队交替
+    queue.Push(&items[0]);
+    CHECK(queue.Pop() == &items[0]);
+    queue.Push(&items[1]);
+    queue.Push(&items[0]);
+    CHECK(queue.Pop() == &items[1]);
+    queue.Push(&items[2]);
+    CHECK(queue.Pop() == &items[0]);
+    CHECK(queue.Pop() == &items[2]);
+    CHECK(queue.Pop() == nullptr);
+}
+
+void TestPendingLink() {
+    MpscQueue queue;
+    Item first;
+    Item second;
+    queue.Push(&first);
+    queue.Push(&second);
+
+    // 模拟第二个生产者已交换尾指针、尚未链接前驱节点
+    first.next.store(nullptr);
+    CHECK(queue.Pop() == nullptr);
+    CHECK(queue.Pop() == nullptr);
+
+    // 链接完成后按顺序取到两个节点
+    first.next.store(&second);
+    CHECK(queue.Pop() == &first);
+    CHECK(queue.Pop() == &second);
+    CHECK(queue.Pop() == nullptr);
+}
+
+void TestConcurrentProducers() {
+    const int kProducers = 4;
+    const int kPerProducer = 50000;
+    std::vector<std::unique_ptr<Item[]>> items;
+    for (int p = 0; p < kProducers; ++p) {
+        items.emplace_back(new Item[kPerProducer]);
+        for (int i = 0; i < kPerProducer; ++i) {
+            items[p][i].producer = p;
+            items[p][i].seq = i;
+        }
+    }
+
+    MpscQueue queue;
+    std::atomic<bool> start{false};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            while (!start) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.Push(&items[p][i]);
+            }
+        });
+    }
+
+    std::vector<int> next_seq(kProducers, 0);
+    int received = 0;
+    bool ordered = true;
+    start = true;
+    while (received < kProducers * kPerProducer) {
+        MpscNode* node = queue.Pop();
+        if (!node) {
+            std::this_thread::yield();
+            continue;
+        }
+        Item* item = static_cast<Item*>(node);
+        ordered = ordered && item->seq == next_seq[item->producer];
+        next_seq[item->producer] = item->seq + 1;
+        ++received;
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    CHECK(ordered);
+    for (int p = 0; p < kProducers; ++p) {
+        CHECK_EQ(next_seq[p], kPerProducer);
+    }
+    CHECK(queue.Pop() == nullptr);
+}
+
+void TestClaimOrWithdraw() {
+    const int kProducers = 4;
+    const int kPerProducer = 20000;
+    std::vector<std::unique_ptr<Item[]>> items;
+    for (int p = 0; p < kProducers; ++p) {
+        items.emplace_back(new Item[kPerProducer]);
+    }
+
+    MpscQueue queue;
+    std::atomic<int> withdrawn{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                Item* item = &items[p][i];
+                queue.Push(item);
+                // 调用方超时：与消费者竞争撤回
+                if (i % 2 == 0) {
+                    int expected = Item::kQueued;
+                    if (item->state.compare_exchange_strong(expected, Item::kWithdrawn)) {
+                        withdrawn++;
+                    }
+                }
+            }
+        });
+    }
+
+    int popped = 0;
+    int claimed = 0;
+    while (popped < kProducers * kPerProducer) {
+        MpscNode* node = queue.Pop();
+        if (!node) {
+            std::this_thread::yield();
+            continue;
+        }
+        ++popped;
+        Item* item = static_cast<Item*>(node);
+        int expected = Item::kQueued;
+        if (item->state.compare_exchange_strong(expected, Item::kClaimed)) {
+            ++claimed;
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    // 每个节点恰好被取出或撤回一次
+    CHECK_EQ(claimed + withdrawn.load(), kProducers * kPerProducer);
+    int still_queued = 0;
+    for (int p = 0; p < kProducers; ++p) {
+        for (int i = 0; i < kPerProducer; ++i) {
+            still_queued += items[p][i].state == Item::kQueued;
+        }
+    }
+    CHECK_EQ(still_queued, 0);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("SingleThread", TestSingleThread);
+    litegrpc::test::RunTest("PendingLink", TestPendingLink);
+    litegrpc::test::RunTest("ConcurrentProducers", TestConcurrentProducers);
+    litegrpc::test::RunTest("ClaimOrWithdraw", TestClaimOrWithdraw);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,185 @@
+/**
+ * @file output_queue_test.cpp
+ * @brief OutputQueue 单元测试
+ *
+ * 覆盖复制段的合并与冻结、跨分段的部分消费、已部分写出的引用段被
+ * Detach() 转为复制段，以及 Consume()/Detach()/Clear() 对 released
+ * 计数器的累加：每个引用段的字节最终恰好计入一次。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/output_queue.h"
+#include "test_util.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+using litegrpc::http2::OutputQueue;
+
+namespace {
+
+/**
+ * @brief 把队首全部分片拼接为字符串
+ */
+std::string Contents(const OutputQueue& queue) {
+    OutputQueue::Slice slices[64];
+    const size_t n = queue.Peek(slices, 64);
+    std::string out;
+    for (size_t i = 0; i < n; ++i) {
+        out.append(reinterpret_cast<const char*>(slices[i].data), slices[i].len);
+    }
+    return out;
+}
+
+void TestCoalesce() {
+    OutputQueue queue;
+    queue.Append("ab", 2);
+    queue.Append("cd", 2);
+    queue.Append("", 0);
+    CHECK_EQ(queue.segment_count(), 1u);
+    CHECK_EQ(queue.size(), 4u);
+
+    // 超过合并上限时新建复制段
+    const std::string big(16384, 'x');
+    queue.Append(big.data(), big.size());
+    CHECK_EQ(queue.segment_count(), 2u);
+    queue.Append("e", 1);
+    CHECK_EQ(queue.segment_count(), 3u);
+
+    // 引用段之后的复制数据不拼接到引用段
+    auto owner = std::make_shared<std::string>("ref");
+    queue.AppendRef(owner->data(), owner->size(), owner);
+    queue.Append("f", 1);
+    CHECK_EQ(queue.segment_count(), 5u);
+    CHECK(Contents(queue) == "abcd" + big + "e" + "ref" + "f");
+
+    // 冻结后追加的数据不拼接到已有分段，已取得的分片保持不变
+    OutputQueue::Slice slice;
+    queue.Seal();
+    CHECK_EQ(queue.Peek(&slice, 1), 1u);
+    const uint8_t* sealed_data = slice.data;
+    queue.Append("g", 1);
+    CHECK_EQ(queue.segment_count(), 6u);
+    CHECK_EQ(queue.Peek(&slice, 1), 1u);
+    CHECK(slice.data == sealed_data);
+    CHECK(slice.owner == nullptr);
+
+    // 冻结的分段全部消费后恢复合并
+    queue.Consume(queue.size() - 1);
+    CHECK_EQ(queue.segment_count(), 1u);
+    queue.Append("h", 1);
+    CHECK_EQ(queue.segment_count(), 1u);
+    CHECK(Contents(queue) == "gh");
+}
+
+void TestPartialConsume() {
+    OutputQueue queue;
+    auto owner = std::make_shared<std::string>("0123456789");
+    size_t released = 0;
+    queue.Append("hello", 5);
+    queue.AppendRef(owner->data(), owner->size(), owner, &released);
+    queue.Append("xyz", 3);
+    CHECK_EQ(queue.size(), 18u);
+    CHECK_EQ(owner.use_count(), 2);
+
+    // 消费跨过复制段并进入引用段
+    queue.Consume(7);
+    CHECK_EQ(released, 2u);
+    CHECK_EQ(queue.size(), 11u);
+    OutputQueue::Slice slices[4];
+    CHECK_EQ(queue.Peek(slices, 4), 2u);
+    CHECK(slices[0].data == reinterpret_cast<const uint8_t*>(owner->data()) + 2);
+    CHECK_EQ(slices[0].len, 8u);
+    CHECK(slices[0].owner != nullptr && slices[0].owner->get() == owner.get());
+    CHECK(slices[1].owner == nullptr);
+
+    // 引用段写完即释放所有者引用
+    queue.Consume(9);
+    CHECK_EQ(released, 10u);
+    CHECK_EQ(owner.use_count(), 1);
+    CHECK(Contents(queue) == "yz");
+
+    // 超出队列长度的消费按队列长度处理
+    queue.Consume(100);
+    CHECK(queue.empty());
+    CHECK_EQ(queue.segment_count(), 0u);
+    CHECK_EQ(released, 10u);
+}
+
+void TestDetachPartial() {
+    OutputQueue queue;
+    auto owner = std::make_shared<std::string>("0123456789");
+    auto other = std::make_shared<std::string>("abcdef");
+    size_t released = 0;
+    size_t other_released = 0;
+    queue.AppendRef(owner->data(), owner->size(), owner, &released);
+    queue.AppendRef(other->data(), other->size(), other, &other_released);
+    queue.AppendRef(owner->data(), 3, owner, &released);
+
+    // 第一个引用段已写出 4 字节时所有者提前释放缓冲区
+    queue.Consume(4);
+    CHECK_EQ(released, 4u);
+    queue.Detach(owner.get());
+    CHECK_EQ(released, 13u);  // 两个段都不再引用所有者的数据
+    CHECK_EQ(owner.use_count(), 1);
+    CHECK_EQ(other.use_count(), 2);
+    CHECK_EQ(queue.size(), 15u);
+
+    // 复制段的数据与原缓冲区无关
+    memset(&(*owner)[0], '#', owner->size());
+    CHECK(Contents(queue) == "456789abcdef012");
+    OutputQueue::Slice slices[4];
+    CHECK_EQ(queue.Peek(slices, 4), 3u);
+    CHECK(slices[0].owner == nullptr);
+    CHECK(slices[1].owner != nullptr);
+    CHECK(slices[2].owner == nullptr);
+
+    // 转为复制段后继续消费不再计入
+    queue.Consume(8);
+    CHECK_EQ(released, 13u);
+    CHECK_EQ(other_released, 2u);
+    queue.Detach(owner.get());
+    CHECK_EQ(released, 13u);
+    CHECK(Contents(queue) == "cdef012");
+}
+
+void TestClear() {
+    OutputQueue queue;
+    auto first = std::make_shared<std::string>("first-buffer");
+    auto second = std::make_shared<std::string>("second");
+    size_t first_released = 0;
+    size_t second_released = 0;
+    queue.Append("hdr", 3);
+    queue.AppendRef(first->data(), first->size(), first, &first_released);
+    queue.AppendRef(second->data(), second->size(), second, &second_released);
+    queue.AppendRef(second->data(), 2, second);  // 不带计数器的引用段
+
+    queue.Consume(8);
+    CHECK_EQ(first_released, 5u);
+    queue.Seal();
+    queue.Clear();
+    CHECK(queue.empty());
+    CHECK_EQ(queue.segment_count(), 0u);
+    CHECK_EQ(first_released, first->size());
+    CHECK_EQ(second_released, second->size());
+    CHECK_EQ(first.use_count(), 1);
+    CHECK_EQ(second.use_count(), 1);
+
+    // 清空后冻结状态一并清除
+    queue.Append("a", 1);
+    queue.Append("b", 1);
+    CHECK_EQ(queue.segment_count(), 1u);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("Coalesce", TestCoalesce);
+    litegrpc::test::RunTest("PartialConsume", TestPartialConsume);
+    litegrpc::test::RunTest("DetachPartial", TestDetachPartial);
+    litegrpc::test::RunTest("Clear", TestClear);
+    return litegrpc::test::TestResult();
+}
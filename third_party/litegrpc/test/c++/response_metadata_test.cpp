@@ -0,0 +1,170 @@
+/**
+ * @file response_metadata_test.cpp
+ * @brief ResponseMetadata 单元测试
+ *
+ * 覆盖对象内容量溢出到堆、常用头部槽位、grpc-status 的无异常解析、
+ * 复制与移动后的数据有效性，以及 grpc-message 的百分号解码和
+ * "-bin" 二进制头部的 base64 解码。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/response_metadata.h"
+#include "test_util.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+using litegrpc::http2::Base64Decode;
+using litegrpc::http2::ParseNonNegativeInt;
+using litegrpc::http2::PercentDecode;
+using litegrpc::http2::ResponseMetadata;
+using litegrpc::http2::WellKnownHeader;
+
+namespace {
+
+void TestWellKnownHeaders() {
+    ResponseMetadata metadata;
+    std::string_view value;
+    CHECK(!metadata.has_grpc_status());
+    CHECK_EQ(metadata.grpc_status(), -1);
+    CHECK(!metadata.Get(WellKnownHeader::kContentType, &value));
+
+    metadata.Add(":status", "200");
+    metadata.Add("content-type", "application/grpc");
+    metadata.Add("x-trace", "a");
+    metadata.Add("x-trace", "b");
+    metadata.Add("grpc-status", "5");
+    CHECK_EQ(metadata.size(), 5u);
+    CHECK(metadata.has_grpc_status());
+    CHECK_EQ(metadata.grpc_status(), 5);
+    CHECK(metadata.Get(WellKnownHeader::kContentType, &value) && value == "application/grpc");
+    CHECK(metadata.Find("content-type", &value) && value == "application/grpc");
+
+    // 同名头部全部保留，Find 返回最后一个
+    CHECK(metadata.Find("x-trace", &value) && value == "b");
+    CHECK(metadata.at(2).name == "x-trace" && metadata.at(2).value == "a");
+    CHECK(!metadata.Find("x-missing", &value));
+    CHECK(!metadata.Find("", &value));
+
+    metadata.Clear();
+    CHECK_EQ(metadata.size(), 0u);
+    CHECK(!metadata.has_grpc_status());
+    CHECK_EQ(metadata.grpc_status(), -1);
+    CHECK(!metadata.Get(WellKnownHeader::kContentType, &value));
+}
+
+void TestGrpcStatusParsing() {
+    int value = 0;
+    CHECK(ParseNonNegativeInt("0", &value) && value == 0);
+    CHECK(ParseNonNegativeInt("16", &value) && value == 16);
+    CHECK(!ParseNonNegativeInt("", &value));
+    CHECK(!ParseNonNegativeInt("-1", &value));
+    CHECK(!ParseNonNegativeInt("+1", &value));
+    CHECK(!ParseNonNegativeInt(" 1", &value));
+    CHECK(!ParseNonNegativeInt("1x", &value));
+    CHECK(!ParseNonNegativeInt("99999999999999999999", &value));
+
+    // 格式错误的 grpc-status 仍然存在，但数值为 -1
+    ResponseMetadata metadata;
+    metadata.Add("grpc-status", "abc");
+    CHECK(metadata.has_grpc_status());
+    CHECK_EQ(metadata.grpc_status(), -1);
+
+    // 重复出现时以最后一次为准
+    metadata.Add("grpc-status", "14");
+    CHECK_EQ(metadata.grpc_status(), 14);
+}
+
+void TestOverflowToHeap() {
+    ResponseMetadata metadata;
+    const std::string large(300, 'v');  // 超过对象内存储区
+    for (int i = 0; i < 20; ++i) {      // 超过对象内条目表
+        metadata.Add("x-key-" + std::to_string(i), i == 10 ? large : std::to_string(i));
+    }
+    metadata.Add("grpc-message", "done");
+    CHECK_EQ(metadata.size(), 21u);
+    for (int i = 0; i < 20; ++i) {
+        auto entry = metadata.at(static_cast<size_t>(i));
+        CHECK(entry.name == "x-key-" + std::to_string(i));
+        CHECK(entry.value == (i == 10 ? large : std::to_string(i)));
+    }
+    std::string_view value;
+    CHECK(metadata.Get(WellKnownHeader::kGrpcMessage, &value) && value == "done");
+}
+
+void TestCopyAndMove() {
+    ResponseMetadata inline_only;
+    inline_only.Add("grpc-status", "0");
+    inline_only.Add("x-key", "value");
+
+    ResponseMetadata copy = inline_only;
+    inline_only.Clear();
+    std::string_view value;
+    CHECK(copy.Find("x-key", &value) && value == "value");
+    CHECK_EQ(copy.grpc_status(), 0);
+
+    ResponseMetadata spilled;
+    for (int i = 0; i < 12; ++i) {
+        spilled.Add("x-key-" + std::to_string(i), std::string(40, static_cast<char>('a' + i)));
+    }
+    ResponseMetadata moved = std::move(spilled);
+    CHECK_EQ(moved.size(), 12u);
+    CHECK(moved.Find("x-key-11", &value) && value == std::string(40, 'l'));
+}
+
+void TestPercentDecode() {
+    CHECK_EQ(PercentDecode("plain text"), "plain text");
+    CHECK_EQ(PercentDecode("100%25 done"), "100% done");
+    CHECK_EQ(PercentDecode("%E4%BD%A0%e5%a5%bd"), "\xe4\xbd\xa0\xe5\xa5\xbd");
+    CHECK_EQ(PercentDecode("line%0Abreak"), "line\nbreak");
+    // 不构成合法转义的 '%' 原样保留
+    CHECK_EQ(PercentDecode("50%"), "50%");
+    CHECK_EQ(PercentDecode("%4"), "%4");
+    CHECK_EQ(PercentDecode("%zz%41"), "%zzA");
+
+    ResponseMetadata metadata;
+    std::string message;
+    CHECK(!metadata.GetGrpcMessage(&message));
+    metadata.Add("grpc-message", "not%20found%3A%20%2Fa%2Fb");
+    CHECK(metadata.GetGrpcMessage(&message));
+    CHECK_EQ(message, "not found: /a/b");
+}
+
+void TestBinaryHeaders() {
+    std::string value;
+    CHECK(Base64Decode("", &value) && value.empty());
+    CHECK(Base64Decode("YQ==", &value) && value == "a");
+    CHECK(Base64Decode("YQ", &value) && value == "a");
+    CHECK(Base64Decode("YWI=", &value) && value == "ab");
+    CHECK(Base64Decode("YWJj", &value) && value == "abc");
+    CHECK(Base64Decode("AP8A/w", &value) && value == std::string("\x00\xff\x00\xff", 4));
+    CHECK(!Base64Decode("Y", &value));
+    CHECK(!Base64Decode("Y===", &value));
+    CHECK(!Base64Decode("Y=Q=", &value));
+    CHECK(!Base64Decode("YW-j", &value));
+
+    ResponseMetadata metadata;
+    metadata.Add("x-detail-bin", "AAECAw");
+    metadata.Add("x-broken-bin", "!!!");
+    metadata.Add("x-text", "AAECAw");
+    CHECK(metadata.FindBinary("x-detail-bin", &value) && value == std::string("\x00\x01\x02\x03", 4));
+    CHECK(!metadata.FindBinary("x-broken-bin", &value));
+    CHECK(!metadata.FindBinary("x-text", &value));   // 不是二进制头部
+    CHECK(!metadata.FindBinary("x-absent-bin", &value));
+    CHECK(!metadata.FindBinary("-bin", &value));
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("WellKnownHeaders", TestWellKnownHeaders);
+    litegrpc::test::RunTest("GrpcStatusParsing", TestGrpcStatusParsing);
+    litegrpc::test::RunTest("OverflowToHeap", TestOverflowToHeap);
+    litegrpc::test::RunTest("CopyAndMove", TestCopyAndMove);
+    litegrpc::test::RunTest("PercentDecode", TestPercentDecode);
+    litegrpc::test::RunTest("BinaryHeaders", TestBinaryHeaders);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,251 @@
+/**
+ * @file session_memory_test.cpp
+ * @brief SessionMemoryPool 单元测试
+ *
+ * 通过交给 nghttp2 的 mem() 分配器操作内存池，覆盖分级选择与对齐、
+ * 释放后复用、Reallocate 失败时旧块保持有效，以及超出 set_limit()
+ * 预算后分配失败、nghttp2 创建会话返回 NGHTTP2_ERR_NOMEM。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/session_memory.h"
+#include "test_util.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using litegrpc::http2::SessionMemoryPool;
+
+namespace {
+
+/**
+ * @brief 以 nghttp2 的方式调用内存池
+ */
+struct PoolAllocator {
+    explicit PoolAllocator(SessionMemoryPool* pool) : mem(pool->mem()) {}
+
+    void* Malloc(size_t size) { return mem->malloc(size, mem->mem_user_data); }
+    void Free(void* ptr) { mem->free(ptr, mem->mem_user_data); }
+    void* Calloc(size_t nmemb, size_t size) { return mem->calloc(nmemb, size, mem->mem_user_data); }
+    void* Realloc(void* ptr, size_t size) { return mem->realloc(ptr, size, mem->mem_user_data); }
+
+    nghttp2_mem* mem;
+};
+
+bool Aligned(const void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t) == 0;
+}
+
+void TestClassSelection() {
+    SessionMemoryPool pool;
+    PoolAllocator alloc(&pool);
+    const size_t header = SessionMemoryPool::kBlockHeaderSize;
+    const size_t max_block = SessionMemoryPool::kMinBlockSize << (SessionMemoryPool::kClassCount - 1);
+
+    // 请求加上块头后向上取到 2 的幂分级
+    struct Case {
+        size_t request;
+        size_t block;
+    } cases[] = {
+        {0, 32}, {1, 32}, {32 - header, 32}, {32 - header + 1, 64},
+        {100, 128}, {512 - header, 512}, {max_block - header, max_block},
+    };
+    std::vector<void*> blocks;
+    for (const auto& c : cases) {
+        const size_t before = pool.in_use();
+        void* ptr = alloc.Malloc(c.request);
+        CHECK(ptr != nullptr);
+        CHECK(Aligned(ptr));
+        CHECK_EQ(pool.in_use() - before, c.block);
+        memset(ptr, 0x5a, c.request);
+        blocks.push_back(ptr);
+    }
+    // 小块从整页切出：7 个请求只落在 5 个分级上
+    CHECK_EQ(pool.system_allocations(), 5u);
+
+    // 超过最大分级的请求直接向系统申请，释放时归还
+    const uint64_t system_before = pool.system_allocations();
+    const size_t reserved_before = pool.reserved();
+    void* large = alloc.Malloc(max_block - header + 1);
+    CHECK(large != nullptr);
+    CHECK(Aligned(large));
+    CHECK_EQ(pool.system_allocations(), system_before + 1);
+    CHECK_EQ(pool.reserved(), reserved_before + max_block + 1);
+    alloc.Free(large);
+    CHECK_EQ(pool.reserved(), reserved_before);
+
+    for (void* ptr : blocks) {
+        alloc.Free(ptr);
+    }
+    CHECK_EQ(pool.in_use(), 0u);
+    CHECK_EQ(pool.allocations(), 8u);
+    alloc.Free(nullptr);
+}
+
+void TestReuseAfterFree() {
+    SessionMemoryPool pool;
+    PoolAllocator alloc(&pool);
+
+    void* first = alloc.Malloc(40);
+    alloc.Free(first);
+    void* second = alloc.Malloc(48);  // 同一分级
+    CHECK(second == first);
+    alloc.Free(second);
+
+    // 反复分配释放一批块，第一次之后不再向系统申请内存
+    std::vector<void*> batch;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            batch.push_back(alloc.Malloc(static_cast<size_t>(8 + i * 9)));
+        }
+        for (void* ptr : batch) {
+            CHECK(ptr != nullptr);
+            alloc.Free(ptr);
+        }
+        batch.clear();
+        if (round == 0) {
+            CHECK(pool.system_allocations() > 0);
+        }
+    }
+    const uint64_t system_after_warmup = pool.system_allocations();
+    for (int i = 0; i < 100; ++i) {
+        batch.push_back(alloc.Malloc(static_cast<size_t>(8 + i * 9)));
+    }
+    for (void* ptr : batch) {
+        alloc.Free(ptr);
+    }
+    CHECK_EQ(pool.system_allocations(), system_after_warmup);
+    CHECK_EQ(pool.in_use(), 0u);
+
+    // calloc 复用的块同样清零
+    unsigned char* dirty = static_cast<unsigned char*>(alloc.Malloc(64));
+    memset(dirty, 0xff, 64);
+    alloc.Free(dirty);
+    unsigned char* zeroed = static_cast<unsigned char*>(alloc.Calloc(8, 8));
+    CHECK(zeroed == dirty);
+    bool all_zero = true;
+    for (int i = 0; i < 64; ++i) {
+        all_zero = all_zero && zeroed[i] == 0;
+    }
+    CHECK(all_zero);
+    alloc.Free(zeroed);
+    CHECK(alloc.Calloc(SIZE_MAX / 2, 4) == nullptr);
+}
+
+void TestReallocate() {
+    SessionMemoryPool pool;
+    PoolAllocator alloc(&pool);
+
+    // 空指针等同于分配
+    char* ptr = static_cast<char*>(alloc.Realloc(nullptr, 10));
+    CHECK(ptr != nullptr);
+    memcpy(ptr, "0123456789", 10);
+
+    // 仍在块容量内时原地返回
+    CHECK(alloc.Realloc(ptr, 32 - SessionMemoryPool::kBlockHeaderSize) == ptr);
+
+    // 超出容量时搬到新块，数据保留
+    char* grown = static_cast<char*>(alloc.Realloc(ptr, 300));
+    CHECK(grown != nullptr && grown != ptr);
+    CHECK(memcmp(grown, "0123456789", 10) == 0);
+
+    // 预算用尽时失败，旧块保持有效且内容不变
+    pool.set_limit(pool.reserved());
+    const uint64_t failures = pool.failures();
+    const size_t in_use = pool.in_use();
+    CHECK(alloc.Realloc(grown, 5000) == nullptr);
+    CHECK_EQ(pool.failures(), failures + 1);
+    CHECK_EQ(pool.in_use(), in_use);
+    CHECK(memcmp(grown, "0123456789", 10) == 0);
+
+    // 大小为 0 时释放
+    CHECK(alloc.Realloc(grown, 0) == nullptr);
+    CHECK_EQ(pool.in_use(), 0u);
+}
+
+void TestLimit() {
+    // 预算不足一整页时退而只申请一个块
+    SessionMemoryPool small;
+    PoolAllocator small_alloc(&small);
+    small.set_limit(100);
+    void* one = small_alloc.Malloc(10);
+    CHECK(one != nullptr);
+    CHECK_EQ(small.reserved(), 32u);
+    small_alloc.Free(one);
+
+    SessionMemoryPool pool;
+    PoolAllocator alloc(&pool);
+    pool.set_limit(4096);
+    std::vector<void*> blocks;
+    while (blocks.size() < 1000) {
+        void* ptr = alloc.Malloc(100);
+        if (!ptr) {
+            break;
+        }
+        blocks.push_back(ptr);
+    }
+    CHECK(!blocks.empty() && blocks.size() < 1000);
+    CHECK(pool.reserved() <= 4096u);
+    CHECK_EQ(pool.peak_reserved(), pool.reserved());
+    CHECK_EQ(pool.failures(), 1u);
+    CHECK(alloc.Malloc(8192) == nullptr);  // 大块同样受预算限制
+    CHECK_EQ(pool.failures(), 2u);
+
+    // 释放后的块可以在预算内再次分配
+    alloc.Free(blocks.back());
+    blocks.pop_back();
+    const uint64_t system_allocations = pool.system_allocations();
+    void* again = alloc.Malloc(100);
+    CHECK(again != nullptr);
+    CHECK_EQ(pool.system_allocations(), system_allocations);
+    blocks.push_back(again);
+    for (void* ptr : blocks) {
+        alloc.Free(ptr);
+    }
+
+    pool.Release();
+    CHECK_EQ(pool.reserved(), 0u);
+    CHECK_EQ(pool.failures(), 0u);
+}
+
+void TestNghttp2Session() {
+    nghttp2_session_callbacks* callbacks = nullptr;
+    CHECK_EQ(nghttp2_session_callbacks_new(&callbacks), 0);
+
+    // 预算远小于会话结构：创建会话返回 NGHTTP2_ERR_NOMEM
+    SessionMemoryPool tight;
+    tight.set_limit(1024);
+    nghttp2_session* session = nullptr;
+    CHECK_EQ(nghttp2_session_client_new3(&session, callbacks, nullptr, nullptr, tight.mem()),
+             NGHTTP2_ERR_NOMEM);
+    CHECK(tight.failures() > 0);
+    CHECK_EQ(tight.in_use(), 0u);
+
+    // 不限预算时会话的全部分配经过内存池，销毁后全部归还
+    SessionMemoryPool pool;
+    session = nullptr;
+    CHECK_EQ(nghttp2_session_client_new3(&session, callbacks, nullptr, nullptr, pool.mem()), 0);
+    CHECK(pool.allocations() > 0);
+    CHECK(pool.in_use() > 0);
+    CHECK_EQ(nghttp2_submit_settings(session, NGHTTP2_FLAG_NONE, nullptr, 0), 0);
+    nghttp2_session_del(session);
+    CHECK_EQ(pool.in_use(), 0u);
+    CHECK_EQ(pool.failures(), 0u);
+
+    nghttp2_session_callbacks_del(callbacks);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("ClassSelection", TestClassSelection);
+    litegrpc::test::RunTest("ReuseAfterFree", TestReuseAfterFree);
+    litegrpc::test::RunTest("Reallocate", TestReallocate);
+    litegrpc::test::RunTest("Limit", TestLimit);
+    litegrpc::test::RunTest("Nghttp2Session", TestNghttp2Session);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,272 @@
+/**
+ * @file shm_ring_test.cpp
+ * @brief 共享内存环与共享段单元测试
+ *
+ * 覆盖记录跨越环末尾时的填充与切分、对端位置越界或未对齐时的损坏检测，
+ * 以及映射未封印、过小或头部无效的 memfd 时的拒绝。
+ * 生产者与消费者在同一线程中交替操作同一个环。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "client/shm_ring.h"
+#include "test_util.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdint>
+#include <string>
+
+using litegrpc::Status;
+using litegrpc::StatusCode;
+namespace shm = litegrpc::shm;
+
+namespace {
+
+/**
+ * @brief 一个共享段及附着在其请求环上的生产者与消费者
+ */
+struct RingPair {
+    shm::Segment segment;
+    shm::Ring producer;
+    shm::Ring consumer;
+
+    RingPair() {
+        int fd = -1;
+        CHECK_OK(shm::CreateSegment(shm::kMinRingCapacity, &segment, &fd));
+        close(fd);
+        auto* header = segment.header();
+        producer.Attach(&header->request, segment.request_data(), header->ring_capacity);
+        consumer.Attach(&header->request, segment.request_data(), header->ring_capacity);
+    }
+
+    ~RingPair() { segment.Unmap(); }
+
+    shm::RingControl* control() { return &segment.header()->request; }
+};
+
+/**
+ * @brief 生成内容随序号变化的数据
+ */
+std::string Payload(uint64_t seed, size_t length) {
+    std::string data(length, '\0');
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = static_cast<char>((seed * 131 + i * 7) & 0xff);
+    }
+    return data;
+}
+
+/**
+ * @brief 读取一个记录并释放，环为空时返回 false
+ */
+bool ReadRecord(shm::Ring* ring, shm::RecordHeader* record, std::string* data) {
+    const char* ptr = nullptr;
+    bool corrupt = false;
+    if (!ring->Peek(record, &ptr, &corrupt)) {
+        CHECK(!corrupt);
+        return false;
+    }
+    data->assign(ptr, record->length);
+    ring->Consume();
+    return true;
+}
+
+void TestWraparoundWithPadding() {
+    RingPair pair;
+    const uint64_t capacity = pair.producer.capacity();
+    uint64_t written = 0;
+    uint64_t id = 0;
+    // 长度不整除容量，记录会多次落在环末尾之前，需要填充后从起始处写入
+    while (written < 8 * capacity) {
+        const size_t length = 1 + static_cast<size_t>((id * 2654435761u) % 9000);
+        const std::string payload = Payload(id, length);
+        size_t n = pair.producer.TryWrite(shm::kRecordData, id, payload.data(), length, true, false);
+        CHECK_EQ(n, length);
+        pair.producer.Publish();
+
+        shm::RecordHeader record;
+        std::string data;
+        CHECK(ReadRecord(&pair.consumer, &record, &data));
+        CHECK_EQ(record.type, static_cast<uint32_t>(shm::kRecordData));
+        CHECK_EQ(record.call_id, id);
+        CHECK((record.flags & shm::kRecordEnd) != 0);
+        CHECK(data == payload);
+        CHECK(!ReadRecord(&pair.consumer, &record, &data));
+        written += length;
+        id++;
+    }
+    CHECK(pair.control()->tail.load() > 8 * capacity);
+    CHECK_EQ(pair.control()->head.load(), pair.control()->tail.load());
+}
+
+void TestFullRingAndSplit() {
+    RingPair pair;
+    const uint64_t capacity = pair.producer.capacity();
+
+    // 不允许切分：环满时返回 SIZE_MAX，不写入任何内容
+    const std::string block(capacity / 4, 'b');
+    size_t records = 0;
+    while (pair.producer.TryWrite(shm::kRecordData, 1, block.data(), block.size(), true, false) != SIZE_MAX) {
+        records++;
+    }
+    CHECK_EQ(records, 3u);  // 每条记录另占一个记录头，第四条放不下
+    pair.producer.Publish();
+    shm::RecordHeader record;
+    std::string data;
+    for (size_t i = 0; i < records; ++i) {
+        CHECK(ReadRecord(&pair.consumer, &record, &data) && data == block);
+    }
+    CHECK(!ReadRecord(&pair.consumer, &record, &data));
+
+    // 允许切分：大消息按可用空间分片写入，读取方交替释放空间，只有最后一片带结束标志
+    const std::string message = Payload(7, static_cast<size_t>(3 * capacity + 12345));
+    std::string received;
+    size_t offset = 0;
+    size_t fragments = 0;
+    bool ended = false;
+    while (!ended) {
+        if (offset < message.size()) {
+            size_t n = pair.producer.TryWrite(shm::kRecordData, 2, message.data() + offset,
+                                              message.size() - offset, true, true);
+            if (n != SIZE_MAX) {
+                offset += n;
+                pair.producer.Publish();
+            }
+        }
+        while (ReadRecord(&pair.consumer, &record, &data)) {
+            CHECK_EQ(record.call_id, 2u);
+            received += data;
+            fragments++;
+            ended = (record.flags & shm::kRecordEnd) != 0;
+            CHECK(!ended || received.size() == message.size());
+        }
+    }
+    CHECK(fragments > 3);
+    CHECK(received == message);
+}
+
+void TestCorruptPeerPosition() {
+    shm::RecordHeader record;
+    const char* data = nullptr;
+    bool corrupt = false;
+
+    // 写入位置超出环容量
+    {
+        RingPair pair;
+        pair.control()->tail.store(pair.consumer.capacity() + 8);
+        CHECK(!pair.consumer.Peek(&record, &data, &corrupt));
+        CHECK(corrupt);
+    }
+    // 写入位置未按 8 字节对齐
+    {
+        RingPair pair;
+        pair.control()->tail.store(sizeof(shm::RecordHeader) + 4);
+        CHECK(!pair.consumer.Peek(&record, &data, &corrupt));
+        CHECK(corrupt);
+    }
+    // 写入位置落后于读取位置（回绕为极大的差值）
+    {
+        RingPair pair;
+        const std::string payload(16, 'p');
+        pair.producer.TryWrite(shm::kRecordData, 1, payload.data(), payload.size(), true, false);
+        pair.producer.Publish();
+        std::string read;
+        CHECK(ReadRecord(&pair.consumer, &record, &read));
+        pair.control()->tail.store(0);
+        CHECK(!pair.consumer.Peek(&record, &data, &corrupt));
+        CHECK(corrupt);
+    }
+    // 记录长度超出已发布的范围
+    {
+        RingPair pair;
+        const std::string payload(64, 'q');
+        pair.producer.TryWrite(shm::kRecordData, 1, payload.data(), payload.size(), true, false);
+        auto* header = reinterpret_cast<shm::RecordHeader*>(pair.segment.request_data());
+        header->length = pair.consumer.capacity();
+        pair.producer.Publish();
+        CHECK(!pair.consumer.Peek(&record, &data, &corrupt));
+        CHECK(corrupt);
+    }
+    // 合法的空环不是损坏
+    {
+        RingPair pair;
+        CHECK(!pair.consumer.Peek(&record, &data, &corrupt));
+        CHECK(!corrupt);
+    }
+}
+
+/**
+ * @brief 创建指定大小的 memfd
+ * @param seals 要添加的封印，0 表示创建不可封印的 memfd
+ */
+int MakeMemfd(size_t size, int seals) {
+    int fd = memfd_create("litegrpc-test", MFD_CLOEXEC | (seals ? MFD_ALLOW_SEALING : 0));
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0 || (seals && fcntl(fd, F_ADD_SEALS, seals) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+StatusCode MapCode(int fd) {
+    shm::Segment segment;
+    Status status = shm::MapSegment(fd, &segment);
+    CHECK(status.ok() == (segment.base != nullptr));
+    segment.Unmap();
+    return status.error_code();
+}
+
+void TestMapSegmentValidation() {
+    const size_t valid_size = shm::kDataOffset + 2 * shm::kMinRingCapacity;
+
+    // 由 CreateSegment 创建的段可以映射
+    shm::Segment created;
+    int fd = -1;
+    CHECK_OK(shm::CreateSegment(shm::kMinRingCapacity, &created, &fd));
+    shm::Segment mapped;
+    CHECK_OK(shm::MapSegment(fd, &mapped));
+    CHECK_EQ(mapped.size, created.size);
+    CHECK_EQ(mapped.header()->ring_capacity, shm::kMinRingCapacity);
+    mapped.Unmap();
+    created.Unmap();
+    close(fd);
+
+    // 未封印：对端之后可以截断文件
+    fd = MakeMemfd(valid_size, 0);
+    CHECK(fd >= 0);
+    CHECK_EQ(MapCode(fd), StatusCode::INVALID_ARGUMENT);
+    close(fd);
+
+    // 只禁止缩小、不禁止增大
+    fd = MakeMemfd(valid_size, F_SEAL_SHRINK);
+    CHECK(fd >= 0);
+    CHECK_EQ(MapCode(fd), StatusCode::INVALID_ARGUMENT);
+    close(fd);
+
+    // 已封印但小于段头
+    fd = MakeMemfd(shm::kDataOffset - 8, F_SEAL_SHRINK | F_SEAL_GROW);
+    CHECK(fd >= 0);
+    CHECK_EQ(MapCode(fd), StatusCode::INVALID_ARGUMENT);
+    close(fd);
+
+    // 已封印、大小正确但段头为零
+    fd = MakeMemfd(valid_size, F_SEAL_SHRINK | F_SEAL_GROW);
+    CHECK(fd >= 0);
+    CHECK_EQ(MapCode(fd), StatusCode::INVALID_ARGUMENT);
+    close(fd);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("WraparoundWithPadding", TestWraparoundWithPadding);
+    litegrpc::test::RunTest("FullRingAndSplit", TestFullRingAndSplit);
+    litegrpc::test::RunTest("CorruptPeerPosition", TestCorruptPeerPosition);
+    litegrpc::test::RunTest("MapSegmentValidation", TestMapSegmentValidation);
+    return litegrpc::test::TestResult();
+}
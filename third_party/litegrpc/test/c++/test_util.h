@@ -0,0 +1,92 @@
+/**
+ * @file test_util.h
+ * @brief 单元测试公共工具
+ *
+ * 不依赖外部测试框架：每个测试文件是一个可执行程序，以 RunTest()
+ * 依次执行各用例，CHECK 系列宏记录失败但不中断当前用例，
+ * main() 返回 TestResult()，由 ctest 根据退出码判断结果。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#ifndef LITEGRPC_TEST_UTIL_H
+#define LITEGRPC_TEST_UTIL_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace litegrpc {
+namespace test {
+
+/**
+ * @brief 本进程累计的检查失败次数
+ */
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * @brief 执行一个测试用例并输出结果
+ * @param name 用例名称
+ * @param body 用例函数
+ */
+template <typename Body>
+void RunTest(const char* name, Body body) {
+    const int before = Failures();
+    body();
+    printf("[%s] %s\n", Failures() == before ? "  OK  " : " FAIL ", name);
+    fflush(stdout);
+}
+
+/**
+ * @brief 全部用例执行后的进程退出码
+ */
+inline int TestResult() {
+    return Failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief 创建临时文件并写入内容
+ * @param content 文件内容
+ * @return std::string 文件路径，失败时为空
+ */
+inline std::string WriteTempFile(const std::string& content) {
+    char path[] = "/tmp/litegrpc_test_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return std::string();
+    }
+    const bool ok = write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size());
+    close(fd);
+    return ok ? std::string(path) : std::string();
+}
+
+} // namespace test
+} // namespace litegrpc
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,  \
+                    #cond);                                                    \
+            ::litegrpc::test::Failures()++;                                    \
+        }                                                                      \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+#define CHECK_OK(status)                                                       \
+    do {                                                                       \
+        const ::litegrpc::Status& check_status_ = (status);                    \
+        if (!check_status_.ok()) {                                             \
+            fprintf(stderr, "%s:%d: CHECK_OK failed: %s -> %s\n", __FILE__,    \
+                    __LINE__, #status, check_status_.error_message().c_str()); \
+            ::litegrpc::test::Failures()++;                                    \
+        }                                                                      \
+    } while (0)
+
+#endif // LITEGRPC_TEST_UTIL_H
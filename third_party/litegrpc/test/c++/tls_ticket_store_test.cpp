@@ -0,0 +1,207 @@
+/**
+ * @file tls_ticket_store_test.cpp
+ * @brief TlsTicketStore 单元测试
+ *
+ * 覆盖保存与读取、损坏槽位与过期槽位被丢弃并复用、槽位用尽时替换
+ * 最早写入的槽位、以不同槽位数重新打开，以及拒绝符号链接、
+ * 对其他用户开放权限或属于其他用户的已有文件。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/tls_ticket_store.h"
+#include "test_util.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+
+using litegrpc::StatusCode;
+using litegrpc::http2::TlsTicketStore;
+
+namespace {
+
+/**
+ * @brief 返回一个尚不存在的临时文件路径
+ */
+std::string TempPath() {
+    std::string path = litegrpc::test::WriteTempFile("");
+    unlink(path.c_str());
+    return path;
+}
+
+int64_t Later() {
+    return static_cast<int64_t>(time(nullptr)) + 3600;
+}
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void TestStoreAndLoad() {
+    const std::string path = TempPath();
+    std::shared_ptr<TlsTicketStore> store;
+    CHECK_OK(TlsTicketStore::Open(path, 4, &store));
+    struct stat st;
+    CHECK(stat(path.c_str(), &st) == 0 && (st.st_mode & 0777) == 0600);
+    CHECK_EQ(static_cast<size_t>(st.st_size), 64 + 4 * TlsTicketStore::kSlotSize);
+
+    // 同一进程内同一路径共享实例
+    std::shared_ptr<TlsTicketStore> again;
+    CHECK_OK(TlsTicketStore::Open(path, 4, &again));
+    CHECK(again == store);
+
+    std::string session;
+    CHECK(!store->Load("host-a", &session));
+    CHECK(store->Store("host-a", "session-a1", Later()));
+    CHECK(store->Load("host-a", &session) && session == "session-a1");
+    CHECK(store->Store("host-a", "session-a2", Later()));  // 覆盖同一个键
+    CHECK(store->Load("host-a", &session) && session == "session-a2");
+
+    // 超出限制的键或会话不保存
+    CHECK(!store->Store("", "x", Later()));
+    CHECK(!store->Store(std::string(TlsTicketStore::kMaxKeySize + 1, 'k'), "x", Later()));
+    CHECK(!store->Store("host-b", std::string(TlsTicketStore::kSlotSize, 's'), Later()));
+
+    store->Erase("host-a");
+    CHECK(!store->Load("host-a", &session));
+    store.reset();
+    again.reset();
+    unlink(path.c_str());
+}
+
+void TestCorruptAndExpiredSlots() {
+    const std::string path = TempPath();
+    std::shared_ptr<TlsTicketStore> store;
+    CHECK_OK(TlsTicketStore::Open(path, 2, &store));
+    std::string session;
+
+    // 过期的会话不返回
+    CHECK(store->Store("corrupt", "payload-to-damage", Later()));
+    CHECK(store->Store("expired", "old-session", static_cast<int64_t>(time(nullptr)) - 1));
+    CHECK(!store->Load("expired", &session));
+    CHECK(store->Load("corrupt", &session) && session == "payload-to-damage");
+
+    // 改动文件中的会话数据：校验和不符，槽位被丢弃
+    const std::string contents = ReadFile(path);
+    const size_t offset = contents.find("payload-to-damage");
+    CHECK(offset != std::string::npos);
+    int fd = open(path.c_str(), O_WRONLY);
+    CHECK(fd >= 0);
+    CHECK(pwrite(fd, "X", 1, static_cast<off_t>(offset)) == 1);
+    close(fd);
+    CHECK(!store->Load("corrupt", &session));
+
+    // 两个槽位分别是过期与损坏的，新的键复用它们而不替换有效槽位
+    CHECK(store->Store("fresh-1", "s1", Later()));
+    CHECK(store->Store("fresh-2", "s2", Later()));
+    CHECK(store->Load("fresh-1", &session) && session == "s1");
+    CHECK(store->Load("fresh-2", &session) && session == "s2");
+    store.reset();
+    unlink(path.c_str());
+}
+
+void TestReplaceOldest() {
+    const std::string path = TempPath();
+    std::shared_ptr<TlsTicketStore> store;
+    CHECK_OK(TlsTicketStore::Open(path, 2, &store));
+    std::string session;
+
+    // 写入时间以秒计，间隔超过一秒使先后顺序确定
+    CHECK(store->Store("first", "s1", Later()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    CHECK(store->Store("second", "s2", Later()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    CHECK(store->Store("first", "s1b", Later()));  // 重新写入后 second 最早
+
+    CHECK(store->Store("third", "s3", Later()));
+    CHECK(!store->Load("second", &session));
+    CHECK(store->Load("first", &session) && session == "s1b");
+    CHECK(store->Load("third", &session) && session == "s3");
+    store.reset();
+    unlink(path.c_str());
+}
+
+void TestReopen() {
+    const std::string path = TempPath();
+    std::shared_ptr<TlsTicketStore> store;
+    CHECK_OK(TlsTicketStore::Open(path, 4, &store));
+    CHECK(store->Store("kept", "session", Later()));
+    store.reset();
+
+    // 有效的已有文件沿用其槽位数，会话保留
+    CHECK_OK(TlsTicketStore::Open(path, 8, &store));
+    std::string session;
+    CHECK(store->Load("kept", &session) && session == "session");
+    struct stat st;
+    CHECK(stat(path.c_str(), &st) == 0);
+    CHECK_EQ(static_cast<size_t>(st.st_size), 64 + 4 * TlsTicketStore::kSlotSize);
+    store.reset();
+
+    // 格式无效的文件按请求的槽位数重建
+    CHECK(truncate(path.c_str(), 100) == 0);
+    CHECK_OK(TlsTicketStore::Open(path, 8, &store));
+    CHECK(!store->Load("kept", &session));
+    CHECK(stat(path.c_str(), &st) == 0);
+    CHECK_EQ(static_cast<size_t>(st.st_size), 64 + 8 * TlsTicketStore::kSlotSize);
+    store.reset();
+    unlink(path.c_str());
+}
+
+void TestRejectUnsafeFiles() {
+    std::shared_ptr<TlsTicketStore> store;
+
+    // 对其他用户可读写的已有文件
+    const std::string open_path = TempPath();
+    int fd = open(open_path.c_str(), O_CREAT | O_WRONLY, 0600);
+    CHECK(fd >= 0);
+    CHECK(fchmod(fd, 0666) == 0);
+    close(fd);
+    CHECK_EQ(TlsTicketStore::Open(open_path, 4, &store).error_code(), StatusCode::UNAVAILABLE);
+    CHECK(!store);
+    CHECK(chmod(open_path.c_str(), 0640) == 0);
+    CHECK_EQ(TlsTicketStore::Open(open_path, 4, &store).error_code(), StatusCode::UNAVAILABLE);
+    CHECK(chmod(open_path.c_str(), 0600) == 0);
+    CHECK_OK(TlsTicketStore::Open(open_path, 4, &store));
+    store.reset();
+
+    // 指向存储文件的符号链接
+    const std::string link_path = TempPath();
+    CHECK(symlink(open_path.c_str(), link_path.c_str()) == 0);
+    CHECK_EQ(TlsTicketStore::Open(link_path, 4, &store).error_code(), StatusCode::UNAVAILABLE);
+    unlink(link_path.c_str());
+
+    // 目录
+    const std::string dir_path = TempPath();
+    CHECK(mkdir(dir_path.c_str(), 0700) == 0);
+    CHECK_EQ(TlsTicketStore::Open(dir_path, 4, &store).error_code(), StatusCode::UNAVAILABLE);
+    rmdir(dir_path.c_str());
+
+    // 属于其他用户的文件（只有 root 能改变属主）
+    if (geteuid() == 0) {
+        CHECK(chown(open_path.c_str(), 65534, 65534) == 0);
+        CHECK_EQ(TlsTicketStore::Open(open_path, 4, &store).error_code(), StatusCode::UNAVAILABLE);
+    }
+    CHECK(!store);
+    unlink(open_path.c_str());
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("StoreAndLoad", TestStoreAndLoad);
+    litegrpc::test::RunTest("CorruptAndExpiredSlots", TestCorruptAndExpiredSlots);
+    litegrpc::test::RunTest("ReplaceOldest", TestReplaceOldest);
+    litegrpc::test::RunTest("Reopen", TestReopen);
+    litegrpc::test::RunTest("RejectUnsafeFiles", TestRejectUnsafeFiles);
+    return litegrpc::test::TestResult();
+}
@@ -0,0 +1,162 @@
+/**
+ * @file write_scheduler_test.cpp
+ * @brief WriteScheduler 单元测试
+ *
+ * 以集合模拟各流的流量控制窗口，覆盖更紧急的流能够发送时暂停、
+ * 只因自身流窗口耗尽而无法发送时不暂停、窗口耗尽后按暂停顺序恢复、
+ * 请求体写完后恢复，以及输出队列积压上限。
+ *
+ * @author LiteGRPC Team
+ * @date 2024
+ */
+
+#include "http2/write_scheduler.h"
+#include "test_util.h"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using litegrpc::http2::WriteScheduler;
+using litegrpc::http2::kDefaultUrgency;
+using litegrpc::http2::kLowPriorityQueueLimit;
+
+namespace {
+
+/**
+ * @brief 模拟的流窗口：集合中的流窗口已耗尽
+ */
+struct Windows {
+    std::set<int32_t> blocked;
+
+    WriteScheduler::CanSend can_send() const {
+        return [this](int32_t stream_id) { return blocked.count(stream_id) == 0; };
+    }
+};
+
+void TestDeferBehindUrgent() {
+    WriteScheduler scheduler;
+    Windows windows;
+    scheduler.AddBody(1, 0);
+    scheduler.AddBody(3, kDefaultUrgency);
+
+    CHECK(!scheduler.ShouldDefer(0, windows.can_send()));
+    CHECK(scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+    CHECK(scheduler.ShouldDefer(7, windows.can_send()));
+
+    // 同一紧急度的流不互相让路
+    scheduler.AddBody(5, kDefaultUrgency);
+    scheduler.RemoveBody(1, 0);
+    CHECK(!scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+    CHECK(scheduler.ShouldDefer(7, windows.can_send()));
+}
+
+void TestWindowBlockedUrgent() {
+    WriteScheduler scheduler;
+    Windows windows;
+    scheduler.AddBody(1, 0);
+    scheduler.AddBody(3, 1);
+    scheduler.AddBody(5, kDefaultUrgency);
+
+    // 更紧急的流全部耗尽流窗口时不暂停
+    windows.blocked = {1, 3};
+    CHECK(!scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+
+    // 只要有一个更紧急的流能够发送就暂停
+    windows.blocked = {1};
+    CHECK(scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+    CHECK(!scheduler.ShouldDefer(1, windows.can_send()));
+}
+
+void TestResumeWhenUrgentBlocked() {
+    WriteScheduler scheduler;
+    Windows windows;
+    scheduler.AddBody(1, 0);
+    scheduler.AddBody(3, 2);
+    scheduler.AddBody(5, 4);
+    scheduler.AddBody(7, 4);
+    CHECK(!scheduler.has_deferred());
+
+    CHECK(scheduler.ShouldDefer(4, windows.can_send()));
+    scheduler.Defer(7, 4);
+    scheduler.Defer(5, 4);
+    CHECK(scheduler.ShouldDefer(2, windows.can_send()));
+    scheduler.Defer(3, 2);
+    CHECK(scheduler.has_deferred());
+
+    // 窗口不变时没有流需要恢复
+    CHECK(scheduler.TakeUnblocked(windows.can_send()).empty());
+
+    // 流 1 耗尽窗口：流 3 不再让路，流 5、7 仍需让路给流 3
+    windows.blocked = {1};
+    std::vector<int32_t> resumed = scheduler.TakeUnblocked(windows.can_send());
+    CHECK(resumed == std::vector<int32_t>({3}));
+    CHECK(scheduler.has_deferred());
+
+    // 流 3 也耗尽窗口：按暂停顺序恢复剩余的流
+    windows.blocked = {1, 3};
+    resumed = scheduler.TakeUnblocked(windows.can_send());
+    CHECK(resumed == std::vector<int32_t>({7, 5}));
+    CHECK(!scheduler.has_deferred());
+}
+
+void TestResumeWhenBodyFinished() {
+    WriteScheduler scheduler;
+    Windows windows;
+    scheduler.AddBody(1, 0);
+    scheduler.AddBody(3, 0);
+    scheduler.AddBody(5, kDefaultUrgency);
+
+    // 没有暂停的流时不需要恢复
+    CHECK(!scheduler.RemoveBody(3, 0));
+    scheduler.AddBody(3, 0);
+
+    scheduler.Defer(5, kDefaultUrgency);
+    CHECK(!scheduler.RemoveBody(1, 0));  // 流 3 仍未写完
+    CHECK(scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+    CHECK(scheduler.RemoveBody(3, 0));
+    CHECK(!scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+
+    CHECK(scheduler.TakeDeferred() == std::vector<int32_t>({5}));
+    CHECK(!scheduler.has_deferred());
+
+    // 多次注销同一个流不影响其他流
+    scheduler.AddBody(9, 1);
+    scheduler.AddBody(11, 1);
+    scheduler.RemoveBody(9, 1);
+    scheduler.RemoveBody(9, 1);
+    CHECK(scheduler.ShouldDefer(kDefaultUrgency, windows.can_send()));
+
+    scheduler.Defer(5, kDefaultUrgency);
+    scheduler.Reset();
+    CHECK(!scheduler.has_deferred());
+    CHECK(!scheduler.ShouldDefer(7, windows.can_send()));
+}
+
+void TestQueueLimit() {
+    WriteScheduler scheduler;
+    const size_t limit = 1024 * 1024;
+    CHECK_EQ(scheduler.QueueLimit(kDefaultUrgency, limit), limit);
+
+    CHECK(scheduler.Enable());
+    CHECK(!scheduler.Enable());
+    CHECK(scheduler.enabled());
+    CHECK_EQ(scheduler.QueueLimit(0, limit), limit);
+    CHECK_EQ(scheduler.QueueLimit(kDefaultUrgency, limit), kLowPriorityQueueLimit);
+    CHECK_EQ(scheduler.QueueLimit(kDefaultUrgency, 1000), 1000u);
+
+    scheduler.Reset();
+    CHECK(!scheduler.enabled());
+    CHECK_EQ(scheduler.QueueLimit(kDefaultUrgency, limit), limit);
+}
+
+} // namespace
+
+int main() {
+    litegrpc::test::RunTest("DeferBehindUrgent", TestDeferBehindUrgent);
+    litegrpc::test::RunTest("WindowBlockedUrgent", TestWindowBlockedUrgent);
+    litegrpc::test::RunTest("ResumeWhenUrgentBlocked", TestResumeWhenUrgentBlocked);
+    litegrpc::test::RunTest("ResumeWhenBodyFinished", TestResumeWhenBodyFinished);
+    litegrpc::test::RunTest("QueueLimit", TestQueueLimit);
+    return litegrpc::test::TestResult();
+}